@@ -520,6 +520,66 @@ Vc_INTRINSIC __m256i mul(__m256i a, __m256i b,   uint) { return AVX::mullo_epi32
 Vc_INTRINSIC __m256i mul(__m256i a, __m256i b,  short) { return AVX::mullo_epi16(a, b); }
 Vc_INTRINSIC __m256i mul(__m256i a, __m256i b, ushort) { return AVX::mullo_epi16(a, b); }
 
+// mulhi{{{1
+// the high half of the full product
+Vc_INTRINSIC __m256i mulhi(__m256i a, __m256i b,  short) { return AVX::mulhi_epi16(a, b); }
+Vc_INTRINSIC __m256i mulhi(__m256i a, __m256i b, ushort) { return AVX::mulhi_epu16(a, b); }
+#ifdef Vc_IMPL_AVX2
+Vc_INTRINSIC __m256i mulhi(__m256i a, __m256i b,   uint) {
+    const __m256i ab02 = _mm256_mul_epu32(a, b);  // [a0 * b0, a2 * b2, ...]
+    const __m256i ab13 =
+        _mm256_mul_epu32(_mm256_shuffle_epi32(a, 0xf5), _mm256_shuffle_epi32(b, 0xf5));
+    return _mm256_blend_epi32(_mm256_shuffle_epi32(ab02, 0xf5), ab13, 0xaa);
+}
+Vc_INTRINSIC __m256i mulhi(__m256i a, __m256i b,    int) {
+    const __m256i ab02 = _mm256_mul_epi32(a, b);  // [a0 * b0, a2 * b2, ...]
+    const __m256i ab13 =
+        _mm256_mul_epi32(_mm256_shuffle_epi32(a, 0xf5), _mm256_shuffle_epi32(b, 0xf5));
+    return _mm256_blend_epi32(_mm256_shuffle_epi32(ab02, 0xf5), ab13, 0xaa);
+}
+#else
+Vc_INTRINSIC __m256i mulhi(__m256i a, __m256i b,   uint) {
+    return AVX::concat(mulhi(AVX::lo128(a), AVX::lo128(b), uint()),
+                       mulhi(AVX::hi128(a), AVX::hi128(b), uint()));
+}
+Vc_INTRINSIC __m256i mulhi(__m256i a, __m256i b,    int) {
+    return AVX::concat(mulhi(AVX::lo128(a), AVX::lo128(b), int()),
+                       mulhi(AVX::hi128(a), AVX::hi128(b), int()));
+}
+#endif
+
+// adds / subs / avg{{{1
+Vc_INTRINSIC __m256i adds(__m256i a, __m256i b,  short) { return AVX::adds_epi16(a, b); }
+Vc_INTRINSIC __m256i adds(__m256i a, __m256i b, ushort) { return AVX::adds_epu16(a, b); }
+Vc_INTRINSIC __m256i subs(__m256i a, __m256i b,  short) { return AVX::subs_epi16(a, b); }
+Vc_INTRINSIC __m256i subs(__m256i a, __m256i b, ushort) { return AVX::subs_epu16(a, b); }
+Vc_INTRINSIC __m256i avg(__m256i a, __m256i b, ushort) { return AVX::avg_epu16(a, b); }
+Vc_INTRINSIC __m256i avg(__m256i a, __m256i b,  short) {
+    // flipping the sign bits maps short to ushort preserving the order
+    const __m256i bias = _mm256_set1_epi16(-0x8000);
+    return xor_(AVX::avg_epu16(xor_(a, bias), xor_(b, bias)), bias);
+}
+
+// mulhrs{{{1
+// (a * b + 0x4000) >> 15, the rounded Q15 product
+Vc_INTRINSIC __m256i mulhrs(__m256i a, __m256i b, short) { return AVX::mulhrs_epi16(a, b); }
+
+// madd / mul_widen{{{1
+// a0 * b0 + a1 * b1, a2 * b2 + a3 * b3, ... as 32-bit integers
+Vc_INTRINSIC __m256i madd(__m256i a, __m256i b, short) { return AVX::madd_epi16(a, b); }
+
+// the full products of the low and high eight entries
+template <typename T> Vc_INTRINSIC void mul_widen(__m256i a, __m256i b, __m256i &r0, __m256i &r1, T)
+{
+    const __m256i lo = AVX::mullo_epi16(a, b);
+    const __m256i hi = mulhi(a, b, T());
+    // the unpacks work per 128-bit lane: [0..3, 8..11] and [4..7, 12..15]
+    const __m256i p0 = AVX::unpacklo_epi16(lo, hi);
+    const __m256i p1 = AVX::unpackhi_epi16(lo, hi);
+    r0 = _mm256_permute2f128_si256(p0, p1, 0x20);
+    r1 = _mm256_permute2f128_si256(p0, p1, 0x31);
+}
+
 // horizontal add{{{1
 template <typename T> Vc_INTRINSIC T add(Common::IntrinsicType<T, 32 / sizeof(T)> a, T)
 {
@@ -1237,6 +1297,46 @@ template<typename V> struct InterleaveImpl<V, 16, 32> {
         v1.data() = AVX::unpackhi_epi16(tmp8, tmp10);
         v2.data() = AVX::unpacklo_epi16(tmp9, tmp11);
     }/*}}}*/
+    static inline void deinterleave(typename V::EntryType const *const data,/*{{{*/
+            const Common::SuccessiveEntries<3> &i, V &v0, V &v1, V &v2)
+    {
+        using namespace AVX;
+        const m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&data[i[0]]));               // [abc]0 [abc]1 [ab]2 | c2 [abc]3 [abc]4 a5
+        const m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&data[i[0] + V::Size]));     // [bc]5 [abc]6 [abc]7 | [abc]8 [abc]9 [ab]10
+        const m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&data[i[0] + 2 * V::Size])); // c10 [abc]11 [abc]12 a13 | [bc]13 [abc]14 [abc]15
+        // structs 0..7 in the low half and 8..15 in the high half
+        const m256i m0 = Mem::shuffle128<X0, Y1>(a, b); // [abc]0 [abc]1 [ab]2 | [abc]8 [abc]9 [ab]10
+        const m256i m1 = Mem::shuffle128<X1, Y0>(a, c); // c2 [abc]3 [abc]4 a5 | c10 [abc]11 [abc]12 a13
+        const m256i m2 = Mem::shuffle128<X0, Y1>(b, c); // [bc]5 [abc]6 [abc]7 | [bc]13 [abc]14 [abc]15
+
+        // move every struct to the low 48 bits of a 64-bit half
+        const m256i s0 = m0;
+        const m256i s1 = srli_si256<6>(m0);
+        const m256i s2 = or_si256(srli_si256<12>(m0), slli_si256<4>(m1));
+        const m256i s3 = srli_si256<2>(m1);
+        const m256i s4 = srli_si256<8>(m1);
+        const m256i s5 = or_si256(srli_si256<14>(m1), slli_si256<2>(m2));
+        const m256i s6 = srli_si256<4>(m2);
+        const m256i s7 = srli_si256<10>(m2);
+
+        const __m256i tmp0 = unpacklo_epi64(s0, s1); // a0 b0 c0 XX a1 b1 c1 XX | a8 b8 c8 XX a9 ...
+        const __m256i tmp1 = unpacklo_epi64(s2, s3);
+        const __m256i tmp2 = unpacklo_epi64(s4, s5);
+        const __m256i tmp3 = unpacklo_epi64(s6, s7);
+        const __m256i tmp4 = AVX::unpacklo_epi16(tmp0, tmp2); // a0 a4 b0 b4 c0 c4 XX XX | a8 a12 b8 ...
+        const __m256i tmp5 = AVX::unpackhi_epi16(tmp0, tmp2); // a1 a5 ...
+        const __m256i tmp6 = AVX::unpacklo_epi16(tmp1, tmp3); // a2 a6 ...
+        const __m256i tmp7 = AVX::unpackhi_epi16(tmp1, tmp3); // a3 a7 ...
+
+        const __m256i tmp8  = AVX::unpacklo_epi16(tmp4, tmp6); // a0 a2 a4 a6 b0 ...
+        const __m256i tmp9  = AVX::unpackhi_epi16(tmp4, tmp6); // c0 c2 c4 c6 XX ...
+        const __m256i tmp10 = AVX::unpacklo_epi16(tmp5, tmp7); // a1 a3 a5 a7 b1 ...
+        const __m256i tmp11 = AVX::unpackhi_epi16(tmp5, tmp7); // c1 c3 c5 c7 XX ...
+
+        v0.data() = AVX::unpacklo_epi16(tmp8, tmp10); // a0 a1 a2 a3 a4 a5 a6 a7 | a8 ...
+        v1.data() = AVX::unpackhi_epi16(tmp8, tmp10);
+        v2.data() = AVX::unpacklo_epi16(tmp9, tmp11);
+    }/*}}}*/
     template<typename I> static inline void deinterleave(typename V::EntryType const *const data,/*{{{*/
             const I &i, V &v0, V &v1, V &v2, V &v3)
     {
@@ -1602,6 +1702,25 @@ template<typename V> struct InterleaveImpl<V, 8, 32> {
         v1.data() = avx_cast<typename V::VectorType>(_mm256_unpackhi_ps(ab0246, ab1357));
         v2.data() = avx_cast<typename V::VectorType>(_mm256_unpacklo_ps(cd0246, cd1357));
     }/*}}}*/
+    static inline void deinterleave(typename V::EntryType const *const data,/*{{{*/
+            const Common::SuccessiveEntries<3> &i, V &v0, V &v1, V &v2)
+    {
+        using namespace AVX;
+        const m256 a = _mm256_loadu_ps(reinterpret_cast<const MayAlias<float> *>(&data[i[0]]));               // a0 b0 c0 a1 b1 c1 a2 b2
+        const m256 b = _mm256_loadu_ps(reinterpret_cast<const MayAlias<float> *>(&data[i[0] + V::Size]));     // c2 a3 b3 c3 a4 b4 c4 a5
+        const m256 c = _mm256_loadu_ps(reinterpret_cast<const MayAlias<float> *>(&data[i[0] + 2 * V::Size])); // b5 c5 a6 b6 c6 a7 b7 c7
+        // structs 0..3 in the low half and 4..7 in the high half
+        const m256 m0 = Mem::shuffle128<X0, Y1>(a, b); // a0 b0 c0 a1 | a4 b4 c4 a5
+        const m256 m1 = Mem::shuffle128<X1, Y0>(a, c); // b1 c1 a2 b2 | b5 c5 a6 b6
+        const m256 m2 = Mem::shuffle128<X0, Y1>(b, c); // c2 a3 b3 c3 | c6 a7 b7 c7
+
+        const m256 tmp0 = _mm256_shuffle_ps(m1, m2, _MM_SHUFFLE(2, 1, 3, 2)); // a2 b2 a3 b3 | a6 b6 a7 b7
+        const m256 tmp1 = _mm256_shuffle_ps(m0, m1, _MM_SHUFFLE(1, 0, 2, 1)); // b0 c0 b1 c1 | b4 c4 b5 c5
+
+        v0.data() = avx_cast<typename V::VectorType>(_mm256_shuffle_ps(m0, tmp0, _MM_SHUFFLE(2, 0, 3, 0)));
+        v1.data() = avx_cast<typename V::VectorType>(_mm256_shuffle_ps(tmp1, tmp0, _MM_SHUFFLE(3, 1, 2, 0)));
+        v2.data() = avx_cast<typename V::VectorType>(_mm256_shuffle_ps(tmp1, m2, _MM_SHUFFLE(3, 0, 3, 1)));
+    }/*}}}*/
     template<typename I> static inline void deinterleave(typename V::EntryType const *const data,/*{{{*/
             const I &i, V &v0, V &v1, V &v2, V &v3)
     {
@@ -1764,6 +1883,22 @@ template<typename V> struct InterleaveImpl<V, 4, 32> {
         v2.gather(data + 2, i);
         deinterleave(data, i, v0, v1);
     }/*}}}*/
+    static inline void deinterleave(typename V::EntryType const *const data,/*{{{*/
+            const Common::SuccessiveEntries<3> &i, V &v0, V &v1, V &v2)
+    {
+        using namespace Vc::AVX;
+        const m256d a = _mm256_loadu_pd(&data[i[0]]);     // a0 b0 c0 a1
+        const m256d b = _mm256_loadu_pd(&data[i[0] + 4]); // b1 c1 a2 b2
+        const m256d c = _mm256_loadu_pd(&data[i[0] + 8]); // c2 a3 b3 c3
+        // structs 0..1 in the low half and 2..3 in the high half
+        const m256d m0 = Mem::shuffle128<X0, Y1>(a, b); // a0 b0 | a2 b2
+        const m256d m1 = Mem::shuffle128<X1, Y0>(a, c); // c0 a1 | c2 a3
+        const m256d m2 = Mem::shuffle128<X0, Y1>(b, c); // b1 c1 | b3 c3
+
+        v0.data() = _mm256_shuffle_pd(m0, m1, 0xa);
+        v1.data() = _mm256_shuffle_pd(m0, m2, 0x5);
+        v2.data() = _mm256_shuffle_pd(m1, m2, 0xa);
+    }/*}}}*/
     template<typename I> static inline void deinterleave(typename V::EntryType const *const data,/*{{{*/
             const I &i, V &v0, V &v1, V &v2, V &v3)
     {
@@ -112,6 +112,10 @@ Vc_ALWAYS_INLINE void prefetchFar(const void *addr, VectorAbi::Avx)
 {
     prefetchFar(addr, VectorAbi::Sse());
 }
+Vc_ALWAYS_INLINE void storeFence(VectorAbi::Avx)
+{
+    storeFence(VectorAbi::Sse());
+}
 }  // namespace Detail
 }  // namespace Vc
 
@@ -187,6 +187,7 @@ public:
 
         Vc_INTRINSIC Vc_PURE int count() const { return Detail::popcnt16(toInt()); }
         Vc_INTRINSIC Vc_PURE int firstOne() const { return _bit_scan_forward(toInt()); }
+        Vc_INTRINSIC Vc_PURE int lastOne() const { return _bit_scan_reverse(toInt()); }
 
         template <typename G> static Vc_INTRINSIC_L Mask generate(G &&gen) Vc_INTRINSIC_R;
         Vc_INTRINSIC_L Vc_PURE_L Mask shifted(int amount) const Vc_INTRINSIC_R Vc_PURE_R;
@@ -1467,7 +1467,12 @@ Vc_SIMD_CAST_2(SSE::double_v, AVX2::double_v) { return AVX::concat(x0.data(), x1
 Vc_SIMD_CAST_2(SSE::double_v, AVX2:: float_v) { return AVX::zeroExtend(simd_cast<SSE:: float_v>(x0, x1).data()); }
 Vc_SIMD_CAST_2(SSE:: float_v, AVX2:: float_v) { return AVX::concat(x0.data(), x1.data()); }
 Vc_SIMD_CAST_2(SSE::   int_v, AVX2:: float_v) { return AVX::convert< int, float>(AVX::concat(x0.data(), x1.data())); }
+#ifdef Vc_IMPL_AVX2
 Vc_SIMD_CAST_2(SSE::  uint_v, AVX2:: float_v) { return AVX::convert<uint, float>(AVX::concat(x0.data(), x1.data())); }
+#else
+// without AVX2 the integer operations of the 256-bit conversion are emulated anyway
+Vc_SIMD_CAST_2(SSE::  uint_v, AVX2:: float_v) { return AVX::concat(SSE::convert<uint, float>(x0.data()), SSE::convert<uint, float>(x1.data())); }
+#endif
 
 #ifdef Vc_IMPL_AVX2
 Vc_SIMD_CAST_2(SSE::double_v, AVX2::   int_v) { return AVX::zeroExtend(simd_cast<SSE::   int_v>(x0, x1).data()); }
@@ -1578,7 +1583,8 @@ Vc_SIMD_CAST_1(AVX2:: float_v, SSE::double_v) { return simd_cast<SSE::double_v>(
 Vc_SIMD_CAST_1(AVX2:: float_v, SSE::   int_v) { return simd_cast<SSE::   int_v>(simd_cast<SSE:: float_v>(x)); }
 Vc_SIMD_CAST_1(AVX2:: float_v, SSE::  uint_v) { return simd_cast<SSE::  uint_v>(simd_cast<SSE:: float_v>(x)); }
 Vc_SIMD_CAST_1(AVX2:: float_v, SSE:: short_v) { return AVX::convert<float, short>(x.data()); }
-Vc_SIMD_CAST_1(AVX2:: float_v, SSE::ushort_v) { return AVX::convert<float, unsigned short>(x.data()); }
+// values outside of [0, 65535] are undefined anyway, thus the signed conversion suffices
+Vc_SIMD_CAST_1(AVX2:: float_v, SSE::ushort_v) { return AVX::convert<int, unsigned short>(AVX::convert<float, int>(x.data())); }
 
 #ifdef Vc_IMPL_AVX2
 Vc_SIMD_CAST_1(AVX2::   int_v, SSE::double_v) { return SSE::convert<int, double>(AVX::lo128(x.data())); }
@@ -2621,6 +2627,66 @@ Vc_INTRINSIC Vc_CONST enable_if<(offset != 0 && SSE::is_vector<Return>::value &&
 Vc_SIMD_CAST_OFFSET(SSE:: short_v, AVX2::double_v, 1) { return simd_cast<AVX2::double_v>(simd_cast<SSE::int_v, 1>(x)); }
 Vc_SIMD_CAST_OFFSET(SSE::ushort_v, AVX2::double_v, 1) { return simd_cast<AVX2::double_v>(simd_cast<SSE::int_v, 1>(x)); }
 
+// 1 AVX2::Vector to 2 Vectors (SimdArray halves) {{{1
+// These overload the generic simd_cast_halves in common/simdarray.h. The conversion
+// instruction is executed once on the full AVX register instead of once per half.
+// 1 AVX2::float_v to 2 SSE::(u)int_v {{{2
+Vc_INTRINSIC void simd_cast_halves(AVX2::float_v x, SSE::int_v &r0, SSE::int_v &r1)
+{
+    const __m256i tmp = AVX::convert<float, int>(x.data());
+    r0 = AVX::lo128(tmp);
+    r1 = AVX::hi128(tmp);
+}
+Vc_INTRINSIC void simd_cast_halves(AVX2::float_v x, SSE::uint_v &r0, SSE::uint_v &r1)
+{
+    // like AVX::convert<float, uint>, but without 256-bit integer instructions: adding
+    // 2^31 to the converted value of x - 2^31 is the same as flipping its sign bit
+    using namespace AVX;
+    const __m256 large = cmpge_ps(x.data(), set2power31_ps());
+    const __m256 tmp = _mm256_or_ps(
+        _mm256_andnot_ps(large, _mm256_castsi256_ps(_mm256_cvttps_epi32(x.data()))),
+        _mm256_and_ps(large, _mm256_xor_ps(_mm256_castsi256_ps(_mm256_cvttps_epi32(
+                                               _mm256_sub_ps(x.data(), set2power31_ps()))),
+                                           setsignmask_ps())));
+    r0 = _mm_castps_si128(lo128(tmp));
+    r1 = _mm_castps_si128(hi128(tmp));
+}
+
+// 1 AVX2::float_v to 2 AVX2::double_v {{{2
+Vc_INTRINSIC void simd_cast_halves(AVX2::float_v x, AVX2::double_v &r0, AVX2::double_v &r1)
+{
+    r0 = _mm256_cvtps_pd(AVX::lo128(x.data()));
+    r1 = _mm256_cvtps_pd(AVX::hi128(x.data()));
+}
+
+#ifdef Vc_IMPL_AVX2
+// 1 AVX2::(u)int_v to 2 AVX2::double_v {{{2
+Vc_INTRINSIC void simd_cast_halves(AVX2::int_v x, AVX2::double_v &r0, AVX2::double_v &r1)
+{
+    r0 = AVX::convert<int, double>(AVX::lo128(x.data()));
+    r1 = AVX::convert<int, double>(AVX::hi128(x.data()));
+}
+Vc_INTRINSIC void simd_cast_halves(AVX2::uint_v x, AVX2::double_v &r0, AVX2::double_v &r1)
+{
+    r0 = AVX::convert<uint, double>(AVX::lo128(x.data()));
+    r1 = AVX::convert<uint, double>(AVX::hi128(x.data()));
+}
+
+// 1 AVX2::(u)short_v to 2 AVX2::(u)int_v {{{2
+#define Vc_SIMD_CAST_HALVES_(from_, to_, shift_)                                         \
+    Vc_INTRINSIC void simd_cast_halves(AVX2::from_ x, AVX2::to_ &r0, AVX2::to_ &r1)       \
+    {                                                                                    \
+        const auto tmp = Mem::permute4x64<X0, X2, X1, X3>(x.data());                     \
+        r0 = shift_(_mm256_unpacklo_epi16(tmp, tmp), 16);                                \
+        r1 = shift_(_mm256_unpackhi_epi16(tmp, tmp), 16);                                \
+    }
+Vc_SIMD_CAST_HALVES_( short_v,  int_v, _mm256_srai_epi32)
+Vc_SIMD_CAST_HALVES_( short_v, uint_v, _mm256_srai_epi32)
+Vc_SIMD_CAST_HALVES_(ushort_v,  int_v, _mm256_srli_epi32)
+Vc_SIMD_CAST_HALVES_(ushort_v, uint_v, _mm256_srli_epi32)
+#undef Vc_SIMD_CAST_HALVES_
+#endif
+
 // Mask casts with offset {{{1
 // 1 AVX2::Mask to N AVX2::Mask {{{2
 // float_v and (u)int_v have size 8, double_v has size 4, and (u)short_v have size 16. Consequently,
@@ -27,6 +27,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 }}}*/
 
 #include "../common/x86_prefetches.h"
+#include "../common/maskedload.h"
 #include "../common/gatherimplementation.h"
 #include "../common/scatterimplementation.h"
 #include "limits.h"
@@ -80,6 +81,45 @@ Vc_INTRINSIC void Vector<DstT, VectorAbi::Avx>::load(const SrcT *mem, Flags flag
     d.v() = Detail::load<VectorType, DstT>(mem, flags);
 }
 
+// masked load {{{2
+namespace Detail
+{
+// vmaskmov suppresses faults for inactive entries
+Vc_INTRINSIC __m256 maskload(const float *mem, __m256i k) { return _mm256_maskload_ps(mem, k); }
+Vc_INTRINSIC __m256d maskload(const double *mem, __m256i k) { return _mm256_maskload_pd(mem, k); }
+Vc_INTRINSIC __m256i maskload(const int *mem, __m256i k)
+{
+    return AVX::avx_cast<__m256i>(_mm256_maskload_ps(reinterpret_cast<const float *>(mem), k));
+}
+Vc_INTRINSIC __m256i maskload(const uint *mem, __m256i k)
+{
+    return AVX::avx_cast<__m256i>(_mm256_maskload_ps(reinterpret_cast<const float *>(mem), k));
+}
+
+template <typename T, typename Flags>
+Vc_INTRINSIC enable_if<(sizeof(T) >= 4), void> maskedLoad(AVX2::Vector<T> &v, const T *mem,
+                                                         const AVX2::Mask<T> &k, Flags)
+{
+    v.assign(AVX2::Vector<T>(maskload(mem, AVX::avx_cast<__m256i>(k.data()))), k);
+}
+// there is no masked load for 16-bit entries
+template <typename T, typename Flags>
+Vc_INTRINSIC enable_if<(sizeof(T) < 4), void> maskedLoad(AVX2::Vector<T> &v, const T *mem,
+                                                        const AVX2::Mask<T> &k, Flags f)
+{
+    Common::maskedLoad(v, mem, k, f);
+}
+}  // namespace Detail
+
+template <typename T>
+template <typename Flags, typename>
+Vc_INTRINSIC void Vector<T, VectorAbi::Avx>::load(const EntryType *mem, MaskArgument mask,
+                                                  Flags flags)
+{
+    Common::handleLoadPrefetches(mem, flags);
+    Detail::maskedLoad(*this, mem, mask, flags);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 // zeroing {{{1
 template<typename T> Vc_INTRINSIC void Vector<T, VectorAbi::Avx>::setZero()
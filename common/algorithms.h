@@ -78,6 +78,93 @@ template<typename Mask> constexpr bool some_of(const Mask &m) { return m.isMix()
 constexpr bool some_of(bool) { return false; }
 //@}
 
+namespace Detail
+{
+/**\internal
+ * Returns a mask where the first \p n entries are \c true.
+ */
+template <typename V> Vc_INTRINSIC typename V::Mask leading_mask(std::size_t n)
+{
+    return V::IndexesFromZero() < V(typename V::EntryType(n));
+}
+
+/**\internal
+ * Whether \p F can be called with a \p V and its mask, in which case the entries after the last
+ * full vector are passed to \p F as one \p V together with the mask of the valid entries.
+ */
+template <typename F, typename V,
+          typename = decltype(std::declval<F &>()(std::declval<V &>(),
+                                                  std::declval<const typename V::Mask &>()))>
+std::true_type accepts_mask_test(int);
+template <typename F, typename V> std::false_type accepts_mask_test(...);
+template <typename F, typename V>
+using functor_accepts_mask = decltype(accepts_mask_test<F, V>(1));
+
+// simd_for_each epilogues {{{1
+template <typename V, typename InputIt, typename UnaryFunction>
+Vc_INTRINSIC void simd_for_each_tail(InputIt first, InputIt last, UnaryFunction &f,
+                                     std::true_type /*immutable*/,
+                                     std::true_type /*accepts mask*/)
+{
+    if (first != last) {
+        const auto k = leading_mask<V>(last - first);
+        V tmp = V::Zero();
+        tmp.load(std::addressof(*first), k, Vc::Aligned);
+        f(tmp, k);
+    }
+}
+template <typename V, typename InputIt, typename UnaryFunction>
+Vc_INTRINSIC void simd_for_each_tail(InputIt first, InputIt last, UnaryFunction &f,
+                                     std::true_type /*immutable*/,
+                                     std::false_type /*accepts mask*/)
+{
+    typedef Scalar::Vector<typename V::EntryType> V1;
+    for (; first != last; ++first) {
+        f(V1(std::addressof(*first), Vc::Aligned));
+    }
+}
+template <typename V, typename InputIt, typename UnaryFunction>
+Vc_INTRINSIC void simd_for_each_tail(InputIt first, InputIt last, UnaryFunction &f,
+                                     std::false_type /*immutable*/,
+                                     std::true_type /*accepts mask*/)
+{
+    if (first != last) {
+        const auto k = leading_mask<V>(last - first);
+        V tmp = V::Zero();
+        tmp.load(std::addressof(*first), k, Vc::Aligned);
+        f(tmp, k);
+        tmp.store(std::addressof(*first), k, Vc::Aligned);
+    }
+}
+template <typename V, typename InputIt, typename UnaryFunction>
+Vc_INTRINSIC void simd_for_each_tail(InputIt first, InputIt last, UnaryFunction &f,
+                                     std::false_type /*immutable*/,
+                                     std::false_type /*accepts mask*/)
+{
+    typedef Scalar::Vector<typename V::EntryType> V1;
+    for (; first != last; ++first) {
+        V1 tmp(std::addressof(*first), Vc::Aligned);
+        f(tmp);
+        tmp.store(std::addressof(*first), Vc::Aligned);
+    }
+}
+//}}}1
+}  // namespace Detail
+
+/**
+ * \ingroup Utilities
+ *
+ * Calls \p f with Vc::Vector<T> objects covering the range [\p first, \p last). The entries
+ * before the first aligned address and after the last full vector are passed as
+ * Vc::Scalar::Vector<T> objects. If \p f takes its argument by non-const reference, the
+ * modified vectors are stored back.
+ *
+ * If \p f can also be called as \c f(Vector<T>, Vector<T>::Mask), the entries after the last
+ * full vector are instead passed as one Vc::Vector<T>, loaded with a masked load, together
+ * with the mask of the entries that lie in the range. The entries outside the mask are zero
+ * and are not stored back. \p f has to take the mask into account where zeros would change
+ * the result (e.g. for products or minima).
+ */
 template <typename InputIt, typename UnaryFunction>
 inline enable_if<std::is_arithmetic<typename InputIt::value_type>::value &&
                      Traits::is_functor_argument_immutable<
@@ -93,13 +180,11 @@ simd_for_each(InputIt first, InputIt last, UnaryFunction f)
          ++first) {
         f(V1(std::addressof(*first), Vc::Aligned));
     }
-    const auto lastV = last - (V::Size + 1);
-    for (; first < lastV; first += V::Size) {
+    for (; std::size_t(last - first) >= V::Size; first += V::Size) {
         f(V(std::addressof(*first), Vc::Aligned));
     }
-    for (; first != last; ++first) {
-        f(V1(std::addressof(*first), Vc::Aligned));
-    }
+    Detail::simd_for_each_tail<V>(first, last, f, std::true_type(),
+                                  Detail::functor_accepts_mask<UnaryFunction, V>());
     return std::move(f);
 }
 
@@ -120,17 +205,13 @@ simd_for_each(InputIt first, InputIt last, UnaryFunction f)
         f(tmp);
         tmp.store(std::addressof(*first), Vc::Aligned);
     }
-    const auto lastV = last - (V::Size + 1);
-    for (; first < lastV; first += V::Size) {
+    for (; std::size_t(last - first) >= V::Size; first += V::Size) {
         V tmp(std::addressof(*first), Vc::Aligned);
         f(tmp);
         tmp.store(std::addressof(*first), Vc::Aligned);
     }
-    for (; first != last; ++first) {
-        V1 tmp(std::addressof(*first), Vc::Aligned);
-        f(tmp);
-        tmp.store(std::addressof(*first), Vc::Aligned);
-    }
+    Detail::simd_for_each_tail<V>(first, last, f, std::false_type(),
+                                  Detail::functor_accepts_mask<UnaryFunction, V>());
     return std::move(f);
 }
 
@@ -0,0 +1,485 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_BYTESCAN_H_
+#define VC_COMMON_BYTESCAN_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "bitscanintrinsics.h"
+#include "maskbits.h"
+#include "macros.h"
+#if defined Vc_IMPL_AVX2
+#include <immintrin.h>
+#elif defined Vc_IMPL_SSSE3
+#include <tmmintrin.h>
+#elif defined Vc_IMPL_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+/**
+ * \ingroup Utilities
+ * \headerfile bytescan.h <Vc/ByteScan>
+ *
+ * A set of byte values for find_first_of, count_bytes, and split_offsets.
+ *
+ * The set is stored as a 256-bit membership bitmap, split into two 16-entry tables
+ * indexed by the low nibble of a byte. This allows a membership test of a whole block of
+ * bytes with two byte shuffles, independent of the number of bytes in the set.
+ */
+class byte_set
+{
+public:
+    /// Constructs an empty set.
+    byte_set() : m_tables(), m_count(0) {}
+    /// Constructs the set of the characters in the NUL-terminated string \p chars.
+    explicit byte_set(const char *chars) : byte_set()
+    {
+        for (; *chars != '\0'; ++chars) {
+            insert(*chars);
+        }
+    }
+    /// Constructs the set of the \p n characters at \p chars.
+    byte_set(const char *chars, std::size_t n) : byte_set()
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            insert(chars[i]);
+        }
+    }
+
+    /// Adds \p c to the set.
+    void insert(char c)
+    {
+        const unsigned char b = static_cast<unsigned char>(c);
+        if (!contains(c)) {
+            m_tables[b >> 7][b & 0x0f] |= static_cast<unsigned char>(1u << ((b >> 4) & 7));
+            m_chars[m_count++] = b;
+        }
+    }
+    /// Returns whether \p c is an element of the set.
+    bool contains(char c) const
+    {
+        const unsigned char b = static_cast<unsigned char>(c);
+        return (m_tables[b >> 7][b & 0x0f] >> ((b >> 4) & 7)) & 1;
+    }
+    /// Returns the number of elements in the set.
+    std::size_t size() const { return m_count; }
+
+    ///\internal The bit `1 << (b >> 4 & 7)` in `tables()[b >> 7][b & 15]` is set for every b.
+    const unsigned char (&tables() const)[2][16] { return m_tables; }
+    ///\internal The elements of the set, in insertion order.
+    const unsigned char *chars() const { return m_chars; }
+
+private:
+    alignas(16) unsigned char m_tables[2][16];
+    unsigned char m_chars[256];
+    std::size_t m_count;
+};
+
+namespace Detail
+{
+// ByteBlock {{{1
+/**\internal
+ * A block of Size consecutive bytes loaded from a Size-aligned address. The comparison
+ * functions return a bitmask with bit \c i set if byte \c i satisfies the predicate.
+ *
+ * Since the load is aligned it never crosses a page boundary, and thus never faults if
+ * any of the bytes in the block is accessible. This is what allows the scan functions to
+ * load the complete blocks at the start and end of a range.
+ */
+#if defined Vc_IMPL_AVX2
+struct ByteBlock
+{
+    static constexpr std::size_t Size = 32;
+    __m256i d;
+
+    static Vc_INTRINSIC ByteBlock load(const unsigned char *mem, unsigned int)
+    {
+        return {_mm256_load_si256(reinterpret_cast<const __m256i *>(mem))};
+    }
+    Vc_INTRINSIC unsigned int equal(unsigned char c) const
+    {
+        return _mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(d, _mm256_set1_epi8(static_cast<char>(c))));
+    }
+    Vc_INTRINSIC unsigned int highBitSet() const { return _mm256_movemask_epi8(d); }
+    Vc_INTRINSIC unsigned int in(const byte_set &set) const
+    {
+        const __m256i nibble = _mm256_set1_epi8(0x0f);
+        const __m256i lo = _mm256_and_si256(d, nibble);
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(d, 4), nibble);
+        const __m256i t0 = _mm256_shuffle_epi8(
+            _mm256_broadcastsi128_si256(
+                _mm_load_si128(reinterpret_cast<const __m128i *>(set.tables()[0]))),
+            lo);
+        const __m256i t1 = _mm256_shuffle_epi8(
+            _mm256_broadcastsi128_si256(
+                _mm_load_si128(reinterpret_cast<const __m128i *>(set.tables()[1]))),
+            lo);
+        const __m256i t = _mm256_blendv_epi8(t0, t1, d);
+        const __m256i bit = _mm256_shuffle_epi8(
+            _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128, 1,
+                             2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128),
+            hi);
+        return _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(t, bit), bit));
+    }
+};
+#elif defined Vc_IMPL_SSE2
+struct ByteBlock
+{
+    static constexpr std::size_t Size = 16;
+    __m128i d;
+
+    static Vc_INTRINSIC ByteBlock load(const unsigned char *mem, unsigned int)
+    {
+        return {_mm_load_si128(reinterpret_cast<const __m128i *>(mem))};
+    }
+    Vc_INTRINSIC unsigned int equal(unsigned char c) const
+    {
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(d, _mm_set1_epi8(static_cast<char>(c))));
+    }
+    Vc_INTRINSIC unsigned int highBitSet() const { return _mm_movemask_epi8(d); }
+#ifdef Vc_IMPL_SSSE3
+    Vc_INTRINSIC unsigned int in(const byte_set &set) const
+    {
+        const __m128i nibble = _mm_set1_epi8(0x0f);
+        const __m128i lo = _mm_and_si128(d, nibble);
+        const __m128i hi = _mm_and_si128(_mm_srli_epi16(d, 4), nibble);
+        const __m128i t0 = _mm_shuffle_epi8(
+            _mm_load_si128(reinterpret_cast<const __m128i *>(set.tables()[0])), lo);
+        const __m128i t1 = _mm_shuffle_epi8(
+            _mm_load_si128(reinterpret_cast<const __m128i *>(set.tables()[1])), lo);
+        const __m128i upper = _mm_cmplt_epi8(d, _mm_setzero_si128());
+        const __m128i t = _mm_or_si128(_mm_and_si128(upper, t1), _mm_andnot_si128(upper, t0));
+        const __m128i bit = _mm_shuffle_epi8(
+            _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128), hi);
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(t, bit), bit));
+    }
+#else
+    // without pshufb every element of the set costs one compare
+    Vc_INTRINSIC unsigned int in(const byte_set &set) const
+    {
+        __m128i r = _mm_setzero_si128();
+        for (std::size_t i = 0; i < set.size(); ++i) {
+            r = _mm_or_si128(
+                r, _mm_cmpeq_epi8(d, _mm_set1_epi8(static_cast<char>(set.chars()[i]))));
+        }
+        return _mm_movemask_epi8(r);
+    }
+#endif
+};
+#else
+struct ByteBlock
+{
+    static constexpr std::size_t Size = 8;
+    unsigned char d[Size];
+
+    // only the bytes selected by valid are read; the others are zero
+    static Vc_INTRINSIC ByteBlock load(const unsigned char *mem, unsigned int valid)
+    {
+        ByteBlock r;
+        for (std::size_t i = 0; i < Size; ++i) {
+            r.d[i] = (valid >> i) & 1 ? mem[i] : 0;
+        }
+        return r;
+    }
+    Vc_INTRINSIC unsigned int equal(unsigned char c) const
+    {
+        unsigned int r = 0;
+        for (std::size_t i = 0; i < Size; ++i) {
+            r |= static_cast<unsigned int>(d[i] == c) << i;
+        }
+        return r;
+    }
+    Vc_INTRINSIC unsigned int highBitSet() const
+    {
+        unsigned int r = 0;
+        for (std::size_t i = 0; i < Size; ++i) {
+            r |= static_cast<unsigned int>(d[i] >> 7) << i;
+        }
+        return r;
+    }
+    Vc_INTRINSIC unsigned int in(const byte_set &set) const
+    {
+        unsigned int r = 0;
+        for (std::size_t i = 0; i < Size; ++i) {
+            r |= static_cast<unsigned int>(set.contains(static_cast<char>(d[i]))) << i;
+        }
+        return r;
+    }
+};
+#endif
+
+// scan_blocks {{{1
+/**\internal
+ * Calls `f(block, valid, base)` for the aligned blocks covering `[first, last)`, where
+ * \c valid masks the bytes of the block that are inside the range. The scan stops early
+ * if \p f returns \c false.
+ */
+template <typename F>
+Vc_INTRINSIC void scan_blocks(const char *first_, const char *last_, F &&f)
+{
+    constexpr unsigned int AllBits =
+        ByteBlock::Size == 32 ? ~0u : (1u << ByteBlock::Size) - 1u;
+    const unsigned char *first = reinterpret_cast<const unsigned char *>(first_);
+    const unsigned char *last = reinterpret_cast<const unsigned char *>(last_);
+    if (first >= last) {
+        return;
+    }
+    const std::size_t misalignment =
+        reinterpret_cast<std::uintptr_t>(first) & (ByteBlock::Size - 1);
+    const unsigned char *base = first - misalignment;
+    unsigned int valid = AllBits << misalignment;
+    for (;;) {
+        if (std::size_t(last - base) <= ByteBlock::Size) {
+            valid &= AllBits >> (ByteBlock::Size - std::size_t(last - base));
+            f(ByteBlock::load(base, valid), valid, base);
+            return;
+        }
+        if (!f(ByteBlock::load(base, valid), valid, base)) {
+            return;
+        }
+        base += ByteBlock::Size;
+        valid = AllBits;
+    }
+}
+
+// find_bits {{{1
+/**\internal
+ * Returns a pointer to the first byte in `[first, last)` for which \p bits returns a set
+ * bit, or \p last.
+ */
+template <typename F>
+Vc_INTRINSIC const char *find_bits(const char *first, const char *last, F &&bits)
+{
+    const char *found = last;
+    scan_blocks(first, last, [&](const ByteBlock &block, unsigned int valid,
+                                 const unsigned char *base) {
+        const unsigned int k = bits(block) & valid;
+        if (k != 0) {
+            found = reinterpret_cast<const char *>(base) + _bit_scan_forward(k);
+            return false;
+        }
+        return true;
+    });
+    return found;
+}
+
+// utf8_sequence_end {{{1
+/**\internal
+ * Returns the end of the UTF-8 sequence starting at \p p, or \c nullptr if the sequence
+ * is invalid, i.e. truncated, overlong, a surrogate, or above U+10FFFF.
+ */
+inline const unsigned char *utf8_sequence_end(const unsigned char *p,
+                                              const unsigned char *last)
+{
+    const unsigned char c = p[0];
+    if (c < 0x80) {
+        return p + 1;
+    }
+    const std::ptrdiff_t n = c < 0xc2 ? 0 : c < 0xe0 ? 2 : c < 0xf0 ? 3 : c < 0xf5 ? 4 : 0;
+    if (n == 0 || last - p < n) {
+        return nullptr;
+    }
+    const unsigned char lower = c == 0xe0 ? 0xa0 : c == 0xf0 ? 0x90 : 0x80;
+    const unsigned char upper = c == 0xed ? 0x9f : c == 0xf4 ? 0x8f : 0xbf;
+    if (p[1] < lower || p[1] > upper) {
+        return nullptr;
+    }
+    for (std::ptrdiff_t i = 2; i < n; ++i) {
+        if ((p[i] & 0xc0) != 0x80) {
+            return nullptr;
+        }
+    }
+    return p + n;
+}
+//}}}1
+}  // namespace Detail
+
+/**
+ * \ingroup Utilities
+ * \headerfile bytescan.h <Vc/ByteScan>
+ *
+ * Returns a pointer to the first occurrence of \p c in `[first, last)`, or \p last if
+ * there is none. This is the equivalent of \c memchr.
+ *
+ * All byte scanning functions compare one SIMD register of bytes per step and use the
+ * \c pmovmskb bitmask of the comparison. The loads are aligned, and thus the first and
+ * last block may read bytes outside of the range, but never outside of the pages that
+ * hold the range.
+ */
+inline const char *find_byte(const char *first, const char *last, char c)
+{
+    return Detail::find_bits(first, last, [&](const Detail::ByteBlock &block) {
+        return block.equal(static_cast<unsigned char>(c));
+    });
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile bytescan.h <Vc/ByteScan>
+ *
+ * Returns a pointer to the first byte in `[first, last)` that is an element of \p set, or
+ * \p last if there is none. This is the equivalent of \c strpbrk for a range.
+ */
+inline const char *find_first_of(const char *first, const char *last, const byte_set &set)
+{
+    return Detail::find_bits(first, last,
+                             [&](const Detail::ByteBlock &block) { return block.in(set); });
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile bytescan.h <Vc/ByteScan>
+ *
+ * Returns the number of occurrences of \p c in `[first, last)`, e.g. the number of lines
+ * of a text buffer.
+ */
+inline std::size_t count_bytes(const char *first, const char *last, char c)
+{
+    std::size_t n = 0;
+    Detail::scan_blocks(first, last, [&](const Detail::ByteBlock &block, unsigned int valid,
+                                         const unsigned char *) {
+        n += Detail::popcount32(block.equal(static_cast<unsigned char>(c)) & valid);
+        return true;
+    });
+    return n;
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile bytescan.h <Vc/ByteScan>
+ *
+ * Returns the number of bytes in `[first, last)` that are elements of \p set.
+ */
+inline std::size_t count_bytes(const char *first, const char *last, const byte_set &set)
+{
+    std::size_t n = 0;
+    Detail::scan_blocks(first, last, [&](const Detail::ByteBlock &block, unsigned int valid,
+                                         const unsigned char *) {
+        n += Detail::popcount32(block.in(set) & valid);
+        return true;
+    });
+    return n;
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile bytescan.h <Vc/ByteScan>
+ *
+ * Writes the offsets (relative to \p first) of all bytes in `[first, last)` that are
+ * elements of \p delimiters to \p out, in ascending order. The fields of a record are the
+ * ranges between consecutive offsets:
+ * \code
+ * std::vector<std::size_t> offsets;
+ * Vc::split_offsets(line, line + length, Vc::byte_set(",\n"), std::back_inserter(offsets));
+ * \endcode
+ *
+ * \returns The output iterator past the last written offset.
+ */
+template <typename OutputIterator>
+inline OutputIterator split_offsets(const char *first, const char *last,
+                                    const byte_set &delimiters, OutputIterator out)
+{
+    const unsigned char *const begin = reinterpret_cast<const unsigned char *>(first);
+    Detail::scan_blocks(first, last, [&](const Detail::ByteBlock &block, unsigned int valid,
+                                         const unsigned char *base) {
+        const std::size_t offset = base - begin;
+        for (unsigned int k = block.in(delimiters) & valid; k != 0; k &= k - 1) {
+            *out = offset + _bit_scan_forward(k);
+            ++out;
+        }
+        return true;
+    });
+    return out;
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile bytescan.h <Vc/ByteScan>
+ *
+ * Returns whether all bytes in `[first, last)` are 7-bit ASCII.
+ */
+inline bool is_ascii(const char *first, const char *last)
+{
+    return Detail::find_bits(first, last, [](const Detail::ByteBlock &block) {
+               return block.highBitSet();
+           }) == last;
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile bytescan.h <Vc/ByteScan>
+ *
+ * Returns a pointer to the first byte of the first invalid UTF-8 sequence in
+ * `[first, last)`, or \p last if the range is valid UTF-8.
+ *
+ * ASCII runs are skipped one SIMD block at a time. Multi-byte sequences are validated one
+ * at a time, which makes the function fastest for text that is mostly ASCII.
+ */
+inline const char *find_invalid_utf8(const char *first, const char *last)
+{
+    const unsigned char *const end = reinterpret_cast<const unsigned char *>(last);
+    const char *p = first;
+    for (;;) {
+        p = Detail::find_bits(p, last, [](const Detail::ByteBlock &block) {
+            return block.highBitSet();
+        });
+        const unsigned char *q = reinterpret_cast<const unsigned char *>(p);
+        while (q != end && *q >= 0x80) {
+            const unsigned char *next = Detail::utf8_sequence_end(q, end);
+            if (next == nullptr) {
+                return reinterpret_cast<const char *>(q);
+            }
+            q = next;
+        }
+        if (q == end) {
+            return last;
+        }
+        p = reinterpret_cast<const char *>(q);
+    }
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile bytescan.h <Vc/ByteScan>
+ *
+ * Returns whether `[first, last)` is valid UTF-8.
+ */
+inline bool is_valid_utf8(const char *first, const char *last)
+{
+    return find_invalid_utf8(first, last) == last;
+}
+}  // namespace Vc
+
+#endif  // VC_COMMON_BYTESCAN_H_
+
+// vim: foldmethod=marker
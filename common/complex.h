@@ -0,0 +1,659 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_COMPLEX_H_
+#define VC_COMMON_COMPLEX_H_
+
+#include <complex>
+#include "deinterleave.h"
+#include "interleave.h"
+#include "fastfma.h"
+#include "macros.h"
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+namespace Detail
+{
+// complexLoad {{{1
+// native vectors have optimized deinterleave implementations
+template <typename V, typename Flags>
+Vc_INTRINSIC void complexLoad(V &re, V &im, const typename V::EntryType *mem, Flags f,
+                              std::false_type)
+{
+    deinterleave(re, im, mem, f);
+}
+// SimdArray: gather with stride 2
+template <typename V, typename Flags>
+Vc_INTRINSIC void complexLoad(V &re, V &im, const typename V::EntryType *mem, Flags,
+                              std::true_type)
+{
+    const SimdArray<int, V::Size> even = SimdArray<int, V::Size>::IndexesFromZero() * 2;
+    re.gather(mem, even);
+    im.gather(mem + 1, even);
+}
+
+// complex_interleaved shuffles {{{1
+// Each function maps the (re, im) pair in entries 2i and 2i + 1 to a new pair. The
+// generic versions shift the whole vector; the native ones permute within 128-bit lanes.
+// (-1, 1) in every pair; a constant, in contrast to a masked negation
+template <typename V> Vc_INTRINSIC V alternatingSigns()
+{
+    return V::generate([](std::size_t i) { return typename V::EntryType(i % 2 ? 1 : -1); });
+}
+template <typename V> Vc_INTRINSIC typename V::mask_type evenEntries()
+{
+    return alternatingSigns<V>() < V::Zero();
+}
+// (re, im) -> (im, re)
+template <typename V> Vc_INTRINSIC V swapPairs(const V &x)
+{
+    return iif(evenEntries<V>(), x.shifted(1), x.shifted(-1));
+}
+// (re, im) -> (re, re)
+template <typename V> Vc_INTRINSIC V duplicateReal(const V &x)
+{
+    return iif(evenEntries<V>(), x, x.shifted(-1));
+}
+// (re, im) -> (im, im)
+template <typename V> Vc_INTRINSIC V duplicateImag(const V &x)
+{
+    return iif(evenEntries<V>(), x.shifted(1), x);
+}
+
+#ifdef Vc_IMPL_SSE
+Vc_INTRINSIC SSE::float_v swapPairs(const SSE::float_v &x)
+{
+    return Mem::permute<X1, X0, X3, X2>(x.data());
+}
+Vc_INTRINSIC SSE::float_v duplicateReal(const SSE::float_v &x)
+{
+    return Mem::permute<X0, X0, X2, X2>(x.data());
+}
+Vc_INTRINSIC SSE::float_v duplicateImag(const SSE::float_v &x)
+{
+    return Mem::permute<X1, X1, X3, X3>(x.data());
+}
+Vc_INTRINSIC SSE::double_v swapPairs(const SSE::double_v &x)
+{
+    return _mm_shuffle_pd(x.data(), x.data(), 1);
+}
+Vc_INTRINSIC SSE::double_v duplicateReal(const SSE::double_v &x)
+{
+    return _mm_unpacklo_pd(x.data(), x.data());
+}
+Vc_INTRINSIC SSE::double_v duplicateImag(const SSE::double_v &x)
+{
+    return _mm_unpackhi_pd(x.data(), x.data());
+}
+#endif  // Vc_IMPL_SSE
+#ifdef Vc_IMPL_AVX
+Vc_INTRINSIC AVX::float_v swapPairs(const AVX::float_v &x)
+{
+    return Mem::permute<X1, X0, X3, X2>(x.data());
+}
+Vc_INTRINSIC AVX::float_v duplicateReal(const AVX::float_v &x)
+{
+    return Mem::permute<X0, X0, X2, X2>(x.data());
+}
+Vc_INTRINSIC AVX::float_v duplicateImag(const AVX::float_v &x)
+{
+    return Mem::permute<X1, X1, X3, X3>(x.data());
+}
+Vc_INTRINSIC AVX::double_v swapPairs(const AVX::double_v &x)
+{
+    return Mem::permute<X1, X0, X3, X2>(x.data());
+}
+Vc_INTRINSIC AVX::double_v duplicateReal(const AVX::double_v &x)
+{
+    return Mem::permute<X0, X0, X2, X2>(x.data());
+}
+Vc_INTRINSIC AVX::double_v duplicateImag(const AVX::double_v &x)
+{
+    return Mem::permute<X1, X1, X3, X3>(x.data());
+}
+#endif  // Vc_IMPL_AVX
+//}}}1
+}  // namespace Detail
+
+/**
+ * \ingroup Utilities
+ * \headerfile complex.h <Vc/Complex>
+ *
+ * A complex number for every entry of the real vector type \p V (`float_v`, `double_v`, or
+ * a SimdArray of `float` or `double`).
+ *
+ * The real and imaginary parts are stored in two separate vectors ("split" storage). This
+ * makes all arithmetic vertical: a multiplication is four multiplications (or two
+ * multiplications and two FMAs) without any shuffles. Memory with interleaved storage
+ * (`std::complex<T>` arrays) is converted on load and store, memory with split storage
+ * (separate arrays for the real and imaginary parts) is loaded and stored directly. See
+ * complex_interleaved for a type that keeps the interleaved layout in registers.
+ *
+ * In contrast to `std::complex<float_v>`, the operators and functions are implemented for
+ * speed, in the spirit of `-ffast-math`:
+ * - multiplication and division do not check for NaN and infinity (C99 Annex G),
+ * - \ref abs and division do not scale their inputs, thus they overflow (underflow) for
+ *   norms larger (smaller) than the range of \p V::EntryType,
+ * - \ref norm is `re * re + im * im` and does not compute \ref abs first.
+ *
+ * \tparam V A vector type of `float` or `double` entries.
+ */
+template <typename V> class complex
+{
+    static_assert(std::is_floating_point<typename V::EntryType>::value,
+                  "Vc::complex requires a vector type of float or double entries");
+
+public:
+    typedef V value_type;
+    typedef typename V::EntryType EntryType;
+    typedef typename V::mask_type mask_type;
+    static constexpr std::size_t Size = V::Size;
+    static constexpr std::size_t size() { return Size; }
+
+    // init {{{1
+    /// Zero-initializes all entries.
+    Vc_INTRINSIC complex() : m_real(V::Zero()), m_imag(V::Zero()) {}
+    /// Initializes the real parts with \p re and the imaginary parts with \p im.
+    Vc_INTRINSIC complex(const V &re, const V &im = V::Zero()) : m_real(re), m_imag(im) {}
+    /// Broadcasts \p z to all entries.
+    Vc_INTRINSIC complex(const std::complex<EntryType> &z) : m_real(z.real()), m_imag(z.imag())
+    {
+    }
+
+    /// Loads \p Size values from an array of `std::complex<EntryType>` (interleaved storage).
+    template <typename Flags = DefaultLoadTag,
+              typename = enable_if<Traits::is_load_store_flag<Flags>::value>>
+    explicit Vc_INTRINSIC complex(const std::complex<EntryType> *mem, Flags f = Flags())
+    {
+        load(mem, f);
+    }
+    /// Loads \p Size real parts from \p re and \p Size imaginary parts from \p im (split
+    /// storage).
+    template <typename Flags = DefaultLoadTag,
+              typename = enable_if<Traits::is_load_store_flag<Flags>::value>>
+    Vc_INTRINSIC complex(const EntryType *re, const EntryType *im, Flags f = Flags())
+        : m_real(re, f), m_imag(im, f)
+    {
+    }
+
+    // load/store {{{1
+    template <typename Flags = DefaultLoadTag,
+              typename = enable_if<Traits::is_load_store_flag<Flags>::value>>
+    Vc_INTRINSIC void load(const std::complex<EntryType> *mem, Flags f = Flags())
+    {
+        Detail::complexLoad(m_real, m_imag, reinterpret_cast<const EntryType *>(mem), f,
+                            Traits::isSimdArray<V>());
+    }
+    template <typename Flags = DefaultLoadTag,
+              typename = enable_if<Traits::is_load_store_flag<Flags>::value>>
+    Vc_INTRINSIC void load(const EntryType *re, const EntryType *im, Flags f = Flags())
+    {
+        m_real.load(re, f);
+        m_imag.load(im, f);
+    }
+
+    /// Stores the \p Size values to an array of `std::complex<EntryType>`.
+    template <typename Flags = DefaultStoreTag,
+              typename = enable_if<Traits::is_load_store_flag<Flags>::value>>
+    Vc_INTRINSIC void store(std::complex<EntryType> *mem, Flags f = Flags()) const
+    {
+        const std::pair<V, V> tmp = Vc::interleave(m_real, m_imag);
+        EntryType *out = reinterpret_cast<EntryType *>(mem);
+        tmp.first.store(out, f);
+        tmp.second.store(out + Size, f);
+    }
+    template <typename Flags = DefaultStoreTag,
+              typename = enable_if<Traits::is_load_store_flag<Flags>::value>>
+    Vc_INTRINSIC void store(EntryType *re, EntryType *im, Flags f = Flags()) const
+    {
+        m_real.store(re, f);
+        m_imag.store(im, f);
+    }
+
+    // access {{{1
+    Vc_INTRINSIC const V &real() const { return m_real; }
+    Vc_INTRINSIC const V &imag() const { return m_imag; }
+    Vc_INTRINSIC void real(const V &re) { m_real = re; }
+    Vc_INTRINSIC void imag(const V &im) { m_imag = im; }
+
+    /// Returns the complex number in entry \p i.
+    Vc_INTRINSIC std::complex<EntryType> operator[](std::size_t i) const
+    {
+        return {m_real[i], m_imag[i]};
+    }
+
+    // compound assignment {{{1
+    Vc_INTRINSIC complex &operator+=(const complex &z)
+    {
+        m_real += z.m_real;
+        m_imag += z.m_imag;
+        return *this;
+    }
+    Vc_INTRINSIC complex &operator-=(const complex &z)
+    {
+        m_real -= z.m_real;
+        m_imag -= z.m_imag;
+        return *this;
+    }
+    Vc_INTRINSIC complex &operator*=(const complex &z) { return *this = *this * z; }
+    Vc_INTRINSIC complex &operator/=(const complex &z) { return *this = *this / z; }
+
+    Vc_INTRINSIC complex &operator+=(const V &x)
+    {
+        m_real += x;
+        return *this;
+    }
+    Vc_INTRINSIC complex &operator-=(const V &x)
+    {
+        m_real -= x;
+        return *this;
+    }
+    Vc_INTRINSIC complex &operator*=(const V &x)
+    {
+        m_real *= x;
+        m_imag *= x;
+        return *this;
+    }
+    Vc_INTRINSIC complex &operator/=(const V &x) { return *this *= V::One() / x; }
+
+    // operators {{{1
+    Vc_INTRINSIC complex operator-() const { return {-m_real, -m_imag}; }
+    Vc_INTRINSIC complex operator+() const { return *this; }
+
+    friend Vc_INTRINSIC complex operator+(complex a, const complex &b) { return a += b; }
+    friend Vc_INTRINSIC complex operator-(complex a, const complex &b) { return a -= b; }
+    friend Vc_INTRINSIC complex operator*(const complex &a, const complex &b)
+    {
+        return {Detail::fastFma(a.m_real, b.m_real, -(a.m_imag * b.m_imag)),
+                Detail::fastFma(a.m_real, b.m_imag, a.m_imag * b.m_real)};
+    }
+    /// Computes `a * conj(b) / norm(b)`, without scaling (see the class documentation).
+    friend Vc_INTRINSIC complex operator/(const complex &a, const complex &b)
+    {
+        const V inv = V::One() / b.norm();
+        return {Detail::fastFma(a.m_real, b.m_real, a.m_imag * b.m_imag) * inv,
+                Detail::fastFma(a.m_imag, b.m_real, -(a.m_real * b.m_imag)) * inv};
+    }
+
+    friend Vc_INTRINSIC complex operator+(complex a, const V &x) { return a += x; }
+    friend Vc_INTRINSIC complex operator-(complex a, const V &x) { return a -= x; }
+    friend Vc_INTRINSIC complex operator*(complex a, const V &x) { return a *= x; }
+    friend Vc_INTRINSIC complex operator/(complex a, const V &x) { return a /= x; }
+    friend Vc_INTRINSIC complex operator+(const V &x, complex a) { return a += x; }
+    friend Vc_INTRINSIC complex operator-(const V &x, const complex &a)
+    {
+        return {x - a.m_real, -a.m_imag};
+    }
+    friend Vc_INTRINSIC complex operator*(const V &x, complex a) { return a *= x; }
+    friend Vc_INTRINSIC complex operator/(const V &x, const complex &a)
+    {
+        return complex(x) / a;
+    }
+
+    friend Vc_INTRINSIC mask_type operator==(const complex &a, const complex &b)
+    {
+        return a.m_real == b.m_real && a.m_imag == b.m_imag;
+    }
+    friend Vc_INTRINSIC mask_type operator!=(const complex &a, const complex &b)
+    {
+        return a.m_real != b.m_real || a.m_imag != b.m_imag;
+    }
+
+    // functions {{{1
+    /// Returns `re * re + im * im`.
+    Vc_INTRINSIC V norm() const { return Detail::fastFma(m_real, m_real, m_imag * m_imag); }
+    /// Returns `z * z` with two multiplications instead of the four of `z * z`.
+    Vc_INTRINSIC complex squared() const
+    {
+        return {(m_real + m_imag) * (m_real - m_imag), (m_real + m_real) * m_imag};
+    }
+    /// Returns `this * b + c` with FMAs.
+    Vc_INTRINSIC complex fma(const complex &b, const complex &c) const
+    {
+        return {Detail::fastFma(m_real, b.m_real, Detail::fastFma(-m_imag, b.m_imag, c.m_real)),
+                Detail::fastFma(m_real, b.m_imag, Detail::fastFma(m_imag, b.m_real, c.m_imag))};
+    }
+
+    /// Returns \p z where \p mask is \c true and `*this` otherwise.
+    Vc_INTRINSIC complex blend(const mask_type &mask, const complex &z) const
+    {
+        complex r = *this;
+        where(mask) | r.m_real = z.m_real;
+        where(mask) | r.m_imag = z.m_imag;
+        return r;
+    }
+    //}}}1
+
+private:
+    V m_real, m_imag;
+};
+
+// free functions {{{1
+/// \relates complex
+template <typename V> Vc_INTRINSIC const V &real(const complex<V> &z) { return z.real(); }
+/// \relates complex
+template <typename V> Vc_INTRINSIC const V &imag(const complex<V> &z) { return z.imag(); }
+/// \relates complex
+/// Returns the squared magnitude `re * re + im * im`.
+template <typename V> Vc_INTRINSIC V norm(const complex<V> &z) { return z.norm(); }
+/// \relates complex
+/// Returns the magnitude `sqrt(norm(z))`, without protection against overflow.
+template <typename V> Vc_INTRINSIC V abs(const complex<V> &z) { return Vc::sqrt(z.norm()); }
+/// \relates complex
+/// Returns the phase angle in the interval [-π, π].
+template <typename V> Vc_INTRINSIC V arg(const complex<V> &z)
+{
+    return Vc::atan2(z.imag(), z.real());
+}
+/// \relates complex
+template <typename V> Vc_INTRINSIC complex<V> conj(const complex<V> &z)
+{
+    return {z.real(), -z.imag()};
+}
+/// \relates complex
+/// Returns the complex number with magnitude \p r and phase angle \p theta.
+template <typename V> Vc_INTRINSIC complex<V> polar(const V &r, const V &theta)
+{
+    V s, c;
+    Vc::sincos(theta, &s, &c);
+    return {r * c, r * s};
+}
+/// \relates complex
+/// Returns `exp(re) * (cos(im) + i sin(im))`, with a single sincos evaluation.
+template <typename V> Vc_INTRINSIC complex<V> exp(const complex<V> &z)
+{
+    return polar(Vc::exp(z.real()), z.imag());
+}
+/// \relates complex
+/// Returns `a * b + c`.
+template <typename V>
+Vc_INTRINSIC complex<V> fma(const complex<V> &a, const complex<V> &b, const complex<V> &c)
+{
+    return a.fma(b, c);
+}
+/// \relates complex
+/// Returns \p a where \p mask is \c true and \p b otherwise.
+template <typename V>
+Vc_INTRINSIC complex<V> iif(const typename V::mask_type &mask, const complex<V> &a,
+                            const complex<V> &b)
+{
+    return b.blend(mask, a);
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile complex.h <Vc/Complex>
+ *
+ * `V::Size / 2` complex numbers in a single vector \p V, with the real and imaginary
+ * parts in alternating entries ("interleaved" storage, the layout of `std::complex<T>`
+ * arrays).
+ *
+ * Loads and stores are plain vector loads and stores, without the deinterleave of
+ * complex<V>. In turn, a multiplication needs shuffles to pair the real part of one
+ * operand with the imaginary part of the other. Use this type for streaming code with
+ * few multiplications per load and store (additions, scaling, a multiply-accumulate per
+ * element) and complex<V> for compute-bound code. The same fast-math semantics as in
+ * complex<V> apply.
+ *
+ * \tparam V A vector type of `float` or `double` entries with an even number of entries.
+ */
+template <typename V> class complex_interleaved
+{
+    static_assert(std::is_floating_point<typename V::EntryType>::value,
+                  "Vc::complex_interleaved requires a vector type of float or double entries");
+    static_assert(V::Size % 2 == 0,
+                  "Vc::complex_interleaved requires a vector type with an even number of "
+                  "entries");
+
+public:
+    typedef V value_type;
+    typedef typename V::EntryType EntryType;
+    /// The split-storage type with the same number of complex numbers.
+    typedef complex<SimdArray<EntryType, V::Size / 2>> split_type;
+    static constexpr std::size_t Size = V::Size / 2;
+    static constexpr std::size_t size() { return Size; }
+
+    // init {{{1
+    /// Zero-initializes all entries.
+    Vc_INTRINSIC complex_interleaved() : m_data(V::Zero()) {}
+    /// Broadcasts \p z to all entries.
+    Vc_INTRINSIC complex_interleaved(const std::complex<EntryType> &z)
+        : m_data(V::generate([&](std::size_t i) { return i % 2 ? z.imag() : z.real(); }))
+    {
+    }
+    /// Loads \p Size values from an array of `std::complex<EntryType>`.
+    template <typename Flags = DefaultLoadTag,
+              typename = enable_if<Traits::is_load_store_flag<Flags>::value>>
+    explicit Vc_INTRINSIC complex_interleaved(const std::complex<EntryType> *mem,
+                                              Flags f = Flags())
+    {
+        load(mem, f);
+    }
+    /// Converts from split storage.
+    explicit Vc_INTRINSIC complex_interleaved(const split_type &z)
+    {
+        std::complex<EntryType> tmp[Size];
+        z.store(tmp, Vc::Unaligned);
+        load(tmp, Vc::Unaligned);
+    }
+
+    // load/store {{{1
+    template <typename Flags = DefaultLoadTag,
+              typename = enable_if<Traits::is_load_store_flag<Flags>::value>>
+    Vc_INTRINSIC void load(const std::complex<EntryType> *mem, Flags f = Flags())
+    {
+        m_data.load(reinterpret_cast<const EntryType *>(mem), f);
+    }
+    template <typename Flags = DefaultStoreTag,
+              typename = enable_if<Traits::is_load_store_flag<Flags>::value>>
+    Vc_INTRINSIC void store(std::complex<EntryType> *mem, Flags f = Flags()) const
+    {
+        m_data.store(reinterpret_cast<EntryType *>(mem), f);
+    }
+
+    // access {{{1
+    /// Returns the vector with the real parts in the even and the imaginary parts in the
+    /// odd entries.
+    Vc_INTRINSIC const V &data() const { return m_data; }
+
+    /// Returns the complex number in entry \p i.
+    Vc_INTRINSIC std::complex<EntryType> operator[](std::size_t i) const
+    {
+        return {m_data[2 * i], m_data[2 * i + 1]};
+    }
+
+    /// Converts to split storage.
+    Vc_INTRINSIC split_type split() const
+    {
+        std::complex<EntryType> tmp[Size];
+        store(tmp, Vc::Unaligned);
+        return split_type(tmp, Vc::Unaligned);
+    }
+
+    // operators {{{1
+    Vc_INTRINSIC complex_interleaved &operator+=(const complex_interleaved &z)
+    {
+        m_data += z.m_data;
+        return *this;
+    }
+    Vc_INTRINSIC complex_interleaved &operator-=(const complex_interleaved &z)
+    {
+        m_data -= z.m_data;
+        return *this;
+    }
+    Vc_INTRINSIC complex_interleaved &operator*=(const complex_interleaved &z)
+    {
+        return *this = *this * z;
+    }
+    Vc_INTRINSIC complex_interleaved &operator*=(EntryType x)
+    {
+        m_data *= x;
+        return *this;
+    }
+
+    Vc_INTRINSIC complex_interleaved operator-() const { return fromData(-m_data); }
+    Vc_INTRINSIC complex_interleaved operator+() const { return *this; }
+
+    friend Vc_INTRINSIC complex_interleaved operator+(complex_interleaved a,
+                                                      const complex_interleaved &b)
+    {
+        return a += b;
+    }
+    friend Vc_INTRINSIC complex_interleaved operator-(complex_interleaved a,
+                                                      const complex_interleaved &b)
+    {
+        return a -= b;
+    }
+    /// `(ar, ai) * (br, bi) = ar * (br, bi) + ai * (-1, 1) * (bi, br)`
+    friend Vc_INTRINSIC complex_interleaved operator*(const complex_interleaved &a,
+                                                      const complex_interleaved &b)
+    {
+        return fromData(
+            Detail::fastFma(a.realParts(), b.m_data,
+                            a.imagParts() * Detail::alternatingSigns<V>() * swapped(b.m_data)));
+    }
+    friend Vc_INTRINSIC complex_interleaved operator*(complex_interleaved a, EntryType x)
+    {
+        return a *= x;
+    }
+    friend Vc_INTRINSIC complex_interleaved operator*(EntryType x, complex_interleaved a)
+    {
+        return a *= x;
+    }
+
+    // functions {{{1
+    /// Returns `re * re + im * im` of every complex number in both of its entries.
+    Vc_INTRINSIC V norm() const
+    {
+        const V sq = m_data * m_data;
+        return sq + swapped(sq);
+    }
+    Vc_INTRINSIC complex_interleaved conj() const
+    {
+        return fromData(m_data * -Detail::alternatingSigns<V>());
+    }
+    /// Returns `this * b + c`. Only the final addition depends on \p c, which keeps the
+    /// dependency chain of an accumulation short.
+    Vc_INTRINSIC complex_interleaved fma(const complex_interleaved &b,
+                                         const complex_interleaved &c) const
+    {
+        return fromData((*this * b).m_data + c.m_data);
+    }
+    //}}}1
+
+private:
+    static Vc_INTRINSIC complex_interleaved fromData(const V &data)
+    {
+        complex_interleaved r;
+        r.m_data = data;
+        return r;
+    }
+    static Vc_INTRINSIC V swapped(const V &x) { return Detail::swapPairs(x); }
+    Vc_INTRINSIC V realParts() const { return Detail::duplicateReal(m_data); }
+    Vc_INTRINSIC V imagParts() const { return Detail::duplicateImag(m_data); }
+
+    V m_data;
+};
+
+// free functions {{{1
+/// \relates complex_interleaved
+template <typename V> Vc_INTRINSIC V norm(const complex_interleaved<V> &z) { return z.norm(); }
+/// \relates complex_interleaved
+template <typename V>
+Vc_INTRINSIC complex_interleaved<V> conj(const complex_interleaved<V> &z)
+{
+    return z.conj();
+}
+/// \relates complex_interleaved
+/// Returns `a * b + c`.
+template <typename V>
+Vc_INTRINSIC complex_interleaved<V> fma(const complex_interleaved<V> &a,
+                                        const complex_interleaved<V> &b,
+                                        const complex_interleaved<V> &c)
+{
+    return a.fma(b, c);
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile complex.h <Vc/Complex>
+ *
+ * A complex vector that caches the squares of its real and imaginary parts, for iterations
+ * of the form `z = z * z + c` with a bailout test on `norm(z)`, as in the Mandelbrot and
+ * Julia sets. The squares are needed for both `z * z` and `norm(z)`, thus each iteration
+ * computes them only once.
+ */
+template <typename V> class complex_squares
+{
+public:
+    typedef V value_type;
+    typedef typename V::mask_type mask_type;
+
+    Vc_INTRINSIC complex_squares(const complex<V> &z)
+        : m_real(z.real()), m_imag(z.imag()), m_real2(z.real() * z.real()),
+          m_imag2(z.imag() * z.imag())
+    {
+    }
+
+    Vc_INTRINSIC const V &real() const { return m_real; }
+    Vc_INTRINSIC const V &imag() const { return m_imag; }
+    Vc_INTRINSIC complex<V> value() const { return {m_real, m_imag}; }
+    /// Returns `re * re + im * im` from the cached squares.
+    Vc_INTRINSIC V norm() const { return m_real2 + m_imag2; }
+
+    /// Returns `z * z + c`.
+    Vc_INTRINSIC complex_squares squared_plus(const complex<V> &c) const
+    {
+        return {m_real2 - m_imag2 + c.real(),
+                Detail::fastFma(m_real + m_real, m_imag, c.imag())};
+    }
+
+    /// Assigns \p z to the entries where \p mask is \c true.
+    Vc_INTRINSIC void assign(const mask_type &mask, const complex_squares &z)
+    {
+        where(mask) | m_real = z.m_real;
+        where(mask) | m_imag = z.m_imag;
+        where(mask) | m_real2 = z.m_real2;
+        where(mask) | m_imag2 = z.m_imag2;
+    }
+
+private:
+    Vc_INTRINSIC complex_squares(const V &re, const V &im)
+        : m_real(re), m_imag(im), m_real2(re * re), m_imag2(im * im)
+    {
+    }
+
+    V m_real, m_imag;
+    V m_real2, m_imag2;
+};
+//}}}1
+}  // namespace Vc
+
+#endif  // VC_COMMON_COMPLEX_H_
+
+// vim: foldmethod=marker
@@ -0,0 +1,198 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_DIVIDER_H_
+#define VC_COMMON_DIVIDER_H_
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include "fixedpoint.h"
+#include "macros.h"
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+namespace Detail
+{
+// floorLog2 {{{1
+Vc_INTRINSIC int floorLog2(std::uint64_t x)
+{
+    int r = 0;
+    while (x >>= 1) {
+        ++r;
+    }
+    return r;
+}
+//}}}1
+}  // namespace Detail
+
+// divider {{{1
+/**
+ * \ingroup Utilities
+ * \headerfile divider.h <Vc/Divider>
+ *
+ * Divides integer vectors by a divisor that is only known at runtime, but the same for
+ * many divisions.
+ *
+ * SSE and AVX have no integer division instructions, thus operator/ of integer vectors
+ * converts to floating-point or divides entry by entry. A divider computes a magic number
+ * for the divisor once (Granlund and Montgomery, as in libdivide), and then divides with a
+ * multiply-high, an add, and shifts:
+ * \code
+ * const Vc::divider<int> binWidth(width);
+ * for (std::size_t i = 0; i < n; i += int_v::Size) {
+ *     const int_v x(&index[i]);
+ *     (x / binWidth).store(&bin[i]);
+ *     (x % binWidth).store(&offset[i]);
+ * }
+ * \endcode
+ *
+ * The quotients are rounded towards zero, as with the built-in operator/. Dividing the
+ * smallest value of a signed type by -1 yields that value again (as with wrap-around).
+ *
+ * \tparam T One of short, unsigned short, int, and unsigned int.
+ */
+template <typename T> class divider
+{
+    static_assert(std::is_integral<T>::value && (sizeof(T) == 2 || sizeof(T) == 4),
+                  "Vc::divider<T> requires a 16- or 32-bit integer type.");
+    typedef typename std::make_unsigned<T>::type U;
+    static constexpr int Digits = std::numeric_limits<U>::digits;
+
+    enum class Algorithm : unsigned char {
+        Shift,       // |d| is a power of two
+        Multiply,    // q = mulhi(n, magic) >> shift
+        MultiplyAdd  // the magic number needs Digits + 1 bits
+    };
+
+    T m_divisor;
+    T m_magic;
+    int m_shift;
+    Algorithm m_algorithm;
+
+    template <typename V> Vc_INTRINSIC V divide(const V &n, std::false_type) const
+    {
+        switch (m_algorithm) {
+        case Algorithm::Shift:
+            return n >> m_shift;
+        case Algorithm::Multiply:
+            return Vc::mulhi(n, V(m_magic)) >> m_shift;
+        default: {
+            const V t = Vc::mulhi(n, V(m_magic));
+            return (((n - t) >> 1) + t) >> m_shift;
+        }
+        }
+    }
+
+    template <typename V> Vc_INTRINSIC V divide(const V &n, std::true_type) const
+    {
+        V q;
+        if (m_algorithm == Algorithm::Shift) {
+            // round towards zero: add |d| - 1 to negative numerators
+            q = (n + ((n >> (Digits - 1)) & V(m_magic))) >> m_shift;
+            return m_divisor < 0 ? -q : q;
+        }
+        q = Vc::mulhi(n, V(m_magic));
+        if (m_algorithm == Algorithm::MultiplyAdd) {
+            q += m_divisor < 0 ? -n : n;
+        }
+        q >>= m_shift;
+        return q - (q >> (Digits - 1));  // + 1 for negative quotients
+    }
+
+public:
+    /// Precomputes the division by \p d, which must not be zero.
+    explicit divider(T d) : m_divisor(d)
+    {
+        Vc_ASSERT(d != 0);
+        const bool negative = std::is_signed<T>::value && d < 0;
+        const U absD = negative ? U(0) - U(d) : U(d);
+        const int log = Detail::floorLog2(absD);
+        if ((absD & (absD - 1)) == 0) {
+            m_algorithm = Algorithm::Shift;
+            m_shift = log;
+            m_magic = T(absD - 1);
+            return;
+        }
+        // without the sign bit for signed types
+        const int bits = std::is_signed<T>::value ? Digits - 1 : Digits;
+        const std::uint64_t p = std::uint64_t(1) << (bits + log);
+        std::uint64_t m = p / absD;
+        const std::uint64_t rem = p - m * absD;
+        if (absD - rem < (std::uint64_t(1) << log)) {
+            // the error of the rounded up magic number is small enough for all numerators
+            m_algorithm = Algorithm::Multiply;
+            m_shift = std::is_signed<T>::value ? log - 1 : log;
+        } else {
+            m_algorithm = Algorithm::MultiplyAdd;
+            m_shift = log;
+            m = 2 * m + (2 * rem >= absD ? 1 : 0);
+        }
+        const U magic = U(m + 1);
+        m_magic = T(negative ? U(U(0) - magic) : magic);
+    }
+
+    /// Returns the divisor.
+    T divisor() const { return m_divisor; }
+
+    /// Returns \p n / divisor() for a Vc::Vector or Vc::SimdArray of T.
+    template <typename V> Vc_INTRINSIC V divide(const V &n) const
+    {
+        static_assert(std::is_same<typename V::value_type, T>::value,
+                      "Vc::divider<T> divides vectors of T only.");
+        return divide(n, std::is_signed<T>());
+    }
+
+    /// Returns \p n % divisor() for a Vc::Vector or Vc::SimdArray of T.
+    template <typename V> Vc_INTRINSIC V remainder(const V &n) const
+    {
+        return n - divide(n) * V(m_divisor);
+    }
+};
+
+/// Returns \p n / \p d.divisor(), using the precomputed magic number of \p d.
+template <typename V, typename T,
+          typename = enable_if<Traits::is_simd_vector<V>::value>>
+Vc_INTRINSIC V operator/(const V &n, const divider<T> &d)
+{
+    return d.divide(n);
+}
+
+/// Returns \p n % \p d.divisor(), using the precomputed magic number of \p d.
+template <typename V, typename T,
+          typename = enable_if<Traits::is_simd_vector<V>::value>>
+Vc_INTRINSIC V operator%(const V &n, const divider<T> &d)
+{
+    return d.remainder(n);
+}
+//}}}1
+}  // namespace Vc
+
+#endif  // VC_COMMON_DIVIDER_H_
+
+// vim: foldmethod=marker
@@ -0,0 +1,85 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_FASTFMA_H_
+#define VC_COMMON_FASTFMA_H_
+
+#include <type_traits>
+#include "macros.h"
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+namespace Detail
+{
+/**\internal
+ * Determines whether Vc::fma on \p V is a single instruction. Otherwise it is an exact (and
+ * slow) emulation. This is the case with FMA4 for all ABIs, and with FMA for the AVX and
+ * the Scalar ABI: SSE vectors in an AVX2 build (e.g. the parts of a SimdArray, or
+ * integer-sized float vectors) still use the emulation.
+ */
+template <typename V> struct HasFastFma : public std::false_type {};
+template <typename T, typename Abi>
+struct HasFastFma<Vector<T, Abi>>
+    : public std::integral_constant<bool,
+#if defined Vc_IMPL_FMA4
+                                    true
+#elif defined Vc_IMPL_FMA
+                                    std::is_same<Abi, VectorAbi::Avx>::value ||
+                                        std::is_same<Abi, VectorAbi::Scalar>::value
+#else
+                                    false
+#endif
+                                    > {
+};
+template <typename T, std::size_t N, typename V, std::size_t M>
+struct HasFastFma<SimdArray<T, N, V, M>> : public HasFastFma<V> {};
+
+template <typename V>
+Vc_INTRINSIC V fastFma(const V &a, const V &b, const V &c, std::true_type)
+{
+    return Vc::fma(a, b, c);
+}
+template <typename V>
+Vc_INTRINSIC V fastFma(const V &a, const V &b, const V &c, std::false_type)
+{
+    return a * b + c;
+}
+/**\internal
+ * Returns `a * b + c`, fused where that is a single instruction (see HasFastFma), and
+ * otherwise rounded twice.
+ */
+template <typename V> Vc_INTRINSIC V fastFma(const V &a, const V &b, const V &c)
+{
+    return fastFma(a, b, c, HasFastFma<V>());
+}
+}  // namespace Detail
+}  // namespace Vc
+
+#endif  // VC_COMMON_FASTFMA_H_
+
+// vim: foldmethod=marker
@@ -0,0 +1,463 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_FFT_H_
+#define VC_COMMON_FFT_H_
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include "macros.h"
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+namespace Detail
+{
+// FftAccess {{{1
+/**\internal
+ * Loads and stores the compute type \p L from/to arrays of \p S.
+ *
+ * If both are the same type, every index holds one element of the transform (or of
+ * Vector::Size transforms, one per lane) and the twiddle factors are broadcast. Otherwise
+ * \p L is a vector of the entries of \p S at consecutive indexes of a single transform.
+ */
+template <typename L, typename S> struct FftAccess
+{
+    static constexpr std::size_t Step = L::Size;
+    static Vc_INTRINSIC L load(const S *p) { return L(p, Vc::Unaligned); }
+    static Vc_INTRINSIC void store(S *p, const L &x) { x.store(p, Vc::Unaligned); }
+    static Vc_INTRINSIC L twiddle(const S *w) { return L(w, Vc::Unaligned); }
+};
+template <typename L> struct FftAccess<L, L>
+{
+    static constexpr std::size_t Step = 1;
+    static Vc_INTRINSIC L load(const L *p) { return *p; }
+    static Vc_INTRINSIC void store(L *p, const L &x) { *p = x; }
+    template <typename T> static Vc_INTRINSIC L twiddle(const T *w) { return L(*w); }
+};
+
+// fftPass4 {{{1
+/**\internal
+ * Executes two radix-2 decimation-in-frequency levels (half sizes \p h and h / 2) as one
+ * radix-4 pass over the \p n elements in \p re and \p im. The butterfly of the four
+ * elements at j, j + h/2, j + h, and j + 3h/2 of every block of 2h elements needs the
+ * twiddle factors \p w (w1, w2, w3 as real/imaginary pairs): W_2h^j, W_h^j, and W_2h^3j.
+ */
+template <typename L, typename S, typename T>
+Vc_INTRINSIC void fftPass4(S *re, S *im, std::size_t n, std::size_t h, const T *const *w)
+{
+    typedef FftAccess<L, S> A;
+    const std::size_t q = h / 2;
+    for (std::size_t b = 0; b < n; b += 2 * h) {
+        S *const r = re + b;
+        S *const i = im + b;
+        for (std::size_t j = 0; j < q; j += A::Step) {
+            const L x0r = A::load(r + j), x0i = A::load(i + j);
+            const L x1r = A::load(r + j + q), x1i = A::load(i + j + q);
+            const L x2r = A::load(r + j + h), x2i = A::load(i + j + h);
+            const L x3r = A::load(r + j + h + q), x3i = A::load(i + j + h + q);
+            const L a0r = x0r + x2r, a0i = x0i + x2i;
+            const L a1r = x1r + x3r, a1i = x1i + x3i;
+            const L d02r = x0r - x2r, d02i = x0i - x2i;
+            const L d13r = x1r - x3r, d13i = x1i - x3i;
+            A::store(r + j, a0r + a1r);
+            A::store(i + j, a0i + a1i);
+            {  // (a0 - a1) * w2
+                const L yr = a0r - a1r, yi = a0i - a1i;
+                const L wr = A::twiddle(w[2] + j), wi = A::twiddle(w[3] + j);
+                A::store(r + j + q, yr * wr - yi * wi);
+                A::store(i + j + q, yr * wi + yi * wr);
+            }
+            {  // (d02 - i * d13) * w1
+                const L yr = d02r + d13i, yi = d02i - d13r;
+                const L wr = A::twiddle(w[0] + j), wi = A::twiddle(w[1] + j);
+                A::store(r + j + h, yr * wr - yi * wi);
+                A::store(i + j + h, yr * wi + yi * wr);
+            }
+            {  // (d02 + i * d13) * w3
+                const L yr = d02r - d13i, yi = d02i + d13r;
+                const L wr = A::twiddle(w[4] + j), wi = A::twiddle(w[5] + j);
+                A::store(r + j + h + q, yr * wr - yi * wi);
+                A::store(i + j + h + q, yr * wi + yi * wr);
+            }
+        }
+    }
+}
+
+// fftPass2 {{{1
+/**\internal
+ * The last radix-2 level (half size 1) if the number of levels is odd.
+ */
+template <typename S> Vc_INTRINSIC void fftPass2(S *re, S *im, std::size_t n)
+{
+    for (std::size_t b = 0; b < n; b += 2) {
+        const S x0r = re[b], x0i = im[b], x1r = re[b + 1], x1i = im[b + 1];
+        re[b] = x0r + x1r;
+        im[b] = x0i + x1i;
+        re[b + 1] = x0r - x1r;
+        im[b + 1] = x0i - x1i;
+    }
+}
+
+// fftBitReverse {{{1
+template <typename S>
+Vc_INTRINSIC void fftBitReverse(S *re, S *im, std::size_t n, const unsigned *reverse,
+                                unsigned shift)
+{
+    for (std::size_t i = 1; i + 1 < n; ++i) {
+        const std::size_t r = reverse[i] >> shift;
+        if (i < r) {
+            std::swap(re[i], re[r]);
+            std::swap(im[i], im[r]);
+        }
+    }
+}
+
+// fftRealForward / fftRealInverse {{{1
+/**\internal
+ * Turns the transform Z of the \p m complex values z[k] = x[2k] + i x[2k + 1] into the
+ * m + 1 non-redundant bins of the transform of the 2m real values x, using the twiddle
+ * factors W_2m^k in \p wr and \p wi.
+ */
+template <typename E, typename T>
+Vc_INTRINSIC void fftRealForward(E *re, E *im, std::size_t m, const T *wr, const T *wi)
+{
+    const E z0r = re[0], z0i = im[0];
+    re[0] = z0r + z0i;
+    im[0] = E(0);
+    re[m] = z0r - z0i;
+    im[m] = E(0);
+    for (std::size_t k = 1; k <= m / 2; ++k) {
+        const E zkr = re[k], zki = im[k], zmr = re[m - k], zmi = im[m - k];
+        // even part (Z[k] + conj Z[m-k]) / 2, odd part (Z[k] - conj Z[m-k]) / 2i
+        const E er = T(0.5) * (zkr + zmr), ei = T(0.5) * (zki - zmi);
+        const E orr = T(0.5) * (zki + zmi), oi = T(0.5) * (zmr - zkr);
+        const E tr = E(wr[k]) * orr - E(wi[k]) * oi;
+        const E ti = E(wr[k]) * oi + E(wi[k]) * orr;
+        re[k] = er + tr;
+        im[k] = ei + ti;
+        re[m - k] = er - tr;
+        im[m - k] = ti - ei;
+    }
+}
+
+/**\internal
+ * The inverse of fftRealForward: turns the m + 1 bins into the transform Z of the \p m
+ * complex values z[k] = x[2k] + i x[2k + 1].
+ */
+template <typename E, typename T>
+Vc_INTRINSIC void fftRealInverse(E *re, E *im, std::size_t m, const T *wr, const T *wi)
+{
+    const E x0 = re[0], xm = re[m];
+    re[0] = T(0.5) * (x0 + xm);
+    im[0] = T(0.5) * (x0 - xm);
+    for (std::size_t k = 1; k <= m / 2; ++k) {
+        const E xkr = re[k], xki = im[k], xmr = re[m - k], xmi = im[m - k];
+        const E er = T(0.5) * (xkr + xmr), ei = T(0.5) * (xki - xmi);
+        // odd part (X[k] - conj X[m-k]) * conj W_2m^k / 2
+        const E dr = T(0.5) * (xkr - xmr), di = T(0.5) * (xki + xmi);
+        const E orr = dr * E(wr[k]) + di * E(wi[k]);
+        const E oi = di * E(wr[k]) - dr * E(wi[k]);
+        re[k] = er - oi;
+        im[k] = ei + orr;
+        re[m - k] = er + oi;
+        im[m - k] = orr - ei;
+    }
+}
+//}}}1
+}  // namespace Detail
+
+// fft_plan {{{1
+/**
+ * \ingroup Utilities
+ * \headerfile fft.h <Vc/FFT>
+ *
+ * Precomputed twiddle factors and bit-reversal permutation for fast Fourier transforms of
+ * size() points (a power of two) with the entry type \p T (\c float or \c double).
+ *
+ * The forward transform computes \f$X_k = \sum_n x_n e^{-2\pi ikn/N}\f$, the inverse
+ * transform includes the factor 1/N, so that inverse(forward(x)) == x. All transforms work
+ * in place on split storage (separate arrays for the real and imaginary parts) and return
+ * the result in natural order.
+ *
+ * There are two variants of every transform:
+ * \li Single transforms on arrays of \p T. The radix-4 passes are vectorized over
+ *     consecutive butterflies with Vc::Vector<T>. The last passes, whose butterflies span
+ *     fewer than Vector<T>::Size entries, are gathered into vectors of independent
+ *     sub-transforms (or executed with scalars for very small sizes).
+ * \li Batched transforms on arrays of a vector type \p V with V::EntryType == T, where every
+ *     lane holds a separate transform (the SoA layout: the n-th point of transform l is
+ *     entry l of re[n] and im[n]). All passes are fully vectorized, which makes this the
+ *     fastest way to execute many small transforms.
+ *
+ * A plan can also be used for the transforms of size() / 2, size() / 4, ... points, and
+ * for real transforms of size() points (which use a complex transform of size() / 2).
+ *
+ * \code
+ * Vc::fft_plan<float> plan(256);
+ * std::vector<float_v, Vc::Allocator<float_v>> re(256), im(256);  // float_v::Size transforms
+ * ...
+ * plan.forward(re.data(), im.data());
+ * \endcode
+ */
+template <typename T> class fft_plan
+{
+    static_assert(std::is_floating_point<T>::value, "fft_plan<T> requires float or double");
+    typedef Vector<T> V;
+
+    std::size_t m_size;
+    unsigned m_log2;
+    // per radix-4 level h: w1, w2, w3 (real and imaginary parts) for j < h / 2
+    std::vector<T> m_twiddles;
+    // W_N^k for k < N / 2, for real transforms
+    std::vector<T> m_realTwiddles;
+    std::vector<unsigned> m_reverse;
+
+    Vc_INTRINSIC const T *twiddle(int component, std::size_t h) const
+    {
+        return &m_twiddles[component * (m_size / 2) + h / 2 - 1];
+    }
+
+    // returns the size of the blocks that remain after the radix-4 passes with h >= hMin
+    template <typename L, typename S>
+    Vc_INTRINSIC std::size_t passes(S *re, S *im, std::size_t n, std::size_t h,
+                                    std::size_t hMin) const
+    {
+        for (; h >= 2 && h >= hMin; h /= 4) {
+            const T *const w[6] = {twiddle(0, h), twiddle(1, h), twiddle(2, h),
+                                   twiddle(3, h), twiddle(4, h), twiddle(5, h)};
+            Detail::fftPass4<L>(re, im, n, h, w);
+        }
+        return 2 * h;
+    }
+
+    template <typename S> Vc_INTRINSIC void finish(S *re, S *im, std::size_t n) const
+    {
+        Detail::fftBitReverse(re, im, n, m_reverse.data(), m_log2 - log2(n));
+    }
+
+    static unsigned log2(std::size_t n)
+    {
+        unsigned r = 0;
+        while ((std::size_t(1) << r) < n) {
+            ++r;
+        }
+        return r;
+    }
+
+    // single transform of n points
+    void transform(T *re, T *im, std::size_t n) const
+    {
+        std::size_t block = passes<V>(re, im, n, n / 2, 2 * V::Size);
+        if (block == 2) {
+            Detail::fftPass2(re, im, n);
+        } else if (block > 2 && n >= block * V::Size) {
+            // the remaining independent sub-transforms of `block` points, V::Size at a
+            // time: transposed into the lanes of a vector, so that all passes are vectorized
+            typedef typename V::IndexType IT;
+            const IT index = IT::IndexesFromZero() * int(block);
+            V tmpRe[4 * V::Size], tmpIm[4 * V::Size];
+            for (std::size_t b = 0; b < n; b += block * V::Size) {
+                for (std::size_t i = 0; i < block; ++i) {
+                    tmpRe[i].gather(re + b + i, index);
+                    tmpIm[i].gather(im + b + i, index);
+                }
+                if (passes<V>(tmpRe, tmpIm, block, block / 2, 0) == 2) {
+                    Detail::fftPass2(tmpRe, tmpIm, block);
+                }
+                for (std::size_t i = 0; i < block; ++i) {
+                    tmpRe[i].scatter(re + b + i, index);
+                    tmpIm[i].scatter(im + b + i, index);
+                }
+            }
+        } else if (block > 2) {
+            if (passes<T>(re, im, n, block / 2, 0) == 2) {
+                Detail::fftPass2(re, im, n);
+            }
+        }
+        finish(re, im, n);
+    }
+
+    // V::Size transforms of n points
+    template <typename W> void transform(W *re, W *im, std::size_t n) const
+    {
+        if (passes<W>(re, im, n, n / 2, 0) == 2) {
+            Detail::fftPass2(re, im, n);
+        }
+        finish(re, im, n);
+    }
+
+    template <typename S> static void scale(S *re, S *im, std::size_t n)
+    {
+        const T factor = T(1) / T(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            re[i] *= factor;
+            im[i] *= factor;
+        }
+    }
+
+public:
+    /// Precomputes the plan for transforms of \p size points; \p size must be a power of two.
+    explicit fft_plan(std::size_t size)
+        : m_size(size)
+        , m_log2(log2(size))
+        , m_twiddles(6 * std::max<std::size_t>(1, size / 2))
+        , m_realTwiddles(std::max<std::size_t>(1, size))
+        , m_reverse(size)
+    {
+        Vc_ASSERT(size > 0 && (size & (size - 1)) == 0);
+        const double pi = 3.141592653589793238462643383279502884;
+        for (std::size_t h = 2; h < size; h *= 2) {
+            for (std::size_t j = 0; j < h / 2; ++j) {
+                const double a = -pi * double(j) / double(h);  // W_2h^j
+                const std::size_t o = h / 2 - 1 + j;
+                m_twiddles[0 * (size / 2) + o] = T(std::cos(a));
+                m_twiddles[1 * (size / 2) + o] = T(std::sin(a));
+                m_twiddles[2 * (size / 2) + o] = T(std::cos(2 * a));
+                m_twiddles[3 * (size / 2) + o] = T(std::sin(2 * a));
+                m_twiddles[4 * (size / 2) + o] = T(std::cos(3 * a));
+                m_twiddles[5 * (size / 2) + o] = T(std::sin(3 * a));
+            }
+        }
+        for (std::size_t k = 0; k < size / 2; ++k) {
+            const double a = -2 * pi * double(k) / double(size);
+            m_realTwiddles[k] = T(std::cos(a));
+            m_realTwiddles[size / 2 + k] = T(std::sin(a));
+        }
+        for (std::size_t i = 0; i < size; ++i) {
+            unsigned r = 0;
+            for (unsigned bit = 0; bit < m_log2; ++bit) {
+                r |= ((i >> bit) & 1u) << (m_log2 - 1 - bit);
+            }
+            m_reverse[i] = r;
+        }
+    }
+
+    /// Returns the number of points of the transforms.
+    std::size_t size() const { return m_size; }
+
+    /**
+     * Replaces the \p n points in \p re and \p im (default: size()) with their forward
+     * transform. \p n must be a power of two, not larger than size().
+     */
+    void forward(T *re, T *im, std::size_t n = 0) const
+    {
+        transform(re, im, n == 0 ? m_size : n);
+    }
+    /// Replaces the \p n points in \p re and \p im with their inverse transform.
+    void inverse(T *re, T *im, std::size_t n = 0) const
+    {
+        n = n == 0 ? m_size : n;
+        // the inverse transform is the forward transform with real and imaginary parts
+        // swapped on input and output
+        transform(im, re, n);
+        scale(re, im, n);
+    }
+
+    /**
+     * Executes V::Size forward transforms of \p n points at once, one in every lane of the
+     * arrays \p re and \p im.
+     */
+    template <typename W, typename = enable_if<Traits::is_simd_vector<W>::value &&
+                                               std::is_same<typename W::EntryType, T>::value>>
+    void forward(W *re, W *im, std::size_t n = 0) const
+    {
+        transform(re, im, n == 0 ? m_size : n);
+    }
+    /// Executes V::Size inverse transforms at once, one in every lane.
+    template <typename W, typename = enable_if<Traits::is_simd_vector<W>::value &&
+                                               std::is_same<typename W::EntryType, T>::value>>
+    void inverse(W *re, W *im, std::size_t n = 0) const
+    {
+        n = n == 0 ? m_size : n;
+        transform(im, re, n);
+        scale(re, im, n);
+    }
+
+    /**
+     * Transforms the size() real values in \p in and writes the size() / 2 + 1
+     * non-redundant bins (the others are their complex conjugates) to \p re and \p im.
+     */
+    void forward_real(const T *in, T *re, T *im) const
+    {
+        realForward(in, re, im);
+    }
+    /**
+     * The inverse of forward_real: writes the size() real values whose transform has the
+     * size() / 2 + 1 bins in \p re and \p im to \p out. \p re and \p im are overwritten.
+     */
+    void inverse_real(T *re, T *im, T *out) const { realInverse(re, im, out); }
+
+    /// Executes V::Size real forward transforms at once, one in every lane.
+    template <typename W, typename = enable_if<Traits::is_simd_vector<W>::value &&
+                                               std::is_same<typename W::EntryType, T>::value>>
+    void forward_real(const W *in, W *re, W *im) const
+    {
+        realForward(in, re, im);
+    }
+    /// Executes V::Size real inverse transforms at once, one in every lane.
+    template <typename W, typename = enable_if<Traits::is_simd_vector<W>::value &&
+                                               std::is_same<typename W::EntryType, T>::value>>
+    void inverse_real(W *re, W *im, W *out) const
+    {
+        realInverse(re, im, out);
+    }
+
+private:
+    template <typename S> void realForward(const S *in, S *re, S *im) const
+    {
+        Vc_ASSERT(m_size >= 2);
+        const std::size_t m = m_size / 2;
+        for (std::size_t k = 0; k < m; ++k) {
+            re[k] = in[2 * k];
+            im[k] = in[2 * k + 1];
+        }
+        transform(re, im, m);
+        Detail::fftRealForward(re, im, m, &m_realTwiddles[0], &m_realTwiddles[m]);
+    }
+
+    template <typename S> void realInverse(S *re, S *im, S *out) const
+    {
+        Vc_ASSERT(m_size >= 2);
+        const std::size_t m = m_size / 2;
+        Detail::fftRealInverse(re, im, m, &m_realTwiddles[0], &m_realTwiddles[m]);
+        transform(im, re, m);
+        const T factor = T(1) / T(m);
+        for (std::size_t k = 0; k < m; ++k) {
+            out[2 * k] = re[k] * factor;
+            out[2 * k + 1] = im[k] * factor;
+        }
+    }
+};
+//}}}1
+}  // namespace Vc
+
+#endif  // VC_COMMON_FFT_H_
+
+// vim: foldmethod=marker
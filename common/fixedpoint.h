@@ -0,0 +1,339 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_FIXEDPOINT_H_
+#define VC_COMMON_FIXEDPOINT_H_
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include "simdarrayhelper.h"
+#include "macros.h"
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+/**
+ * \defgroup FixedPoint Fixed-point integer operations
+ * \ingroup Utilities
+ * \headerfile fixedpoint.h <Vc/FixedPoint>
+ *
+ * Saturating, averaging, and widening multiply operations on vectors of short and unsigned
+ * short, as needed for fixed-point (e.g. Q15) signal processing and image code. The
+ * operator overloads of the vector types wrap around instead.
+ *
+ * SSE and AVX2 map every function to one or a few instructions (paddsw, pavgw, pmulhw,
+ * pmulhrsw, pmaddwd, ...). The other ABIs compute in 32-bit integers with the same results.
+ * SimdArray arguments are processed per native vector.
+ */
+namespace Detail
+{
+// traits {{{1
+template <typename T>
+struct IsInt16 : public std::integral_constant<bool, std::is_same<T, short>::value ||
+                                                         std::is_same<T, ushort>::value>
+{
+};
+template <typename T>
+struct IsInt16or32 : public std::integral_constant<bool, IsInt16<T>::value ||
+                                                             std::is_same<T, int>::value ||
+                                                             std::is_same<T, uint>::value>
+{
+};
+
+// the ABIs with the 16-bit integer instructions
+template <typename Abi>
+struct HasFixedPointInstructions
+    : public std::integral_constant<bool, std::is_same<Abi, VectorAbi::Sse>::value ||
+                                              std::is_same<Abi, VectorAbi::Avx>::value>
+{
+};
+
+// the type that holds all products of two T
+template <typename T>
+using WidenedType = typename std::conditional<std::is_signed<T>::value, int, uint>::type;
+
+template <typename T, typename W> Vc_INTRINSIC W saturate(const W &x)
+{
+    return Vc::min(Vc::max(x, W(int(std::numeric_limits<T>::min()))),
+                   W(int(std::numeric_limits<T>::max())));
+}
+
+// implementations {{{1
+// the native ones call the intrinsics overloads in sse/detail.h and avx/detail.h, the
+// others compute in 32 bits
+#define Vc_FIXEDPOINT_NATIVE(name_)                                                      \
+    template <typename T, typename Abi>                                                  \
+    Vc_INTRINSIC Vector<T, Abi> name_##Impl(const Vector<T, Abi> &a,                     \
+                                            const Vector<T, Abi> &b, std::true_type)     \
+    {                                                                                    \
+        return Vector<T, Abi>(name_(a.data(), b.data(), T()));                          \
+    }
+Vc_FIXEDPOINT_NATIVE(adds)
+Vc_FIXEDPOINT_NATIVE(subs)
+Vc_FIXEDPOINT_NATIVE(avg)
+Vc_FIXEDPOINT_NATIVE(mulhi)
+Vc_FIXEDPOINT_NATIVE(mulhrs)
+#undef Vc_FIXEDPOINT_NATIVE
+
+template <typename T, typename Abi>
+Vc_INTRINSIC Vector<T, Abi> addsImpl(const Vector<T, Abi> &a, const Vector<T, Abi> &b,
+                                     std::false_type)
+{
+    typedef SimdArray<int, Vector<T, Abi>::Size> W;
+    return simd_cast<Vector<T, Abi>>(saturate<T>(simd_cast<W>(a) + simd_cast<W>(b)));
+}
+
+template <typename T, typename Abi>
+Vc_INTRINSIC Vector<T, Abi> subsImpl(const Vector<T, Abi> &a, const Vector<T, Abi> &b,
+                                     std::false_type)
+{
+    typedef SimdArray<int, Vector<T, Abi>::Size> W;
+    return simd_cast<Vector<T, Abi>>(saturate<T>(simd_cast<W>(a) - simd_cast<W>(b)));
+}
+
+template <typename T, typename Abi>
+Vc_INTRINSIC Vector<T, Abi> avgImpl(const Vector<T, Abi> &a, const Vector<T, Abi> &b,
+                                    std::false_type)
+{
+    typedef SimdArray<int, Vector<T, Abi>::Size> W;
+    return simd_cast<Vector<T, Abi>>((simd_cast<W>(a) + simd_cast<W>(b) + 1) >> 1);
+}
+
+template <typename T, typename Abi>
+Vc_INTRINSIC enable_if<IsInt16<T>::value, Vector<T, Abi>> mulhiImpl(
+    const Vector<T, Abi> &a, const Vector<T, Abi> &b, std::false_type)
+{
+    typedef SimdArray<WidenedType<T>, Vector<T, Abi>::Size> W;
+    return simd_cast<Vector<T, Abi>>((simd_cast<W>(a) * simd_cast<W>(b)) >> 16);
+}
+
+template <typename T, typename Abi>
+Vc_INTRINSIC enable_if<!IsInt16<T>::value, Vector<T, Abi>> mulhiImpl(
+    const Vector<T, Abi> &a, const Vector<T, Abi> &b, std::false_type)
+{
+    typedef typename std::conditional<std::is_signed<T>::value, std::int64_t,
+                                      std::uint64_t>::type Wide;
+    return Vector<T, Abi>::generate(
+        [&](std::size_t i) { return T((Wide(a[i]) * Wide(b[i])) >> 32); });
+}
+
+template <typename T, typename Abi>
+Vc_INTRINSIC Vector<T, Abi> mulhrsImpl(const Vector<T, Abi> &a, const Vector<T, Abi> &b,
+                                       std::false_type)
+{
+    typedef SimdArray<int, Vector<T, Abi>::Size> W;
+    // -1 * -1 wraps to -1 (0x8000), as with pmulhrsw
+    const W r = ((simd_cast<W>(a) * simd_cast<W>(b) + 0x4000) >> 15) & 0xffff;
+    return simd_cast<Vector<T, Abi>>(r - ((r & 0x8000) << 1));
+}
+
+// SimdArray operations {{{1
+#define Vc_FIXEDPOINT_OPERATION(name_)                                                   \
+    struct Forward_##name_ : public Common::Operations::tag                              \
+    {                                                                                    \
+        template <typename V> Vc_INTRINSIC void operator()(V &r, const V &a, const V &b) \
+        {                                                                                \
+            r = name_(a, b);                                                             \
+        }                                                                                \
+    };
+Vc_FIXEDPOINT_OPERATION(adds)
+Vc_FIXEDPOINT_OPERATION(subs)
+Vc_FIXEDPOINT_OPERATION(avg)
+Vc_FIXEDPOINT_OPERATION(mulhi)
+Vc_FIXEDPOINT_OPERATION(mulhrs)
+#undef Vc_FIXEDPOINT_OPERATION
+//}}}1
+}  // namespace Detail
+
+// adds / subs / avg / mulhi / mulhrs {{{1
+#define Vc_FIXEDPOINT_FUNCTION(name_, condition_)                                        \
+    template <typename T, typename Abi, typename = enable_if<condition_<T>::value>>      \
+    Vc_INTRINSIC Vector<T, Abi> name_(const Vector<T, Abi> &a, const Vector<T, Abi> &b)  \
+    {                                                                                    \
+        return Detail::name_##Impl(a, b, Detail::HasFixedPointInstructions<Abi>());      \
+    }                                                                                    \
+    template <typename T, std::size_t N, typename V, std::size_t M,                      \
+              typename = enable_if<condition_<T>::value>>                                \
+    Vc_INTRINSIC SimdArray<T, N, V, M> name_(const SimdArray<T, N, V, M> &a,             \
+                                             const SimdArray<T, N, V, M> &b)             \
+    {                                                                                    \
+        return SimdArray<T, N, V, M>::fromOperation(Detail::Forward_##name_(), a, b);    \
+    }
+
+/**
+ * \fn adds
+ * \ingroup FixedPoint
+ * Returns `a + b`, saturated to the range of short or unsigned short.
+ */
+Vc_FIXEDPOINT_FUNCTION(adds, Detail::IsInt16)
+/**
+ * \fn subs
+ * \ingroup FixedPoint
+ * Returns `a - b`, saturated to the range of short or unsigned short.
+ */
+Vc_FIXEDPOINT_FUNCTION(subs, Detail::IsInt16)
+/**
+ * \fn avg
+ * \ingroup FixedPoint
+ * Returns `(a + b + 1) >> 1` without overflow, i.e. the average rounded up.
+ */
+Vc_FIXEDPOINT_FUNCTION(avg, Detail::IsInt16)
+/**
+ * \fn mulhi
+ * \ingroup FixedPoint
+ * Returns the high half of the full product `a * b` (short, unsigned short, int, and
+ * unsigned int).
+ */
+Vc_FIXEDPOINT_FUNCTION(mulhi, Detail::IsInt16or32)
+#undef Vc_FIXEDPOINT_FUNCTION
+
+/**
+ * \ingroup FixedPoint
+ * Returns the Q15 product `(a * b + 0x4000) >> 15` of short vectors, rounded to nearest.
+ * Only `-1 * -1` (0x8000 * 0x8000) overflows and yields -1 (0x8000).
+ */
+template <typename Abi>
+Vc_INTRINSIC Vector<short, Abi> mulhrs(const Vector<short, Abi> &a, const Vector<short, Abi> &b)
+{
+    return Detail::mulhrsImpl(a, b, Detail::HasFixedPointInstructions<Abi>());
+}
+template <std::size_t N, typename V, std::size_t M>
+Vc_INTRINSIC SimdArray<short, N, V, M> mulhrs(const SimdArray<short, N, V, M> &a,
+                                              const SimdArray<short, N, V, M> &b)
+{
+    return SimdArray<short, N, V, M>::fromOperation(Detail::Forward_mulhrs(), a, b);
+}
+
+// mul_widen {{{1
+namespace Detail
+{
+template <typename V> struct FixedPointAbi
+{
+    typedef std::false_type type;
+};
+template <typename T, typename Abi> struct FixedPointAbi<Vector<T, Abi>>
+{
+    typedef HasFixedPointInstructions<Abi> type;
+};
+// a SimdArray that wraps one native vector
+template <typename T, std::size_t N, typename V>
+struct FixedPointAbi<SimdArray<T, N, V, N>> : public FixedPointAbi<V>
+{
+};
+
+template <typename T, typename Abi>
+Vc_INTRINSIC const Vector<T, Abi> &nativeVector(const Vector<T, Abi> &x)
+{
+    return x;
+}
+template <typename T, std::size_t N, typename V>
+Vc_INTRINSIC const V &nativeVector(const SimdArray<T, N, V, N> &x)
+{
+    return internal_data(x);
+}
+template <typename V>
+using NativeAbi = typename std::decay<decltype(nativeVector(std::declval<V>()))>::type::abi;
+
+template <typename V>
+using MulWidenResult =
+    SimdArray<WidenedType<typename V::value_type>, V::Size>;
+
+template <typename V>
+Vc_INTRINSIC MulWidenResult<V> mulWidenImpl(const V &a, const V &b, std::true_type)
+{
+    typedef typename V::value_type T;
+    typedef Vector<WidenedType<T>, NativeAbi<V>> W;
+    typename W::VectorType r0, r1;
+    mul_widen(nativeVector(a).data(), nativeVector(b).data(), r0, r1, T());
+    return simd_cast<MulWidenResult<V>>(W(r0), W(r1));
+}
+
+template <typename V>
+Vc_INTRINSIC MulWidenResult<V> mulWidenImpl(const V &a, const V &b, std::false_type)
+{
+    typedef MulWidenResult<V> W;
+    return simd_cast<W>(a) * simd_cast<W>(b);
+}
+}  // namespace Detail
+
+/**
+ * \ingroup FixedPoint
+ * Returns the full 32-bit products `a * b` of short (int results) or unsigned short
+ * (unsigned int results) vectors, as a SimdArray with the same number of entries.
+ */
+template <typename V, typename = enable_if<Traits::is_simd_vector<V>::value &&
+                                           Detail::IsInt16<typename V::value_type>::value>>
+Vc_INTRINSIC Detail::MulWidenResult<V> mul_widen(const V &a, const V &b)
+{
+    return Detail::mulWidenImpl(a, b, typename Detail::FixedPointAbi<V>::type());
+}
+
+// madd {{{1
+namespace Detail
+{
+template <typename V> using MaddResult = SimdArray<int, V::Size / 2>;
+
+template <typename V>
+Vc_INTRINSIC MaddResult<V> maddImpl(const V &a, const V &b, std::true_type)
+{
+    return simd_cast<MaddResult<V>>(Vector<int, NativeAbi<V>>(
+        madd(nativeVector(a).data(), nativeVector(b).data(), short())));
+}
+
+template <typename V>
+Vc_INTRINSIC MaddResult<V> maddImpl(const V &a, const V &b, std::false_type)
+{
+    const auto products = mul_widen(a, b);
+    return MaddResult<V>::generate(
+        [&](std::size_t i) { return products[2 * i] + products[2 * i + 1]; });
+}
+}  // namespace Detail
+
+/**
+ * \ingroup FixedPoint
+ * Multiplies the short vectors \p a and \p b to 32-bit products and adds adjacent pairs:
+ * `r[i] = a[2i] * b[2i] + a[2i + 1] * b[2i + 1]`. This is the inner step of a dot product
+ * (e.g. an FIR filter) in 16-bit fixed-point with a 32-bit accumulator. Only
+ * `0x8000 * 0x8000 * 2` does not fit and wraps to `INT_MIN`.
+ *
+ * \p V must have an even number of entries, i.e. use SimdArray<short, N> for the Scalar
+ * ABI.
+ */
+template <typename V, typename = enable_if<Traits::is_simd_vector<V>::value &&
+                                           std::is_same<typename V::value_type, short>::value>>
+Vc_INTRINSIC Detail::MaddResult<V> madd(const V &a, const V &b)
+{
+    static_assert(V::Size % 2 == 0, "Vc::madd requires an even number of entries.");
+    return Detail::maddImpl(a, b, typename Detail::FixedPointAbi<V>::type());
+}
+//}}}1
+}  // namespace Vc
+
+#endif  // VC_COMMON_FIXEDPOINT_H_
+
+// vim: foldmethod=marker
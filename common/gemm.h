@@ -0,0 +1,236 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_GEMM_H_
+#define VC_COMMON_GEMM_H_
+
+#include <algorithm>
+#include <Vc/cpuid.h>
+#include "memory.h"
+#include "pitchedmemory.h"
+#include "macros.h"
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+namespace Common
+{
+namespace GemmImpl
+{
+/**\internal
+ * The micro kernel computes a block of MR rows and NR = 2 * V::Size columns of C. Its
+ * 2 * MR accumulators together with the two vectors of B and the broadcast of A fit into
+ * the 16 registers of SSE/AVX on x86_64.
+ */
+constexpr std::size_t MR = 4;
+
+// Blocking {{{1
+/**\internal
+ * Determines the cache blocking. A packed panel of B (kc × NR) should stay in L1 while
+ * it is multiplied with all rows of the current block of A (mc × kc), which should stay in
+ * L2.
+ */
+template <typename T> struct Blocking
+{
+    std::size_t kc, mc;
+    explicit Blocking(std::size_t NR)
+    {
+        CpuId::init();
+        const std::size_t l1 = CpuId::L1Data() > 0 ? CpuId::L1Data() : 32 * 1024;
+        const std::size_t l2 = CpuId::L2Data() > 0 ? CpuId::L2Data() : 256 * 1024;
+        kc = std::min<std::size_t>(512, std::max<std::size_t>(32, l1 / 2 / (NR * sizeof(T))));
+        mc = std::min<std::size_t>(512, std::max<std::size_t>(MR, l2 / 2 / (kc * sizeof(T))));
+        mc = mc / MR * MR;
+    }
+};
+
+// packB {{{1
+/**\internal
+ * Copies \p kc rows of \p n columns of B into panels of NR columns each. Every panel is
+ * stored contiguously (row by row) and aligned, the columns beyond \p n are zero.
+ */
+template <typename V, typename T>
+inline void packB(const T *b, std::size_t ldb, std::size_t kc, std::size_t n, T *packed)
+{
+    constexpr std::size_t NR = 2 * V::Size;
+    for (std::size_t j0 = 0; j0 < n; j0 += NR) {
+        if (j0 + NR <= n) {
+            for (std::size_t p = 0; p < kc; ++p) {
+                const T *row = b + p * ldb + j0;
+                V(row, Vc::Unaligned).store(packed, Vc::Aligned);
+                V(row + V::Size, Vc::Unaligned).store(packed + V::Size, Vc::Aligned);
+                packed += NR;
+            }
+        } else {
+            for (std::size_t p = 0; p < kc; ++p) {
+                const T *row = b + p * ldb + j0;
+                for (std::size_t j = 0; j < NR; ++j) {
+                    packed[j] = j0 + j < n ? row[j] : T(0);
+                }
+                packed += NR;
+            }
+        }
+    }
+}
+
+// kernel {{{1
+/**\internal
+ * C[0..Rows, 0..nCols] += A[0..Rows, 0..kc] * panel
+ */
+template <typename V, std::size_t Rows, typename T>
+Vc_ALWAYS_INLINE void kernel(std::size_t kc, const T *a, std::size_t lda, const T *panel,
+                             T *c, std::size_t ldc, std::size_t nCols)
+{
+    constexpr std::size_t NR = 2 * V::Size;
+    V acc[Rows][2];
+    for (std::size_t r = 0; r < Rows; ++r) {
+        acc[r][0] = V::Zero();
+        acc[r][1] = V::Zero();
+    }
+    for (std::size_t p = 0; p < kc; ++p) {
+        const V b0(panel + p * NR, Vc::Aligned);
+        const V b1(panel + p * NR + V::Size, Vc::Aligned);
+        for (std::size_t r = 0; r < Rows; ++r) {
+            const V ar = a[r * lda + p];
+            acc[r][0] += ar * b0;
+            acc[r][1] += ar * b1;
+        }
+    }
+    if (nCols == NR) {
+        for (std::size_t r = 0; r < Rows; ++r) {
+            T *cr = c + r * ldc;
+            (V(cr, Vc::Unaligned) + acc[r][0]).store(cr, Vc::Unaligned);
+            (V(cr + V::Size, Vc::Unaligned) + acc[r][1]).store(cr + V::Size, Vc::Unaligned);
+        }
+    } else {
+        Memory<V, NR> tmp;
+        for (std::size_t r = 0; r < Rows; ++r) {
+            tmp.vector(0) = acc[r][0];
+            tmp.vector(1) = acc[r][1];
+            for (std::size_t j = 0; j < nCols; ++j) {
+                c[r * ldc + j] += tmp[j];
+            }
+        }
+    }
+}
+//}}}1
+}  // namespace GemmImpl
+
+/**
+ * \ingroup Utilities
+ * \headerfile gemm.h <Vc/Matrix>
+ *
+ * Computes C += A * B for row-major matrices.
+ *
+ * The implementation packs B into aligned panels of two vectors width, blocks the
+ * iteration such that the working set of the inner loops stays in L1 and L2 (as reported
+ * by CpuId), and accumulates blocks of 4 rows × 2 vectors of C in registers.
+ *
+ * Use SmallMatrix instead for many independent small matrices.
+ *
+ * \param m The number of rows of A and C.
+ * \param n The number of columns of B and C.
+ * \param k The number of columns of A and rows of B.
+ * \param a Pointer to A. The rows are \p lda entries apart.
+ * \param lda The leading dimension of A.
+ * \param b Pointer to B. The rows are \p ldb entries apart.
+ * \param ldb The leading dimension of B.
+ * \param c Pointer to C. The rows are \p ldc entries apart.
+ * \param ldc The leading dimension of C.
+ */
+template <typename T>
+inline void gemm(std::size_t m, std::size_t n, std::size_t k, const T *a, std::size_t lda,
+                 const T *b, std::size_t ldb, T *c, std::size_t ldc)
+{
+    typedef Vector<T> V;
+    constexpr std::size_t NR = 2 * V::Size;
+    constexpr std::size_t MR = GemmImpl::MR;
+    if (m == 0 || n == 0 || k == 0) {
+        return;
+    }
+    const GemmImpl::Blocking<T> blocking(NR);
+    const std::size_t nPadded = (n + NR - 1) / NR * NR;
+    Memory<V> packed(std::min(blocking.kc, k) * nPadded);
+
+    for (std::size_t k0 = 0; k0 < k; k0 += blocking.kc) {
+        const std::size_t kb = std::min(blocking.kc, k - k0);
+        GemmImpl::packB<V>(b + k0 * ldb, ldb, kb, n, packed.entries());
+        for (std::size_t i0 = 0; i0 < m; i0 += blocking.mc) {
+            const std::size_t iEnd = std::min(i0 + blocking.mc, m);
+            for (std::size_t j0 = 0; j0 < n; j0 += NR) {
+                const T *panel = packed.entries() + j0 * kb;
+                const std::size_t nCols = std::min(NR, n - j0);
+                std::size_t i = i0;
+                for (; i + MR <= iEnd; i += MR) {
+                    GemmImpl::kernel<V, MR>(kb, a + i * lda + k0, lda, panel,
+                                            c + i * ldc + j0, ldc, nCols);
+                }
+                const T *ai = a + i * lda + k0;
+                T *ci = c + i * ldc + j0;
+                switch (iEnd - i) {
+                case 3:
+                    GemmImpl::kernel<V, 3>(kb, ai, lda, panel, ci, ldc, nCols);
+                    break;
+                case 2:
+                    GemmImpl::kernel<V, 2>(kb, ai, lda, panel, ci, ldc, nCols);
+                    break;
+                case 1:
+                    GemmImpl::kernel<V, 1>(kb, ai, lda, panel, ci, ldc, nCols);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile gemm.h <Vc/Matrix>
+ *
+ * Computes \p c += \p a * \p b.
+ *
+ * \note The extents must match: \c a.size(1) == \c b.size(0), \c c.size(0) == \c
+ * a.size(0), and \c c.size(1) == \c b.size(1).
+ */
+template <typename V>
+inline void gemm(const PitchedMemory<V, 2> &a, const PitchedMemory<V, 2> &b,
+                 PitchedMemory<V, 2> &c)
+{
+    Vc_ASSERT(a.size(1) == b.size(0));
+    Vc_ASSERT(c.size(0) == a.size(0));
+    Vc_ASSERT(c.size(1) == b.size(1));
+    gemm(a.size(0), b.size(1), a.size(1), a.entries(), a.pitch(), b.entries(), b.pitch(),
+         c.entries(), c.pitch());
+}
+}  // namespace Common
+
+using Common::gemm;
+}  // namespace Vc
+
+#endif  // VC_COMMON_GEMM_H_
+
+// vim: foldmethod=marker
@@ -0,0 +1,322 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_GEOMETRY_H_
+#define VC_COMMON_GEOMETRY_H_
+
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <limits>
+#include <vector>
+#include "simdize.h"
+#include "macros.h"
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+/**
+ * \ingroup Utilities
+ * \headerfile geometry.h <Vc/Geometry>
+ *
+ * Geometry kernels that evaluate one vector of points (or rays) per call against one
+ * scalar shape: containment in axis-aligned and oriented boxes and in polygons, ray-box
+ * and ray-triangle intersection, safety distances, and polar coordinates.
+ *
+ * The point types are class templates with the simdize interface: \c point3<float> is one
+ * point, `simdize<point3<float>>` is a point3<float_v>, and Vc::soa_vector<point3<float>>
+ * stores many points as structure of arrays:
+ * \code
+ * using namespace Vc::Geometry;
+ * const aabb<float> box = {{0.2f, 0.3f, 0.4f}, {0.5f, 0.3f, 0.1f}};
+ * Vc::soa_vector<point3<float>> points = ...;
+ * std::size_t inside = 0;
+ * for (auto &&chunk : points.vectors()) {
+ *     Vc::simdize<point3<float>> p = chunk;
+ *     inside += (contains(box, p) && chunk.mask()).count();
+ * }
+ * \endcode
+ *
+ * The shapes use the scalar type of the points (\c float for float_v points). Comparisons
+ * are strict, i.e. points on the surface of a shape are outside.
+ */
+namespace Geometry
+{
+// point2 / point3 {{{1
+/// A point or vector in the plane, with \p T either a scalar or a Vc vector type.
+template <typename T> struct point2
+{
+    T x, y;
+
+    point2() = default;
+    Vc_INTRINSIC point2(T xx, T yy) : x(xx), y(yy) {}
+
+    Vc_SIMDIZE_INTERFACE((x, y));
+};
+
+/// A point or vector in space, with \p T either a scalar or a Vc vector type.
+template <typename T> struct point3
+{
+    T x, y, z;
+
+    point3() = default;
+    Vc_INTRINSIC point3(T xx, T yy, T zz) : x(xx), y(yy), z(zz) {}
+
+    Vc_SIMDIZE_INTERFACE((x, y, z));
+};
+
+/// Componentwise difference, also of a scalar and a vectorized point.
+template <typename A, typename B>
+Vc_INTRINSIC auto operator-(const point3<A> &a, const point3<B> &b)
+    -> point3<decltype(a.x - b.x)>
+{
+    return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+/// Returns the dot product of \p a and \p b.
+template <typename A, typename B>
+Vc_INTRINSIC auto dot(const point3<A> &a, const point3<B> &b) -> decltype(a.x * b.x)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+/// Returns the cross product of \p a and \p b.
+template <typename A, typename B>
+Vc_INTRINSIC auto cross(const point3<A> &a, const point3<B> &b)
+    -> point3<decltype(a.x * b.x)>
+{
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+/// Returns the Euclidean distance of \p a and \p b.
+template <typename A, typename B>
+Vc_INTRINSIC auto distance(const point3<A> &a, const point3<B> &b) -> decltype(a.x - b.x)
+{
+    using std::sqrt;
+    using Vc::sqrt;
+    const auto d = a - b;
+    return sqrt(dot(d, d));
+}
+
+// shapes {{{1
+/// An axis-aligned box, given by its center and half the edge lengths.
+template <typename T> struct aabb
+{
+    point3<T> center;
+    point3<T> half;
+};
+
+/**
+ * An oriented box, given by its center, half the edge lengths, and the directions of its
+ * edges (three orthonormal vectors, the rows of the rotation into the box frame).
+ */
+template <typename T> struct obb
+{
+    point3<T> center;
+    point3<T> half;
+    point3<T> axis[3];
+};
+
+/// A triangle, given by its corners.
+template <typename T> struct triangle
+{
+    point3<T> a, b, c;
+};
+
+/**
+ * A simple polygon in the plane, given by its corners in order (clockwise or
+ * counterclockwise). The edges are prepared for contains() on construction.
+ */
+template <typename T> class polygon
+{
+public:
+    struct edge
+    {
+        T x0, y0, y1;
+        T slope;  // dx/dy, infinite for horizontal edges (which are never crossed)
+    };
+
+    polygon() = default;
+    polygon(std::initializer_list<point2<T>> corners)
+        : polygon(corners.begin(), corners.size())
+    {
+    }
+    polygon(const point2<T> *corners, std::size_t n)
+    {
+        m_edges.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            const point2<T> &p = corners[i];
+            const point2<T> &q = corners[i + 1 == n ? 0 : i + 1];
+            m_edges.push_back({p.x, p.y, q.y, (q.x - p.x) / (q.y - p.y)});
+        }
+    }
+
+    const std::vector<edge> &edges() const { return m_edges; }
+
+private:
+    std::vector<edge> m_edges;
+};
+
+// containment {{{1
+/// Returns the lanes of \p p that are inside \p box.
+template <typename T, typename V>
+Vc_INTRINSIC typename V::mask_type contains(const aabb<T> &box, const point3<V> &p)
+{
+    return Vc::abs(p.x - box.center.x) < box.half.x &&
+           Vc::abs(p.y - box.center.y) < box.half.y &&
+           Vc::abs(p.z - box.center.z) < box.half.z;
+}
+
+/// Returns the lanes of \p p that are inside \p box.
+template <typename T, typename V>
+Vc_INTRINSIC typename V::mask_type contains(const obb<T> &box, const point3<V> &p)
+{
+    const point3<V> d = p - box.center;
+    return Vc::abs(dot(box.axis[0], d)) < box.half.x &&
+           Vc::abs(dot(box.axis[1], d)) < box.half.y &&
+           Vc::abs(dot(box.axis[2], d)) < box.half.z;
+}
+
+/**
+ * Returns the lanes of \p p that are inside \p poly, by the even-odd rule: a point is
+ * inside if a ray from it in +x direction crosses an odd number of edges. Every edge is
+ * tested against all lanes at once.
+ */
+template <typename T, typename V>
+typename V::mask_type contains(const polygon<T> &poly, const point2<V> &p)
+{
+    typename V::mask_type inside(false);
+    for (const auto &e : poly.edges()) {
+        // the edge spans the height of the point, and crosses its ray right of it
+        const auto spans = (V(e.y0) > p.y) ^ (V(e.y1) > p.y);
+        inside ^= spans && p.x < (p.y - e.y0) * e.slope + e.x0;
+    }
+    return inside;
+}
+
+// safety distances {{{1
+/**
+ * Returns the distance of \p p to \p box for points outside, and 0 for points inside. This
+ * is the largest step a particle at \p p can take in any direction without entering the
+ * box.
+ */
+template <typename T, typename V>
+Vc_INTRINSIC V safety_to_in(const aabb<T> &box, const point3<V> &p)
+{
+    const V dx = Vc::max(Vc::abs(p.x - box.center.x) - box.half.x, V::Zero());
+    const V dy = Vc::max(Vc::abs(p.y - box.center.y) - box.half.y, V::Zero());
+    const V dz = Vc::max(Vc::abs(p.z - box.center.z) - box.half.z, V::Zero());
+    return Vc::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+/**
+ * Returns the distance of \p p to the surface of \p box for points inside, i.e. the
+ * largest step in any direction that stays inside. The result is negative for points
+ * outside.
+ */
+template <typename T, typename V>
+Vc_INTRINSIC V safety_to_out(const aabb<T> &box, const point3<V> &p)
+{
+    return Vc::min(Vc::min(box.half.x - Vc::abs(p.x - box.center.x),
+                           box.half.y - Vc::abs(p.y - box.center.y)),
+                   box.half.z - Vc::abs(p.z - box.center.z));
+}
+
+// ray intersection {{{1
+/**
+ * Intersects the rays `origin + t * direction` with \p box (slab method). Returns the lanes
+ * that hit the box for some t >= 0, and sets \p t_near and \p t_far to the parameters
+ * where the rays enter and leave the box (\p t_near is negative for origins inside).
+ *
+ * \param inverse_direction `1 / direction` per component, so that rays can be tested
+ *                          against many boxes with multiplications only. Zero components
+ *                          yield infinities, which the slab method handles, except for
+ *                          origins exactly on a slab plane.
+ */
+template <typename T, typename V>
+Vc_INTRINSIC typename V::mask_type intersect(const aabb<T> &box, const point3<V> &origin,
+                                             const point3<V> &inverse_direction, V &t_near,
+                                             V &t_far)
+{
+    const V x0 = (box.center.x - box.half.x - origin.x) * inverse_direction.x;
+    const V x1 = (box.center.x + box.half.x - origin.x) * inverse_direction.x;
+    const V y0 = (box.center.y - box.half.y - origin.y) * inverse_direction.y;
+    const V y1 = (box.center.y + box.half.y - origin.y) * inverse_direction.y;
+    const V z0 = (box.center.z - box.half.z - origin.z) * inverse_direction.z;
+    const V z1 = (box.center.z + box.half.z - origin.z) * inverse_direction.z;
+    t_near = Vc::max(Vc::max(Vc::min(x0, x1), Vc::min(y0, y1)), Vc::min(z0, z1));
+    t_far = Vc::min(Vc::min(Vc::max(x0, x1), Vc::max(y0, y1)), Vc::max(z0, z1));
+    return t_near <= t_far && t_far >= V::Zero();
+}
+
+/**
+ * Intersects the rays `origin + t * direction` with \p tri (Möller-Trumbore). Returns the
+ * lanes that hit the triangle for some t > 0 and sets \p t to the parameter of the hit;
+ * the other lanes of \p t are set to infinity. Rays parallel to the triangle miss.
+ */
+template <typename T, typename V>
+Vc_INTRINSIC typename V::mask_type intersect(const triangle<T> &tri, const point3<V> &origin,
+                                             const point3<V> &direction, V &t)
+{
+    const point3<T> e1 = tri.b - tri.a;
+    const point3<T> e2 = tri.c - tri.a;
+    const point3<V> p = cross(direction, e2);
+    const V det = dot(e1, p);
+    const V inv = V::One() / det;
+    const point3<V> s = origin - tri.a;
+    const V u = dot(s, p) * inv;
+    const point3<V> q = cross(s, e1);
+    const V v = dot(direction, q) * inv;
+    t = dot(e2, q) * inv;
+    const auto hit = Vc::abs(det) > std::numeric_limits<T>::min() && u >= V::Zero() &&
+                     v >= V::Zero() && u + v <= V::One() && t > V::Zero();
+    where(!hit) | t = std::numeric_limits<T>::infinity();
+    return hit;
+}
+
+// polar coordinates {{{1
+/// Converts \p p to the radius \p r and the angle \p phi in [-π, π].
+template <typename V> Vc_INTRINSIC void to_polar(const point2<V> &p, V &r, V &phi)
+{
+    r = Vc::sqrt(p.x * p.x + p.y * p.y);
+    phi = Vc::atan2(p.y, p.x);
+}
+
+/// Returns the point at radius \p r and angle \p phi.
+template <typename V> Vc_INTRINSIC point2<V> from_polar(const V &r, const V &phi)
+{
+    V s, c;
+    Vc::sincos(phi, &s, &c);
+    return {r * c, r * s};
+}
+//}}}1
+}  // namespace Geometry
+}  // namespace Vc
+
+#endif  // VC_COMMON_GEOMETRY_H_
+
+// vim: foldmethod=marker
@@ -0,0 +1,508 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_GRIDINTERPOLATOR_H_
+#define VC_COMMON_GRIDINTERPOLATOR_H_
+
+#include <array>
+#include <cstddef>
+#include <vector>
+#include "interleavedmemory.h"
+#include "simdize.h"
+#include "macros.h"
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+namespace Common
+{
+namespace GridInterpolatorImpl
+{
+// ValueTraits {{{1
+/**\internal
+ * Describes the values stored at the grid nodes: either a single arithmetic value or an
+ * std::array of \p N components (e.g. the three components of a field).
+ */
+template <typename T> struct ValueTraits
+{
+    typedef T scalar_type;
+    static constexpr std::size_t Components = 1;
+    template <typename R> static Vc_INTRINSIC R &component(R &x, std::size_t) { return x; }
+};
+template <typename T, std::size_t N> struct ValueTraits<std::array<T, N>>
+{
+    typedef T scalar_type;
+    static constexpr std::size_t Components = N;
+    template <typename R>
+    static Vc_INTRINSIC auto component(R &x, std::size_t i) -> decltype(x[i])
+    {
+        return x[i];
+    }
+};
+
+// Kernel {{{1
+/**\internal
+ * The interpolation weights of the \p Order + 1 nodes of one dimension.
+ *
+ * offset() is subtracted from the position in units of the grid step, so that the
+ * truncated position is the first node of the stencil. weights() receives the distance
+ * \c t of the position to that node.
+ */
+template <std::size_t Order> struct Kernel;
+
+/**\internal
+ * Linear interpolation between the two neighbouring nodes.
+ */
+template <> struct Kernel<1>
+{
+    template <typename T> static constexpr T offset() { return T(0); }
+    template <typename V> static Vc_INTRINSIC void weights(const V &t, V *w)
+    {
+        w[0] = V::One() - t;
+        w[1] = t;
+    }
+};
+
+/**\internal
+ * Quadratic interpolation through the nearest node and its two neighbours (the same
+ * polynomial as Spline::GetSpline2 in the spline example).
+ */
+template <> struct Kernel<2>
+{
+    template <typename T> static constexpr T offset() { return T(0.5); }
+    template <typename V> static Vc_INTRINSIC void weights(const V &t, V *w)
+    {
+        const V x = t - V(0.5f);
+        const V half = V(0.5f) * x;
+        w[0] = half * (x - V::One());
+        w[1] = V::One() - x * x;
+        w[2] = half * (x + V::One());
+    }
+};
+
+/**\internal
+ * Cubic (Catmull-Rom) interpolation between the two middle nodes of four (the same
+ * polynomial as GetSpline3 in the spline example).
+ */
+template <> struct Kernel<3>
+{
+    template <typename T> static constexpr T offset() { return T(1); }
+    template <typename V> static Vc_INTRINSIC void weights(const V &t, V *w)
+    {
+        const V half = V(0.5f);
+        const V t2 = t * t;
+        const V t3 = t2 * t;
+        w[0] = half * (t2 + t2 - t3 - t);
+        w[1] = half * (V(3.f) * t3 - V(5.f) * t2) + V::One();
+        w[2] = half * (V(4.f) * t2 - V(3.f) * t3 + t);
+        w[3] = half * (t3 - t2);
+    }
+};
+//}}}1
+}  // namespace GridInterpolatorImpl
+
+// GridInterpolator {{{1
+/**
+ * \ingroup Utilities
+ * \headerfile gridinterpolator.h <Vc/Interpolation>
+ *
+ * Interpolates values given on a regular \p Dim dimensional grid (a lookup table, such as a
+ * field map or a calibration map) at arbitrary positions.
+ *
+ * Positions outside of the grid are extrapolated from the outermost nodes.
+ *
+ * The node values are stored in bricks of 4 nodes per dimension. A brick of a 3-D float
+ * grid with three components (padded to four) thus needs 1 KiB, and the 64 nodes that
+ * one cubic evaluation reads touch at most eight bricks, instead of 16 rows of the whole
+ * grid. The extents are padded to multiples of 4 for that purpose.
+ *
+ * The vectorized evaluation computes the node indexes for all lanes with integer
+ * vector operations and reads the components of a node with a single
+ * InterleavedMemoryWrapper gather (i.e. vector loads and an in-register transpose).
+ *
+ * Example:
+ * \code
+ * // the magnetic field in a box of 2×2×4 m with 5 cm bins
+ * typedef std::array<float, 3> Vec3;
+ * Vc::GridInterpolator<3, 3, Vec3> field({{-1.f, -1.f, -2.f}}, {{1.f, 1.f, 2.f}},
+ *                                        {{41, 41, 81}});
+ * field.fill([](const Vec3 &x) { return measuredField(x); });
+ *
+ * const Vec3 b = field(Vec3{{0.1f, 0.2f, 0.3f}});      // a single position
+ * Vc::simdize<Vec3> bv = field(Vc::simdize<Vec3>(...)); // float_v::Size positions
+ * field.evaluate(positions, results, count);            // arrays of positions
+ * \endcode
+ *
+ * \tparam Dim The number of dimensions of the grid.
+ * \tparam Order The interpolation order: 1 (linear), 2 (quadratic), or 3 (cubic). It
+ *               requires at least \p Order + 1 nodes per dimension.
+ * \tparam T The type of the node values: \c float, \c double, or an \c std::array of
+ *           those.
+ */
+template <std::size_t Dim, std::size_t Order, typename T = float> class GridInterpolator
+{
+    static_assert(Dim > 0, "GridInterpolator requires at least one dimension");
+    static_assert(Order >= 1 && Order <= 3,
+                  "GridInterpolator supports linear, quadratic, and cubic interpolation");
+
+    typedef GridInterpolatorImpl::ValueTraits<T> Traits;
+    typedef GridInterpolatorImpl::Kernel<Order> Kernel;
+
+public:
+    /// The type of the node values.
+    typedef T value_type;
+    /// The arithmetic type of the positions and of the node values.
+    typedef typename Traits::scalar_type scalar_type;
+    /// The vector type used for the vectorized evaluation.
+    typedef Vector<scalar_type> vector_type;
+    /// The type of a position.
+    typedef std::array<scalar_type, Dim> point_type;
+    /// The type of vector_type::Size positions.
+    typedef simdize<point_type, vector_type::Size> point_vector;
+    /// The type of vector_type::Size interpolated values.
+    typedef simdize<value_type, vector_type::Size> value_vector;
+
+    /// The number of components of one node value.
+    static constexpr std::size_t Components = Traits::Components;
+    /// The number of nodes per dimension in one brick.
+    static constexpr std::size_t BrickSize = 4;
+
+private:
+    static constexpr std::size_t BrickShift = 2;
+    static constexpr std::size_t Width = Order + 1;
+    /// Whether the deinterleave of \p N members stays within the structs (see simdize.h).
+    template <std::size_t N>
+    using StaysInBounds = SimdizeDetail::IteratorDetails::deinterleave_stays_in_bounds<
+        N, sizeof(scalar_type)>;
+    /// Three components are padded to four, which makes the node gathers a 4×4 transpose.
+    /// (The in-bounds kernel for three members only applies to successive structs, not to
+    /// gathers.) Seven are padded to eight, so that the gather of the last node stays in
+    /// the table.
+    static constexpr std::size_t Stride =
+        Components == 1 || (Components != 3 && StaysInBounds<Components>::value)
+            ? Components
+            : Components + 1;
+    typedef std::array<scalar_type, Stride> Node;
+
+    point_type m_min;
+    point_type m_step;
+    point_type m_scale;
+    std::array<int, Dim> m_nodes;
+    std::array<int, Dim> m_brickStride;
+    std::array<int, Dim> m_innerStride;
+    std::vector<scalar_type, Allocator<scalar_type>> m_data;
+
+public:
+    /**
+     * Constructs the grid with \p nodes nodes per dimension, spanning from \p min to \p
+     * max. All node values are zero-initialized.
+     *
+     * \param min The position of the first node.
+     * \param max The position of the last node.
+     * \param nodes The number of nodes per dimension. Values smaller than \p Order + 1
+     *              are increased to \p Order + 1.
+     */
+    GridInterpolator(const point_type &min, const point_type &max,
+                     const std::array<std::size_t, Dim> &nodes)
+        : m_min(min)
+    {
+        std::size_t volume = 1;
+        for (std::size_t d = Dim; d > 0; --d) {
+            const std::size_t n = std::max(nodes[d - 1], Width);
+            const std::size_t bricks = (n + BrickSize - 1) >> BrickShift;
+            m_nodes[d - 1] = int(n);
+            m_innerStride[d - 1] = int(std::size_t(1) << (BrickShift * (Dim - d)));
+            m_brickStride[d - 1] = int(volume);
+            volume *= bricks;
+            const scalar_type range = max[d - 1] > min[d - 1] ? max[d - 1] - min[d - 1] : 1;
+            m_step[d - 1] = range / scalar_type(n - 1);
+            m_scale[d - 1] = scalar_type(1) / m_step[d - 1];
+        }
+        const std::size_t brickVolume = std::size_t(1) << (BrickShift * Dim);
+        for (auto &s : m_brickStride) {
+            s *= int(brickVolume);
+        }
+        m_data.assign(volume * brickVolume * Stride, scalar_type(0));
+    }
+
+    /// Returns the number of nodes in dimension \p d.
+    std::size_t nodeCount(std::size_t d) const { return m_nodes[d]; }
+
+    /// Returns the number of Bytes allocated for the node values (including padding).
+    std::size_t memorySize() const { return m_data.size() * sizeof(scalar_type); }
+
+    /// Returns the position of the node with the index \p i.
+    point_type position(const std::array<std::size_t, Dim> &i) const
+    {
+        point_type r;
+        for (std::size_t d = 0; d < Dim; ++d) {
+            r[d] = m_min[d] + scalar_type(i[d]) * m_step[d];
+        }
+        return r;
+    }
+
+    /// Returns a reference to the value of the node with the index \p i.
+    value_type &node(const std::array<std::size_t, Dim> &i)
+    {
+        return *reinterpret_cast<value_type *>(&m_data[nodeIndex(i) * Stride]);
+    }
+    /// Returns the value of the node with the index \p i.
+    const value_type &node(const std::array<std::size_t, Dim> &i) const
+    {
+        return *reinterpret_cast<const value_type *>(&m_data[nodeIndex(i) * Stride]);
+    }
+
+    /**
+     * Sets every node to the value \p f returns for the position of the node.
+     *
+     * \param f A callable with the signature \c value_type(const point_type &).
+     */
+    template <typename F> void fill(F &&f)
+    {
+        std::size_t count = 1;
+        for (std::size_t d = 0; d < Dim; ++d) {
+            count *= m_nodes[d];
+        }
+        std::array<std::size_t, Dim> i;
+        for (std::size_t n = 0; n < count; ++n) {
+            for (std::size_t d = Dim, k = n; d > 0; --d) {
+                i[d - 1] = k % m_nodes[d - 1];
+                k /= m_nodes[d - 1];
+            }
+            node(i) = f(position(i));
+        }
+    }
+
+    /// Returns the interpolated value at the position \p p.
+    value_type operator()(const point_type &p) const
+    {
+        typedef Scalar::Vector<scalar_type> V1;
+        V1 x[Dim];
+        for (std::size_t d = 0; d < Dim; ++d) {
+            x[d] = p[d];
+        }
+        V1 r[Components];
+        evaluateImpl(x, r);
+        value_type result;
+        for (std::size_t c = 0; c < Components; ++c) {
+            Traits::component(result, c) = r[c][0];
+        }
+        return result;
+    }
+
+    /// Returns the interpolated values at the vector_type::Size positions \p p.
+    value_vector operator()(const point_vector &p) const
+    {
+        vector_type x[Dim];
+        for (std::size_t d = 0; d < Dim; ++d) {
+            x[d] = p[d];
+        }
+        vector_type r[Components];
+        evaluateImpl(x, r);
+        value_vector result;
+        for (std::size_t c = 0; c < Components; ++c) {
+            Traits::component(result, c) = r[c];
+        }
+        return result;
+    }
+
+    /**
+     * Interpolates the values at the \p n positions \p points and writes them to \p
+     * results.
+     *
+     * The positions are loaded and the results are stored with InterleavedMemoryWrapper,
+     * i.e. with vector loads and stores. Positions that do not fill a complete vector
+     * are evaluated one by one. Nothing outside of the \p n positions is read.
+     */
+    void evaluate(const point_type *points, value_type *results, std::size_t n) const
+    {
+        std::size_t i = 0;
+        for (; i + vector_type::Size <= n; i += vector_type::Size) {
+            vector_type x[Dim];
+            // with three or seven coordinates the deinterleave reads up to a vector past
+            // the last position, which is fine as long as another position follows
+            if (Dim == 1 || StaysInBounds<Dim>::value || i + vector_type::Size < n) {
+                load(points + i, x, make_index_sequence<Dim>());
+            } else {
+                gatherPoints(points + i, x);
+            }
+            vector_type r[Components];
+            evaluateImpl(x, r);
+            store(results + i, r, make_index_sequence<Components>());
+        }
+        for (; i < n; ++i) {
+            results[i] = operator()(points[i]);
+        }
+    }
+
+private:
+    std::size_t nodeIndex(const std::array<std::size_t, Dim> &i) const
+    {
+        std::size_t r = 0;
+        for (std::size_t d = 0; d < Dim; ++d) {
+            r += (i[d] >> BrickShift) * m_brickStride[d] +
+                 (i[d] & (BrickSize - 1)) * m_innerStride[d];
+        }
+        return r;
+    }
+
+    // evaluateImpl {{{2
+    /**\internal
+     * Implements the interpolation for Scalar::Vector and vector_type. The stencil is
+     * traversed as Width^(Dim-1) rows of Width nodes in the innermost dimension. Every row
+     * is reduced with the weights of the innermost dimension before it is multiplied with
+     * the product of the weights of the outer dimensions.
+     */
+    template <typename V> Vc_INTRINSIC void evaluateImpl(const V *x, V *r) const
+    {
+        typedef typename V::IndexType I;
+        I offsets[Dim][Width];
+        V weights[Dim][Width];
+        for (std::size_t d = 0; d < Dim; ++d) {
+            const V l = (x[d] - V(m_min[d])) * V(m_scale[d]) -
+                        V(Kernel::template offset<scalar_type>());
+            const I i = static_cast<I>(
+                Vc::min(V(scalar_type(m_nodes[d] - int(Width))), Vc::max(l, V::Zero())));
+            Kernel::weights(l - simd_cast<V>(i), weights[d]);
+            for (std::size_t k = 0; k < Width; ++k) {
+                const I ik = i + int(k);
+                offsets[d][k] = (ik >> int(BrickShift)) * m_brickStride[d] +
+                                (ik & int(BrickSize - 1)) * m_innerStride[d];
+            }
+        }
+
+        for (std::size_t c = 0; c < Components; ++c) {
+            r[c] = V::Zero();
+        }
+        constexpr std::size_t Rows = RowCount<Dim - 1>::value;
+        for (std::size_t row = 0; row < Rows; ++row) {
+            I base = I::Zero();
+            V w = V::One();
+            for (std::size_t d = Dim - 1, k = row; d > 0; --d, k /= Width) {
+                base += offsets[d - 1][k % Width];
+                w *= weights[d - 1][k % Width];
+            }
+            V sum[Components];
+            for (std::size_t c = 0; c < Components; ++c) {
+                sum[c] = V::Zero();
+            }
+            for (std::size_t k = 0; k < Width; ++k) {
+                V v[Components];
+                gather(base + offsets[Dim - 1][k], v, make_index_sequence<Components>());
+                for (std::size_t c = 0; c < Components; ++c) {
+                    sum[c] += weights[Dim - 1][k] * v[c];
+                }
+            }
+            for (std::size_t c = 0; c < Components; ++c) {
+                r[c] += w * sum[c];
+            }
+        }
+    }
+
+    template <std::size_t N, int = 0> struct RowCount
+    {
+        static constexpr std::size_t value = Width * RowCount<N - 1>::value;
+    };
+    template <int Dummy> struct RowCount<0, Dummy>
+    {
+        static constexpr std::size_t value = 1;
+    };
+
+    // gather {{{2
+    /**\internal
+     * Reads the Components values of the nodes with the indexes \p i.
+     */
+    template <typename V, typename I, std::size_t... Indexes>
+    Vc_INTRINSIC void gather(const I &i, V *v, index_sequence<Indexes...> seq) const
+    {
+        gather(i, v, seq,
+               std::integral_constant<int, (Components == 1 ? 0 : V::Size == 1 ? 1 : 2)>());
+    }
+    template <typename V, typename I, std::size_t... Indexes>
+    Vc_INTRINSIC void gather(const I &i, V *v, index_sequence<Indexes...>,
+                             std::integral_constant<int, 0>) const
+    {
+        v[0] = V(m_data.data(), i);
+    }
+    template <typename V, typename I, std::size_t... Indexes>
+    Vc_INTRINSIC void gather(const I &i, V *v, index_sequence<Indexes...>,
+                             std::integral_constant<int, 1>) const
+    {
+        const scalar_type *node = m_data.data() + i[0] * Stride;
+        auto &&unused = {(v[Indexes] = node[Indexes], 0)...};
+        (void)unused;
+    }
+    template <typename V, typename I, std::size_t... Indexes>
+    Vc_INTRINSIC void gather(const I &i, V *v, index_sequence<Indexes...>,
+                             std::integral_constant<int, 2>) const
+    {
+        const InterleavedMemoryWrapper<const Node, V> map(
+            reinterpret_cast<const Node *>(m_data.data()));
+        map[i].deinterleave(v[Indexes]...);
+    }
+
+    // load / store {{{2
+    template <std::size_t... Indexes>
+    static Vc_INTRINSIC void load(const point_type *p, vector_type *x,
+                                  index_sequence<Indexes...>)
+    {
+        const InterleavedMemoryWrapper<const point_type, vector_type> map(p);
+        map[std::size_t(0)].deinterleave(x[Indexes]...);
+    }
+    static Vc_INTRINSIC void load(const point_type *p, vector_type *x, index_sequence<0>)
+    {
+        x[0].load(&(*p)[0], Vc::Unaligned);
+    }
+    static Vc_INTRINSIC void gatherPoints(const point_type *p, vector_type *x)
+    {
+        const auto offsets = vector_type::IndexType::IndexesFromZero() * int(Dim);
+        for (std::size_t d = 0; d < Dim; ++d) {
+            x[d].gather(&p[0][d], offsets);
+        }
+    }
+    template <std::size_t... Indexes>
+    static Vc_INTRINSIC void store(value_type *out, const vector_type *r,
+                                   index_sequence<Indexes...>)
+    {
+        InterleavedMemoryWrapper<value_type, vector_type>(out)[std::size_t(0)].interleave(
+            r[Indexes]...);
+    }
+    static Vc_INTRINSIC void store(value_type *out, const vector_type *r, index_sequence<0>)
+    {
+        r[0].store(reinterpret_cast<scalar_type *>(out), Vc::Unaligned);
+    }
+    //}}}2
+};
+//}}}1
+}  // namespace Common
+
+using Common::GridInterpolator;
+}  // namespace Vc
+
+#endif  // VC_COMMON_GRIDINTERPOLATOR_H_
+
+// vim: foldmethod=marker
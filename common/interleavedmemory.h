@@ -35,6 +35,89 @@ namespace Vc_VERSIONED_NAMESPACE
 {
 namespace Common
 {
+namespace InterleavedMemoryImpl
+{
+// is_compatible {{{1
+/**\internal
+ * Determines whether the members of type \p W can be accessed through an
+ * InterleavedMemoryWrapper with vector type \p V. This is the case if \p W has the same
+ * number of entries, and entries of the same size as \p V (e.g. \c int_v members in a
+ * struct accessed with \c float_v). The members are then moved through the shuffles as
+ * \p V and reinterpreted as \p W.
+ */
+template <typename V, typename W, bool = Traits::is_simd_vector_internal<W>::value>
+struct is_compatible : public std::false_type
+{
+};
+template <typename V, typename W>
+struct is_compatible<V, W, true>
+    : public std::integral_constant<bool,
+                                    (W::Size == V::Size &&
+                                     sizeof(typename W::EntryType) ==
+                                         sizeof(typename V::EntryType) &&
+                                     sizeof(W) == sizeof(V))>
+{
+};
+
+template <typename V, typename... Ws> struct all_compatible;
+template <typename V> struct all_compatible<V> : public std::true_type
+{
+};
+template <typename V, typename W, typename... Ws>
+struct all_compatible<V, W, Ws...>
+    : public std::integral_constant<bool, (is_compatible<V, W>::value &&
+                                           all_compatible<V, Ws...>::value)>
+{
+};
+
+template <typename V, typename... Ws>
+using enable_if_members = enable_if<(sizeof...(Ws) >= 2 && sizeof...(Ws) <= 16 &&
+                                     all_compatible<V, Ws...>::value),
+                                    void>;
+
+// reinterpret {{{1
+template <typename W, typename V>
+Vc_INTRINSIC enable_if<std::is_same<W, V>::value, const V &> reinterpret(const V &x)
+{
+    return x;
+}
+template <typename W, typename V>
+Vc_INTRINSIC enable_if<!std::is_same<W, V>::value, W> reinterpret(const V &x)
+{
+    return x.template reinterpretCast<W>();
+}
+
+// GroupIndexes {{{1
+/**\internal
+ * Structs with more than eight members are shuffled in groups of (at most) four members.
+ * Every group needs the same \p I::Size offsets into memory. An index vector is therefore
+ * converted to scalars once, instead of extracting every entry once per group. The
+ * offsets of SuccessiveEntries are known at compile time and need no conversion.
+ */
+template <typename I, bool = (Traits::simd_vector_size<I>::value > 1)>
+struct GroupIndexes
+{
+    typedef I type;
+    static Vc_INTRINSIC const I &convert(const I &i) { return i; }
+};
+#ifndef Vc_IMPL_MIC
+template <typename I> struct GroupIndexes<I, true>
+{
+    class type
+    {
+        typename I::EntryType m_data[I::Size];
+
+    public:
+        typedef const type &AsArg;
+        Vc_INTRINSIC explicit type(const I &i) { i.store(&m_data[0], Vc::Unaligned); }
+        Vc_INTRINSIC std::size_t operator[](std::size_t k) const { return m_data[k]; }
+    };
+    static Vc_INTRINSIC type convert(const I &i) { return type(i); }
+};
+#endif
+//}}}1
+}  // namespace InterleavedMemoryImpl
+
 /**
  * \internal
  */
@@ -73,14 +156,132 @@ template<typename V, typename I, bool Readonly> struct InterleavedMemoryAccessBa
     inline void interleave(VArg v0, VArg v1, VArg v2, VArg v3, VArg v4, VArg v5, VArg v6);
     inline void interleave(VArg v0, VArg v1, VArg v2, VArg v3, VArg v4, VArg v5, VArg v6, VArg v7);
 
+    // structs with up to 16 members and members of different vector types with the same
+    // layout as V (e.g. float_v and int_v), implemented via the above functions
+    template <typename... Ws>
+    inline InterleavedMemoryImpl::enable_if_members<V, Ws...> deinterleave(Ws &... vs) const;
+    template <typename... Ws>
+    inline InterleavedMemoryImpl::enable_if_members<V, Ws...> interleave(const Ws &... vs);
+
 protected:
     template <typename T, std::size_t... Indexes>
     Vc_INTRINSIC void callInterleave(T &&a, index_sequence<Indexes...>)
     {
         interleave(a[Indexes]...);
     }
+
+    template <typename T, std::size_t... Indexes>
+    Vc_INTRINSIC void callInterleaveTuple(const T &a, index_sequence<Indexes...>)
+    {
+        interleave(std::get<Indexes>(a)...);
+    }
+
+private:
+    typedef InterleavedMemoryImpl::GroupIndexes<I> GroupIndexes;
+    typedef InterleavedMemoryAccessBase<V, typename GroupIndexes::type, Readonly> GroupAccess;
+
+    template <std::size_t... Indexes>
+    Vc_INTRINSIC void deinterleaveMembers(V *v, index_sequence<Indexes...>,
+                                          std::false_type) const
+    {
+        deinterleave(v[Indexes]...);
+    }
+    template <std::size_t... Indexes>
+    Vc_INTRINSIC void deinterleaveMembers(V *v, index_sequence<Indexes...>, std::true_type) const;
+    template <std::size_t... Indexes, typename... Ws>
+    Vc_INTRINSIC void deinterleaveInto(index_sequence<Indexes...>, Ws &... vs) const
+    {
+        V tmp[sizeof...(Ws)];
+        deinterleaveMembers(tmp, index_sequence<Indexes...>(),
+                            std::integral_constant<bool, (sizeof...(Ws) > 8)>());
+        auto &&unused = {(vs = InterleavedMemoryImpl::reinterpret<Ws>(tmp[Indexes]), 0)...};
+        (void)unused;
+    }
+    template <std::size_t... Indexes>
+    Vc_INTRINSIC void interleaveMembers(const V *v, index_sequence<Indexes...>,
+                                        std::false_type)
+    {
+        interleave(v[Indexes]...);
+    }
+    template <std::size_t... Indexes>
+    Vc_INTRINSIC void interleaveMembers(const V *v, index_sequence<Indexes...>, std::true_type);
+
+    template <std::size_t... Indexes>
+    static Vc_INTRINSIC void deinterleaveGroup(const GroupAccess &access, V *v,
+                                               index_sequence<Indexes...>)
+    {
+        access.deinterleave(v[Indexes]...);
+    }
+    template <std::size_t... Indexes>
+    static Vc_INTRINSIC void interleaveGroup(GroupAccess &&access, const V *v,
+                                             index_sequence<Indexes...>)
+    {
+        access.interleave(v[Indexes]...);
+    }
 };
 
+// InterleavedMemoryAccessBase::deinterleave (up to 16 members) {{{1
+/**\internal
+ * Members are moved through the shuffles of the backends in groups of four. The remaining
+ * one, two, or three members are handled with a group that overlaps the previous one,
+ * instead of the gather/scatter or the read past the end of the struct that the
+ * implementations for five and seven members use.
+ */
+template <typename V, typename I, bool RO>
+template <std::size_t... Indexes>
+Vc_INTRINSIC void InterleavedMemoryAccessBase<V, I, RO>::deinterleaveMembers(
+    V *v, index_sequence<Indexes...>, std::true_type) const
+{
+    constexpr std::size_t N = sizeof...(Indexes);
+    const auto indexes = GroupIndexes::convert(m_indexes);
+    for (std::size_t offset = 0; offset + 4 <= N; offset += 4) {
+        deinterleaveGroup({indexes, m_data + offset}, v + offset, make_index_sequence<4>());
+    }
+    if (N % 4 == 3) {
+        deinterleaveGroup({indexes, m_data + N - 4}, v + N - 4, make_index_sequence<4>());
+    } else if (N % 4 != 0) {
+        deinterleaveGroup({indexes, m_data + N - 2}, v + N - 2, make_index_sequence<2>());
+    }
+}
+
+template <typename V, typename I, bool RO>
+template <typename... Ws>
+inline InterleavedMemoryImpl::enable_if_members<V, Ws...>
+InterleavedMemoryAccessBase<V, I, RO>::deinterleave(Ws &... vs) const
+{
+    deinterleaveInto(make_index_sequence<sizeof...(Ws)>(), vs...);
+}
+
+// InterleavedMemoryAccessBase::interleave (up to 16 members) {{{1
+template <typename V, typename I, bool RO>
+template <std::size_t... Indexes>
+Vc_INTRINSIC void InterleavedMemoryAccessBase<V, I, RO>::interleaveMembers(
+    const V *v, index_sequence<Indexes...>, std::true_type)
+{
+    constexpr std::size_t N = sizeof...(Indexes);
+    const auto indexes = GroupIndexes::convert(m_indexes);
+    for (std::size_t offset = 0; offset + 4 <= N; offset += 4) {
+        interleaveGroup({indexes, m_data + offset}, v + offset, make_index_sequence<4>());
+    }
+    // the overlapping group stores the same values again
+    if (N % 4 == 3) {
+        interleaveGroup({indexes, m_data + N - 4}, v + N - 4, make_index_sequence<4>());
+    } else if (N % 4 != 0) {
+        interleaveGroup({indexes, m_data + N - 2}, v + N - 2, make_index_sequence<2>());
+    }
+}
+
+template <typename V, typename I, bool RO>
+template <typename... Ws>
+inline InterleavedMemoryImpl::enable_if_members<V, Ws...>
+InterleavedMemoryAccessBase<V, I, RO>::interleave(const Ws &... vs)
+{
+    constexpr std::size_t N = sizeof...(Ws);
+    const V tmp[N] = {InterleavedMemoryImpl::reinterpret<V>(vs)...};
+    interleaveMembers(tmp, make_index_sequence<N>(), std::integral_constant<bool, (N > 8)>());
+}
+//}}}1
+
 /**
  * \internal
  */
@@ -117,8 +318,9 @@ struct InterleavedMemoryReadAccess : public InterleavedMemoryAccessBase<V, I, Re
 
     template <typename T,
               typename = enable_if<(std::is_default_constructible<T>::value &&
-                                    std::is_same<V, Traits::decay<decltype(std::get<0>(
-                                                        std::declval<T &>()))>>::value)>>
+                                    InterleavedMemoryImpl::is_compatible<
+                                        V, Traits::decay<decltype(std::get<0>(
+                                               std::declval<T &>()))>>::value)>>
     Vc_ALWAYS_INLINE operator T() const
     {
         return deinterleave_unpack<T>(make_index_sequence<std::tuple_size<T>::value>());
@@ -171,6 +373,12 @@ struct InterleavedMemoryAccess : public InterleavedMemoryReadAccess<StructSize,
                       "You_are_trying_to_scatter_more_data_into_the_struct_than_it_has");
         this->callInterleave(std::move(rhs), make_index_sequence<N>());
     }
+    template <typename... Ws> Vc_ALWAYS_INLINE void operator=(const std::tuple<Ws...> &rhs)
+    {
+        static_assert(sizeof...(Ws) <= StructSize,
+                      "You_are_trying_to_scatter_more_data_into_the_struct_than_it_has");
+        this->callInterleaveTuple(rhs, make_index_sequence<sizeof...(Ws)>());
+    }
 };
 
 /**
@@ -180,6 +388,21 @@ struct InterleavedMemoryAccess : public InterleavedMemoryReadAccess<StructSize,
  * \param V The type of the vector to be returned when read. This should reflect the type of the
  * members inside the struct.
  *
+ * Structs with up to 16 members are supported. If the struct mixes members of different types
+ * with the same size (e.g. \c float and \c int), use \p V for one of them and access the
+ * others with vectors of the same \c Size, converting to and from \c std::tuple:
+ * \code
+ * struct Hit {
+ *   float x, y, z;
+ *   int detector;
+ * };
+ *
+ * Vc::InterleavedMemoryWrapper<Hit, float_v> data(hits);
+ * std::tuple<float_v, float_v, float_v, int_v> hit = data[indexes];
+ * data[indexes] = std::tie(x, y, z, detector);
+ * \endcode
+ * (\c int_v::Size must equal \c float_v::Size, which is not the case for the AVX target.)
+ *
  * \see operator[]
  * \ingroup Utilities
  * \headerfile interleavedmemory.h <Vc/Memory>
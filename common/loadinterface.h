@@ -95,6 +95,36 @@ template <typename U, typename Flags = DefaultLoadTag,
                sizeof(EntryType) >= sizeof(U)) &&
               std::is_arithmetic<U>::value &&Traits::is_load_store_flag<Flags>::value>>
 Vc_INTRINSIC_L void load(const U *mem, Flags = Flags()) Vc_INTRINSIC_R;
+
+/**
+ * Load the vector entries from \p mem where \p mask is set. The remaining entries keep
+ * their previous values.
+ *
+ * The load never faults on the memory of inactive entries. Thus, it can be used to load
+ * the last, partial vector of an array without reading past its end:
+ * \code
+ * float_v x = float_v::Zero();
+ * x.load(&data[i], float_v::IndexesFromZero() < float_v(n - i));
+ * \endcode
+ *
+ * \param mem
+ * A pointer to data. If \p flags contains the Vc::Aligned flag, the pointer must be
+ * aligned on a MemoryAlignment boundary.
+ * \param mask
+ * A mask object that determines which entries of the vector are loaded from `mem[i]`.
+ * \param flags
+ * A (combination of) flag object(s), such as Vc::Aligned, Vc::Streaming, Vc::Unaligned,
+ * and/or Vc::PrefetchDefault.
+ *
+ * \note
+ * Like the masked store, the masked load does not unpack values from memory. I.e. the
+ * value at offset \c i is loaded from `mem[i]`, independent of the other entries of \p
+ * mask.
+ */
+template <typename Flags = DefaultLoadTag,
+          typename = enable_if<Traits::is_load_store_flag<Flags>::value>>
+Vc_INTRINSIC_L void load(const EntryType *mem, MaskArgument mask,
+                         Flags flags = Flags()) Vc_INTRINSIC_R;
 //}}}1
 
 // vim: foldmethod=marker
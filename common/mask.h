@@ -364,6 +364,18 @@ public:
      */
     Vc_ALWAYS_INLINE int firstOne() const;
 
+    /**
+     * Returns the index of the last one in the mask.
+     *
+     * \returns the index of the last component that is \c true.
+     *
+     * \warning The return value is undefined if the mask is empty.
+     *
+     * Thus, unless `none_of(mask)`, `mask[mask.lastOne()] == true` holds and `mask[i] ==
+     * false` for all `i > mask.lastOne()`.
+     */
+    Vc_ALWAYS_INLINE int lastOne() const;
+
     /**
      * Convert the boolean components of the mask into bits of an integer.
      *
@@ -0,0 +1,315 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_MASKBITS_H_
+#define VC_COMMON_MASKBITS_H_
+
+#include <cstdint>
+#include <cstring>
+#include "bitscanintrinsics.h"
+#include "macros.h"
+#if defined Vc_IMPL_BMI2 && (defined __x86_64__ || defined _M_X64)
+#include <immintrin.h>
+#define Vc_MASKBITS_USE_BMI2 1
+#endif
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+namespace Detail
+{
+// popcount32 {{{1
+Vc_INTRINSIC Vc_CONST unsigned int popcount32(unsigned int n)
+{
+#ifdef Vc_IMPL_POPCNT
+    return _mm_popcnt_u32(n);
+#else
+    n = (n & 0x55555555U) + ((n >> 1) & 0x55555555U);
+    n = (n & 0x33333333U) + ((n >> 2) & 0x33333333U);
+    n = (n & 0x0f0f0f0fU) + ((n >> 4) & 0x0f0f0f0fU);
+    n = (n & 0x00ff00ffU) + ((n >> 8) & 0x00ff00ffU);
+    n = (n & 0x0000ffffU) + ((n >>16) & 0x0000ffffU);
+    return n;
+#endif
+}
+
+// mask_bits {{{1
+template <typename M> Vc_INTRINSIC unsigned int mask_bits(const M &k)
+{
+    static_assert(M::Size <= 32, "the mask bit functions support masks with up to 32 entries");
+    return static_cast<unsigned int>(k.toInt());
+}
+
+// mask_prefix_count {{{1
+#ifdef Vc_MASKBITS_USE_BMI2
+/*\internal
+ * pdep spreads eight mask bits into the bytes of a 64-bit integer. The multiplication with
+ * 0x0101...0100 then sums all lower bytes into each byte.
+ */
+template <typename M> Vc_INTRINSIC SimdArray<int, M::Size> mask_prefix_count(const M &k)
+{
+    unsigned int bits = mask_bits(k);
+    alignas(16) unsigned char counts[(M::Size + 7) / 8 * 8];
+    std::uint64_t offset = 0;
+    for (std::size_t i = 0; i < M::Size; i += 8) {
+        const std::uint64_t prefix =
+            _pdep_u64(bits & 0xff, 0x0101010101010101ull) * 0x0101010101010100ull +
+            offset * 0x0101010101010101ull;
+        std::memcpy(&counts[i], &prefix, 8);
+        offset += popcount32(bits & 0xff);
+        bits >>= 8;
+    }
+    return SimdArray<int, M::Size>(&counts[0], Vc::Unaligned);
+}
+#else
+/*\internal
+ * Inclusive scan of the 0/1 entries in log2(Size) shift-and-add steps, shifted by one entry
+ * to make it exclusive.
+ */
+template <typename M> Vc_INTRINSIC SimdArray<int, M::Size> mask_prefix_count(const M &k)
+{
+    using I = SimdArray<int, M::Size>;
+    I x = iif(simd_cast<typename I::mask_type>(k), I(1), I(0)).shifted(-1);
+    for (std::size_t step = 1; step < M::Size; step *= 2) {
+        x += x.shifted(-int(step));
+    }
+    return x;
+}
+#endif
+
+// mask_to_indexes {{{1
+#ifdef Vc_MASKBITS_USE_BMI2
+/*\internal
+ * pext selects the bytes of the identity permutation that correspond to active entries.
+ */
+template <typename M> Vc_INTRINSIC SimdArray<int, M::Size> mask_to_indexes(const M &k)
+{
+    unsigned int bits = mask_bits(k);
+    alignas(16) unsigned char indexes[(M::Size + 7) / 8 * 8 + 8] = {};
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < M::Size; i += 8) {
+        const std::uint64_t selected =
+            _pdep_u64(bits & 0xff, 0x0101010101010101ull) * 0xff;
+        const std::uint64_t packed =
+            _pext_u64(0x0706050403020100ull + i * 0x0101010101010101ull, selected);
+        std::memcpy(&indexes[n], &packed, 8);
+        n += popcount32(bits & 0xff);
+        bits >>= 8;
+    }
+    return SimdArray<int, M::Size>(&indexes[0], Vc::Unaligned);
+}
+#else
+template <typename M> Vc_INTRINSIC SimdArray<int, M::Size> mask_to_indexes(const M &k)
+{
+    unsigned int bits = mask_bits(k);
+    alignas(16) int indexes[M::Size] = {};
+    for (int n = 0; bits != 0; ++n) {
+        indexes[n] = _bit_scan_forward(bits);
+        bits &= bits - 1;
+    }
+    return SimdArray<int, M::Size>(&indexes[0], Vc::Unaligned);
+}
+#endif
+
+// mask_from_bits {{{1
+#ifdef Vc_MASKBITS_USE_BMI2
+// pdep spreads the bits into bytes with the object representation of bool
+template <typename M> Vc_INTRINSIC M mask_from_bits(std::uint64_t bits)
+{
+    alignas(16) bool mem[(M::Size + 7) / 8 * 8];
+    for (std::size_t i = 0; i < M::Size; i += 8) {
+        const std::uint64_t bytes = _pdep_u64(bits >> i, 0x0101010101010101ull);
+        std::memcpy(&mem[i], &bytes, 8);
+    }
+    return M(&mem[0]);
+}
+#else
+template <typename M> Vc_INTRINSIC M mask_from_bits(std::uint64_t bits)
+{
+    return M::generate([&](std::size_t i) { return ((bits >> i) & 1) != 0; });
+}
+#endif
+
+// compress_store {{{1
+// native vectors scatter to the prefix counts
+template <typename V>
+Vc_INTRINSIC enable_if<!Traits::isSimdArray<V>::value, std::size_t> compress_store(
+    const V &x, const typename V::mask_type &k, typename V::EntryType *mem)
+{
+    x.scatter(mem, Detail::mask_prefix_count(k), k);
+    return k.count();
+}
+// SimdArray has no scatter member, thus copy the active entries one by one
+template <typename V>
+Vc_INTRINSIC enable_if<Traits::isSimdArray<V>::value, std::size_t> compress_store(
+    const V &x, const typename V::mask_type &k, typename V::EntryType *mem)
+{
+    std::size_t n = 0;
+    for (unsigned int bits = mask_bits(k); bits != 0; bits &= bits - 1) {
+        mem[n++] = x[_bit_scan_forward(bits)];
+    }
+    return n;
+}
+//}}}1
+}  // namespace Detail
+
+/**
+ * \ingroup Utilities
+ * \headerfile maskbits.h <Vc/vector.h>
+ *
+ * Returns the number of \c true entries in \p k before each entry, i.e. the exclusive prefix
+ * popcount of \p k.
+ *
+ * For every active entry \c i, `mask_prefix_count(k)[i]` is the position that entry \c i
+ * takes if the active entries are compressed to the front, e.g. for stream compaction:
+ * \code
+ * const auto k = x > 0;
+ * x.scatter(&out[n], simd_cast<float_v::IndexType>(mask_prefix_count(k)), k);
+ * n += k.count();
+ * \endcode
+ *
+ * \param k A native mask or SimdMaskArray with at most 32 entries.
+ * \returns A SimdArray<int, M::Size> with the prefix counts.
+ */
+template <typename M, typename = enable_if<Traits::is_simd_mask<M>::value>>
+Vc_INTRINSIC SimdArray<int, M::Size> mask_prefix_count(const M &k)
+{
+    return Detail::mask_prefix_count(k);
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile maskbits.h <Vc/vector.h>
+ *
+ * Returns the indexes of the active entries of \p k, in ascending order, in the first
+ * `k.count()` entries. The remaining entries are zero.
+ *
+ * \param k A native mask or SimdMaskArray with at most 32 entries.
+ */
+template <typename M, typename = enable_if<Traits::is_simd_mask<M>::value>>
+Vc_INTRINSIC SimdArray<int, M::Size> mask_to_indexes(const M &k)
+{
+    return Detail::mask_to_indexes(k);
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile maskbits.h <Vc/vector.h>
+ *
+ * Stores the entries of \p x where \p k is \c true to consecutive memory at \p mem, in
+ * ascending order (compress-store). Nothing is written past `mem[k.count() - 1]`.
+ *
+ * \returns The number of entries written, i.e. `k.count()`.
+ */
+template <typename V, typename = enable_if<Traits::is_simd_vector<V>::value>>
+Vc_INTRINSIC std::size_t compress_store(const V &x, const typename V::mask_type &k,
+                                        typename V::EntryType *mem)
+{
+    return Detail::compress_store(x, k, mem);
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile maskbits.h <Vc/vector.h>
+ *
+ * Loads consecutive values from \p mem into the entries of \p x where \p k is \c true
+ * (expand-load). The first active entry receives `mem[0]`, the second `mem[1]`, and so
+ * on. The inactive entries keep their values and nothing is read past
+ * `mem[k.count() - 1]`.
+ */
+template <typename V, typename = enable_if<Traits::is_simd_vector<V>::value>>
+Vc_INTRINSIC void expand_load(V &x, const typename V::EntryType *mem,
+                              const typename V::mask_type &k)
+{
+    x.gather(mem, mask_prefix_count(k), k);
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile maskbits.h <Vc/vector.h>
+ *
+ * Packs the masks in [\p first, \p last) into a dense bitset.
+ *
+ * Entry \c j of mask \c i is stored in bit `(i * M::Size + j) % 64` of `bits[(i * M::Size +
+ * j) / 64]`. The unused bits of the last word are zero.
+ *
+ * \param first The first mask to pack.
+ * \param last One past the last mask to pack.
+ * \param bits The output bitset, with room for `ceil((last - first) * M::Size / 64)` words.
+ * \returns The number of words written to \p bits.
+ */
+template <typename M, typename = enable_if<Traits::is_simd_mask<M>::value>>
+inline std::size_t pack_masks(const M *first, const M *last, std::uint64_t *bits)
+{
+    constexpr unsigned int Size = M::Size;
+    std::size_t n = 0;
+    std::uint64_t word = 0;
+    unsigned int shift = 0;
+    for (; first != last; ++first) {
+        const std::uint64_t b = Detail::mask_bits(*first);
+        word |= b << shift;
+        shift += Size;
+        if (shift >= 64) {
+            bits[n++] = word;
+            shift -= 64;
+            word = shift == 0 ? 0 : b >> (Size - shift);
+        }
+    }
+    if (shift > 0) {
+        bits[n++] = word;
+    }
+    return n;
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile maskbits.h <Vc/vector.h>
+ *
+ * Reverses pack_masks: reads the masks [\p first, \p last) from the dense bitset at \p bits.
+ */
+template <typename M, typename = enable_if<Traits::is_simd_mask<M>::value>>
+inline void unpack_masks(const std::uint64_t *bits, M *first, M *last)
+{
+    constexpr unsigned int Size = M::Size;
+    static_assert(Size <= 32, "the mask bit functions support masks with up to 32 entries");
+    std::size_t bit = 0;
+    for (; first != last; ++first, bit += Size) {
+        const unsigned int shift = bit % 64;
+        std::uint64_t b = bits[bit / 64] >> shift;
+        if (shift + Size > 64) {
+            b |= bits[bit / 64 + 1] << (64 - shift);
+        }
+        *first = Detail::mask_from_bits<M>(b & ((std::uint64_t(1) << Size) - 1));
+    }
+}
+}  // namespace Vc
+
+#undef Vc_MASKBITS_USE_BMI2
+
+#endif  // VC_COMMON_MASKBITS_H_
+
+// vim: foldmethod=marker
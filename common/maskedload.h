@@ -0,0 +1,84 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_MASKEDLOAD_H_
+#define VC_COMMON_MASKEDLOAD_H_
+
+#include <cstdint>
+#include "macros.h"
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+namespace Common
+{
+/**\internal
+ * The smallest page size of all supported targets. Memory protection cannot differ within
+ * a block of this size.
+ */
+constexpr std::size_t MinimumPageSize = 4096;
+
+/**\internal
+ * Returns whether the \p Bytes starting at \p mem lie within a single memory page.
+ */
+template <std::size_t Bytes> Vc_INTRINSIC bool isWithinOnePage(const void *mem)
+{
+    return (reinterpret_cast<std::uintptr_t>(mem) & (MinimumPageSize - 1)) <=
+           MinimumPageSize - Bytes;
+}
+
+/**\internal
+ * Fault-safe masked load for targets without a masked load instruction.
+ *
+ * If at least one entry is active and the vector does not straddle a page boundary, all
+ * entries lie in the same page as the active one(s). Then a full vector load cannot fault
+ * and the loaded values are blended into \p v. Otherwise only the active entries are read.
+ * An aligned vector never straddles a page boundary.
+ */
+template <typename V, typename Flags>
+Vc_INTRINSIC void maskedLoad(V &v, const typename V::EntryType *mem,
+                             const typename V::Mask &k, Flags flags)
+{
+    constexpr std::size_t Bytes = V::Size * sizeof(typename V::EntryType);
+    if (Flags::IsAligned || isWithinOnePage<Bytes>(mem)) {
+        if (Vc_IS_LIKELY(k.isNotEmpty())) {
+            v.assign(V(mem, flags), k);
+        }
+    } else {
+        for (std::size_t i = 0; i < V::Size; ++i) {
+            if (k[i]) {
+                v[i] = mem[i];
+            }
+        }
+    }
+}
+}  // namespace Common
+}  // namespace Vc
+
+#endif  // VC_COMMON_MASKEDLOAD_H_
+
+// vim: foldmethod=marker
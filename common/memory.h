@@ -569,6 +569,66 @@ class Memory<V, Size, 0u, InitPadding>
         }
 };
 
+/**
+ * A non-owning Memory object for an existing, aligned and padded array.
+ *
+ * MemoryView provides the complete MemoryBase interface (vector access, iteration,
+ * arithmetic) for memory that is not allocated by Vc, such as a memory-mapped file or the
+ * buffer of a different container. Use it to work on such data without copying it into a
+ * Memory object.
+ *
+ * The array must be aligned on V::MemoryAlignment and must be accessible (and padded) up to
+ * a multiple of V::Size entries. If the memory is read-only, only the const interface
+ * may be used.
+ *
+ * \ingroup Utilities
+ * \headerfile memory.h <Vc/Memory>
+ */
+template <typename V> class MemoryView : public MemoryBase<V, MemoryView<V>, 1, void>
+{
+public:
+    typedef typename V::EntryType EntryType;
+
+private:
+    typedef MemoryBase<V, MemoryView<V>, 1, void> Base;
+    friend class MemoryBase<V, MemoryView<V>, 1, void>;
+    friend class MemoryDimensionBase<V, MemoryView<V>, 1, void>;
+    size_t m_entriesCount;
+    size_t m_vectorsCount;
+    EntryType *m_mem;
+
+public:
+    using Base::vector;
+
+    /**
+     * Constructs an empty view.
+     */
+    MemoryView() : m_entriesCount(0), m_vectorsCount(0), m_mem(nullptr) {}
+
+    /**
+     * Constructs a view of the \p size entries at \p mem.
+     *
+     * \param mem A pointer aligned on V::MemoryAlignment.
+     * \param size The number of entries. The memory must be padded to the next multiple of
+     *             V::Size.
+     */
+    MemoryView(EntryType *mem, size_t size)
+        : m_entriesCount(size), m_vectorsCount((size + V::Size - 1) / V::Size), m_mem(mem)
+    {
+        assert((reinterpret_cast<size_t>(mem) & (V::MemoryAlignment - 1)) == 0);
+    }
+
+    /**
+     * \return the number of scalar entries in the whole array.
+     */
+    Vc_ALWAYS_INLINE Vc_PURE size_t entriesCount() const { return m_entriesCount; }
+
+    /**
+     * \return the number of vectors in the whole array.
+     */
+    Vc_ALWAYS_INLINE Vc_PURE size_t vectorsCount() const { return m_vectorsCount; }
+};
+
 /**
  * Prefetch the cacheline containing \p addr for a single read access.
  *
@@ -648,6 +708,7 @@ Vc_ALWAYS_INLINE void prefetchFar(const void *addr)
 }  // namespace Common
 
 using Common::Memory;
+using Common::MemoryView;
 using Common::prefetchForOneRead;
 using Common::prefetchForModify;
 using Common::prefetchClose;
@@ -0,0 +1,403 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_NUMERICIO_H_
+#define VC_COMMON_NUMERICIO_H_
+
+#include <cfloat>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "bytescan.h"
+#include "macros.h"
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+namespace Detail
+{
+// numeric_separators {{{1
+/**\internal
+ * The bytes that separate the numbers of a text column: white space, comma, and semicolon.
+ */
+inline const byte_set &numeric_separators()
+{
+    static const byte_set separators(" \t\n\v\f\r,;");
+    return separators;
+}
+
+// eight digits {{{1
+/**\internal
+ * Returns whether the eight bytes in \p v (loaded in little-endian order) are all decimal
+ * digits. Every byte must be in the range 0x30-0x39, i.e. its high nibble is 3 and adding
+ * 6 to it must not carry into the high nibble.
+ */
+Vc_INTRINSIC bool is_eight_digits(std::uint64_t v)
+{
+    return ((v & 0xf0f0f0f0f0f0f0f0ull) |
+            (((v + 0x0606060606060606ull) & 0xf0f0f0f0f0f0f0f0ull) >> 4)) ==
+           0x3333333333333333ull;
+}
+
+/**\internal
+ * Converts eight decimal digits, loaded in little-endian order, to their value. The three
+ * multiplications combine neighbouring digits into pairs, quadruples, and finally the
+ * full number.
+ */
+Vc_INTRINSIC std::uint32_t eight_digits_value(std::uint64_t v)
+{
+    v -= 0x3030303030303030ull;
+    v = (v * 10) + (v >> 8);
+    v = (((v & 0x000000ff000000ffull) * 0x000f424000000064ull) +
+         (((v >> 16) & 0x000000ff000000ffull) * 0x0000271000000001ull)) >>
+        32;
+    return static_cast<std::uint32_t>(v);
+}
+
+// parse_digits {{{1
+/**\internal
+ * Appends the decimal digits at \p p to \p value, eight at a time while possible, and
+ * returns the pointer past the last digit. \p count is incremented by the number of
+ * digits. Digits beyond the 19th are counted but not accumulated.
+ */
+Vc_INTRINSIC const char *parse_digits(const char *p, const char *last,
+                                      std::uint64_t &value, int &count)
+{
+    while (last - p >= 8 && count <= 11) {
+        std::uint64_t chunk;
+        std::memcpy(&chunk, p, 8);
+        if (!is_eight_digits(chunk)) {
+            break;
+        }
+        value = value * 100000000u + eight_digits_value(chunk);
+        count += 8;
+        p += 8;
+    }
+    for (; p != last && static_cast<unsigned char>(*p - '0') < 10; ++p) {
+        if (count < 19) {
+            value = value * 10 + static_cast<unsigned>(*p - '0');
+        }
+        ++count;
+    }
+    return p;
+}
+
+// DecimalToken {{{1
+/**\internal
+ * A number of the form `[+-]digits[.digits][(e|E)[+-]digits]`, with the value
+ * `mantissa * 10^exponent`.
+ */
+struct DecimalToken
+{
+    std::uint64_t mantissa;
+    int exponent;
+    bool negative;
+};
+
+/**\internal
+ * Parses `[first, last)` into \p r. Returns \c false if the token does not match the
+ * grammar of DecimalToken or has more than 19 significant digits. Such tokens must be
+ * handed to strtof.
+ */
+inline bool parse_decimal(const char *first, const char *last, DecimalToken &r)
+{
+    const char *p = first;
+    r.negative = *p == '-';
+    if (*p == '-' || *p == '+') {
+        ++p;
+    }
+    while (p != last && *p == '0') {  // leading zeros are not significant
+        ++p;
+    }
+    const bool hadLeadingZero = p != first && p[-1] == '0';
+    std::uint64_t mantissa = 0;
+    int digits = 0;
+    const char *integerEnd = parse_digits(p, last, mantissa, digits);
+    int exponent = 0;
+    bool anyDigit = hadLeadingZero || integerEnd != p;
+    p = integerEnd;
+    if (p != last && *p == '.') {
+        ++p;
+        if (digits == 0) {
+            const char *const fraction = p;
+            while (p != last && *p == '0') {
+                ++p;
+            }
+            exponent = -int(p - fraction);
+            anyDigit |= p != fraction;
+        }
+        const int integerDigits = digits;
+        const char *const fractionEnd = parse_digits(p, last, mantissa, digits);
+        anyDigit |= fractionEnd != p;
+        exponent -= digits - integerDigits;
+        p = fractionEnd;
+    }
+    if (!anyDigit || digits > 19) {
+        return false;
+    }
+    if (p != last && (*p == 'e' || *p == 'E')) {
+        ++p;
+        const bool negativeExponent = p != last && *p == '-';
+        if (p != last && (*p == '-' || *p == '+')) {
+            ++p;
+        }
+        if (p == last) {
+            return false;
+        }
+        int e = 0;
+        for (; p != last && static_cast<unsigned char>(*p - '0') < 10; ++p) {
+            if (e < 100000) {
+                e = e * 10 + (*p - '0');
+            }
+        }
+        exponent += negativeExponent ? -e : e;
+    }
+    r.mantissa = mantissa;
+    r.exponent = exponent;
+    return p == last;
+}
+
+// strtof_token {{{1
+/**\internal
+ * Converts the token `[first, last)` with strtof. Returns \c false if strtof does not
+ * consume the complete token.
+ */
+inline bool strtof_token(const char *first, const char *last, float &r)
+{
+    const std::string token(first, last);
+    char *end;
+    r = std::strtof(token.c_str(), &end);
+    return end == token.c_str() + token.size() && !token.empty();
+}
+
+// format_float {{{1
+/**\internal
+ * Writes the shortest representation of \p x that std::to_chars(first, last, x) writes,
+ * and returns the number of characters (at most 14). Implemented in src/numericio.cpp.
+ */
+std::size_t format_float(float x, char *out);
+//}}}1
+}  // namespace Detail
+
+/**
+ * \ingroup Utilities
+ * \headerfile numericio.h <Vc/NumericIO>
+ *
+ * Parses the numbers in the text `[text, text + length)` to \p out and returns the number
+ * of values written.
+ *
+ * The numbers are separated by any sequence of white space, commas, and semicolons. Each
+ * value is bit-identical to the result of \c strtof (in the "C" locale) for the same
+ * token. Parsing stops at the first token that \c strtof does not consume completely.
+ *
+ * The token boundaries are found with find_first_of. The digits are converted eight at a
+ * time and a batch of double_v::Size tokens is scaled by their powers of ten in one vector
+ * operation. This is exact (and thus correctly rounded) for up to 2^53 and exponents up to
+ * 22; rare tokens outside this range, and results that would need a second rounding
+ * step, are handed to \c strtof.
+ *
+ * \param text The text to parse.
+ * \param length The number of bytes in \p text.
+ * \param out The destination. It must have room for `(length + 1) / 2` values.
+ * \param stop If not \c nullptr, receives the pointer to the token that stopped parsing,
+ *             or the end of the text.
+ */
+inline std::size_t parse_floats(const char *text, std::size_t length, float *out,
+                                const char **stop = nullptr)
+{
+    constexpr std::size_t Batch = double_v::Size;
+    alignas(double_v::MemoryAlignment) static const double powersOfTen[23] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const byte_set &separators = Detail::numeric_separators();
+    const char *p = text;
+    const char *const last = text + length;
+    std::size_t n = 0;
+    for (;;) {
+        alignas(double_v::MemoryAlignment) double mantissas[Batch];
+        alignas(double_v::MemoryAlignment) double scaled[Batch];
+        int exponents[Batch];
+        const char *tokens[Batch];
+        const char *ends[Batch];
+        bool exact[Batch];
+        std::size_t k = 0;
+        for (; k < Batch; ++k) {
+            while (p != last && separators.contains(*p)) {
+                ++p;
+            }
+            if (p == last) {
+                break;
+            }
+            const char *end = find_first_of(p, last, separators);
+            Detail::DecimalToken t;
+            exact[k] = Detail::parse_decimal(p, end, t) && t.mantissa <= (1ull << 53) &&
+                       t.exponent >= -22 && t.exponent <= 22;
+            const double m = exact[k] ? double(t.mantissa) : 0.;
+            mantissas[k] = t.negative ? -m : m;
+            exponents[k] = exact[k] ? t.exponent : 0;
+            tokens[k] = p;
+            ends[k] = end;
+            p = end;
+        }
+        if (k == 0) {
+            break;
+        }
+        for (std::size_t i = k; i < Batch; ++i) {
+            mantissas[i] = 0;
+            exponents[i] = 0;
+        }
+
+        // m * 10^e and m / 10^-e are correctly rounded doubles
+        typedef SimdArray<int, Batch> IV;
+        const IV e(&exponents[0]);
+        const double_v m(&mantissas[0], Vc::Aligned);
+        const double_v scale(&powersOfTen[0], simd_cast<double_v::IndexType>(abs(e)));
+        const double_v r = iif(simd_cast<double_v::Mask>(e < 0), m / scale, m * scale);
+        r.store(&scaled[0], Vc::Aligned);
+
+        for (std::size_t i = 0; i < k; ++i) {
+            // The conversion to float rounds a second time. The result is only wrong if
+            // the double is exactly halfway between two floats, or if the float is
+            // subnormal, has overflowed, or the token needs strtof anyway.
+            const double d = scaled[i];
+            std::uint64_t bits;
+            std::memcpy(&bits, &d, 8);
+            const double magnitude = d < 0 ? -d : d;
+            const bool rounded = exact[i] && (bits & 0x1fffffffu) != 0x10000000u &&
+                                 (d == 0 || (magnitude >= FLT_MIN && magnitude <= FLT_MAX));
+            if (rounded) {
+                out[n++] = static_cast<float>(d);
+            } else if (Detail::strtof_token(tokens[i], ends[i], out[n])) {
+                ++n;
+            } else {
+                if (stop) {
+                    *stop = tokens[i];
+                }
+                return n;
+            }
+        }
+    }
+    if (stop) {
+        *stop = last;
+    }
+    return n;
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile numericio.h <Vc/NumericIO>
+ *
+ * Parses the integers in the text `[text, text + length)` to \p out and returns the
+ * number of values written.
+ *
+ * The numbers are separated like for parse_floats. Each token must have the form
+ * `[+-]digits` and its value must be representable as \c int. Then the value is identical
+ * to the result of \c strtol. Parsing stops at the first token that does not satisfy this.
+ *
+ * \param text The text to parse.
+ * \param length The number of bytes in \p text.
+ * \param out The destination. It must have room for `(length + 1) / 2` values.
+ * \param stop If not \c nullptr, receives the pointer to the token that stopped parsing,
+ *             or the end of the text.
+ */
+inline std::size_t parse_ints(const char *text, std::size_t length, int *out,
+                              const char **stop = nullptr)
+{
+    const byte_set &separators = Detail::numeric_separators();
+    const char *p = text;
+    const char *const last = text + length;
+    std::size_t n = 0;
+    for (;;) {
+        while (p != last && separators.contains(*p)) {
+            ++p;
+        }
+        if (p == last) {
+            break;
+        }
+        const char *const end = find_first_of(p, last, separators);
+        const char *q = p;
+        const bool negative = *q == '-';
+        if (*q == '-' || *q == '+') {
+            ++q;
+        }
+        const char *const digitsBegin = q;
+        while (q != end && *q == '0') {
+            ++q;
+        }
+        std::uint64_t value = 0;
+        int digits = 0;
+        const char *const digitsEnd = Detail::parse_digits(q, end, value, digits);
+        if (digitsEnd == digitsBegin || digitsEnd != end || digits > 19 ||
+            value > std::uint64_t(INT_MAX) + negative) {
+            if (stop) {
+                *stop = p;
+            }
+            return n;
+        }
+        out[n++] = static_cast<int>(negative ? -static_cast<std::int64_t>(value)
+                                              : static_cast<std::int64_t>(value));
+        p = end;
+    }
+    if (stop) {
+        *stop = last;
+    }
+    return n;
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile numericio.h <Vc/NumericIO>
+ *
+ * Writes the \p count values at \p values as text to \p out, each followed by \p
+ * separator, and returns the number of characters written.
+ *
+ * Every value is written exactly like `std::to_chars(first, last, value)` writes it: the
+ * shortest representation that parses back to the same float, in fixed or scientific
+ * notation, whichever is shorter. Thus parse_floats restores the values bit-identically.
+ *
+ * \param values The floats to format.
+ * \param count The number of values.
+ * \param out The destination. It must have room for 15 characters per value.
+ * \param separator The character written after every value.
+ */
+inline std::size_t format_floats(const float *values, std::size_t count, char *out,
+                                 char separator = '\n')
+{
+    char *p = out;
+    for (std::size_t i = 0; i < count; ++i) {
+        p += Detail::format_float(values[i], p);
+        *p++ = separator;
+    }
+    return p - out;
+}
+}  // namespace Vc
+
+#endif  // VC_COMMON_NUMERICIO_H_
+
+// vim: foldmethod=marker
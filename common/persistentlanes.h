@@ -0,0 +1,125 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_PERSISTENTLANES_H_
+#define VC_COMMON_PERSISTENTLANES_H_
+
+#include <algorithm>
+#include "maskbits.h"
+#include "macros.h"
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+/**
+ * \ingroup Utilities
+ * \headerfile persistentlanes.h <Vc/vector.h>
+ *
+ * Processes the work items `0, 1, ..., count - 1` in the lanes (entries) of the vector
+ * type \p V, where every work item needs a different number of iterations.
+ *
+ * A plain vectorized loop iterates until the slowest lane of a vector is done, leaving the
+ * other lanes idle. Here, a lane that finishes its work item is refilled with the next
+ * work item right away, so that all lanes stay busy until the work items run out:
+ * -# \p start initializes the state of the lanes for the given work items,
+ * -# \p step advances all active lanes by one iteration and returns the lanes that are done,
+ * -# \p finish emits the results of the done lanes,
+ * -# the done lanes receive the next work items (in ascending order, as an expand-load of
+ *    consecutive indexes) and \p start is called for them.
+ *
+ * Refilling costs a few extra instructions and a hard to predict branch. It pays off if
+ * the number of iterations varies a lot between neighboring work items (the Collatz
+ * kernel in examples/persistent_lanes is about 1.3x faster than the plain loop with AVX2),
+ * but not if the plain loop keeps most lanes busy anyway (Mandelbrot: about 0.7x).
+ *
+ * The state of the lanes is owned by the caller, usually in vector variables captured by
+ * reference in the function objects. \p start and \p finish receive the work item
+ * indexes of all lanes and a mask that selects the lanes to act on; they should only
+ * modify the selected lanes, e.g. with Vc::where:
+ * \code
+ * float_v z, c;
+ * Vc::persistent_lanes<float_v>(
+ *     count,
+ *     [&](Vc::SimdArray<int, float_v::Size> item, float_m lanes) {
+ *         where(lanes) | c = simd_cast<float_v>(item) * scale;
+ *         where(lanes) | z = 0.f;
+ *     },
+ *     [&](float_m active) {
+ *         z = z * z + c;
+ *         return z > 2.f;
+ *     },
+ *     [&](Vc::SimdArray<int, float_v::Size> item, float_m done) {
+ *         z.scatter(result, item, done);  // or Vc::compress_store for a result stream
+ *     });
+ * \endcode
+ *
+ * \tparam V The vector type whose entries are the lanes.
+ * \param count The number of work items.
+ * \param start Called as `start(items, lanes)`, with `items` a SimdArray<int, V::Size> and
+ *              `lanes` a `V::mask_type`.
+ * \param step Called as `step(active)` and must return a `V::mask_type` where the lanes
+ *             that finished their work item in this iteration are \c true. Inactive lanes
+ *             may be modified, but their return value is ignored.
+ * \param finish Called as `finish(items, done)`, for every finished work item exactly once.
+ */
+template <typename V, typename Start, typename Step, typename Finish>
+Vc_ALWAYS_INLINE void persistent_lanes(std::size_t count, Start &&start, Step &&step,
+                                       Finish &&finish)
+{
+    typedef SimdArray<int, V::Size> I;
+    typedef typename V::mask_type M;
+    typedef typename I::mask_type IM;
+    if (count == 0) {
+        return;
+    }
+    I items = I::IndexesFromZero();
+    M active = simd_cast<M>(items < int(count));
+    std::size_t next = std::min(count, std::size_t(V::Size));
+    start(items, active);
+    while (!active.isEmpty()) {
+        const M done = step(active) && active;
+        if (done.isEmpty()) {
+            continue;
+        }
+        finish(items, done);
+        active = active && !done;
+        if (next < count) {
+            // the done lanes take the next items: next + 0, next + 1, ... in lane order
+            const I refill = int(next) + mask_prefix_count(done);
+            const M fresh = done && simd_cast<M>(refill < int(count));
+            where(simd_cast<IM>(fresh)) | items = refill;
+            start(items, fresh);
+            active = active || fresh;
+            next = std::min(count, next + done.count());
+        }
+    }
+}
+}  // namespace Vc
+
+#endif  // VC_COMMON_PERSISTENTLANES_H_
+
+// vim: foldmethod=marker
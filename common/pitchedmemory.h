@@ -0,0 +1,512 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_PITCHEDMEMORY_H_
+#define VC_COMMON_PITCHEDMEMORY_H_
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <Vc/cpuid.h>
+#include "memorybase.h"
+#include "malloc.h"
+#include "macros.h"
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+namespace Common
+{
+// MemoryTile {{{1
+/**
+ * \ingroup Utilities
+ * \headerfile pitchedmemory.h <Vc/Memory>
+ *
+ * Describes a rectangular block of a PitchedMemory object.
+ *
+ * The range in the innermost dimension always starts at a multiple of \c V::Size and
+ * extends to a multiple of \c V::Size (possibly reaching into the row padding). Thus the
+ * entries of a tile row can be accessed with aligned vector loads and stores.
+ */
+template <std::size_t Dimension> class MemoryTile
+{
+    template <std::size_t> friend class MemoryTileIterator;
+    std::array<size_t, Dimension> m_first;
+    std::array<size_t, Dimension> m_last;
+
+public:
+    /// Returns the first index of the tile in dimension \p d.
+    size_t begin(size_t d) const { return m_first[d]; }
+    /// Returns the index one past the last index of the tile in dimension \p d.
+    size_t end(size_t d) const { return m_last[d]; }
+    /// Returns the number of indexes the tile covers in dimension \p d.
+    size_t size(size_t d) const { return m_last[d] - m_first[d]; }
+};
+
+// MemoryTileIterator {{{1
+/**
+ * \ingroup Utilities
+ * \headerfile pitchedmemory.h <Vc/Memory>
+ *
+ * A forward iterator over all tiles of a PitchedMemory object. The tiles are visited in
+ * row-major order, i.e. neighbouring tiles in the innermost dimension are visited one after
+ * another.
+ */
+template <std::size_t Dimension> class MemoryTileIterator
+{
+    std::array<size_t, Dimension> m_extents;
+    std::array<size_t, Dimension> m_shape;
+    MemoryTile<Dimension> m_tile;
+
+    void updateLast()
+    {
+        for (size_t d = 0; d < Dimension; ++d) {
+            m_tile.m_last[d] = std::min(m_tile.m_first[d] + m_shape[d], m_extents[d]);
+        }
+    }
+
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef MemoryTile<Dimension> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const MemoryTile<Dimension> *pointer;
+    typedef const MemoryTile<Dimension> &reference;
+
+    MemoryTileIterator(const std::array<size_t, Dimension> &extents,
+                       const std::array<size_t, Dimension> &shape, bool atEnd)
+        : m_extents(extents), m_shape(shape)
+    {
+        m_tile.m_first.fill(0);
+        if (atEnd) {
+            m_tile.m_first[0] = m_extents[0];
+        }
+        updateLast();
+    }
+
+    reference operator*() const { return m_tile; }
+    pointer operator->() const { return &m_tile; }
+
+    MemoryTileIterator &operator++()
+    {
+        for (size_t d = Dimension - 1; d > 0; --d) {
+            m_tile.m_first[d] += m_shape[d];
+            if (m_tile.m_first[d] < m_extents[d]) {
+                updateLast();
+                return *this;
+            }
+            m_tile.m_first[d] = 0;
+        }
+        m_tile.m_first[0] += m_shape[0];
+        if (m_tile.m_first[0] >= m_extents[0]) {
+            m_tile.m_first[0] = m_extents[0];
+        }
+        updateLast();
+        return *this;
+    }
+    MemoryTileIterator operator++(int)
+    {
+        MemoryTileIterator r = *this;
+        ++*this;
+        return r;
+    }
+
+    bool operator==(const MemoryTileIterator &rhs) const
+    {
+        return m_tile.m_first == rhs.m_tile.m_first;
+    }
+    bool operator!=(const MemoryTileIterator &rhs) const { return !operator==(rhs); }
+};
+
+// MemoryTileRange {{{1
+/**
+ * \ingroup Utilities
+ * \headerfile pitchedmemory.h <Vc/Memory>
+ *
+ * The return type of PitchedMemory::tiles. Use it in a range-based for loop.
+ */
+template <std::size_t Dimension> class MemoryTileRange
+{
+    std::array<size_t, Dimension> m_extents;
+    std::array<size_t, Dimension> m_shape;
+
+public:
+    MemoryTileRange(const std::array<size_t, Dimension> &extents,
+                    const std::array<size_t, Dimension> &shape)
+        : m_extents(extents), m_shape(shape)
+    {
+    }
+
+    /// Returns the extents of a (complete) tile.
+    const std::array<size_t, Dimension> &shape() const { return m_shape; }
+
+    MemoryTileIterator<Dimension> begin() const { return {m_extents, m_shape, false}; }
+    MemoryTileIterator<Dimension> end() const { return {m_extents, m_shape, true}; }
+};
+
+// PitchedMemory {{{1
+/**
+ * \ingroup Utilities
+ * \headerfile pitchedmemory.h <Vc/Memory>
+ *
+ * A dynamically sized, multi-dimensional array with aligned and padded rows.
+ *
+ * The innermost (last) dimension is stored contiguously. Every row starts at an address
+ * aligned to \c V::MemoryAlignment and is padded to the row pitch, which is a multiple of
+ * \c V::Size. Thus every row can be processed with aligned vector loads and stores only.
+ * The padding is initialized to zero.
+ *
+ * If the row pitch is chosen automatically it is increased by one cache line whenever the
+ * pitch in Bytes is a multiple of 512. Otherwise every n-th row would map to the same
+ * cache sets and column-wise access patterns (e.g. stencils or the inner loop of a matrix
+ * product) would continuously evict their own data.
+ *
+ * Example:
+ * \code
+ * Vc::PitchedMemory<float_v, 2> grid(rows, cols);
+ * for (const auto &tile : grid.l1Tiles()) {
+ *   for (size_t i = tile.begin(0); i < tile.end(0); ++i) {
+ *     for (size_t j = tile.begin(1); j < tile.end(1); j += float_v::Size) {
+ *       grid.vector(i, j / float_v::Size) *= 2.f;
+ *     }
+ *   }
+ * }
+ * \endcode
+ *
+ * \param V The vector type you want to operate on. (e.g. float_v or uint_v)
+ * \param Dimension The number of dimensions. The last index addresses the contiguous
+ *                  dimension.
+ */
+template <typename V, std::size_t Dimension> class PitchedMemory
+{
+    static_assert(Dimension >= 2, "PitchedMemory requires at least two dimensions. Use "
+                                  "Vc::Memory<V> for one-dimensional arrays.");
+
+public:
+    typedef typename V::EntryType EntryType;
+
+private:
+    std::array<size_t, Dimension> m_extents;
+    // m_strides[d] is the distance in entries between two neighbouring indexes in dimension
+    // d. The stride of the innermost dimension is always 1.
+    std::array<size_t, Dimension> m_strides;
+    EntryType *m_mem;
+
+    static size_t paddedSize(size_t n)
+    {
+        return (n + V::Size - 1) / V::Size * V::Size;
+    }
+
+    // the indexes start at dimension D
+    template <size_t D = 0, typename... Indexes>
+    size_t offset(size_t i, Indexes... rest) const
+    {
+        static_assert(D + sizeof...(Indexes) < Dimension, "too many indexes");
+        return i * m_strides[D] + offset<D + 1>(rest...);
+    }
+    template <size_t D> size_t offset() const { return 0; }
+
+    // as above, but the last index counts vectors instead of entries
+    template <size_t D = 0, typename... Indexes>
+    size_t vectorOffset(size_t i, size_t j, Indexes... rest) const
+    {
+        return i * m_strides[D] + vectorOffset<D + 1>(j, rest...);
+    }
+    template <size_t D> size_t vectorOffset(size_t i) const { return i * V::Size; }
+
+    void allocate()
+    {
+        const size_t n = m_extents[0] * m_strides[0];
+        m_mem = Vc::malloc<EntryType, Vc::AlignOnCacheline>(n);
+        std::memset(m_mem, 0, n * sizeof(EntryType));
+    }
+
+    void initStrides(size_t rowPitch)
+    {
+        Vc_ASSERT(rowPitch >= m_extents[Dimension - 1] && rowPitch % V::Size == 0);
+        m_strides[Dimension - 1] = 1;
+        m_strides[Dimension - 2] = rowPitch;
+        for (size_t d = Dimension - 2; d > 0; --d) {
+            m_strides[d - 1] = m_strides[d] * m_extents[d];
+        }
+    }
+
+public:
+    /**
+     * Returns the row pitch (in entries) that is used if none is given to the constructor.
+     *
+     * \param columns The number of entries in the innermost dimension.
+     */
+    static size_t defaultPitch(size_t columns)
+    {
+        size_t pitch = paddedSize(columns);
+        if ((pitch * sizeof(EntryType)) % 512 == 0) {
+            pitch += paddedSize((64 + sizeof(EntryType) - 1) / sizeof(EntryType));
+        }
+        return pitch;
+    }
+
+    /**
+     * Allocates an array with the given extents. The last extent is the number of entries
+     * in a row.
+     *
+     * \code
+     * Vc::PitchedMemory<float_v, 3> volume(nz, ny, nx);
+     * \endcode
+     */
+    template <typename... Extents,
+              typename = enable_if<sizeof...(Extents) == Dimension>>
+    explicit PitchedMemory(Extents... extents)
+        : m_extents{{static_cast<size_t>(extents)...}}
+    {
+        initStrides(defaultPitch(m_extents[Dimension - 1]));
+        allocate();
+    }
+
+    /**
+     * Allocates an array with the given extents and an explicit row pitch.
+     *
+     * \param extents The number of indexes in each dimension.
+     * \param rowPitch The distance (in entries) between the starts of two rows. It must be a
+     *                 multiple of \c V::Size and at least as large as the last extent.
+     */
+    PitchedMemory(const std::array<size_t, Dimension> &extents, size_t rowPitch)
+        : m_extents(extents)
+    {
+        initStrides(rowPitch);
+        allocate();
+    }
+
+    /**
+     * Copies the extents, the pitch and the data of \p rhs.
+     */
+    PitchedMemory(const PitchedMemory &rhs)
+        : m_extents(rhs.m_extents), m_strides(rhs.m_strides)
+    {
+        allocate();
+        std::memcpy(m_mem, rhs.m_mem, m_extents[0] * m_strides[0] * sizeof(EntryType));
+    }
+
+    PitchedMemory(PitchedMemory &&rhs)
+        : m_extents(rhs.m_extents), m_strides(rhs.m_strides), m_mem(rhs.m_mem)
+    {
+        rhs.m_mem = nullptr;
+    }
+
+    PitchedMemory &operator=(PitchedMemory rhs)
+    {
+        swap(rhs);
+        return *this;
+    }
+
+    ~PitchedMemory() { Vc::free(m_mem); }
+
+    /**
+     * Swap the contents and size information of two PitchedMemory objects.
+     */
+    void swap(PitchedMemory &rhs)
+    {
+        std::swap(m_extents, rhs.m_extents);
+        std::swap(m_strides, rhs.m_strides);
+        std::swap(m_mem, rhs.m_mem);
+    }
+
+    /// Returns the number of indexes in dimension \p d.
+    size_t size(size_t d) const { return m_extents[d]; }
+    /// Returns the distance (in entries) between two neighbouring indexes in dimension \p d.
+    size_t stride(size_t d) const { return m_strides[d]; }
+    /// Returns the distance (in entries) between the starts of two neighbouring rows.
+    size_t pitch() const { return m_strides[Dimension - 2]; }
+    /// Returns the number of vectors needed to cover one row (without the extra padding).
+    size_t vectorsPerRow() const { return paddedSize(m_extents[Dimension - 1]) / V::Size; }
+    /// Returns the number of scalar entries, not counting any padding.
+    size_t entriesCount() const
+    {
+        size_t n = 1;
+        for (size_t e : m_extents) {
+            n *= e;
+        }
+        return n;
+    }
+
+    /// Returns a pointer to the first entry.
+    EntryType *entries() { return m_mem; }
+    /// Const overload of the above function.
+    const EntryType *entries() const { return m_mem; }
+
+    /**
+     * Returns an aligned pointer to the first entry of the row identified by the \c
+     * Dimension - 1 outer indexes.
+     */
+    template <typename... Indexes>
+    enable_if<sizeof...(Indexes) == Dimension - 1, EntryType *> row(Indexes... outer)
+    {
+        return m_mem + offset(static_cast<size_t>(outer)...);
+    }
+    /// Const overload of the above function.
+    template <typename... Indexes>
+    enable_if<sizeof...(Indexes) == Dimension - 1, const EntryType *> row(Indexes... outer) const
+    {
+        return m_mem + offset(static_cast<size_t>(outer)...);
+    }
+
+    /**
+     * Scalar access to the entry identified by \c Dimension indexes.
+     */
+    template <typename... Indexes>
+    enable_if<sizeof...(Indexes) == Dimension, EntryType &> operator()(Indexes... indexes)
+    {
+        return m_mem[offset(static_cast<size_t>(indexes)...)];
+    }
+    /// Const overload of the above function.
+    template <typename... Indexes>
+    enable_if<sizeof...(Indexes) == Dimension, const EntryType &> operator()(
+        Indexes... indexes) const
+    {
+        return m_mem[offset(static_cast<size_t>(indexes)...)];
+    }
+
+    /**
+     * Returns a smart object to wrap the vector identified by the outer indexes and the
+     * vector index in the row (i.e. the last argument counts vectors, not entries).
+     *
+     * Only aligned loads and stores are used.
+     */
+    template <typename... Indexes>
+    enable_if<sizeof...(Indexes) == Dimension, MemoryVector<V, AlignedTag> &> vector(
+        Indexes... indexes)
+    {
+        return *new (&m_mem[vectorOffset(static_cast<size_t>(indexes)...)])
+            MemoryVector<V, AlignedTag>;
+    }
+    /// Const overload of the above function.
+    template <typename... Indexes>
+    enable_if<sizeof...(Indexes) == Dimension, MemoryVector<const V, AlignedTag> &> vector(
+        Indexes... indexes) const
+    {
+        return *new (const_cast<EntryType *>(
+            &m_mem[vectorOffset(static_cast<size_t>(indexes)...)]))
+            MemoryVector<const V, AlignedTag>;
+    }
+
+    /**
+     * Returns a smart object to wrap the vector starting at the entry identified by \c
+     * Dimension indexes. Unaligned loads and stores are used.
+     */
+    template <typename... Indexes>
+    enable_if<sizeof...(Indexes) == Dimension, MemoryVector<V, UnalignedTag> &> vectorAt(
+        Indexes... indexes)
+    {
+        return *new (&m_mem[offset(static_cast<size_t>(indexes)...)])
+            MemoryVector<V, UnalignedTag>;
+    }
+    /// Const overload of the above function.
+    template <typename... Indexes>
+    enable_if<sizeof...(Indexes) == Dimension, MemoryVector<const V, UnalignedTag> &>
+    vectorAt(Indexes... indexes) const
+    {
+        return *new (const_cast<EntryType *>(&m_mem[offset(static_cast<size_t>(indexes)...)]))
+            MemoryVector<const V, UnalignedTag>;
+    }
+
+    /**
+     * Returns a range over all blocks of the given \p shape that cover the array.
+     *
+     * The extent of \p shape in the innermost dimension is rounded up to a multiple of \c
+     * V::Size.
+     */
+    MemoryTileRange<Dimension> tiles(std::array<size_t, Dimension> shape) const
+    {
+        std::array<size_t, Dimension> extents = m_extents;
+        extents[Dimension - 1] = paddedSize(extents[Dimension - 1]);
+        for (size_t d = 0; d < Dimension; ++d) {
+            shape[d] = std::max<size_t>(1, shape[d]);
+        }
+        shape[Dimension - 1] = paddedSize(shape[Dimension - 1]);
+        return {extents, shape};
+    }
+
+    /**
+     * Returns a range over tiles that each occupy at most half of \p cacheSize Bytes.
+     *
+     * The tiles are as wide as possible in the innermost dimension (up to the square root
+     * of the number of entries that fit), since hardware prefetchers work best on long
+     * contiguous runs.
+     */
+    MemoryTileRange<Dimension> cacheTiles(size_t cacheSize) const
+    {
+        size_t budget = std::max<size_t>(V::Size, cacheSize / 2 / sizeof(EntryType));
+        std::array<size_t, Dimension> shape;
+        const size_t width = std::max<size_t>(
+            V::Size,
+            std::min(paddedSize(m_extents[Dimension - 1]),
+                     static_cast<size_t>(std::sqrt(static_cast<double>(budget))) / V::Size *
+                         V::Size));
+        shape[Dimension - 1] = width;
+        budget = std::max<size_t>(1, budget / width);
+        for (size_t d = Dimension - 1; d > 0; --d) {
+            shape[d - 1] = std::max<size_t>(1, std::min(m_extents[d - 1], budget));
+            budget = std::max<size_t>(1, budget / shape[d - 1]);
+        }
+        return tiles(shape);
+    }
+
+    /// Returns cacheTiles for the L1 data cache size reported by CpuId.
+    MemoryTileRange<Dimension> l1Tiles() const
+    {
+        CpuId::init();
+        return cacheTiles(CpuId::L1Data() > 0 ? CpuId::L1Data() : 32 * 1024);
+    }
+
+    /// Returns cacheTiles for the L2 cache size reported by CpuId.
+    MemoryTileRange<Dimension> l2Tiles() const
+    {
+        CpuId::init();
+        return cacheTiles(CpuId::L2Data() > 0 ? CpuId::L2Data() : 256 * 1024);
+    }
+};
+//}}}1
+}  // namespace Common
+
+using Common::MemoryTile;
+using Common::MemoryTileRange;
+using Common::PitchedMemory;
+}  // namespace Vc
+
+namespace std
+{
+template <typename V, std::size_t Dimension>
+Vc_ALWAYS_INLINE void swap(Vc::PitchedMemory<V, Dimension> &a,
+                           Vc::PitchedMemory<V, Dimension> &b)
+{
+    a.swap(b);
+}
+}  // namespace std
+
+#endif  // VC_COMMON_PITCHEDMEMORY_H_
+
+// vim: foldmethod=marker
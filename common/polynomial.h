@@ -0,0 +1,232 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_POLYNOMIAL_H_
+#define VC_COMMON_POLYNOMIAL_H_
+
+#include <cstddef>
+#include <type_traits>
+#include "fastfma.h"
+#include "macros.h"
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+namespace Detail
+{
+// Estrin {{{1
+/**\internal
+ * Evaluates the N coefficients starting at \p Begin with Estrin's scheme: the upper and
+ * the lower part are independent polynomials, combined as upper * x^H + lower with the
+ * largest power of two H < N. \p powers holds x, x^2, x^4, ...
+ */
+template <std::size_t Begin, std::size_t N> struct Estrin
+{
+    static constexpr std::size_t H = N > 2 ? 2 * Estrin<0, (N + 1) / 2>::H : 1;
+    static constexpr std::size_t Level = N > 2 ? Estrin<0, (N + 1) / 2>::Level + 1 : 0;
+
+    template <typename V, typename T>
+    static Vc_INTRINSIC V eval(const V *powers, const T *c)
+    {
+        return fastFma(Estrin<Begin + H, N - H>::eval(powers, c), powers[Level],
+                       Estrin<Begin, H>::eval(powers, c));
+    }
+};
+template <std::size_t Begin> struct Estrin<Begin, 1>
+{
+    static constexpr std::size_t H = 1;
+    static constexpr std::size_t Level = 0;
+    template <typename V, typename T> static Vc_INTRINSIC V eval(const V *, const T *c)
+    {
+        return V(c[Begin]);
+    }
+};
+
+// the number of powers x, x^2, x^4, ... Estrin<0, N> needs
+constexpr std::size_t estrinLevels(std::size_t n) { return n > 2 ? 1 + estrinLevels((n + 1) / 2) : 1; }
+
+// estrinTail {{{1
+// evaluates n < 8 coefficients with the unrolled Estrin<0, n>
+template <typename V, typename T>
+Vc_INTRINSIC V estrinTail(const V *powers, const T *c, std::size_t n)
+{
+    switch (n) {
+    case 1: return Estrin<0, 1>::eval(powers, c);
+    case 2: return Estrin<0, 2>::eval(powers, c);
+    case 3: return Estrin<0, 3>::eval(powers, c);
+    case 4: return Estrin<0, 4>::eval(powers, c);
+    case 5: return Estrin<0, 5>::eval(powers, c);
+    case 6: return Estrin<0, 6>::eval(powers, c);
+    case 7: return Estrin<0, 7>::eval(powers, c);
+    default: return V::Zero();
+    }
+}
+//}}}1
+}  // namespace Detail
+
+/**
+ * \ingroup Utilities
+ * \headerfile polynomial.h <Vc/Polynomial>
+ *
+ * Evaluates the polynomial \f$c_0 + c_1 x + \ldots + c_{N-1} x^{N-1}\f$ with Horner's
+ * scheme: one (fused, if the target supports FMA) multiply-add per coefficient, but every
+ * step depends on the previous one. This is the best choice if there are enough independent
+ * evaluations to fill the pipeline (throughput bound loops).
+ *
+ * The coefficients are given in ascending order, as a braced list or an array:
+ * \code
+ * float_v y = Vc::horner(x, {1.f, 1.f, 0.5f, 1.f / 6});
+ * \endcode
+ * The degree is known at compile time and the scheme is fully unrolled.
+ */
+template <typename V, typename T, std::size_t N> Vc_INTRINSIC V horner(const V &x, const T (&c)[N])
+{
+    V r(c[N - 1]);
+    Common::unrolled_loop<std::size_t, 1, N>(
+        [&](std::size_t i) { r = Detail::fastFma(r, x, V(c[N - 1 - i])); });
+    return r;
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile polynomial.h <Vc/Polynomial>
+ *
+ * Evaluates the polynomial with the \p n coefficients \p c (ascending order, determined at
+ * runtime) with Horner's scheme. Returns 0 for \p n == 0.
+ *
+ * The loop over the coefficients cannot be unrolled, which makes this variant slower than
+ * the runtime estrin() even in throughput bound code (see examples/polynomial).
+ */
+template <typename V, typename T> Vc_INTRINSIC V horner(const V &x, const T *c, std::size_t n)
+{
+    if (n == 0) {
+        return V::Zero();
+    }
+    V r(c[n - 1]);
+    for (std::size_t i = n - 1; i > 0; --i) {
+        r = Detail::fastFma(r, x, V(c[i - 1]));
+    }
+    return r;
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile polynomial.h <Vc/Polynomial>
+ *
+ * Evaluates the polynomial with Estrin's scheme: pairs of coefficients are combined to
+ * \f$c_{2i} + c_{2i+1}x\f$, pairs of those with \f$x^2\f$, and so on. The dependency chain
+ * is only about \f$\log_2 N\f$ multiply-adds long, at the cost of computing the powers
+ * \f$x^2, x^4, \ldots\f$. This is the best choice where the result is needed quickly
+ * (latency bound code, e.g. a polynomial in an iteration).
+ */
+template <typename V, typename T, std::size_t N> Vc_INTRINSIC V estrin(const V &x, const T (&c)[N])
+{
+    V powers[Detail::estrinLevels(N)];
+    powers[0] = x;
+    for (std::size_t i = 1; i < Detail::estrinLevels(N); ++i) {
+        powers[i] = powers[i - 1] * powers[i - 1];
+    }
+    return Detail::Estrin<0, N>::eval(powers, c);
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile polynomial.h <Vc/Polynomial>
+ *
+ * Evaluates the polynomial with the \p n coefficients \p c (determined at runtime) with
+ * Estrin's scheme in blocks of 8 coefficients, which are combined with Horner's scheme in
+ * \f$x^8\f$. The blocks are independent, thus only the combination is a dependency chain.
+ */
+template <typename V, typename T> Vc_INTRINSIC V estrin(const V &x, const T *c, std::size_t n)
+{
+    V powers[4];
+    powers[0] = x;
+    powers[1] = x * x;
+    powers[2] = powers[1] * powers[1];
+    powers[3] = powers[2] * powers[2];
+    std::size_t begin = n / 8 * 8;
+    V r = Detail::estrinTail(powers, c + begin, n - begin);
+    if (begin == n && begin > 0) {
+        begin -= 8;
+        r = Detail::Estrin<0, 8>::eval(powers, c + begin);
+    }
+    while (begin > 0) {
+        begin -= 8;
+        r = Detail::fastFma(r, powers[3], Detail::Estrin<0, 8>::eval(powers, c + begin));
+    }
+    return r;
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile polynomial.h <Vc/Polynomial>
+ *
+ * Evaluates the polynomial with the coefficients \p c (ascending order), with Horner's
+ * scheme up to degree 4 and with Estrin's scheme for higher degrees, where its shorter
+ * dependency chain pays off (see examples/polynomial).
+ */
+template <typename V, typename T, std::size_t N>
+Vc_INTRINSIC V polynomial(const V &x, const T (&c)[N])
+{
+    return N <= 5 ? horner(x, c) : estrin(x, c);
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile polynomial.h <Vc/Polynomial>
+ *
+ * Evaluates the rational function \f$p(x) / q(x)\f$ with the coefficients of the numerator
+ * \p p and the denominator \p q (ascending order). Both polynomials are independent and
+ * evaluated as with polynomial(), followed by one division.
+ * \code
+ * // Padé approximation of exp(x) near 0
+ * float_v y = Vc::rational(x, {1.f, .5f, 1.f / 12}, {1.f, -.5f, 1.f / 12});
+ * \endcode
+ */
+template <typename V, typename T, std::size_t N, std::size_t M>
+Vc_INTRINSIC V rational(const V &x, const T (&p)[N], const T (&q)[M])
+{
+    return polynomial(x, p) / polynomial(x, q);
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile polynomial.h <Vc/Polynomial>
+ *
+ * Evaluates the rational function with runtime coefficients: \p n coefficients of the
+ * numerator in \p p and \p m coefficients of the denominator in \p q, with Estrin's scheme.
+ */
+template <typename V, typename T>
+Vc_INTRINSIC V rational(const V &x, const T *p, std::size_t n, const T *q, std::size_t m)
+{
+    return estrin(x, p, n) / estrin(x, q, m);
+}
+}  // namespace Vc
+
+#endif  // VC_COMMON_POLYNOMIAL_H_
+
+// vim: foldmethod=marker
@@ -0,0 +1,476 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_ROOFLINE_H_
+#define VC_COMMON_ROOFLINE_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <Vc/cpuid.h>
+#include "fastfma.h"
+#include "memory.h"
+#include "macros.h"
+
+#ifdef Vc_MSVC
+#include <intrin.h>
+#endif
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+/**
+ * \ingroup Utilities
+ * \headerfile roofline.h <Vc/Roofline>
+ *
+ * Probes for the throughput limits of the machine, as inputs to a roofline model: the peak
+ * floating-point throughput per vector ABI, the load and store bandwidth from every cache
+ * level and from memory, and the gather throughput.
+ *
+ * \code
+ * Vc::Roofline::Report report;
+ * report.add(Vc::Roofline::probe_fma<Vc::float_v>());
+ * report.add(Vc::Roofline::probe_load<Vc::float_v>(1 << 28, Vc::Aligned));
+ * // a kernel with 0.25 FLOP/Byte that runs at 3.1 FLOP/cycle
+ * double e = report.efficiency(3.1, 0.25, "float");
+ * report.write_json(std::cout);
+ * \endcode
+ *
+ * All rates are given per TSC cycle (the cycle counter of the examples) and per second.
+ */
+namespace Roofline
+{
+// Measurement {{{1
+/// The result of one probe.
+struct Measurement
+{
+    std::string kernel;   ///< "fma", "load", "store", or "gather"
+    std::string abi;      ///< "Scalar", "SSE", "AVX", "AVX2", or "MIC"
+    std::string type;     ///< the entry type: "float" or "double"
+    std::string flags;    ///< "Aligned", "Unaligned", "Streaming", or empty
+    std::string level;    ///< "register", "L1", "L2", "L3", or "DRAM"
+    std::size_t bytes;    ///< the working set size in Bytes
+    std::string unit;     ///< "FLOP", "Byte", or "entry"
+    double perCycle;      ///< units per TSC cycle
+    double perSecond;     ///< units per second
+};
+
+namespace Detail
+{
+// cycles {{{1
+inline bool hasRdtscp()
+{
+    static const bool r = (CpuId::init(), CpuId::hasRdtscp());
+    return r;
+}
+
+// rdtscp waits for the preceding instructions; without it, lfence does the same
+inline unsigned long long cycles()
+{
+#if defined Vc_IMPL_MIC || defined __MIC__
+    unsigned int lo, hi;
+    asm volatile("xor %%eax,%%eax\n\tcpuid\n\trdtsc" : "=a"(lo), "=d"(hi) :: "ebx", "ecx");
+    return lo | (static_cast<unsigned long long>(hi) << 32);
+#elif defined Vc_MSVC
+    if (hasRdtscp()) {
+        unsigned int tmp;
+        return __rdtscp(&tmp);
+    }
+    _mm_lfence();
+    return __rdtsc();
+#else
+    unsigned int lo, hi;
+    if (hasRdtscp()) {
+        asm volatile("rdtscp" : "=a"(lo), "=d"(hi) :: "ecx");
+    } else {
+        asm volatile("lfence\n\trdtsc" : "=a"(lo), "=d"(hi));
+    }
+    return lo | (static_cast<unsigned long long>(hi) << 32);
+#endif
+}
+
+// time {{{1
+// returns the best of \p reps runs of f in TSC cycles and seconds
+struct Timing
+{
+    double cycles;
+    double seconds;
+};
+template <typename F> Timing time(int reps, F &&f)
+{
+    Timing best = {1e300, 1e300};
+    for (int rep = 0; rep < reps; ++rep) {
+        const auto t0 = std::chrono::steady_clock::now();
+        const unsigned long long c0 = cycles();
+        f();
+        const unsigned long long c1 = cycles();
+        const auto t1 = std::chrono::steady_clock::now();
+        if (double(c1 - c0) < best.cycles) {
+            best.cycles = double(c1 - c0);
+            best.seconds = std::chrono::duration<double>(t1 - t0).count();
+        }
+    }
+    return best;
+}
+
+// names {{{1
+inline const char *abiName(VectorAbi::Scalar) { return "Scalar"; }
+#ifdef Vc_IMPL_SSE
+inline const char *abiName(VectorAbi::Sse) { return "SSE"; }
+#endif
+#ifdef Vc_IMPL_AVX
+inline const char *abiName(VectorAbi::Avx)
+{
+#ifdef Vc_IMPL_AVX2
+    return "AVX2";
+#else
+    return "AVX";
+#endif
+}
+#endif
+#ifdef Vc_IMPL_MIC
+inline const char *abiName(VectorAbi::Mic) { return "MIC"; }
+#endif
+
+inline const char *typeName(float) { return "float"; }
+inline const char *typeName(double) { return "double"; }
+
+template <typename Flags> inline const char *flagsName(Flags)
+{
+    return Flags::IsStreaming ? "Streaming" : Flags::IsUnaligned ? "Unaligned" : "Aligned";
+}
+
+// the cache level that a working set of \p bytes is served from
+inline const char *levelName(std::size_t bytes)
+{
+    CpuId::init();
+    return bytes <= CpuId::L1Data() ? "L1" : bytes <= CpuId::L2Data()
+                                                 ? "L2"
+                                                 : bytes <= CpuId::L3Data() ? "L3" : "DRAM";
+}
+
+template <typename V>
+Measurement measurement(const char *kernel, const char *flags, std::size_t bytes,
+                        const char *unit, double amount, const Timing &t)
+{
+    typedef typename V::EntryType T;
+    return {kernel,
+            abiName(typename V::abi()),
+            typeName(T()),
+            flags,
+            bytes == 0 ? "register" : levelName(bytes),
+            bytes,
+            unit,
+            amount / t.cycles,
+            amount / t.seconds};
+}
+
+// Chains independent FMA dependency chains, enough to hide the latency of two FMA units
+template <typename V, int Chains> struct FmaChains
+{
+    V acc;
+    FmaChains<V, Chains - 1> rest;
+    Vc_INTRINSIC FmaChains(V x) : acc(x + typename V::EntryType(Chains)), rest(x) {}
+    Vc_INTRINSIC void step(V b, V c)
+    {
+        acc = Vc::Detail::fastFma(acc, b, c);
+        rest.step(b, c);
+    }
+    Vc_INTRINSIC V sum() const { return acc + rest.sum(); }
+};
+template <typename V> struct FmaChains<V, 0>
+{
+    Vc_INTRINSIC FmaChains(V) {}
+    Vc_INTRINSIC void step(V, V) {}
+    Vc_INTRINSIC V sum() const { return V::Zero(); }
+};
+
+// prevents the compiler from dropping a computation
+template <typename V> Vc_INTRINSIC void keep(const V &x)
+{
+#ifdef Vc_MSVC
+    static volatile typename V::EntryType sink;
+    sink = x.sum();
+#else
+    asm volatile("" ::"m"(x));
+#endif
+}
+//}}}1
+}  // namespace Detail
+
+// probe_fma {{{1
+/**
+ * Measures the peak throughput of fused multiply-adds for the vector type \p V, in FLOP
+ * (two per entry and FMA). Without FMA instructions a multiplication and an addition are
+ * executed instead.
+ */
+template <typename V> Measurement probe_fma(std::size_t iterations = 1 << 20)
+{
+    typedef typename V::EntryType T;
+    constexpr int Chains = 12;
+    const Detail::Timing t = Detail::time(5, [&] {
+        // b and c keep the values finite and away from denormals
+        const V b = T(0.999999), c = T(0.000001);
+        Detail::FmaChains<V, Chains> chains(V::One());
+        for (std::size_t i = 0; i < iterations; ++i) {
+            chains.step(b, c);
+        }
+        Detail::keep(chains.sum());
+    });
+    return Detail::measurement<V>("fma", "", 0, "FLOP",
+                                  2. * V::Size * Chains * double(iterations), t);
+}
+
+// probe_load {{{1
+/**
+ * Measures the load bandwidth for a working set of \p bytes Bytes, using loads with the
+ * given \p flags (Vc::Aligned, Vc::Unaligned, or Vc::Streaming). The unaligned loads read
+ * from an address that is misaligned by one entry.
+ */
+template <typename V, typename Flags> Measurement probe_load(std::size_t bytes, Flags flags)
+{
+    typedef typename V::EntryType T;
+    const std::size_t n = std::max<std::size_t>(1, bytes / sizeof(T) / (4 * V::Size)) * 4 * V::Size;
+    T *mem = Vc::malloc<T, Vc::AlignOnPage>(n + V::Size);
+    std::fill_n(mem, n + V::Size, T(1));
+    const T *p = mem + (Flags::IsUnaligned ? 1 : 0);
+    const std::size_t passes = std::max<std::size_t>(1, (std::size_t(1) << 26) / (n * sizeof(T)));
+    const Detail::Timing t = Detail::time(5, [&] {
+        V a0 = V::Zero(), a1 = V::Zero(), a2 = V::Zero(), a3 = V::Zero();
+        for (std::size_t pass = 0; pass < passes; ++pass) {
+            for (std::size_t i = 0; i < n; i += 4 * V::Size) {
+                a0 += V(p + i, flags);
+                a1 += V(p + i + V::Size, flags);
+                a2 += V(p + i + 2 * V::Size, flags);
+                a3 += V(p + i + 3 * V::Size, flags);
+            }
+        }
+        Detail::keep((a0 + a1) + (a2 + a3));
+    });
+    Vc::free(mem);
+    return Detail::measurement<V>("load", Detail::flagsName(flags), n * sizeof(T), "Byte",
+                                  double(passes * n * sizeof(T)), t);
+}
+
+// probe_store {{{1
+/**
+ * Measures the store bandwidth for a working set of \p bytes Bytes, using stores with the
+ * given \p flags. Streaming stores are followed by a store fence.
+ */
+template <typename V, typename Flags> Measurement probe_store(std::size_t bytes, Flags flags)
+{
+    typedef typename V::EntryType T;
+    const std::size_t n = std::max<std::size_t>(1, bytes / sizeof(T) / (4 * V::Size)) * 4 * V::Size;
+    T *mem = Vc::malloc<T, Vc::AlignOnPage>(n + V::Size);
+    std::fill_n(mem, n + V::Size, T(0));
+    T *p = mem + (Flags::IsUnaligned ? 1 : 0);
+    const std::size_t passes = std::max<std::size_t>(1, (std::size_t(1) << 26) / (n * sizeof(T)));
+    V x = V::One();
+    const Detail::Timing t = Detail::time(5, [&] {
+        for (std::size_t pass = 0; pass < passes; ++pass) {
+            for (std::size_t i = 0; i < n; i += 4 * V::Size) {
+                x.store(p + i, flags);
+                x.store(p + i + V::Size, flags);
+                x.store(p + i + 2 * V::Size, flags);
+                x.store(p + i + 3 * V::Size, flags);
+            }
+            x += V::One();
+        }
+        if (Flags::IsStreaming) {
+            Vc::Detail::storeFence(typename V::abi());
+        }
+    });
+    Detail::keep(V(p + n - V::Size, Vc::Unaligned));
+    Vc::free(mem);
+    return Detail::measurement<V>("store", Detail::flagsName(flags), n * sizeof(T), "Byte",
+                                  double(passes * n * sizeof(T)), t);
+}
+
+// probe_gather {{{1
+/**
+ * Measures the throughput of gathers with random indexes from a table of \p bytes Bytes, in
+ * gathered entries.
+ */
+template <typename V> Measurement probe_gather(std::size_t bytes)
+{
+    typedef typename V::EntryType T;
+    typedef typename V::IndexType I;
+    const std::size_t n = std::max<std::size_t>(V::Size, bytes / sizeof(T));
+    T *table = Vc::malloc<T, Vc::AlignOnPage>(n);
+    std::fill_n(table, n, T(1));
+    // 4096 random index vectors, reused for every pass
+    constexpr std::size_t IndexCount = 4096;
+    std::vector<typename I::EntryType> indexes(IndexCount * V::Size);
+    std::default_random_engine engine;
+    std::uniform_int_distribution<std::size_t> dist(0, n - 1);
+    for (auto &i : indexes) {
+        i = static_cast<typename I::EntryType>(dist(engine));
+    }
+    const std::size_t passes = 64;
+    const Detail::Timing t = Detail::time(5, [&] {
+        V a0 = V::Zero(), a1 = V::Zero();
+        for (std::size_t pass = 0; pass < passes; ++pass) {
+            for (std::size_t i = 0; i < IndexCount; i += 2) {
+                a0 += V(table, I(&indexes[i * V::Size], Vc::Unaligned));
+                a1 += V(table, I(&indexes[(i + 1) * V::Size], Vc::Unaligned));
+            }
+        }
+        Detail::keep(a0 + a1);
+    });
+    Vc::free(table);
+    return Detail::measurement<V>("gather", "", n * sizeof(T), "entry",
+                                  double(passes * IndexCount * V::Size), t);
+}
+
+// probe_sizes {{{1
+/**
+ * Returns working set sizes that are served from L1, L2, L3 (if present), and memory: half
+ * of every cache size, and four times the last level cache (at least 64 MiB) for memory.
+ *
+ * \param maxBytes An upper bound for the memory working set.
+ */
+inline std::vector<std::size_t> probe_sizes(std::size_t maxBytes = std::size_t(1) << 30)
+{
+    CpuId::init();
+    std::vector<std::size_t> sizes;
+    const std::size_t l1 = CpuId::L1Data() > 0 ? CpuId::L1Data() : 32 * 1024;
+    const std::size_t l2 = CpuId::L2Data() > 0 ? CpuId::L2Data() : 256 * 1024;
+    const std::size_t l3 = CpuId::L3Data();
+    sizes.push_back(l1 / 2);
+    sizes.push_back(std::max(l1 * 2, l2 / 2));
+    if (l3 > l2) {
+        sizes.push_back(std::max(l2 * 2, l3 / 2));
+    }
+    sizes.push_back(std::min(maxBytes, std::max(std::max(l2, l3) * 4, std::size_t(64) << 20)));
+    return sizes;
+}
+
+// Report {{{1
+/**
+ * A collection of measurements with the roofline model derived from them.
+ */
+class Report
+{
+    std::vector<Measurement> m_measurements;
+
+    static void writeString(std::ostream &out, const std::string &s)
+    {
+        out << '"';
+        for (char c : s) {
+            if (c == '"' || c == '\\') {
+                out << '\\';
+            }
+            out << c;
+        }
+        out << '"';
+    }
+
+public:
+    /// Appends \p m.
+    void add(const Measurement &m) { m_measurements.push_back(m); }
+    /// Returns all measurements in the order they were added.
+    const std::vector<Measurement> &measurements() const { return m_measurements; }
+
+    /**
+     * Returns the largest rate (per cycle) of the given \p kernel among the measurements
+     * matching \p type (if not empty) and \p level (if not empty), or 0 if there is none.
+     */
+    double best(const std::string &kernel, const std::string &type = std::string(),
+                const std::string &level = std::string()) const
+    {
+        double r = 0;
+        for (const auto &m : m_measurements) {
+            if (m.kernel == kernel && (type.empty() || m.type == type) &&
+                (level.empty() || m.level == level)) {
+                r = std::max(r, m.perCycle);
+            }
+        }
+        return r;
+    }
+
+    /**
+     * Returns the attainable FLOP/cycle for a kernel with the arithmetic \p intensity (in
+     * FLOP per Byte) whose data comes from \p level: the minimum of the peak FMA
+     * throughput and intensity times the best load bandwidth of that level.
+     */
+    double attainable(double intensity, const std::string &type,
+                      const std::string &level = "DRAM") const
+    {
+        return std::min(best("fma", type), intensity * best("load", std::string(), level));
+    }
+
+    /**
+     * Returns the fraction of the roof a kernel achieves that runs at \p flopsPerCycle with
+     * the arithmetic \p intensity.
+     */
+    double efficiency(double flopsPerCycle, double intensity, const std::string &type,
+                      const std::string &level = "DRAM") const
+    {
+        const double roof = attainable(intensity, type, level);
+        return roof > 0 ? flopsPerCycle / roof : 0;
+    }
+
+    /**
+     * Writes the measurements and the cache sizes reported by CpuId as a JSON object.
+     */
+    void write_json(std::ostream &out) const
+    {
+        CpuId::init();
+        out << "{\n  \"cache\": {\"L1\": " << CpuId::L1Data() << ", \"L2\": " << CpuId::L2Data()
+            << ", \"L3\": " << CpuId::L3Data() << "},\n  \"measurements\": [";
+        const char *separator = "\n";
+        for (const auto &m : m_measurements) {
+            out << separator << "    {\"kernel\": ";
+            writeString(out, m.kernel);
+            out << ", \"abi\": ";
+            writeString(out, m.abi);
+            out << ", \"type\": ";
+            writeString(out, m.type);
+            out << ", \"flags\": ";
+            writeString(out, m.flags);
+            out << ", \"level\": ";
+            writeString(out, m.level);
+            out << ", \"bytes\": " << m.bytes << ", \"unit\": ";
+            writeString(out, m.unit);
+            out << ", \"per_cycle\": " << m.perCycle << ", \"per_second\": " << m.perSecond
+                << '}';
+            separator = ",\n";
+        }
+        out << "\n  ]\n}\n";
+    }
+};
+//}}}1
+}  // namespace Roofline
+}  // namespace Vc
+
+#endif  // VC_COMMON_ROOFLINE_H_
+
+// vim: foldmethod=marker
@@ -0,0 +1,403 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_SELECTION_H_
+#define VC_COMMON_SELECTION_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "concurrency.h"
+#include "maskbits.h"
+#include "macros.h"
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+namespace Detail
+{
+// SelectionOrder {{{1
+/**\internal
+ * The order of the selection algorithms: \p Max selects the largest values (argmax,
+ * top-k), otherwise the smallest. Equal values are ordered by their index, so that the
+ * first occurrence wins.
+ */
+template <bool Max> struct SelectionOrder
+{
+    // only operator< is false for NaN operands (operator> of float vectors is not ordered)
+    template <typename T> static Vc_INTRINSIC auto better(const T &a, const T &b) -> decltype(a < b)
+    {
+        return Max ? b < a : a < b;
+    }
+    // the initial value of a lane: no value is better than it, except NaN
+    template <typename T> static constexpr T worst()
+    {
+        return Max ? (std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity()
+                                                           : std::numeric_limits<T>::lowest())
+                   : (std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                           : std::numeric_limits<T>::max());
+    }
+    template <typename T>
+    static Vc_INTRINSIC bool before(const std::pair<T, std::size_t> &a,
+                                    const std::pair<T, std::size_t> &b)
+    {
+        return better(a.first, b.first) || (a.first == b.first && a.second < b.second);
+    }
+};
+
+// argBest {{{1
+/**\internal
+ * Returns the index of the first best of the \p n > 0 values at \p data, and that value.
+ * NaNs are skipped; if all values are NaN the index is \p n.
+ *
+ * Every lane of four accumulators keeps its best value and the iteration it was found in.
+ * The iteration counter is a vector of T, thus the loop restarts every MaxIterations
+ * iterations (the largest count that T represents exactly) and reduces the lanes.
+ */
+template <bool Max, typename T>
+std::pair<T, std::size_t> argBest(const T *data, std::size_t n)
+{
+    typedef SelectionOrder<Max> O;
+    typedef Vector<T> V;
+    constexpr std::size_t Unroll = 4;
+    constexpr std::size_t Step = Unroll * V::Size;
+    constexpr std::size_t MaxIterations =
+        std::numeric_limits<T>::digits < 20 ? std::size_t(std::numeric_limits<T>::max())
+                                            : std::size_t(1) << 20;
+
+    std::pair<T, std::size_t> best(O::template worst<T>(), n);
+    std::size_t i = 0;
+    while (n - i >= Step) {
+        const std::size_t begin = i;
+        const std::size_t end = begin + std::min((n - i) / Step, MaxIterations) * Step;
+        V value[Unroll], iteration[Unroll];
+        for (std::size_t a = 0; a < Unroll; ++a) {
+            value[a] = O::template worst<T>();
+            iteration[a] = V::Zero();
+        }
+        V counter = V::Zero();
+        for (; i < end; i += Step) {
+            for (std::size_t a = 0; a < Unroll; ++a) {
+                const V x(data + i + a * V::Size, Vc::Unaligned);
+                const auto better = O::better(x, value[a]);
+                where(better) | value[a] = x;
+                where(better) | iteration[a] = counter;
+            }
+            counter += V::One();
+        }
+        for (std::size_t a = 0; a < Unroll; ++a) {
+            for (std::size_t l = 0; l < V::Size; ++l) {
+                const std::pair<T, std::size_t> candidate(
+                    value[a][l], begin + std::size_t(iteration[a][l]) * Step + a * V::Size + l);
+                // a lane that was never updated holds worst(), which is only a value of
+                // the range if its first entry has it
+                if (data[candidate.second] == candidate.first && O::before(candidate, best)) {
+                    best = candidate;
+                }
+            }
+        }
+    }
+    for (; i < n; ++i) {
+        const std::pair<T, std::size_t> candidate(data[i], i);
+        if (O::before(candidate, best)) {
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+// argBestConcurrently {{{1
+/**\internal
+ * Returns the index of the first best of the \p n > 0 values at \p data. As with
+ * std::max_element, a NaN in the first position is the result, all other NaNs are
+ * skipped.
+ */
+template <bool Max, typename T>
+std::size_t argBest(const T *data, std::size_t n, std::size_t threads)
+{
+    if (!(data[0] == data[0])) {
+        return 0;
+    }
+    threads = std::max<std::size_t>(1, std::min(threads, n / 4096));
+    if (threads == 1) {
+        return argBest<Max>(data, n).second;
+    }
+    std::vector<std::pair<T, std::size_t>> results(threads);
+    const std::size_t chunk = (n + threads - 1) / threads;
+    runConcurrently(threads, [&](std::size_t t) {
+        const std::size_t begin = std::min(n, t * chunk);
+        const std::size_t count = std::min(n, begin + chunk) - begin;
+        results[t] = {SelectionOrder<Max>::template worst<T>(), n};
+        if (count > 0) {
+            const std::pair<T, std::size_t> r = argBest<Max>(data + begin, count);
+            if (r.second < count) {  // otherwise the chunk is all NaN
+                results[t] = {r.first, begin + r.second};
+            }
+        }
+    });
+    std::pair<T, std::size_t> best = results[0];
+    for (const auto &r : results) {
+        if (SelectionOrder<Max>::before(r, best)) {
+            best = r;
+        }
+    }
+    return best.second;
+}
+
+// TopK {{{1
+/**\internal
+ * Collects the k best values of a range and their indexes.
+ *
+ * Only values better than the threshold (a bound for the k-th best value seen so far) are
+ * candidates. The candidates are reduced to the k best whenever the buffer is full, which
+ * tightens the threshold. For k <= V::Size the V::Size best values seen are also kept in a
+ * register, merged with every vector that has candidates: the bitonic merge of two sorted
+ * vectors keeps the better half, which sorted() orders again.
+ */
+template <bool Max, typename T> class TopK
+{
+    typedef SelectionOrder<Max> O;
+    typedef Vector<T> V;
+    typedef std::pair<T, std::size_t> Candidate;
+
+    std::size_t m_k;
+    std::size_t m_capacity;
+    std::vector<Candidate> m_candidates;
+    T m_threshold;
+
+    static bool before(const Candidate &a, const Candidate &b) { return O::before(a, b); }
+
+    void reduce()
+    {
+        std::nth_element(m_candidates.begin(), m_candidates.begin() + (m_k - 1),
+                         m_candidates.end(), &before);
+        m_candidates.resize(m_k);
+        const T kth = m_candidates[m_k - 1].first;
+        if (O::better(kth, m_threshold)) {
+            m_threshold = kth;
+        }
+    }
+
+    // \p best is ascending. NaNs in \p x become the worst value: they would otherwise
+    // survive max/min and break the order of sorted().
+    Vc_INTRINSIC void merge(V &best, V x)
+    {
+        x(x != x) = O::template worst<T>();
+        const V y = x.sorted().reversed();
+        best = (Max ? Vc::max(best, y) : Vc::min(best, y)).sorted();
+        const T kth = best[Max ? V::Size - m_k : m_k - 1];
+        if (O::better(kth, m_threshold)) {
+            m_threshold = kth;
+        }
+    }
+
+public:
+    explicit TopK(std::size_t k)
+        : m_k(k)
+        , m_capacity(2 * k + 64)
+        , m_threshold(O::template worst<T>())
+    {
+    }
+
+    void scan(const T *data, std::size_t n, std::size_t offset)
+    {
+        m_candidates.reserve(m_capacity);
+        V best = O::template worst<T>();  // a local, TopK is stored in std::vector
+        std::size_t i = 0;
+        // the first k values are candidates unconditionally, NaNs are skipped
+        for (; i < n && m_candidates.size() < m_k; ++i) {
+            if (data[i] == data[i]) {
+                m_candidates.emplace_back(data[i], offset + i);
+                if (m_candidates.size() == m_k) {
+                    m_threshold = std::min_element(m_candidates.begin(), m_candidates.end(),
+                                                   [](const Candidate &a, const Candidate &b) {
+                                                       return O::better(b.first, a.first);
+                                                   })->first;
+                }
+            }
+        }
+        for (; i + V::Size <= n; i += V::Size) {
+            const V x(data + i, Vc::Unaligned);
+            const auto better = O::better(x, V(m_threshold));
+            if (Vc_IS_UNLIKELY(!better.isEmpty())) {
+                for (unsigned int bits = mask_bits(better); bits != 0; bits &= bits - 1) {
+                    const std::size_t l = _bit_scan_forward(bits);
+                    m_candidates.emplace_back(x[l], offset + i + l);
+                }
+                if (m_k <= V::Size) {
+                    merge(best, x);
+                }
+                if (m_candidates.size() + V::Size > m_capacity) {
+                    reduce();
+                }
+            }
+        }
+        for (; i < n; ++i) {
+            if (O::better(data[i], m_threshold)) {
+                m_candidates.emplace_back(data[i], offset + i);
+            }
+        }
+    }
+
+    /// moves the candidates of \p other into this object
+    void add(const TopK &other)
+    {
+        m_candidates.insert(m_candidates.end(), other.m_candidates.begin(),
+                            other.m_candidates.end());
+    }
+
+    template <typename OutputIt> OutputIt write(OutputIt out)
+    {
+        const std::size_t k = std::min(m_k, m_candidates.size());
+        std::partial_sort(m_candidates.begin(), m_candidates.begin() + k, m_candidates.end(),
+                          &before);
+        for (std::size_t j = 0; j < k; ++j) {
+            *out++ = m_candidates[j].second;
+        }
+        return out;
+    }
+};
+
+template <bool Max, typename T, typename OutputIt>
+OutputIt topK(const T *data, std::size_t n, std::size_t k, OutputIt out, std::size_t threads)
+{
+    if (k == 0 || n == 0) {
+        return out;
+    }
+    threads = std::max<std::size_t>(1, std::min(threads, n / 4096));
+    TopK<Max, T> result(k);
+    if (threads == 1) {
+        result.scan(data, n, 0);
+        return result.write(out);
+    }
+    std::vector<TopK<Max, T>> parts(threads, TopK<Max, T>(k));
+    const std::size_t chunk = (n + threads - 1) / threads;
+    runConcurrently(threads, [&](std::size_t t) {
+        const std::size_t begin = std::min(n, t * chunk);
+        parts[t].scan(data + begin, std::min(n, begin + chunk) - begin, begin);
+    });
+    for (const auto &part : parts) {
+        result.add(part);
+    }
+    return result.write(out);
+}
+//}}}1
+}  // namespace Detail
+
+// simd_argmin / simd_argmax {{{1
+/**
+ * \ingroup Utilities
+ * \headerfile selection.h <Vc/Selection>
+ *
+ * Returns an iterator to the smallest value in [\p first, \p last), or \p last if the
+ * range is empty. Like std::min_element, the first of equal values is returned and NaNs
+ * are never selected, except if the first value is NaN.
+ *
+ * The range must be contiguous memory of an arithmetic type with a Vc::Vector. Every lane
+ * of the vector loop keeps its best value and the index it was found at, so that the
+ * lanes are only compared with each other at the end.
+ *
+ * \param threads The number of threads to split the range over (each part of at least
+ *                4096 values).
+ */
+template <typename It> It simd_argmin(It first, It last, std::size_t threads = 1)
+{
+    if (first == last) {
+        return last;
+    }
+    return first + Detail::argBest<false>(std::addressof(*first), last - first, threads);
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile selection.h <Vc/Selection>
+ *
+ * Returns an iterator to the largest value in [\p first, \p last), or \p last if the range
+ * is empty. Otherwise the same as simd_argmin.
+ */
+template <typename It> It simd_argmax(It first, It last, std::size_t threads = 1)
+{
+    if (first == last) {
+        return last;
+    }
+    return first + Detail::argBest<true>(std::addressof(*first), last - first, threads);
+}
+
+// simd_top_k / simd_bottom_k {{{1
+/**
+ * \ingroup Utilities
+ * \headerfile selection.h <Vc/Selection>
+ *
+ * Writes the indexes of the \p k largest values in [\p first, \p last) to \p out, ordered
+ * from the largest value down; of equal values the first ones are selected. If the range
+ * has fewer than \p k values (NaNs are skipped), only those are written. Returns the end of
+ * the written indexes.
+ *
+ * The vector loop only compares the values with a threshold: the k-th largest value seen
+ * so far. This makes top-k almost as fast as a scan for k much smaller than the range.
+ * \code
+ * std::vector<std::size_t> peaks(8);
+ * Vc::simd_top_k(signal.begin(), signal.end(), peaks.size(), peaks.begin());
+ * \endcode
+ *
+ * \param threads The number of threads to split the range over.
+ */
+template <typename It, typename OutputIt>
+OutputIt simd_top_k(It first, It last, std::size_t k, OutputIt out, std::size_t threads = 1)
+{
+    if (first == last) {
+        return out;
+    }
+    return Detail::topK<true>(std::addressof(*first), last - first, k, out, threads);
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile selection.h <Vc/Selection>
+ *
+ * Writes the indexes of the \p k smallest values in [\p first, \p last) to \p out, ordered
+ * from the smallest value up (e.g. the k nearest neighbours for a range of distances).
+ * Otherwise the same as simd_top_k.
+ */
+template <typename It, typename OutputIt>
+OutputIt simd_bottom_k(It first, It last, std::size_t k, OutputIt out, std::size_t threads = 1)
+{
+    if (first == last) {
+        return out;
+    }
+    return Detail::topK<false>(std::addressof(*first), last - first, k, out, threads);
+}
+//}}}1
+}  // namespace Vc
+
+#endif  // VC_COMMON_SELECTION_H_
+
+// vim: foldmethod=marker
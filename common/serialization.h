@@ -0,0 +1,843 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_SERIALIZATION_H_
+#define VC_COMMON_SERIALIZATION_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <vector>
+#include "memory.h"
+#include "soa_vector.h"
+#include "streamingstore.h"
+#include "macros.h"
+#ifdef Vc_IMPL_SSE4_2
+#include <nmmintrin.h>
+#endif
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+/**
+ * \ingroup Utilities
+ * \headerfile serialization.h <Vc/Serialization>
+ *
+ * The result of reading serialized Memory or soa_vector data.
+ */
+enum class SerializationResult {
+    /// The data was read successfully.
+    Success,
+    /// The stream failed or the buffer is shorter than the data it announces.
+    IOError,
+    /// The data does not start with a valid header.
+    InvalidHeader,
+    /// The data was written by an incompatible version of the format.
+    UnsupportedVersion,
+    /// The entry types of the data and the destination differ.
+    TypeMismatch,
+    /// The number of rows, entries, or columns of the data and the destination differ.
+    SizeMismatch,
+    /// The checksum of the payload does not match the checksum in the header.
+    ChecksumMismatch,
+    /// The data cannot be viewed in place, because it is not suitably aligned or padded.
+    Misaligned
+};
+
+namespace Detail
+{
+// crc32c {{{1
+/**\internal
+ * The table for the bytewise CRC32C calculation (reflected Castagnoli polynomial).
+ */
+inline const std::uint32_t *crc32cTable()
+{
+    static const std::array<std::uint32_t, 256> table = [] {
+        std::array<std::uint32_t, 256> t;
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = c & 1 ? (c >> 1) ^ 0x82f63b78u : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    return table.data();
+}
+
+/**\internal
+ * Updates the (non-inverted) CRC32C state \p crc with \p n bytes at \p data. With SSE4.2
+ * this uses the crc32 instruction on eight bytes at a time.
+ */
+inline std::uint32_t crc32cUpdate(std::uint32_t crc, const void *data, std::size_t n)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+#ifdef Vc_IMPL_SSE4_2
+#if defined __x86_64__ || defined _M_X64
+    std::uint64_t crc64 = crc;
+    for (; n >= 8; n -= 8, p += 8) {
+        std::uint64_t x;
+        std::memcpy(&x, p, 8);
+        crc64 = _mm_crc32_u64(crc64, x);
+    }
+    crc = static_cast<std::uint32_t>(crc64);
+#endif
+    for (; n >= 4; n -= 4, p += 4) {
+        std::uint32_t x;
+        std::memcpy(&x, p, 4);
+        crc = _mm_crc32_u32(crc, x);
+    }
+    for (; n > 0; --n, ++p) {
+        crc = _mm_crc32_u8(crc, *p);
+    }
+#else
+    const std::uint32_t *table = crc32cTable();
+    for (; n > 0; --n, ++p) {
+        crc = table[(crc ^ *p) & 0xff] ^ (crc >> 8);
+    }
+#endif
+    return crc;
+}
+//}}}1
+}  // namespace Detail
+
+/**
+ * \ingroup Utilities
+ * \headerfile serialization.h <Vc/Serialization>
+ *
+ * Returns the CRC32C (Castagnoli) checksum of the \p n bytes at \p data.
+ *
+ * To checksum data in pieces, pass the checksum of the preceding bytes as \p crc.
+ * The crc32 instruction is used if the target supports SSE4.2.
+ */
+inline std::uint32_t crc32c(const void *data, std::size_t n, std::uint32_t crc = 0)
+{
+    return ~Detail::crc32cUpdate(~crc, data, n);
+}
+
+namespace SerializationImpl
+{
+// format {{{1
+/**\internal
+ * The serialized data consists of
+ * - the 64 byte Header,
+ * - one type byte per column, padded with zeros to a multiple of 64 bytes,
+ * - the columns, each padded with zeros to a multiple of 64 bytes.
+ *
+ * A column stores `rows * paddedEntriesPerRow` entries, i.e. the padding of every row is
+ * part of the data. Thus a column can be used in place (e.g. from a memory-mapped file)
+ * with aligned vector loads. The checksum covers the type bytes and the columns, without
+ * the padding to 64 bytes. All fields are stored in the byte order of the host.
+ */
+constexpr std::size_t BlockSize = 64;
+constexpr std::uint32_t FormatVersion = 1;
+constexpr std::uint32_t HasChecksum = 1;
+
+struct Header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t columns;
+    std::uint64_t payloadOffset;
+    std::uint64_t rows;
+    std::uint64_t entriesPerRow;
+    std::uint64_t paddedEntriesPerRow;
+    std::uint32_t vectorSize;
+    std::uint32_t alignment;
+    std::uint32_t flags;
+    std::uint32_t checksum;
+};
+static_assert(sizeof(Header) == BlockSize, "the serialization header must be 64 bytes");
+
+inline const char *magic() { return "VcMemory"; }
+
+/**\internal
+ * The type byte of a column: the kind of the entry type in the high nibble (1: floating
+ * point, 2: signed, 3: unsigned integer, 4: bool, 5: char) and its size in the low nibble.
+ * bool and char have their own kinds, because they have the same size and (depending on
+ * the platform) signedness as signed or unsigned char.
+ */
+template <typename T> constexpr unsigned char typeCode()
+{
+    static_assert(std::is_arithmetic<T>::value && sizeof(T) <= 8,
+                  "only arithmetic entry types can be serialized");
+    return static_cast<unsigned char>(
+        (std::is_same<T, bool>::value
+             ? 0x40
+             : std::is_same<T, char>::value
+                   ? 0x50
+                   : std::is_floating_point<T>::value
+                         ? 0x10
+                         : std::is_signed<T>::value ? 0x20 : 0x30) |
+        sizeof(T));
+}
+
+inline std::size_t roundUp(std::size_t n) { return (n + BlockSize - 1) & ~(BlockSize - 1); }
+
+// Layout {{{1
+/**\internal
+ * The shape of the serialized object, and one pointer and type byte per column.
+ */
+struct Layout
+{
+    std::uint64_t rows;
+    std::uint64_t entriesPerRow;
+    std::uint64_t paddedEntriesPerRow;
+    std::uint32_t vectorSize;
+    std::uint32_t alignment;
+    std::vector<unsigned char> types;
+    std::vector<char *> columns;
+
+    template <typename T> void addColumn(const T *data)
+    {
+        types.push_back(typeCode<T>());
+        columns.push_back(reinterpret_cast<char *>(const_cast<T *>(data)));
+    }
+    std::size_t columnBytes(std::size_t i) const
+    {
+        return rows * paddedEntriesPerRow * (types[i] & 0x0f);
+    }
+    std::size_t payloadOffset() const { return BlockSize + roundUp(types.size()); }
+    std::size_t size() const
+    {
+        std::size_t n = payloadOffset();
+        for (std::size_t i = 0; i < types.size(); ++i) {
+            n += roundUp(columnBytes(i));
+        }
+        return n;
+    }
+    Header header(bool withChecksum, std::uint32_t checksum) const
+    {
+        Header h;
+        std::memcpy(h.magic, magic(), 8);
+        h.version = FormatVersion;
+        h.columns = static_cast<std::uint32_t>(types.size());
+        h.payloadOffset = payloadOffset();
+        h.rows = rows;
+        h.entriesPerRow = entriesPerRow;
+        h.paddedEntriesPerRow = paddedEntriesPerRow;
+        h.vectorSize = vectorSize;
+        h.alignment = alignment;
+        h.flags = withChecksum ? HasChecksum : 0;
+        h.checksum = withChecksum ? checksum : 0;
+        return h;
+    }
+    std::uint32_t checksum() const
+    {
+        std::uint32_t crc = crc32c(types.data(), types.size());
+        for (std::size_t i = 0; i < columns.size(); ++i) {
+            crc = crc32c(columns[i], columnBytes(i), crc);
+        }
+        return crc;
+    }
+};
+
+/**\internal
+ * Describes a 1- or 2-dimensional Memory object.
+ */
+template <typename V, typename Parent, typename RM>
+Layout memoryLayout(const Common::MemoryBase<V, Parent, 1, RM> &m)
+{
+    Layout l = {1, m.entriesCount(), m.vectorsCount() * V::Size, V::Size, V::MemoryAlignment,
+                {}, {}};
+    l.addColumn(m.entries());
+    return l;
+}
+template <typename V, typename Parent, typename RM>
+Layout memoryLayout(const Common::MemoryBase<V, Parent, 2, RM> &m)
+{
+    const std::size_t rows = m.rowsCount();
+    Layout l = {rows, m.entriesCount() / rows, m.vectorsCount() * V::Size / rows, V::Size,
+                V::MemoryAlignment, {}, {}};
+    l.addColumn(m.entries());
+    return l;
+}
+
+/**\internal
+ * Describes a soa_vector: one column per data member.
+ */
+template <typename T, std::size_t N, std::size_t... I>
+Layout soaLayout(const soa_vector<T, N> &v, Vc::index_sequence<I...>)
+{
+    typedef soa_vector<T, N> S;
+    Layout l = {1, v.size(), v.vectorsCount() * S::simd_width, S::simd_width,
+                Vc::VectorAlignment, {}, {}};
+    auto &&unused = {(l.addColumn(v.template data<I>()), 0)...};
+    if (&unused == &unused) {}
+    return l;
+}
+template <typename T, std::size_t N> Layout soaLayout(const soa_vector<T, N> &v)
+{
+    return soaLayout(
+        v, Vc::make_index_sequence<SimdizeDetail::determine_tuple_size<T>()>());
+}
+
+// writing {{{1
+/**\internal
+ * Writes the serialization of \p l to the buffer at \p dst. With \p streaming the columns
+ * are written with streaming stores. The checksum is calculated in chunks right before
+ * the chunk is copied, so that the source is read from the cache only once.
+ */
+inline std::size_t writeBuffer(const Layout &l, char *dst, bool streaming, bool withChecksum)
+{
+    constexpr std::size_t ChunkSize = 64 * 1024;
+    std::uint32_t crc = withChecksum ? crc32c(l.types.data(), l.types.size()) : 0;
+    std::memset(dst + BlockSize, 0, l.payloadOffset() - BlockSize);
+    std::memcpy(dst + BlockSize, l.types.data(), l.types.size());
+    char *out = dst + l.payloadOffset();
+    for (std::size_t c = 0; c < l.columns.size(); ++c) {
+        const std::size_t bytes = l.columnBytes(c);
+        for (std::size_t i = 0; i < bytes; i += ChunkSize) {
+            const std::size_t n = std::min(ChunkSize, bytes - i);
+            if (withChecksum) {
+                crc = crc32c(l.columns[c] + i, n, crc);
+            }
+            if (streaming) {
+                // copied as 32-bit words; a 2-byte entry type may leave two bytes
+                const std::size_t words = n / 4;
+                Common::streaming_copy(reinterpret_cast<std::uint32_t *>(out + i),
+                                       reinterpret_cast<const std::uint32_t *>(l.columns[c] + i),
+                                       words);
+                std::memcpy(out + i + words * 4, l.columns[c] + i + words * 4, n - words * 4);
+            } else {
+                std::memcpy(out + i, l.columns[c] + i, n);
+            }
+        }
+        std::memset(out + bytes, 0, roundUp(bytes) - bytes);
+        out += roundUp(bytes);
+    }
+    const Header h = l.header(withChecksum, crc);
+    std::memcpy(dst, &h, sizeof(Header));
+    return out - dst;
+}
+
+/**\internal
+ * Writes the serialization of \p l to \p out. The columns are written directly from the
+ * serialized object, without an intermediate copy.
+ */
+inline SerializationResult writeStream(const Layout &l, std::ostream &out, bool withChecksum)
+{
+    static const char zeros[BlockSize] = {};
+    const Header h = l.header(withChecksum, withChecksum ? l.checksum() : 0);
+    out.write(reinterpret_cast<const char *>(&h), sizeof(Header));
+    out.write(reinterpret_cast<const char *>(l.types.data()), l.types.size());
+    out.write(zeros, l.payloadOffset() - BlockSize - l.types.size());
+    for (std::size_t c = 0; c < l.columns.size(); ++c) {
+        const std::size_t bytes = l.columnBytes(c);
+        out.write(l.columns[c], bytes);
+        out.write(zeros, roundUp(bytes) - bytes);
+    }
+    return out ? SerializationResult::Success : SerializationResult::IOError;
+}
+
+// reading {{{1
+/**\internal
+ * Reads consecutive bytes from a buffer.
+ */
+class BufferSource
+{
+    const char *m_pos;
+    const char *m_end;
+
+public:
+    BufferSource(const void *data, std::size_t size)
+        : m_pos(static_cast<const char *>(data)), m_end(m_pos + size)
+    {
+    }
+    bool read(void *dst, std::size_t n)
+    {
+        if (std::size_t(m_end - m_pos) < n) {
+            return false;
+        }
+        std::memcpy(dst, m_pos, n);
+        m_pos += n;
+        return true;
+    }
+    std::size_t remaining() const { return m_end - m_pos; }
+};
+
+/**\internal
+ * Reads consecutive bytes from an std::istream.
+ */
+class StreamSource
+{
+    std::istream &m_in;
+
+public:
+    StreamSource(std::istream &in) : m_in(in) {}
+    bool read(void *dst, std::size_t n)
+    {
+        m_in.read(static_cast<char *>(dst), n);
+        return std::size_t(m_in.gcount()) == n;
+    }
+    // the bytes left in a seekable stream; unknown (the maximum) for e.g. pipes
+    std::size_t remaining()
+    {
+        const std::istream::pos_type pos = m_in.tellg();
+        if (pos == std::istream::pos_type(-1)) {
+            return std::numeric_limits<std::size_t>::max();
+        }
+        m_in.seekg(0, std::ios::end);
+        const std::istream::pos_type end = m_in.tellg();
+        m_in.clear();
+        m_in.seekg(pos);
+        if (end == std::istream::pos_type(-1) || end < pos) {
+            return std::numeric_limits<std::size_t>::max();
+        }
+        return std::size_t(end - pos);
+    }
+};
+
+/**\internal
+ * Validates the fields of the header that do not depend on the destination.
+ */
+inline SerializationResult checkHeader(const Header &h)
+{
+    if (std::memcmp(h.magic, magic(), 8) != 0) {
+        return SerializationResult::InvalidHeader;
+    }
+    if (h.version != FormatVersion) {
+        return SerializationResult::UnsupportedVersion;
+    }
+    if (h.columns == 0 || h.payloadOffset != BlockSize + roundUp(h.columns) ||
+        h.paddedEntriesPerRow < h.entriesPerRow) {
+        return SerializationResult::InvalidHeader;
+    }
+    return SerializationResult::Success;
+}
+
+/**\internal
+ * Returns whether the columns announced by \p h fit into \p available bytes. This is
+ * checked before anything is allocated for the data, thus a corrupted header cannot
+ * trigger an arbitrarily large allocation.
+ */
+inline bool payloadFits(const Header &h, const std::vector<unsigned char> &types,
+                        std::size_t available)
+{
+    for (unsigned char type : types) {
+        const std::size_t entrySize = type & 0x0f;
+        if (entrySize == 0 || h.paddedEntriesPerRow == 0) {
+            continue;
+        }
+        if (h.rows > available / entrySize / h.paddedEntriesPerRow) {
+            return false;
+        }
+        const std::size_t bytes = roundUp(h.rows * h.paddedEntriesPerRow * entrySize);
+        if (bytes > available) {
+            return false;
+        }
+        available -= bytes;
+    }
+    return true;
+}
+
+/**\internal
+ * Reads and validates the header and returns the type bytes in \p types.
+ */
+template <typename Source>
+SerializationResult readHeader(Source &src, Header &h, std::vector<unsigned char> &types)
+{
+    if (!src.read(&h, sizeof(Header))) {
+        return SerializationResult::IOError;
+    }
+    const SerializationResult r = checkHeader(h);
+    if (r != SerializationResult::Success) {
+        return r;
+    }
+    if (h.payloadOffset - BlockSize > src.remaining()) {
+        return SerializationResult::IOError;
+    }
+    types.resize(h.payloadOffset - BlockSize);
+    if (!src.read(types.data(), types.size())) {
+        return SerializationResult::IOError;
+    }
+    types.resize(h.columns);
+    if (!payloadFits(h, types, src.remaining())) {
+        return SerializationResult::IOError;
+    }
+    return SerializationResult::Success;
+}
+
+/**\internal
+ * Reads the columns described by \p h into the columns of \p l, which must have the same
+ * number of rows and entries per row. If the padding of the rows differs (e.g. because
+ * the data was written with a different vector width) the rows are copied one by one and
+ * the destination padding is zeroed.
+ */
+template <typename Source>
+SerializationResult readColumns(Source &src, const Header &h,
+                                const std::vector<unsigned char> &types, const Layout &l,
+                                bool verify)
+{
+    if (types != l.types) {
+        return types.size() == l.types.size() ? SerializationResult::TypeMismatch
+                                               : SerializationResult::SizeMismatch;
+    }
+    if (h.rows != l.rows || h.entriesPerRow != l.entriesPerRow) {
+        return SerializationResult::SizeMismatch;
+    }
+    std::uint32_t crc = crc32c(types.data(), types.size());
+    std::vector<char> row;
+    char gap[BlockSize];
+    for (std::size_t c = 0; c < l.columns.size(); ++c) {
+        const std::size_t entrySize = l.types[c] & 0x0f;
+        const std::size_t bytes = h.rows * h.paddedEntriesPerRow * entrySize;
+        if (h.paddedEntriesPerRow == l.paddedEntriesPerRow) {
+            if (!src.read(l.columns[c], bytes)) {
+                return SerializationResult::IOError;
+            }
+            if (verify) {
+                crc = crc32c(l.columns[c], bytes, crc);
+            }
+        } else {
+            const std::size_t fileRow = h.paddedEntriesPerRow * entrySize;
+            const std::size_t ourRow = l.paddedEntriesPerRow * entrySize;
+            const std::size_t used = h.entriesPerRow * entrySize;
+            row.resize(fileRow);
+            for (std::size_t i = 0; i < h.rows; ++i) {
+                if (!src.read(row.data(), fileRow)) {
+                    return SerializationResult::IOError;
+                }
+                if (verify) {
+                    crc = crc32c(row.data(), fileRow, crc);
+                }
+                std::memcpy(l.columns[c] + i * ourRow, row.data(), used);
+                std::memset(l.columns[c] + i * ourRow + used, 0, ourRow - used);
+            }
+        }
+        if (!src.read(gap, roundUp(bytes) - bytes)) {
+            return SerializationResult::IOError;
+        }
+    }
+    if (verify && (h.flags & HasChecksum) && crc != h.checksum) {
+        return SerializationResult::ChecksumMismatch;
+    }
+    return SerializationResult::Success;
+}
+
+template <typename Source, typename V, std::size_t Size1, std::size_t Size2, bool IP>
+SerializationResult readMemory(Source &src, Memory<V, Size1, Size2, IP> &m, bool verify)
+{
+    Header h;
+    std::vector<unsigned char> types;
+    SerializationResult r = readHeader(src, h, types);
+    if (r == SerializationResult::Success) {
+        r = readColumns(src, h, types, memoryLayout(m), verify);
+    }
+    return r;
+}
+
+template <typename Source, typename V>
+SerializationResult readMemory(Source &src, Memory<V> &m, bool verify)
+{
+    Header h;
+    std::vector<unsigned char> types;
+    SerializationResult r = readHeader(src, h, types);
+    if (r != SerializationResult::Success) {
+        return r;
+    }
+    if (h.rows != 1) {
+        return SerializationResult::SizeMismatch;
+    }
+    if (m.entriesCount() == h.entriesPerRow) {
+        return readColumns(src, h, types, memoryLayout(m), verify);
+    }
+    Memory<V> tmp(h.entriesPerRow);
+    r = readColumns(src, h, types, memoryLayout(tmp), verify);
+    if (r == SerializationResult::Success) {
+        m.swap(tmp);
+    }
+    return r;
+}
+
+template <typename Source, typename T, std::size_t N>
+SerializationResult readSoa(Source &src, soa_vector<T, N> &v, bool verify)
+{
+    Header h;
+    std::vector<unsigned char> types;
+    SerializationResult r = readHeader(src, h, types);
+    if (r != SerializationResult::Success) {
+        return r;
+    }
+    if (h.rows != 1) {
+        return SerializationResult::SizeMismatch;
+    }
+    soa_vector<T, N> tmp(h.entriesPerRow);
+    r = readColumns(src, h, types, soaLayout(tmp), verify);
+    if (r == SerializationResult::Success) {
+        std::swap(v, tmp);
+    }
+    return r;
+}
+//}}}1
+}  // namespace SerializationImpl
+
+/**
+ * \ingroup Utilities
+ * \headerfile serialization.h <Vc/Serialization>
+ *
+ * Returns the number of bytes serialize() writes for \p m.
+ */
+template <typename V, typename Parent, int Dimension, typename RM>
+inline std::size_t serialized_size(const Common::MemoryBase<V, Parent, Dimension, RM> &m)
+{
+    return SerializationImpl::memoryLayout(m).size();
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile serialization.h <Vc/Serialization>
+ *
+ * Writes \p m to the buffer at \p dst in the Vc binary format and returns the number of
+ * bytes written, which is serialized_size(m).
+ *
+ * The format starts with a 64 byte header that records the entry type, V::Size,
+ * V::MemoryAlignment, the number of rows and entries, the format version, and an optional
+ * CRC32C checksum. It is followed by the entries, including the padding of every row.
+ * Thus, the entries start at a multiple of 64 bytes and can be used in place (see
+ * view_serialized) if \p dst is aligned on 64 bytes.
+ *
+ * \param m The 1- or 2-dimensional Memory object to write.
+ * \param dst The destination buffer, e.g. a memory-mapped output file.
+ * \param flags Pass Vc::Streaming to write the entries with streaming stores, bypassing
+ *              the cache (see streaming_copy).
+ * \param withChecksum Whether to calculate the CRC32C checksum of the data.
+ */
+template <typename V, typename Parent, int Dimension, typename RM,
+          typename Flags = DefaultStoreTag,
+          typename = enable_if<Traits::is_load_store_flag<Flags>::value>>
+inline std::size_t serialize(const Common::MemoryBase<V, Parent, Dimension, RM> &m, void *dst,
+                             Flags = Flags(), bool withChecksum = true)
+{
+    return SerializationImpl::writeBuffer(SerializationImpl::memoryLayout(m),
+                                          static_cast<char *>(dst), Flags::IsStreaming,
+                                          withChecksum);
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile serialization.h <Vc/Serialization>
+ *
+ * Writes \p m to \p out in the format described at serialize(const MemoryBase &, void *).
+ * The entries are written directly from \p m.
+ */
+template <typename V, typename Parent, int Dimension, typename RM>
+inline SerializationResult serialize(const Common::MemoryBase<V, Parent, Dimension, RM> &m,
+                                     std::ostream &out, bool withChecksum = true)
+{
+    return SerializationImpl::writeStream(SerializationImpl::memoryLayout(m), out,
+                                          withChecksum);
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile serialization.h <Vc/Serialization>
+ *
+ * Reads data written by serialize() from the \p size bytes at \p src into \p m.
+ *
+ * For fixed-size Memory the entry type and the number of rows and entries must match.
+ * A dynamically sized Memory<V> is reallocated to the number of entries of the data,
+ * unless it already has that size. The entries are copied into the aligned memory of \p m
+ * directly. If the data was written with a different vector width, the row padding is
+ * adjusted. If reading fails after the header was validated, the contents of \p m are
+ * unspecified.
+ *
+ * \param verify Whether to verify the checksum (if the data has one).
+ */
+template <typename V, std::size_t Size1, std::size_t Size2, bool IP>
+inline SerializationResult deserialize(const void *src, std::size_t size,
+                                       Memory<V, Size1, Size2, IP> &m, bool verify = true)
+{
+    SerializationImpl::BufferSource source(src, size);
+    return SerializationImpl::readMemory(source, m, verify);
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile serialization.h <Vc/Serialization>
+ *
+ * Reads data written by serialize() from \p in into \p m.
+ *
+ * The sizes in the header are checked against the length of \p in before any memory is
+ * allocated. Streams that cannot seek (e.g. pipes) have no known length; for them only
+ * the subsequent reads fail.
+ *
+ * \see deserialize(const void *, std::size_t, Memory &, bool)
+ */
+template <typename V, std::size_t Size1, std::size_t Size2, bool IP>
+inline SerializationResult deserialize(std::istream &in, Memory<V, Size1, Size2, IP> &m,
+                                       bool verify = true)
+{
+    SerializationImpl::StreamSource source(in);
+    return SerializationImpl::readMemory(source, m, verify);
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile serialization.h <Vc/Serialization>
+ *
+ * Makes \p view refer to the entries of the serialized 1-dimensional Memory at \p src,
+ * without copying them. This is the read path for memory-mapped files:
+ * \code
+ * void *data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+ * Vc::MemoryView<float_v> view;
+ * if (Vc::view_serialized(data, size, view) == Vc::SerializationResult::Success) {
+ *   for (const float_v x : static_cast<const Vc::MemoryView<float_v> &>(view)) { ... }
+ * }
+ * \endcode
+ *
+ * The entries must be aligned on V::MemoryAlignment (which holds if \p src is
+ * page-aligned) and the data must be padded to a multiple of V::Size, i.e. it must have
+ * been written with the same or a larger multiple of the vector width. Otherwise the
+ * result is SerializationResult::Misaligned and the data has to be read with
+ * deserialize().
+ *
+ * \param verify Whether to verify the checksum. This reads all the data once.
+ */
+template <typename V>
+inline SerializationResult view_serialized(const void *src, std::size_t size,
+                                           MemoryView<V> &view, bool verify = false)
+{
+    using namespace SerializationImpl;
+    if (size < sizeof(Header)) {
+        return SerializationResult::IOError;
+    }
+    Header h;
+    std::memcpy(&h, src, sizeof(Header));
+    const SerializationResult r = checkHeader(h);
+    if (r != SerializationResult::Success) {
+        return r;
+    }
+    if (h.columns != 1 || h.rows != 1) {
+        return SerializationResult::SizeMismatch;
+    }
+    const char *const bytes = static_cast<const char *>(src);
+    typedef typename V::EntryType T;
+    if (static_cast<unsigned char>(bytes[BlockSize]) != typeCode<T>()) {
+        return SerializationResult::TypeMismatch;
+    }
+    const std::size_t payloadBytes = h.paddedEntriesPerRow * sizeof(T);
+    if (size < h.payloadOffset + payloadBytes) {
+        return SerializationResult::IOError;
+    }
+    const char *const payload = bytes + h.payloadOffset;
+    if (h.paddedEntriesPerRow % V::Size != 0 ||
+        reinterpret_cast<std::uintptr_t>(payload) % V::MemoryAlignment != 0) {
+        return SerializationResult::Misaligned;
+    }
+    if (verify && (h.flags & HasChecksum) &&
+        crc32c(payload, payloadBytes, crc32c(bytes + BlockSize, 1)) != h.checksum) {
+        return SerializationResult::ChecksumMismatch;
+    }
+    view = MemoryView<V>(reinterpret_cast<T *>(const_cast<char *>(payload)),
+                         h.entriesPerRow);
+    return SerializationResult::Success;
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile serialization.h <Vc/Serialization>
+ *
+ * Returns the number of bytes serialize() writes for \p v.
+ */
+template <typename T, std::size_t N>
+inline std::size_t serialized_size(const soa_vector<T, N> &v)
+{
+    return SerializationImpl::soaLayout(v).size();
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile serialization.h <Vc/Serialization>
+ *
+ * Writes \p v to the buffer at \p dst and returns the number of bytes written. Every data
+ * member is stored as one column, starting at a multiple of 64 bytes.
+ *
+ * \see serialize(const MemoryBase &, void *, Flags, bool)
+ */
+template <typename T, std::size_t N, typename Flags = DefaultStoreTag,
+          typename = enable_if<Traits::is_load_store_flag<Flags>::value>>
+inline std::size_t serialize(const soa_vector<T, N> &v, void *dst, Flags = Flags(),
+                             bool withChecksum = true)
+{
+    return SerializationImpl::writeBuffer(SerializationImpl::soaLayout(v),
+                                          static_cast<char *>(dst), Flags::IsStreaming,
+                                          withChecksum);
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile serialization.h <Vc/Serialization>
+ *
+ * Writes \p v to \p out.
+ */
+template <typename T, std::size_t N>
+inline SerializationResult serialize(const soa_vector<T, N> &v, std::ostream &out,
+                                     bool withChecksum = true)
+{
+    return SerializationImpl::writeStream(SerializationImpl::soaLayout(v), out,
+                                          withChecksum);
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile serialization.h <Vc/Serialization>
+ *
+ * Replaces the contents of \p v with the data written by serialize() at \p src. The
+ * member types must match.
+ */
+template <typename T, std::size_t N>
+inline SerializationResult deserialize(const void *src, std::size_t size,
+                                       soa_vector<T, N> &v, bool verify = true)
+{
+    SerializationImpl::BufferSource source(src, size);
+    return SerializationImpl::readSoa(source, v, verify);
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile serialization.h <Vc/Serialization>
+ *
+ * Replaces the contents of \p v with the data written by serialize() read from \p in.
+ */
+template <typename T, std::size_t N>
+inline SerializationResult deserialize(std::istream &in, soa_vector<T, N> &v,
+                                       bool verify = true)
+{
+    SerializationImpl::StreamSource source(in);
+    return SerializationImpl::readSoa(source, v, verify);
+}
+}  // namespace Vc
+
+#endif  // VC_COMMON_SERIALIZATION_H_
+
+// vim: foldmethod=marker
@@ -63,6 +63,46 @@ template <typename T, std::size_t N, typename V, std::size_t M>
 inline SimdArray<T, N, V, M> max(const SimdArray<T, N, V, M> &x,
                                  const SimdArray<T, N, V, M> &y);
 
+// simd_cast_halves {{{1
+/**\internal
+ * Converts the native vector \p x to the two native vectors \p r0 and \p r1, which receive
+ * the first and second half of the entries of \p x.
+ *
+ * This is the conversion a non-atomic SimdArray needs whenever the result type uses a
+ * narrower native vector than the argument, e.g. `SimdArray<int, 8>` from AVX::float_v on
+ * AVX (without AVX2). The generic implementation converts each half on its own. The SIMD
+ * implementations overload it where a single full-width conversion followed by a split
+ * is cheaper.
+ */
+template <typename V0, typename V1, typename From>
+Vc_INTRINSIC void simd_cast_halves(const From &x, V0 &r0, V1 &r1)
+{
+    r0 = simd_cast<V0>(x);
+    r1 = simd_cast<V1, 1>(x);
+}
+
+// converts_to_native_halves {{{1
+/**\internal
+ * Is \c true if \p Return is a non-atomic SimdArray with the same number of entries as
+ * \p From, where both halves of \p Return are a single native vector and \p From is a
+ * native vector or an atomic SimdArray.
+ */
+template <typename Return, typename From,
+          bool = Traits::isSimdArray<Return>::value &&
+                 !Traits::isAtomicSimdArray<Return>::value>
+struct converts_to_native_halves : public std::false_type {
+};
+template <typename Return, typename From>
+struct converts_to_native_halves<Return, From, true>
+    : public std::integral_constant<
+          bool, (Return::Size == From::Size && Traits::is_simd_vector<From>::value &&
+                 (!Traits::isSimdArray<From>::value ||
+                  Traits::isAtomicSimdArray<From>::value) &&
+                 Traits::isAtomicSimdArray<typename Return::storage_type0>::value &&
+                 std::is_same<typename Return::storage_type0,
+                              typename Return::storage_type1>::value)> {
+};
+
 // SimdArray class {{{1
 /// \addtogroup SimdArray
 /// @{
@@ -387,6 +427,12 @@ public:
     Vc_INTRINSIC SimdArray shifted(int amount, const SimdArray<value_type, NN> &shiftIn)
         const
     {
+        if (amount < 0 && NN > N) {
+            // entries are shifted in from the end of shiftIn
+            return {data.shifted(amount, simd_cast<VectorType>(shiftIn.shifted(int(NN) - int(N))))};
+        } else if (amount < 0 && NN < N) {
+            return {data.shifted(amount, simd_cast<VectorType>(shiftIn).shifted(int(NN) - int(N)))};
+        }
         return {data.shifted(amount, simd_cast<VectorType>(shiftIn))};
     }
 
@@ -581,7 +627,9 @@ public:
         enable_if<(Traits::is_simd_vector<V>::value && Traits::simd_vector_size<V>::value == N &&
                    !(std::is_convertible<Traits::entry_type_of<V>, T>::value &&
                      Traits::isSimdArray<V>::value))> = nullarg)
-        : data0(Split::lo(x)), data1(Split::hi(x))
+        : SimdArray(std::forward<V>(x),
+                    std::integral_constant<
+                        bool, converts_to_native_halves<SimdArray, Traits::decay<V>>::value>())
     {
     }
 
@@ -591,7 +639,9 @@ public:
         V &&x,
         enable_if<(Traits::isSimdArray<V>::value && Traits::simd_vector_size<V>::value == N &&
                    std::is_convertible<Traits::entry_type_of<V>, T>::value)> = nullarg)
-        : data0(Split::lo(x)), data1(Split::hi(x))
+        : SimdArray(std::forward<V>(x),
+                    std::integral_constant<
+                        bool, converts_to_native_halves<SimdArray, Traits::decay<V>>::value>())
     {
     }
 
@@ -904,13 +954,14 @@ public:
         shifted(int amount, const SimdArray<value_type, NN> &shiftIn) const
     {
         constexpr int SSize = Size;
+        constexpr int ShiftInSize = NN;
         if (amount < 0) {
             return SimdArray::generate([&](int i) -> value_type {
                 i += amount;
                 if (i >= 0) {
                     return operator[](i);
-                } else if (i >= -SSize) {
-                    return shiftIn[i + SSize];
+                } else if (i >= -ShiftInSize) {
+                    return shiftIn[i + ShiftInSize];
                 }
                 return 0;
             });
@@ -919,7 +970,7 @@ public:
             i += amount;
             if (i < SSize) {
                 return operator[](i);
-            } else if (i < 2 * SSize) {
+            } else if (i < SSize + ShiftInSize) {
                 return shiftIn[i - SSize];
             }
             return 0;
@@ -1002,7 +1053,7 @@ public:
             return {data0.shifted(amount, d1cvtd), std::move(d0cvtd)};
         } else if (int(size()) - amount < size1) {
             return {data0.shifted(amount - int(size()), d1cvtd.shifted(size1 - size0)),
-                    data1.shifted(amount - int(size()), data0.shifted(size0 - size1))};
+                    data1.shifted(amount - int(size()), data0)};
         } else if (int(size()) - amount == size1) {
             return {data0.shifted(-size1, d1cvtd.shifted(size1 - size0)),
                     simd_cast<storage_type1>(data0.shifted(size0 - size1))};
@@ -1150,6 +1201,28 @@ public:
     {
     }
 private: //{{{2
+    // casts from a single vector to both halves {{{2
+    template <typename V>
+    Vc_INTRINSIC SimdArray(V &&x, std::false_type)
+        : data0(Split::lo(x)), data1(Split::hi(x))
+    {
+    }
+    // the conversion from x is done with one call, see simd_cast_halves
+    template <typename V>
+    Vc_INTRINSIC SimdArray(V &&x, std::true_type)
+    {
+        simd_cast_halves(native_vector(x), internal_data(data0), internal_data(data1));
+    }
+    template <typename V> static Vc_INTRINSIC const V &native_vector(const V &x)
+    {
+        return x;
+    }
+    template <typename U, std::size_t M, typename V>
+    static Vc_INTRINSIC const V &native_vector(const SimdArray<U, M, V, M> &x)
+    {
+        return internal_data(x);
+    }
+
     storage_type0 data0;
     storage_type1 data1;
 };
@@ -1594,6 +1667,9 @@ Vc_INTRINSIC void vc_debug_(const char *, const char *, const T0 &, const Ts &..
                                      Traits::is_simd_##trait_name_<From>::value &&       \
                                      Common::left_size(Return::Size) <                   \
                                          From::Size * (1 + sizeof...(Froms)) &&          \
+                                     !(sizeof...(Froms) == 0 &&                          \
+                                       converts_to_native_halves<Return,                 \
+                                                                 From>::value) &&        \
                                      are_all_types_equal<From, Froms...>::value),        \
                                     Return>                                              \
     simd_cast(From x, Froms... xs)                                                       \
@@ -1624,6 +1700,20 @@ Vc_SIMDARRAY_CASTS(SimdArray, vector)
 Vc_SIMDARRAY_CASTS(SimdMaskArray, mask)
 #undef Vc_SIMDARRAY_CASTS
 
+// simd_cast<SimdArray>(V) to two native halves {{{2
+template <typename Return, typename From>
+Vc_INTRINSIC Vc_CONST
+    enable_if<(!Traits::isSimdArray<From>::value && Traits::is_simd_vector<From>::value &&
+               converts_to_native_halves<Return, From>::value),
+              Return>
+    simd_cast(From x)
+{
+    vc_debug_("simd_cast{halves}(", ")\n", x);
+    typename Return::storage_type0::storage_type r0, r1;
+    simd_cast_halves(x, r0, r1);
+    return {std::move(r0), std::move(r1)};
+}
+
 // simd_cast<SimdArray/-mask, offset>(V) {{{2
 #define Vc_SIMDARRAY_CASTS(SimdArrayType_, trait_name_)                                  \
     /* SIMD Vector/Mask to atomic SimdArray/simdmaskarray */                             \
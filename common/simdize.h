@@ -31,7 +31,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <tuple>
 #include <array>
+#include <vector>
 
+#include "interleavedmemory.h"
 #include "macros.h"
 
 /*!
@@ -956,7 +958,7 @@ inline S extract_impl(const Adapter<S, T, N> &a, size_t i, Vc::index_sequence<In
 {
     const std::tuple<decltype(decay_workaround(get_dispatcher<Indexes>(a)[i]))...> tmp(
         decay_workaround(get_dispatcher<Indexes>(a)[i])...);
-    return S(get_dispatcher<Indexes>(tmp)...);
+    return S{get_dispatcher<Indexes>(tmp)...};
 }
 
 /**
@@ -1145,10 +1147,175 @@ Vc_INTRINSIC V fromIteratorImpl(enable_if<(I < End), It> it)
     get_dispatcher<I>(r) = tmp;
     return r;
 }
+
+// contiguous structs {{{
+/**\internal
+ * Determines whether \p It is known to reference consecutive objects in memory. This is
+ * the case for pointers and the iterators of std::vector (with the default allocator or
+ * Vc::Allocator).
+ */
+template <typename It, typename S = typename std::iterator_traits<It>::value_type>
+struct is_contiguous_iterator
+    : public std::integral_constant<
+          bool,
+          (std::is_pointer<It>::value ||
+           std::is_same<It, typename std::vector<S>::iterator>::value ||
+           std::is_same<It, typename std::vector<S>::const_iterator>::value ||
+           std::is_same<It, typename std::vector<S, Allocator<S>>::iterator>::value ||
+           std::is_same<It, typename std::vector<S, Allocator<S>>::const_iterator>::value)>
+{
+};
+
+/**\internal
+ * Determines whether the simdized object \p V can be loaded from (and stored to) the
+ * scalar objects of type \p S with vector loads and in-register deinterleaving. This
+ * requires a standard-layout struct without padding whose members all simdize to
+ * Vc::Vector types with entries of the same size (e.g. \c float and \c int members in
+ * \c float_v and \c int_v objects of equal width). Whether get<N> really returns the
+ * members in the order of their declaration is checked at runtime with
+ * has_successive_members.
+ */
+template <typename W, bool = Traits::is_simd_vector_internal<W>::value>
+struct entry_size : public std::integral_constant<size_t, 0>
+{
+};
+template <typename W>
+struct entry_size<W, true>
+    : public std::integral_constant<size_t, sizeof(typename W::EntryType)>
+{
+};
+template <typename S, typename V, typename = make_index_sequence<determine_tuple_size<S>()>>
+struct is_interleaved_struct;
+template <typename S, typename V, size_t... Indexes>
+struct is_interleaved_struct<S, V, index_sequence<Indexes...>>
+{
+    typedef Traits::decay<decltype(get_dispatcher<0>(std::declval<V &>()))> first_vector;
+    static constexpr bool value =
+        std::is_class<S>::value && std::is_standard_layout<S>::value &&
+        sizeof...(Indexes) >= 2 && sizeof...(Indexes) <= 16 &&
+        Common::InterleavedMemoryImpl::all_compatible<
+            first_vector,
+            Traits::decay<decltype(get_dispatcher<Indexes>(std::declval<V &>()))>...>::value &&
+        sizeof(S) == sizeof...(Indexes) * entry_size<first_vector>::value;
+};
+
+template <typename It, typename V,
+          bool = !Traits::is_simd_vector<V>::value && is_contiguous_iterator<It>::value>
+struct is_contiguous_struct_iterator : public std::false_type
+{
+};
+template <typename It, typename V>
+struct is_contiguous_struct_iterator<It, V, true>
+    : public std::integral_constant<
+          bool, is_interleaved_struct<typename std::iterator_traits<It>::value_type,
+                                      V>::value>
+{
+};
+
+/**\internal
+ * Determines whether the backend deinterleave of successive structs with \p Members
+ * entries of \p EntrySize bytes reads nothing but the structs. Three members have their
+ * own kernel for successive structs, which loads exactly three vectors. The kernels for
+ * seven members (and five or six 16-bit members) load a whole vector per struct and would
+ * read past the last struct of the chunk, which may be the end of the array.
+ */
+template <std::size_t Members, std::size_t EntrySize>
+struct deinterleave_stays_in_bounds
+    : public std::integral_constant<bool, (Members == 2 || Members == 3 || Members == 4 ||
+                                           Members >= 8 ||
+                                           (EntrySize >= 4 && (Members == 5 ||
+                                                               Members == 6)))>
+{
+};
+
+template <typename It, typename V, bool = is_contiguous_struct_iterator<It, V>::value>
+struct is_deinterleavable_struct_iterator : public std::false_type
+{
+};
+template <typename It, typename V>
+struct is_deinterleavable_struct_iterator<It, V, true>
+    : public deinterleave_stays_in_bounds<
+          determine_tuple_size<typename std::iterator_traits<It>::value_type>(),
+          entry_size<typename is_interleaved_struct<
+              typename std::iterator_traits<It>::value_type, V>::first_vector>::value>
+{
+};
+
+/**\internal
+ * Returns whether the members of \p s returned by get<N> are stored in this order at
+ * consecutive addresses. The offsets are constant, thus the compiler folds the result.
+ */
+template <typename T, typename S, size_t... Indexes>
+Vc_INTRINSIC bool has_successive_members(const S &s, index_sequence<Indexes...>)
+{
+    const char *const base = reinterpret_cast<const char *>(std::addressof(s));
+    bool r = true;
+    auto &&unused = {(r = r && reinterpret_cast<const char *>(std::addressof(
+                                   get_dispatcher<Indexes>(s))) == base + Indexes * sizeof(T),
+                      0)...};
+    (void)unused;
+    return r;
+}
+
+template <typename It, typename V, size_t... Indexes>
+Vc_INTRINSIC bool deinterleaveStructs(const It &it, V &r, index_sequence<Indexes...> seq)
+{
+    typedef typename is_interleaved_struct<
+        typename std::iterator_traits<It>::value_type, V>::first_vector V0;
+    typedef typename V0::EntryType T;
+    const auto &first = *it;
+    if (!has_successive_members<T>(first, seq)) {
+        return false;
+    }
+    Common::InterleavedMemoryReadAccess<sizeof...(Indexes), V0,
+                                        Common::SuccessiveEntries<sizeof...(Indexes)>>(
+        reinterpret_cast<const T *>(std::addressof(first)), 0)
+        .deinterleave(get_dispatcher<Indexes>(r)...);
+    return true;
+}
+
+template <typename It, typename V, size_t... Indexes>
+Vc_INTRINSIC bool interleaveStructs(const It &it, const V &x, index_sequence<Indexes...> seq)
+{
+    typedef typename is_interleaved_struct<
+        typename std::iterator_traits<It>::value_type, V>::first_vector V0;
+    typedef typename V0::EntryType T;
+    auto &first = *it;
+    if (!has_successive_members<T>(first, seq)) {
+        return false;
+    }
+    Common::InterleavedMemoryAccess<sizeof...(Indexes), V0,
+                                    Common::SuccessiveEntries<sizeof...(Indexes)>>(
+        reinterpret_cast<T *>(std::addressof(first)), 0)
+        .interleave(get_dispatcher<Indexes>(x)...);
+    return true;
+}
+// }}}
+
+template <typename It, typename V>
+Vc_INTRINSIC V fromIterator(const It &it, std::false_type)
+{
+    using S = typename std::iterator_traits<It>::value_type;
+    return fromIteratorImpl<It, V, 0, determine_tuple_size<S>()>(it);
+}
+/**\internal
+ * Loads Size consecutive structs with vector loads and deinterleaves them into the
+ * members of the simdized object, instead of copying one member of one lane at a time.
+ */
+template <typename It, typename V>
+Vc_INTRINSIC V fromIterator(const It &it, std::true_type)
+{
+    using S = typename std::iterator_traits<It>::value_type;
+    V r;
+    if (!deinterleaveStructs(it, r, make_index_sequence<determine_tuple_size<S>()>())) {
+        r = fromIteratorImpl<It, V, 0, determine_tuple_size<S>()>(it);
+    }
+    return r;
+}
 template <typename It, typename V>
 Vc_INTRINSIC V fromIterator(enable_if<!Traits::is_simd_vector<V>::value, const It &> it)
 {
-    return fromIteratorImpl<It, V, 0, determine_tuple_size<V>()>(it);
+    return fromIterator<It, V>(it, is_deinterleavable_struct_iterator<It, V>());
 }
 template <typename It, typename V>
 Vc_INTRINSIC V fromIterator(enable_if<Traits::is_simd_vector<V>::value, It> it)
@@ -1160,6 +1327,30 @@ Vc_INTRINSIC V fromIterator(enable_if<Traits::is_simd_vector<V>::value, It> it)
     return r;
 }
 
+/**\internal
+ * Stores the Size entries of \p x to the scalar objects starting at \p it. This is the
+ * reverse of fromIterator: contiguous structs are written with interleaving vector stores.
+ */
+template <typename It, typename V>
+Vc_INTRINSIC void toIterator(const V &x, It it, std::false_type)
+{
+    for (size_t i = 0; i < V::size(); ++i, ++it) {
+        *it = extract(x, i);
+    }
+}
+template <typename It, typename V>
+Vc_INTRINSIC void toIterator(const V &x, const It &it, std::true_type)
+{
+    using S = typename std::iterator_traits<It>::value_type;
+    if (!interleaveStructs(it, x, make_index_sequence<determine_tuple_size<S>()>())) {
+        toIterator(x, it, std::false_type());
+    }
+}
+template <typename It, typename V> Vc_INTRINSIC void toIterator(const V &x, const It &it)
+{
+    toIterator(x, it, is_contiguous_struct_iterator<It, V>());
+}
+
 // Note: §13.5.6 says: “An expression x->m is interpreted as (x.operator->())->m for a
 // class object x of type T if T::operator->() exists and if the operator is selected as
 // the best match function by the overload resolution mechanism (13.3).”
@@ -1201,9 +1392,7 @@ public:
     ~Pointer()
     {
         // store data back to where it came from
-        for (size_t i = 0; i < Size; ++i, ++begin_iterator) {
-            *begin_iterator = extract(data, i);
-        }
+        toIterator(data, begin_iterator);
     }
 
     /// Construct the Pointer object from the values returned by the scalar iterator \p it.
@@ -1285,10 +1474,7 @@ public:
     void operator=(const value_vector &x)
     {
         static_cast<value_vector &>(*this) = x;
-        auto it = scalar_it;
-        for (size_t i = 0; i < Size; ++i, ++it) {
-            *it = extract(x, i);
-        }
+        toIterator(x, scalar_it);
     }
 };
 
@@ -215,6 +215,13 @@ public:
      */
     Vc_INTRINSIC Vc_PURE int firstOne() const { return data.firstOne(); }
 
+    /**
+     * Returns the index of the last one in the mask.
+     *
+     * The return value is undefined if the mask is empty.
+     */
+    Vc_INTRINSIC Vc_PURE int lastOne() const { return data.lastOne(); }
+
     template <typename G> static Vc_INTRINSIC SimdMaskArray generate(const G &gen)
     {
         return {mask_type::generate(gen)};
@@ -495,6 +502,13 @@ public:
         return data0.firstOne();
     }
 
+    Vc_INTRINSIC Vc_PURE int lastOne() const {
+        if (data1.isEmpty()) {
+            return data0.lastOne();
+        }
+        return data1.lastOne() + storage_type0::size();
+    }
+
     template <typename G> static Vc_INTRINSIC SimdMaskArray generate(const G &gen)
     {
         return {storage_type0::generate(gen),
@@ -0,0 +1,354 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_SMALLMATRIX_H_
+#define VC_COMMON_SMALLMATRIX_H_
+
+#include <cmath>
+#include <cstddef>
+#include "iif.h"
+#include "macros.h"
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+namespace Common
+{
+// SmallMatrix {{{1
+/**
+ * \ingroup Utilities
+ * \headerfile smallmatrix.h <Vc/Matrix>
+ *
+ * A matrix with compile-time extents, intended for sizes up to roughly 8×8.
+ *
+ * The entry type \p T may be a fundamental arithmetic type or a Vc vector type. In the
+ * latter case the object stores \c T::Size independent matrices, one per SIMD lane (i.e.
+ * structure of arrays). All functions in this header are written for both cases. Thus,
+ * the same code multiplies, inverts, or decomposes a single matrix or \c T::Size
+ * matrices at once.
+ *
+ * The class supports \ref simdize, so that \c simdize<SmallMatrix<float, 5>> is the SoA
+ * type for \c SmallMatrix<float, 5>, and \c assign / \c extract convert between the two:
+ * \code
+ * using Cov = Vc::SmallMatrix<float, 5>;
+ * using CovV = Vc::simdize<Cov>;
+ * CovV c;
+ * for (std::size_t i = 0; i < CovV::size(); ++i) {
+ *   assign(c, i, covariances[first + i]);
+ * }
+ * const auto l = cholesky(c);  // decomposes CovV::size() matrices
+ * \endcode
+ *
+ * \tparam T The entry type.
+ * \tparam Rows The number of rows.
+ * \tparam Cols The number of columns.
+ */
+template <typename T, std::size_t Rows, std::size_t Cols = Rows> class SmallMatrix
+{
+    static_assert(Rows > 0 && Cols > 0, "SmallMatrix requires non-zero extents");
+    T m_data[Rows * Cols];
+
+public:
+    typedef T value_type;
+
+    /// The number of rows.
+    static constexpr std::size_t rows() { return Rows; }
+    /// The number of columns.
+    static constexpr std::size_t cols() { return Cols; }
+
+    /**
+     * Default initialization. Entries of fundamental type are left uninitialized, Vc
+     * vector entries are zero.
+     */
+    SmallMatrix() = default;
+
+    /**
+     * Initializes the matrix from \c Rows * \c Cols values in row-major order.
+     */
+    template <typename... Ts,
+              typename = enable_if<(Rows * Cols > 1 && sizeof...(Ts) == Rows * Cols)>>
+    SmallMatrix(const Ts &... values)
+        : m_data{static_cast<T>(values)...}
+    {
+    }
+
+    /// Returns a matrix with all entries set to zero.
+    static SmallMatrix zero()
+    {
+        SmallMatrix r;
+        for (std::size_t i = 0; i < Rows * Cols; ++i) {
+            r.m_data[i] = T(0);
+        }
+        return r;
+    }
+
+    /// Returns a matrix with ones on the diagonal and zeros elsewhere.
+    static SmallMatrix identity()
+    {
+        SmallMatrix r = zero();
+        for (std::size_t i = 0; i < Rows && i < Cols; ++i) {
+            r(i, i) = T(1);
+        }
+        return r;
+    }
+
+    /// Returns a reference to the entry in row \p i and column \p j.
+    Vc_ALWAYS_INLINE T &operator()(std::size_t i, std::size_t j)
+    {
+        return m_data[i * Cols + j];
+    }
+    /// Const overload of the above function.
+    Vc_ALWAYS_INLINE const T &operator()(std::size_t i, std::size_t j) const
+    {
+        return m_data[i * Cols + j];
+    }
+
+    ///\internal simdize interface
+    template <std::size_t N_> Vc_ALWAYS_INLINE T &vc_get_() { return m_data[N_]; }
+    ///\internal simdize interface
+    template <std::size_t N_> Vc_ALWAYS_INLINE const T &vc_get_() const
+    {
+        return m_data[N_];
+    }
+    enum : std::size_t { tuple_size = Rows * Cols };
+
+    SmallMatrix &operator+=(const SmallMatrix &rhs)
+    {
+        for (std::size_t i = 0; i < Rows * Cols; ++i) {
+            m_data[i] += rhs.m_data[i];
+        }
+        return *this;
+    }
+    SmallMatrix &operator-=(const SmallMatrix &rhs)
+    {
+        for (std::size_t i = 0; i < Rows * Cols; ++i) {
+            m_data[i] -= rhs.m_data[i];
+        }
+        return *this;
+    }
+    SmallMatrix &operator*=(const T &rhs)
+    {
+        for (std::size_t i = 0; i < Rows * Cols; ++i) {
+            m_data[i] *= rhs;
+        }
+        return *this;
+    }
+};
+
+// arithmetic operators {{{1
+template <typename T, std::size_t R, std::size_t C>
+inline SmallMatrix<T, R, C> operator+(SmallMatrix<T, R, C> a, const SmallMatrix<T, R, C> &b)
+{
+    return a += b;
+}
+template <typename T, std::size_t R, std::size_t C>
+inline SmallMatrix<T, R, C> operator-(SmallMatrix<T, R, C> a, const SmallMatrix<T, R, C> &b)
+{
+    return a -= b;
+}
+template <typename T, std::size_t R, std::size_t C>
+inline SmallMatrix<T, R, C> operator*(SmallMatrix<T, R, C> a, const T &b)
+{
+    return a *= b;
+}
+template <typename T, std::size_t R, std::size_t C>
+inline SmallMatrix<T, R, C> operator*(const T &a, SmallMatrix<T, R, C> b)
+{
+    return b *= a;
+}
+
+/**
+ * Returns the matrix product of \p a and \p b.
+ */
+template <typename T, std::size_t R, std::size_t K, std::size_t C>
+inline SmallMatrix<T, R, C> operator*(const SmallMatrix<T, R, K> &a,
+                                      const SmallMatrix<T, K, C> &b)
+{
+    SmallMatrix<T, R, C> r;
+    for (std::size_t i = 0; i < R; ++i) {
+        for (std::size_t j = 0; j < C; ++j) {
+            T sum = a(i, 0) * b(0, j);
+            for (std::size_t k = 1; k < K; ++k) {
+                sum += a(i, k) * b(k, j);
+            }
+            r(i, j) = sum;
+        }
+    }
+    return r;
+}
+
+// transpose {{{1
+/**
+ * Returns the transposed matrix.
+ */
+template <typename T, std::size_t R, std::size_t C>
+inline SmallMatrix<T, C, R> transpose(const SmallMatrix<T, R, C> &a)
+{
+    SmallMatrix<T, C, R> r;
+    for (std::size_t i = 0; i < R; ++i) {
+        for (std::size_t j = 0; j < C; ++j) {
+            r(j, i) = a(i, j);
+        }
+    }
+    return r;
+}
+
+// inverse {{{1
+namespace SmallMatrixImpl
+{
+template <typename M, typename T> Vc_ALWAYS_INLINE void conditionalSwap(const M &k, T &a, T &b)
+{
+    const T tmp = iif(k, b, a);
+    b = iif(k, a, b);
+    a = tmp;
+}
+}  // namespace SmallMatrixImpl
+
+/**
+ * Returns the inverse of the square matrix \p a.
+ *
+ * The implementation uses Gauss-Jordan elimination with partial pivoting. The pivot row is
+ * chosen independently for every SIMD lane, using blends instead of branches. Lanes
+ * holding a singular matrix produce non-finite entries without affecting the other lanes.
+ */
+template <typename T, std::size_t N>
+inline SmallMatrix<T, N, N> inverse(SmallMatrix<T, N, N> a)
+{
+    using std::abs;
+    SmallMatrix<T, N, N> r = SmallMatrix<T, N, N>::identity();
+    for (std::size_t k = 0; k < N; ++k) {
+        // after this loop row k holds the largest pivot candidate of column k
+        for (std::size_t i = k + 1; i < N; ++i) {
+            const auto swap = abs(a(i, k)) > abs(a(k, k));
+            for (std::size_t j = k; j < N; ++j) {
+                SmallMatrixImpl::conditionalSwap(swap, a(k, j), a(i, j));
+            }
+            for (std::size_t j = 0; j < N; ++j) {
+                SmallMatrixImpl::conditionalSwap(swap, r(k, j), r(i, j));
+            }
+        }
+        const T pivotInv = T(1) / a(k, k);
+        for (std::size_t j = k + 1; j < N; ++j) {
+            a(k, j) *= pivotInv;
+        }
+        for (std::size_t j = 0; j < N; ++j) {
+            r(k, j) *= pivotInv;
+        }
+        for (std::size_t i = 0; i < N; ++i) {
+            if (i != k) {
+                const T f = a(i, k);
+                for (std::size_t j = k + 1; j < N; ++j) {
+                    a(i, j) -= f * a(k, j);
+                }
+                for (std::size_t j = 0; j < N; ++j) {
+                    r(i, j) -= f * r(k, j);
+                }
+            }
+        }
+    }
+    return r;
+}
+
+// cholesky {{{1
+/**
+ * Returns the lower triangular matrix \c L with \c L * transpose(L) == \p a.
+ *
+ * Only the lower triangle of \p a is read. The upper triangle of the result is zero. If a
+ * matrix is not positive definite, the corresponding lane of the result contains NaNs.
+ */
+template <typename T, std::size_t N>
+inline SmallMatrix<T, N, N> cholesky(const SmallMatrix<T, N, N> &a)
+{
+    using std::sqrt;
+    SmallMatrix<T, N, N> l = SmallMatrix<T, N, N>::zero();
+    for (std::size_t j = 0; j < N; ++j) {
+        T d = a(j, j);
+        for (std::size_t k = 0; k < j; ++k) {
+            d -= l(j, k) * l(j, k);
+        }
+        l(j, j) = sqrt(d);
+        const T dInv = T(1) / l(j, j);
+        for (std::size_t i = j + 1; i < N; ++i) {
+            T s = a(i, j);
+            for (std::size_t k = 0; k < j; ++k) {
+                s -= l(i, k) * l(j, k);
+            }
+            l(i, j) = s * dInv;
+        }
+    }
+    return l;
+}
+
+/**
+ * Returns the inverse of the symmetric positive definite matrix \p a.
+ *
+ * This is cheaper and numerically more stable than inverse() for covariance matrices. Only
+ * the lower triangle of \p a is read; the result is symmetric.
+ */
+template <typename T, std::size_t N>
+inline SmallMatrix<T, N, N> choleskyInverse(const SmallMatrix<T, N, N> &a)
+{
+    const SmallMatrix<T, N, N> l = cholesky(a);
+    // invert L by forward substitution
+    SmallMatrix<T, N, N> li = SmallMatrix<T, N, N>::zero();
+    for (std::size_t i = 0; i < N; ++i) {
+        li(i, i) = T(1) / l(i, i);
+        for (std::size_t j = 0; j < i; ++j) {
+            T s = l(i, j) * li(j, j);
+            for (std::size_t k = j + 1; k < i; ++k) {
+                s += l(i, k) * li(k, j);
+            }
+            li(i, j) = -s * li(i, i);
+        }
+    }
+    // a⁻¹ = transpose(li) * li
+    SmallMatrix<T, N, N> r;
+    for (std::size_t i = 0; i < N; ++i) {
+        for (std::size_t j = 0; j <= i; ++j) {
+            T s = li(i, i) * li(i, j);
+            for (std::size_t k = i + 1; k < N; ++k) {
+                s += li(k, i) * li(k, j);
+            }
+            r(i, j) = s;
+            r(j, i) = s;
+        }
+    }
+    return r;
+}
+//}}}1
+}  // namespace Common
+
+using Common::SmallMatrix;
+using Common::transpose;
+using Common::inverse;
+using Common::cholesky;
+using Common::choleskyInverse;
+}  // namespace Vc
+
+#endif  // VC_COMMON_SMALLMATRIX_H_
+
+// vim: foldmethod=marker
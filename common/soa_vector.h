@@ -0,0 +1,413 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_SOA_VECTOR_H_
+#define VC_COMMON_SOA_VECTOR_H_
+
+#include <iterator>
+#include <tuple>
+#include <vector>
+#include "simdize.h"
+#include "macros.h"
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+namespace SimdizeDetail
+{
+/**\internal
+ * The type of the \p I-th data member of \p T as seen through the simdize get interface.
+ */
+template <typename T, std::size_t I>
+using member_type = Traits::decay<decltype(get_dispatcher<I>(std::declval<T &>()))>;
+
+/**\internal
+ * One aligned std::vector per data member of \p T.
+ */
+template <typename T, typename Seq> struct SoaColumns;
+template <typename T, std::size_t... I> struct SoaColumns<T, Vc::index_sequence<I...>>
+{
+    using type =
+        std::tuple<std::vector<member_type<T, I>, Vc::Allocator<member_type<T, I>>>...>;
+
+    template <bool...> struct Bools;
+    /// std::vector<bool> has no contiguous data() to load vectors from
+    static constexpr bool hasBoolMember =
+        !std::is_same<Bools<false, std::is_same<member_type<T, I>, bool>::value...>,
+                      Bools<std::is_same<member_type<T, I>, bool>::value..., false>>::value;
+};
+}  // namespace SimdizeDetail
+
+/**
+ * \ingroup Simdize
+ *
+ * A container for objects of type \p T that stores each data member in its own aligned
+ * array (structure of arrays).
+ *
+ * \p T must support the simdize get interface (e.g. via Vc_SIMDIZE_INTERFACE or by being a
+ * std::tuple/std::array) and must not have \c bool data members. Scalar element access works through proxy objects that
+ * convert to and from \p T. Vectorized access uses simdize<T, N> objects, which are
+ * loaded and stored with one vector load/store per data member instead of gathering
+ * lane by lane:
+ * \code
+ * Vc::soa_vector<Point> points;
+ * points.push_back({1.f, 2.f, 3.f});
+ * ...
+ * for (auto &&chunk : points.vectors()) {
+ *   simdize<Point> p = chunk;         // loads simd_width points
+ *   p.x() += 1.f;
+ *   chunk = p;                        // stores back (only the valid lanes are used)
+ *   count += chunk.mask().count();    // the last chunk may be partially filled
+ * }
+ * \endcode
+ *
+ * The arrays are padded to a multiple of simd_width entries, so that vector loads and
+ * stores of the last chunk never access memory outside of the allocation.
+ *
+ * \tparam T The scalar struct type.
+ * \tparam N The width of the vectorized type, as in simdize<T, N>. The default lets
+ *           simdize choose.
+ */
+template <typename T, std::size_t N = 0> class soa_vector
+{
+    using IndexSeq = Vc::make_index_sequence<SimdizeDetail::determine_tuple_size<T>()>;
+    using Columns = typename SimdizeDetail::SoaColumns<T, IndexSeq>::type;
+    static_assert(!SimdizeDetail::SoaColumns<T, IndexSeq>::hasBoolMember,
+                  "soa_vector does not support bool data members (the column would be a "
+                  "std::vector<bool>); use an integral type such as unsigned char instead");
+
+public:
+    /// The scalar type.
+    using value_type = T;
+    /// The vectorized type.
+    using simd_type = simdize<T, N>;
+    /// The number of entries in one simd_type object.
+    static constexpr std::size_t simd_width = simd_type::size();
+    /// The mask type identifying the valid entries of a simd_type chunk.
+    using mask_type = simdize<bool, simd_width>;
+
+    // reference {{{1
+    /**
+     * Proxy object for one entry. It converts to \p T and can be assigned from \p T.
+     */
+    class reference
+    {
+        friend class soa_vector;
+        soa_vector *m_container;
+        std::size_t m_index;
+        reference(soa_vector *c, std::size_t i) : m_container(c), m_index(i) {}
+
+    public:
+        /// Returns a reference to the \p I-th data member.
+        template <std::size_t I>
+        SimdizeDetail::member_type<T, I> &get() const
+        {
+            return std::get<I>(m_container->m_columns)[m_index];
+        }
+
+        operator T() const { return m_container->get(m_index, IndexSeq()); }
+
+        reference &operator=(const T &x)
+        {
+            m_container->set(m_index, x, IndexSeq());
+            return *this;
+        }
+        reference &operator=(const reference &x) { return operator=(T(x)); }
+    };
+
+    // chunk {{{1
+    /**
+     * Read-only proxy object for simd_width entries starting at an index that is a
+     * multiple of simd_width.
+     */
+    class const_chunk
+    {
+        friend class soa_vector;
+
+    protected:
+        const soa_vector *m_container;
+        std::size_t m_index;
+        const_chunk(const soa_vector *c, std::size_t i) : m_container(c), m_index(i) {}
+
+    public:
+        /// Returns the index of the first entry in this chunk.
+        std::size_t index() const { return m_index; }
+
+        /// Returns the mask of entries that are part of the container.
+        mask_type mask() const
+        {
+            return simdize<float, simd_width>::IndexesFromZero() <
+                   float(m_container->size() - m_index);
+        }
+
+        /// Loads the entries.
+        operator simd_type() const { return m_container->load(m_index, Vc::Aligned); }
+    };
+
+    /**
+     * Proxy object for simd_width entries starting at an index that is a multiple of
+     * simd_width.
+     */
+    class chunk : public const_chunk
+    {
+        friend class soa_vector;
+        chunk(soa_vector *c, std::size_t i) : const_chunk(c, i) {}
+
+    public:
+        /**
+         * Stores \p x to the entries of this chunk. Values in lanes outside of mask()
+         * end up in the padding and are not observable.
+         */
+        chunk &operator=(const simd_type &x)
+        {
+            // chunks are only created for non-const containers
+            const_cast<soa_vector *>(this->m_container)
+                ->store(this->m_index, x, Vc::Aligned);
+            return *this;
+        }
+    };
+
+    // iterators {{{1
+    /**
+     * Random access iterator over the entries of the container \p C, yielding proxies
+     * of type \p R.
+     */
+    template <typename R, typename C> class basic_iterator
+    {
+        friend class soa_vector;
+        C *m_container;
+        std::size_t m_index;
+        std::size_t m_step;
+        basic_iterator(C *c, std::size_t i, std::size_t step)
+            : m_container(c), m_index(i), m_step(step)
+        {
+        }
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = R;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = R;
+
+        R operator*() const { return {m_container, m_index}; }
+        basic_iterator &operator++()
+        {
+            m_index += m_step;
+            return *this;
+        }
+        basic_iterator operator++(int)
+        {
+            basic_iterator r = *this;
+            m_index += m_step;
+            return r;
+        }
+        bool operator==(const basic_iterator &rhs) const { return m_index == rhs.m_index; }
+        bool operator!=(const basic_iterator &rhs) const { return m_index != rhs.m_index; }
+    };
+    using iterator = basic_iterator<reference, soa_vector>;
+    using chunk_iterator = basic_iterator<chunk, soa_vector>;
+    using const_chunk_iterator = basic_iterator<const_chunk, const soa_vector>;
+
+    /**
+     * The return type of vectors(). Iterating over it yields chunk (or const_chunk)
+     * objects.
+     */
+    template <typename It, typename C> class basic_chunk_range
+    {
+        friend class soa_vector;
+        C *m_container;
+        basic_chunk_range(C *c) : m_container(c) {}
+
+    public:
+        It begin() const { return {m_container, 0, simd_width}; }
+        It end() const
+        {
+            return {m_container, m_container->vectorsCount() * simd_width, simd_width};
+        }
+    };
+    using chunk_range = basic_chunk_range<chunk_iterator, soa_vector>;
+    using const_chunk_range = basic_chunk_range<const_chunk_iterator, const soa_vector>;
+
+    //}}}1
+
+    /// Constructs an empty container.
+    soa_vector() = default;
+
+    /// Constructs a container with \p n value-initialized entries.
+    explicit soa_vector(std::size_t n) { resize(n); }
+
+    /// Constructs a container with \p n copies of \p value.
+    soa_vector(std::size_t n, const T &value) { resize(n, value); }
+
+    /// Returns the number of entries.
+    std::size_t size() const { return m_size; }
+    /// Returns whether the container has no entries.
+    bool empty() const { return m_size == 0; }
+    /// Returns the number of simd_type chunks needed to cover all entries.
+    std::size_t vectorsCount() const { return (m_size + simd_width - 1) / simd_width; }
+    /// Returns the number of entries that fit without reallocation.
+    std::size_t capacity() const { return std::get<0>(m_columns).capacity(); }
+
+    /// Makes sure that \p n entries fit without reallocation.
+    void reserve(std::size_t n) { reserve_impl(padded(n), IndexSeq()); }
+
+    /// Removes all entries.
+    void clear() { resize_impl(0, IndexSeq()); m_size = 0; }
+
+    /**
+     * Resizes the container to \p n entries. New entries are value-initialized.
+     */
+    void resize(std::size_t n) { resize(n, T()); }
+
+    /**
+     * Resizes the container to \p n entries. New entries are initialized to \p value.
+     */
+    void resize(std::size_t n, const T &value)
+    {
+        resize_impl(padded(n), IndexSeq());
+        for (std::size_t i = m_size; i < n; ++i) {
+            set(i, value, IndexSeq());
+        }
+        m_size = n;
+    }
+
+    /// Appends \p x.
+    void push_back(const T &x)
+    {
+        if (m_size == std::get<0>(m_columns).size()) {
+            resize_impl(m_size + simd_width, IndexSeq());
+        }
+        set(m_size, x, IndexSeq());
+        ++m_size;
+    }
+
+    /// Returns a proxy for the entry at \p i.
+    reference operator[](std::size_t i) { return {this, i}; }
+    /// Returns a copy of the entry at \p i.
+    T operator[](std::size_t i) const { return get(i, IndexSeq()); }
+
+    /// Returns a pointer to the aligned array of the \p I-th data member.
+    template <std::size_t I> SimdizeDetail::member_type<T, I> *data()
+    {
+        return std::get<I>(m_columns).data();
+    }
+    /// Const overload of the above function.
+    template <std::size_t I> const SimdizeDetail::member_type<T, I> *data() const
+    {
+        return std::get<I>(m_columns).data();
+    }
+
+    /**
+     * Loads the simd_width entries starting at \p i with one vector load per data member.
+     *
+     * \param i The index of the first entry. \p i + simd_width may exceed size(), but not
+     *          the padded size `vectorsCount() * simd_width`.
+     * \param flags Pass Vc::Aligned if \p i is a multiple of simd_width.
+     */
+    template <typename Flags = DefaultLoadTag>
+    simd_type load(std::size_t i, Flags flags = Flags()) const
+    {
+        Vc_ASSERT(i + simd_width <= vectorsCount() * simd_width);
+        simd_type r;
+        load_impl(r, i, flags, IndexSeq());
+        return r;
+    }
+
+    /**
+     * Stores \p x to the simd_width entries starting at \p i.
+     *
+     * \see load
+     */
+    template <typename Flags = DefaultLoadTag>
+    void store(std::size_t i, const simd_type &x, Flags flags = Flags())
+    {
+        Vc_ASSERT(i + simd_width <= vectorsCount() * simd_width);
+        store_impl(x, i, flags, IndexSeq());
+    }
+
+    /// Returns an iterator to the first entry.
+    iterator begin() { return {this, 0, 1}; }
+    /// Returns an iterator past the last entry.
+    iterator end() { return {this, m_size, 1}; }
+
+    /// Returns a range over the simd_type chunks of the container.
+    chunk_range vectors() { return {this}; }
+    /// Returns a read-only range over the simd_type chunks of the container.
+    const_chunk_range vectors() const { return {this}; }
+
+private:
+    static std::size_t padded(std::size_t n)
+    {
+        return (n + simd_width - 1) / simd_width * simd_width;
+    }
+
+    template <std::size_t... I> T get(std::size_t i, Vc::index_sequence<I...>) const
+    {
+        return T{std::get<I>(m_columns)[i]...};
+    }
+    template <std::size_t... I>
+    void set(std::size_t i, const T &x, Vc::index_sequence<I...>)
+    {
+        auto &&unused = {(std::get<I>(m_columns)[i] = SimdizeDetail::get_dispatcher<I>(x), 0)...};
+        if (&unused == &unused) {}
+    }
+    template <std::size_t... I> void resize_impl(std::size_t n, Vc::index_sequence<I...>)
+    {
+        auto &&unused = {(std::get<I>(m_columns).resize(n), 0)...};
+        if (&unused == &unused) {}
+    }
+    template <std::size_t... I> void reserve_impl(std::size_t n, Vc::index_sequence<I...>)
+    {
+        auto &&unused = {(std::get<I>(m_columns).reserve(n), 0)...};
+        if (&unused == &unused) {}
+    }
+    template <typename Flags, std::size_t... I>
+    void load_impl(simd_type &r, std::size_t i, Flags f, Vc::index_sequence<I...>) const
+    {
+        auto &&unused = {(SimdizeDetail::get_dispatcher<I>(r).load(
+                              std::get<I>(m_columns).data() + i, f),
+                          0)...};
+        if (&unused == &unused) {}
+    }
+    template <typename Flags, std::size_t... I>
+    void store_impl(const simd_type &x, std::size_t i, Flags f, Vc::index_sequence<I...>)
+    {
+        auto &&unused = {(SimdizeDetail::get_dispatcher<I>(x).store(
+                              std::get<I>(m_columns).data() + i, f),
+                          0)...};
+        if (&unused == &unused) {}
+    }
+
+    Columns m_columns;
+    std::size_t m_size = 0;
+};
+}  // namespace Vc
+
+#endif  // VC_COMMON_SOA_VECTOR_H_
+
+// vim: foldmethod=marker
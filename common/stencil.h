@@ -0,0 +1,550 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_STENCIL_H_
+#define VC_COMMON_STENCIL_H_
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include <Vc/cpuid.h>
+#include "concurrency.h"
+#include "memory.h"
+#include "pitchedmemory.h"
+#include "macros.h"
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+namespace Detail
+{
+// constexpr helpers {{{1
+constexpr int stencilNth(std::size_t) { return 0; }
+template <typename... Ints>
+constexpr int stencilNth(std::size_t n, int first, Ints... rest)
+{
+    return n == 0 ? first : stencilNth(n - 1, rest...);
+}
+
+constexpr int stencilMax(int a) { return a; }
+template <typename... Ints> constexpr int stencilMax(int a, int b, Ints... rest)
+{
+    return stencilMax(a > b ? a : b, rest...);
+}
+
+constexpr int stencilFloorDiv(int a, int b) { return a >= 0 ? a / b : -((b - 1 - a) / b); }
+//}}}1
+}  // namespace Detail
+
+// stencil_point {{{1
+/**
+ * \ingroup Utilities
+ * \headerfile stencil.h <Vc/Stencil>
+ *
+ * Names one point of a stencil by its offsets relative to the updated entry, one offset per
+ * dimension. The last offset is along the innermost (contiguous) dimension.
+ *
+ * \code
+ * Vc::stencil_point<0, -1, 0>  // the entry one row above in a 3-D grid
+ * \endcode
+ */
+template <int... Offsets> struct stencil_point
+{
+    static constexpr std::size_t Dimension = sizeof...(Offsets);
+    /// Returns the offset in dimension \p d.
+    static constexpr int offset(std::size_t d) { return Detail::stencilNth(d, Offsets...); }
+};
+
+namespace Detail
+{
+// StencilTaps {{{1
+// Every point of the stencil keeps the input vectors it needs in registers. For the output
+// vector j a point with offset Dx along the row reads the entries
+// [j * Size + Dx, (j + 1) * Size + Dx), i.e. the vectors K = floor(Dx / Size) and K + 1
+// relative to j, shifted by R = Dx - K * Size. Moving on to vector j + 1 rotates K + 1 into
+// K and loads one new aligned vector. Points in the same input row load the same
+// addresses, which the compiler merges.
+template <typename V, std::size_t I, typename... Points> struct StencilTaps
+{
+    typedef typename V::EntryType T;
+    Vc_INTRINSIC void init(const T *, const std::ptrdiff_t *, std::ptrdiff_t, std::size_t) {}
+    Vc_INTRINSIC V accumulate(const V *, V acc) const { return acc; }
+    Vc_INTRINSIC void advance(std::ptrdiff_t, std::size_t) {}
+};
+
+template <typename V, std::size_t I, typename P, typename... Rest>
+struct StencilTaps<V, I, P, Rest...> : public StencilTaps<V, I + 1, Rest...>
+{
+    typedef StencilTaps<V, I + 1, Rest...> Base;
+    typedef typename V::EntryType T;
+    static constexpr int Dx = P::offset(P::Dimension - 1);
+    static constexpr int K = stencilFloorDiv(Dx, int(V::Size));
+    static constexpr int R = Dx - K * int(V::Size);
+
+    const T *row;
+    V lo, hi;
+
+    // entries outside of the (padded) row read as zero
+    static Vc_INTRINSIC V load(const T *row, std::ptrdiff_t j, std::size_t rowVectors)
+    {
+        return std::size_t(j) < rowVectors ? V(row + j * std::ptrdiff_t(V::Size), Vc::Aligned)
+                                           : V::Zero();
+    }
+
+    Vc_INTRINSIC void init(const T *center, const std::ptrdiff_t *rowOffsets, std::ptrdiff_t j,
+                           std::size_t rowVectors)
+    {
+        row = center + rowOffsets[I];
+        lo = load(row, j + K, rowVectors);
+        hi = R == 0 ? lo : load(row, j + K + 1, rowVectors);
+        Base::init(center, rowOffsets, j, rowVectors);
+    }
+
+    Vc_INTRINSIC V value() const { return R == 0 ? lo : lo.shifted(R, hi); }
+
+    // the weighted sum of all points, summed in the order of the points
+    Vc_INTRINSIC V sum(const V *coefficients) const
+    {
+        return Base::accumulate(coefficients, coefficients[I] * value());
+    }
+    Vc_INTRINSIC V accumulate(const V *coefficients, V acc) const
+    {
+        return Base::accumulate(coefficients, acc + coefficients[I] * value());
+    }
+
+    Vc_INTRINSIC void advance(std::ptrdiff_t j, std::size_t rowVectors)
+    {
+        if (R == 0) {
+            lo = load(row, j + K, rowVectors);
+        } else {
+            lo = hi;
+            hi = load(row, j + K + 1, rowVectors);
+        }
+        Base::advance(j, rowVectors);
+    }
+};
+
+// StencilBarrier {{{1
+class StencilBarrier
+{
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    const std::size_t m_count;
+    std::size_t m_waiting = 0;
+    std::size_t m_generation = 0;
+
+public:
+    explicit StencilBarrier(std::size_t count) : m_count(count) {}
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        const std::size_t generation = m_generation;
+        if (++m_waiting == m_count) {
+            m_waiting = 0;
+            ++m_generation;
+            m_cv.notify_all();
+        } else {
+            m_cv.wait(lock, [&] { return generation != m_generation; });
+        }
+    }
+};
+//}}}1
+}  // namespace Detail
+
+// stencil {{{1
+/**
+ * \ingroup Utilities
+ * \headerfile stencil.h <Vc/Stencil>
+ *
+ * A linear stencil with the points \p Points (see stencil_point) and a coefficient per
+ * point. Applying it computes for every inner entry \c x of the output grid
+ * \code
+ * out[x] = c[0] * in[x + Points[0]] + c[1] * in[x + Points[1]] + ...
+ * \endcode
+ * with the sum taken in the order of the points.
+ *
+ * The stencil only writes to the inner entries: those that have all their neighbours
+ * inside the grid. The halo, i.e. the first lowerHalo(d) and the last upperHalo(d) indexes
+ * of every dimension d, holds the boundary values and is never written.
+ *
+ * The points are known at compile time. Thus every row is processed with aligned vector
+ * loads only: the neighbours along the row are composed from two registers with
+ * Vector::shifted, and every input vector is loaded once per row and point row, instead
+ * of once per point with unaligned loads.
+ *
+ * \code
+ * // 7-point diffusion in 3-D
+ * typedef Vc::stencil<float_v, Vc::stencil_point<0, 0, 0>,
+ *                     Vc::stencil_point<-1, 0, 0>, Vc::stencil_point<1, 0, 0>,
+ *                     Vc::stencil_point<0, -1, 0>, Vc::stencil_point<0, 1, 0>,
+ *                     Vc::stencil_point<0, 0, -1>, Vc::stencil_point<0, 0, 1>> Diffusion;
+ * const Diffusion diffusion(1 - 6 * k, k, k, k, k, k, k);
+ * Vc::PitchedMemory<float_v, 3> a(nz, ny, nx), b(nz, ny, nx);
+ * // ... initialize a, and the halo of b with the same boundary values
+ * diffusion.sweep(a, b, 100);  // 100 time steps, the result is in a
+ * \endcode
+ *
+ * \tparam V The vector type the grids are processed with.
+ * \tparam Points A list of stencil_point types of equal dimension.
+ */
+template <typename V, typename... Points> class stencil
+{
+public:
+    typedef typename V::EntryType EntryType;
+    /// The number of points.
+    static constexpr std::size_t Size = sizeof...(Points);
+    /// The number of dimensions of the grids.
+    static constexpr std::size_t Dimension =
+        Detail::stencilMax(int(Points::Dimension)...);
+
+    static_assert(Size > 0, "a stencil needs at least one point");
+    static_assert(Detail::stencilMax(-int(Points::Dimension)...) == -int(Dimension),
+                  "all stencil points must have the same number of offsets");
+
+    /// Returns the number of boundary indexes at the start of dimension \p d.
+    static constexpr std::size_t lowerHalo(std::size_t d)
+    {
+        return std::size_t(Detail::stencilMax(0, -Points::offset(d)...));
+    }
+    /// Returns the number of boundary indexes at the end of dimension \p d.
+    static constexpr std::size_t upperHalo(std::size_t d)
+    {
+        return std::size_t(Detail::stencilMax(0, Points::offset(d)...));
+    }
+
+    /**
+     * Initializes the coefficients, one per point, in the order of the points.
+     */
+    template <typename... Coefficients,
+              typename = enable_if<sizeof...(Coefficients) == Size>>
+    explicit stencil(Coefficients... coefficients)
+        : m_coefficients{{EntryType(coefficients)...}}
+    {
+    }
+
+    /// Returns the coefficient of point \p i.
+    EntryType coefficient(std::size_t i) const { return m_coefficients[i]; }
+
+    // apply 1-D {{{2
+    /**
+     * Applies the stencil once to the one-dimensional array \p in and writes the inner
+     * entries of \p out. Both must have the same number of entries.
+     *
+     * \param threads The number of threads that share the work.
+     */
+    template <typename P0, typename RM0, typename P1, typename RM1>
+    void apply(const Common::MemoryBase<V, P0, 1, RM0> &in, Common::MemoryBase<V, P1, 1, RM1> &out,
+               std::size_t threads = 1) const
+    {
+        static_assert(Dimension == 1, "the stencil points must have one offset");
+        Vc_ASSERT(in.entriesCount() == out.entriesCount());
+        const std::size_t n = in.entriesCount();
+        const std::size_t xLo = lowerHalo(0);
+        if (n <= xLo + upperHalo(0)) {
+            return;
+        }
+        const std::ptrdiff_t rowOffsets[Size] = {};
+        V c[Size];
+        broadcastCoefficients(c);
+        const std::size_t vectors = in.vectorsCount();
+        auto &&work = [&](std::size_t t) {
+            const std::size_t chunk = (vectors + threads - 1) / threads;
+            applyRow(in.entries(), out.entries(), rowOffsets, c, t * chunk,
+                     std::min(vectors, (t + 1) * chunk), vectors, xLo, n - upperHalo(0));
+        };
+        if (threads > 1) {
+            Detail::runConcurrently(threads, work);
+        } else {
+            work(0);
+        }
+    }
+
+    // apply N-D {{{2
+    /**
+     * Applies the stencil once to the grid \p in and writes the inner entries of \p out.
+     * Both grids must have the same extents and row pitch.
+     *
+     * The grid is processed in blocks that fit into the L2 cache (see
+     * PitchedMemory::l2Tiles), such that the rows shared by neighbouring output rows are
+     * read from the cache.
+     *
+     * \param threads The number of threads that share the blocks.
+     */
+    template <std::size_t D>
+    void apply(const PitchedMemory<V, D> &in, PitchedMemory<V, D> &out,
+               std::size_t threads = 1) const
+    {
+        static_assert(D == Dimension, "the grid and the stencil points must have the same "
+                                      "number of dimensions");
+        Vc_ASSERT(in.pitch() == out.pitch());
+        std::array<std::ptrdiff_t, Size> rowOffsets;
+        computeRowOffsets(in, rowOffsets);
+        V c[Size];
+        broadcastCoefficients(c);
+        const auto tiles = out.l2Tiles();
+        if (threads > 1) {
+            const std::vector<MemoryTile<D>> list(tiles.begin(), tiles.end());
+            Detail::runConcurrently(threads, [&](std::size_t t) {
+                for (std::size_t i = t; i < list.size(); i += threads) {
+                    applyBlock(in, out, list[i], rowOffsets.data(), c);
+                }
+            });
+        } else {
+            for (const auto &tile : tiles) {
+                applyBlock(in, out, tile, rowOffsets.data(), c);
+            }
+        }
+    }
+
+    // sweep {{{2
+    /**
+     * Applies the stencil \p steps times, alternating between the grids \p a and \p b.
+     * The result is in \p a afterwards (the grids are swapped for odd \p steps). The halo
+     * of both grids must hold the same boundary values.
+     *
+     * The time steps are tiled along the outermost dimension: up to \p stepsPerPass steps
+     * advance together as a wavefront through the grid, where step s + 1 updates the
+     * outer index i as soon as step s has finished all indexes that i depends on. Thus
+     * every pass reads the grid from memory only once, instead of once per step.
+     *
+     * \param threads The number of threads. Each thread processes a slab of the second
+     *                dimension in every outer index and the threads synchronize once per
+     *                wavefront position.
+     * \param stepsPerPass The number of time steps per pass through the grid. The default
+     *                     chooses as many steps as fit into the L2 cache.
+     */
+    template <std::size_t D>
+    void sweep(PitchedMemory<V, D> &a, PitchedMemory<V, D> &b, std::size_t steps,
+               std::size_t threads = 1, std::size_t stepsPerPass = 0) const
+    {
+        static_assert(D == Dimension, "the grid and the stencil points must have the same "
+                                      "number of dimensions");
+        Vc_ASSERT(a.pitch() == b.pitch() && a.size(0) == b.size(0));
+        threads = std::max<std::size_t>(1, threads);
+        std::array<std::ptrdiff_t, Size> rowOffsets;
+        computeRowOffsets(a, rowOffsets);
+        V c[Size];
+        broadcastCoefficients(c);
+
+        // the distance between the outer indexes of consecutive steps on the wavefront.
+        // With more than one thread it is one larger, such that no step reads an outer
+        // index that another thread writes at the same wavefront position.
+        const std::size_t lag =
+            std::max(lowerHalo(0), upperHalo(0)) + (threads > 1 ? 1 : 0);
+        if (stepsPerPass == 0) {
+            stepsPerPass = defaultStepsPerPass(a, threads, lag);
+        }
+        const std::size_t first = lowerHalo(0);
+        const std::size_t last = a.size(0) > upperHalo(0) ? a.size(0) - upperHalo(0) : 0;
+
+        // the slabs of the second dimension; for 2-D grids these are vectors in the rows
+        const std::size_t unit = D == 2 ? V::Size : 1;
+        const std::size_t extent1 = D == 2 ? a.vectorsPerRow() : a.size(1);
+        const std::size_t slab = (extent1 + threads - 1) / threads;
+
+        Detail::StencilBarrier barrier(threads);
+        auto &&work = [&](std::size_t t) {
+            std::array<std::size_t, D> lo, hi;
+            for (std::size_t d = 0; d < D; ++d) {
+                lo[d] = 0;
+                hi[d] = d == D - 1 ? a.vectorsPerRow() * V::Size : a.size(d);
+            }
+            lo[1] = std::min(extent1, t * slab) * unit;
+            hi[1] = std::min(extent1, (t + 1) * slab) * unit;
+            for (std::size_t done = 0; done < steps; done += stepsPerPass) {
+                const std::size_t n = std::min(stepsPerPass, steps - done);
+                for (std::size_t w = first; w < last + (n - 1) * lag; ++w) {
+                    for (std::size_t s = 0; s < n && s * lag <= w; ++s) {
+                        const std::size_t i = w - s * lag;
+                        if (i < first) {
+                            break;
+                        }
+                        if (i < last) {
+                            lo[0] = i;
+                            hi[0] = i + 1;
+                            const bool even = (done + s) % 2 == 0;
+                            applyBlock(even ? a : b, even ? b : a, lo, hi,
+                                       rowOffsets.data(), c);
+                        }
+                    }
+                    if (threads > 1) {
+                        barrier.wait();
+                    }
+                }
+            }
+        };
+        if (threads > 1) {
+            Detail::runConcurrently(threads, work);
+        } else {
+            work(0);
+        }
+        if (steps % 2 == 1) {
+            a.swap(b);
+        }
+    }
+    //}}}2
+
+private:
+    typedef Detail::StencilTaps<V, 0, Points...> Taps;
+
+    void broadcastCoefficients(V *c) const
+    {
+        for (std::size_t i = 0; i < Size; ++i) {
+            c[i] = V(m_coefficients[i]);
+        }
+    }
+
+    template <std::size_t D>
+    static void computeRowOffsets(const PitchedMemory<V, D> &grid,
+                                  std::array<std::ptrdiff_t, Size> &rowOffsets)
+    {
+        rowOffsets.fill(0);
+        for (std::size_t d = 0; d + 1 < D; ++d) {
+            const int offsets[Size] = {Points::offset(d)...};
+            for (std::size_t i = 0; i < Size; ++i) {
+                rowOffsets[i] += std::ptrdiff_t(grid.stride(d)) * offsets[i];
+            }
+        }
+    }
+
+    // the number of time steps per pass such that the outer indexes on the wavefront (and
+    // their halo) of both grids fit into half of the L2 cache
+    template <std::size_t D>
+    static std::size_t defaultStepsPerPass(const PitchedMemory<V, D> &grid,
+                                           std::size_t threads, std::size_t lag)
+    {
+        CpuId::init();
+        const std::size_t cache = CpuId::L2Data() > 0 ? CpuId::L2Data() : 256 * 1024;
+        const std::size_t bytes =
+            std::max<std::size_t>(1, grid.stride(0) * sizeof(EntryType) / threads);
+        const std::size_t fit = cache / 2 / (2 * bytes);
+        const std::size_t halo = lowerHalo(0) + upperHalo(0) + 1;
+        return fit > halo && lag > 0 ? std::max<std::size_t>(1, (fit - halo) / lag) : 1;
+    }
+
+    template <std::size_t D>
+    static void applyBlock(const PitchedMemory<V, D> &in, PitchedMemory<V, D> &out,
+                           const MemoryTile<D> &tile, const std::ptrdiff_t *rowOffsets,
+                           const V *c)
+    {
+        std::array<std::size_t, D> lo, hi;
+        for (std::size_t d = 0; d < D; ++d) {
+            lo[d] = tile.begin(d);
+            hi[d] = tile.end(d);
+        }
+        applyBlock(in, out, lo, hi, rowOffsets, c);
+    }
+
+    // applies the stencil to all inner entries in [lo, hi), where the innermost range is
+    // given in multiples of V::Size
+    template <std::size_t D>
+    static void applyBlock(const PitchedMemory<V, D> &in, PitchedMemory<V, D> &out,
+                           std::array<std::size_t, D> lo, std::array<std::size_t, D> hi,
+                           const std::ptrdiff_t *rowOffsets, const V *c)
+    {
+        for (std::size_t d = 0; d + 1 < D; ++d) {
+            lo[d] = std::max(lo[d], lowerHalo(d));
+            hi[d] = std::min(hi[d], in.size(d) > upperHalo(d) ? in.size(d) - upperHalo(d) : 0);
+            if (lo[d] >= hi[d]) {
+                return;
+            }
+        }
+        const std::size_t n = in.size(D - 1);
+        if (n <= lowerHalo(D - 1) + upperHalo(D - 1)) {
+            return;
+        }
+        std::array<std::size_t, D - 1> index;
+        std::copy(lo.begin(), lo.end() - 1, index.begin());
+        while (true) {
+            std::size_t offset = 0;
+            for (std::size_t d = 0; d + 1 < D; ++d) {
+                offset += index[d] * in.stride(d);
+            }
+            applyRow(in.entries() + offset, out.entries() + offset, rowOffsets, c,
+                     lo[D - 1] / V::Size, hi[D - 1] / V::Size, in.pitch() / V::Size,
+                     lowerHalo(D - 1), n - upperHalo(D - 1));
+            // next row, the last outer index runs fastest
+            std::size_t d = D - 1;
+            while (d > 0 && ++index[d - 1] == hi[d - 1]) {
+                index[d - 1] = lo[d - 1];
+                --d;
+            }
+            if (d == 0) {
+                return;
+            }
+        }
+    }
+
+    // computes the output vectors [jBegin, jEnd) of one row and stores the entries in
+    // [xLo, xHi)
+    static Vc_ALWAYS_INLINE void applyRow(const EntryType *in, EntryType *out,
+                                          const std::ptrdiff_t *rowOffsets, const V *c,
+                                          std::size_t jBegin, std::size_t jEnd,
+                                          std::size_t rowVectors, std::size_t xLo,
+                                          std::size_t xHi)
+    {
+        jBegin = std::max(jBegin, xLo / V::Size);
+        jEnd = std::min(jEnd, (xHi + V::Size - 1) / V::Size);
+        if (jBegin >= jEnd) {
+            return;
+        }
+        // the vectors that are completely inside of [xLo, xHi)
+        const std::size_t fullBegin = (xLo + V::Size - 1) / V::Size;
+        const std::size_t fullEnd = xHi / V::Size;
+        Taps taps;
+        taps.init(in, rowOffsets, jBegin, rowVectors);
+        for (std::size_t j = jBegin; j < jEnd; ++j) {
+            const V r = taps.sum(c);
+            if (j >= fullBegin && j < fullEnd) {
+                r.store(out + j * V::Size, Vc::Aligned);
+            } else {
+                // blend instead of a masked store, which is slow without AVX
+                // (maskmovdqu bypasses the cache)
+                const std::ptrdiff_t first = std::ptrdiff_t(j * V::Size);
+                const V index = V::IndexesFromZero();
+                V blended(out + j * V::Size, Vc::Aligned);
+                where(index >= EntryType(std::max<std::ptrdiff_t>(0, std::ptrdiff_t(xLo) - first)) &&
+                      index < EntryType(std::min<std::ptrdiff_t>(V::Size, std::ptrdiff_t(xHi) - first))) |
+                    blended = r;
+                blended.store(out + j * V::Size, Vc::Aligned);
+            }
+            taps.advance(j + 1, rowVectors);
+        }
+    }
+
+    std::array<EntryType, Size> m_coefficients;
+};
+//}}}1
+}  // namespace Vc
+
+#endif  // VC_COMMON_STENCIL_H_
+
+// vim: foldmethod=marker
@@ -0,0 +1,284 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_STREAMINGSTORE_H_
+#define VC_COMMON_STREAMINGSTORE_H_
+
+#include <cstdint>
+#include <Vc/cpuid.h>
+#include "memorybase.h"
+#include "macros.h"
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+namespace Common
+{
+/**\internal
+ * Returns the number of Bytes below which a buffer is written with normal stores.
+ *
+ * Streaming stores only pay off if the written data would otherwise evict a significant
+ * part of the cache hierarchy. Buffers that fit into L2 are likely to be read again soon
+ * and are therefore better served from the cache.
+ */
+inline size_t streamingStoreThreshold()
+{
+    static const size_t threshold = []() -> size_t {
+        CpuId::init();
+        return CpuId::L2Data() > 0 ? CpuId::L2Data() : 256 * 1024;
+    }();
+    return threshold;
+}
+
+namespace StreamingStoreImpl
+{
+// the operations {{{1
+/**\internal
+ * The operation objects calculate the vector for the entries starting at offset \p i. The
+ * flags describe the alignment of the source. They are called with \p V set to the native
+ * vector type for the head, body and tail of the buffer, and with Scalar::Vector for
+ * entries that do not fill a native vector.
+ */
+template <typename T> struct Copy
+{
+    const T *src;
+    template <typename V, typename Flags> Vc_INTRINSIC V load(size_t i, Flags f) const
+    {
+        return V(src + i, f);
+    }
+};
+
+template <typename T> struct Fill
+{
+    T value;
+    template <typename V, typename Flags> Vc_INTRINSIC V load(size_t, Flags) const
+    {
+        return V(value);
+    }
+};
+
+template <typename T, typename F> struct Transform
+{
+    const T *src;
+    F &f;
+    template <typename V, typename Flags> Vc_INTRINSIC V load(size_t i, Flags flags) const
+    {
+        return f(V(src + i, flags));
+    }
+};
+
+// run {{{1
+/**\internal
+ * Writes \p n entries starting at \p dst with the values produced by \p op.
+ *
+ * The body of the buffer is written with aligned streaming stores. The unaligned head and
+ * tail are written with one regular unaligned store each. These two vectors are
+ * calculated before the body is written, so that in-place transformations never see
+ * values that were already written. Finally a single store fence orders the streaming
+ * stores before any subsequent store.
+ */
+template <typename T, typename Op> inline void run(T *dst, size_t n, const Op &op)
+{
+    typedef Vector<T> V;
+    typedef Scalar::Vector<T> V1;
+    constexpr size_t Alignment = V::MemoryAlignment;
+
+    const std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(dst);
+    const size_t head = ((Alignment - (addr & (Alignment - 1))) & (Alignment - 1)) / sizeof(T);
+    if (n * sizeof(T) < streamingStoreThreshold() || n < head + V::Size ||
+        head >= V::Size || addr % sizeof(T) != 0) {
+        size_t i = 0;
+        for (; i + V::Size <= n; i += V::Size) {
+            op.template load<V>(i, Vc::Unaligned).store(dst + i, Vc::Unaligned);
+        }
+        for (; i < n; ++i) {
+            op.template load<V1>(i, Vc::Unaligned).store(dst + i, Vc::Unaligned);
+        }
+        return;
+    }
+
+    const size_t tail = n - V::Size;
+    const V headVector = op.template load<V>(0, Vc::Unaligned);
+    const V tailVector = op.template load<V>(tail, Vc::Unaligned);
+
+    size_t i = head;
+    for (; i + 4 * V::Size <= n; i += 4 * V::Size) {
+        const V tmp0 = op.template load<V>(i + 0 * V::Size, Vc::Unaligned);
+        const V tmp1 = op.template load<V>(i + 1 * V::Size, Vc::Unaligned);
+        const V tmp2 = op.template load<V>(i + 2 * V::Size, Vc::Unaligned);
+        const V tmp3 = op.template load<V>(i + 3 * V::Size, Vc::Unaligned);
+        tmp0.store(dst + i + 0 * V::Size, Vc::Aligned | Vc::Streaming);
+        tmp1.store(dst + i + 1 * V::Size, Vc::Aligned | Vc::Streaming);
+        tmp2.store(dst + i + 2 * V::Size, Vc::Aligned | Vc::Streaming);
+        tmp3.store(dst + i + 3 * V::Size, Vc::Aligned | Vc::Streaming);
+    }
+    for (; i + V::Size <= n; i += V::Size) {
+        op.template load<V>(i, Vc::Unaligned).store(dst + i, Vc::Aligned | Vc::Streaming);
+    }
+
+    headVector.store(dst, Vc::Unaligned);
+    tailVector.store(dst + tail, Vc::Unaligned);
+    Vc::Detail::storeFence(VectorAbi::Best<float>());
+}
+
+// runMemory {{{1
+/**\internal
+ * Writes all vectors of \p dst, including the padding, with aligned (streaming) stores.
+ */
+template <typename V, typename Parent, int Dimension, typename RowMemory, typename Op>
+inline void runMemory(MemoryBase<V, Parent, Dimension, RowMemory> &dst, const Op &op)
+{
+    typedef typename V::EntryType T;
+    T *mem = dst.entries();
+    const size_t count = dst.vectorsCount() * V::Size;
+    if (count * sizeof(T) < streamingStoreThreshold()) {
+        for (size_t i = 0; i < count; i += V::Size) {
+            op.template load<V>(i, Vc::Aligned).store(mem + i, Vc::Aligned);
+        }
+    } else {
+        for (size_t i = 0; i < count; i += V::Size) {
+            op.template load<V>(i, Vc::Aligned).store(mem + i, Vc::Aligned | Vc::Streaming);
+        }
+        Vc::Detail::storeFence(VectorAbi::Best<float>());
+    }
+}
+//}}}1
+}  // namespace StreamingStoreImpl
+
+/**
+ * \ingroup Utilities
+ * \headerfile streamingstore.h <Vc/Memory>
+ *
+ * Copies \p n values from \p src to \p dst, bypassing the cache for the destination.
+ *
+ * Use this function for output buffers that will not be read again soon (e.g. by a
+ * different pipeline stage), so that writing them does not evict the working set of the
+ * following computation from the cache. The function takes care of the unaligned head and
+ * tail of \p dst and issues a single store fence after the last streaming store. Thus, the
+ * data is visible to other threads once the function returns.
+ *
+ * Buffers smaller than the L2 cache (as reported by CpuId) are written with normal stores,
+ * since their data is likely to still be in the cache when it is used next.
+ *
+ * \param dst The destination buffer. It does not need to be aligned.
+ * \param src The source buffer. It does not need to be aligned.
+ * \param n The number of values to copy.
+ */
+template <typename T> inline void streaming_copy(T *dst, const T *src, size_t n)
+{
+    StreamingStoreImpl::run(dst, n, StreamingStoreImpl::Copy<T>{src});
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile streamingstore.h <Vc/Memory>
+ *
+ * Writes \p value to the \p n entries starting at \p dst, bypassing the cache.
+ *
+ * \see streaming_copy
+ */
+template <typename T> inline void streaming_fill(T *dst, size_t n, T value)
+{
+    StreamingStoreImpl::run(dst, n, StreamingStoreImpl::Fill<T>{value});
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile streamingstore.h <Vc/Memory>
+ *
+ * Writes \p f applied to the \p n values starting at \p src to \p dst, bypassing the cache.
+ *
+ * \p f is called with Vc::Vector<T> objects. If \p n is smaller than Vc::Vector<T>::Size, or
+ * \p dst is not aligned to \c sizeof(T), \p f is also called with Vc::Scalar::Vector<T>
+ * objects (as for simd_for_each). \p src and \p dst may point to the same buffer.
+ *
+ * \see streaming_copy
+ */
+template <typename T, typename F> inline void streaming_transform(T *dst, const T *src, size_t n, F &&f)
+{
+    StreamingStoreImpl::run(dst, n, StreamingStoreImpl::Transform<T, F>{src, f});
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile streamingstore.h <Vc/Memory>
+ *
+ * Copies all vectors of \p src into \p dst, bypassing the cache for \p dst.
+ *
+ * \note Both objects must have the exact same vectorsCount().
+ */
+template <typename V, typename ParentL, typename ParentR, int Dimension, typename RowMemoryL,
+          typename RowMemoryR>
+inline void streaming_copy(MemoryBase<V, ParentL, Dimension, RowMemoryL> &dst,
+                           const MemoryBase<V, ParentR, Dimension, RowMemoryR> &src)
+{
+    Vc_ASSERT(dst.vectorsCount() == src.vectorsCount());
+    StreamingStoreImpl::runMemory(dst,
+                                  StreamingStoreImpl::Copy<typename V::EntryType>{src.entries()});
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile streamingstore.h <Vc/Memory>
+ *
+ * Assigns \p value to all entries of \p dst (including the padding), bypassing the cache.
+ */
+template <typename V, typename Parent, int Dimension, typename RowMemory>
+inline void streaming_fill(MemoryBase<V, Parent, Dimension, RowMemory> &dst,
+                           typename V::EntryType value)
+{
+    StreamingStoreImpl::runMemory(dst, StreamingStoreImpl::Fill<typename V::EntryType>{value});
+}
+
+/**
+ * \ingroup Utilities
+ * \headerfile streamingstore.h <Vc/Memory>
+ *
+ * Writes \p f applied to all vectors of \p src to \p dst, bypassing the cache for \p dst.
+ *
+ * \note Both objects must have the exact same vectorsCount(). They may be the same object.
+ */
+template <typename V, typename ParentL, typename ParentR, int Dimension, typename RowMemoryL,
+          typename RowMemoryR, typename F>
+inline void streaming_transform(MemoryBase<V, ParentL, Dimension, RowMemoryL> &dst,
+                                const MemoryBase<V, ParentR, Dimension, RowMemoryR> &src,
+                                F &&f)
+{
+    Vc_ASSERT(dst.vectorsCount() == src.vectorsCount());
+    StreamingStoreImpl::runMemory(
+        dst, StreamingStoreImpl::Transform<typename V::EntryType, F>{src.entries(), f});
+}
+}  // namespace Common
+
+using Common::streaming_copy;
+using Common::streaming_fill;
+using Common::streaming_transform;
+}  // namespace Vc
+
+#endif  // VC_COMMON_STREAMINGSTORE_H_
+
+// vim: foldmethod=marker
@@ -0,0 +1,440 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#ifndef VC_COMMON_SYMMATRIX_H_
+#define VC_COMMON_SYMMATRIX_H_
+
+#include "smallmatrix.h"
+#include "macros.h"
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+namespace Common
+{
+// Vec {{{1
+/**
+ * \ingroup Utilities
+ * \headerfile symmatrix.h <Vc/Matrix>
+ *
+ * A column vector with \p N entries of type \p T.
+ *
+ * As for SmallMatrix, \p T may be a Vc vector type, in which case every SIMD lane holds
+ * an independent vector. \c simdize<Vec<float, N>> yields the corresponding SoA type.
+ */
+template <typename T, std::size_t N> class Vec
+{
+    T m_data[N];
+
+public:
+    typedef T value_type;
+
+    /// The number of entries.
+    static constexpr std::size_t size() { return N; }
+
+    /**
+     * Default initialization. Entries of fundamental type are left uninitialized, Vc
+     * vector entries are zero.
+     */
+    Vec() = default;
+
+    /// Initializes the \p N entries from \p N values.
+    template <typename... Ts, typename = enable_if<(N > 1 && sizeof...(Ts) == N)>>
+    Vec(const Ts &... values)
+        : m_data{static_cast<T>(values)...}
+    {
+    }
+
+    /// Returns a vector with all entries set to zero.
+    static Vec zero()
+    {
+        Vec r;
+        for (std::size_t i = 0; i < N; ++i) {
+            r.m_data[i] = T(0);
+        }
+        return r;
+    }
+
+    /// Returns a reference to the entry at index \p i.
+    Vc_ALWAYS_INLINE T &operator[](std::size_t i) { return m_data[i]; }
+    /// Const overload of the above function.
+    Vc_ALWAYS_INLINE const T &operator[](std::size_t i) const { return m_data[i]; }
+
+    ///\internal simdize interface
+    template <std::size_t N_> Vc_ALWAYS_INLINE T &vc_get_() { return m_data[N_]; }
+    ///\internal simdize interface
+    template <std::size_t N_> Vc_ALWAYS_INLINE const T &vc_get_() const
+    {
+        return m_data[N_];
+    }
+    enum : std::size_t { tuple_size = N };
+
+    Vec &operator+=(const Vec &rhs)
+    {
+        for (std::size_t i = 0; i < N; ++i) {
+            m_data[i] += rhs.m_data[i];
+        }
+        return *this;
+    }
+    Vec &operator-=(const Vec &rhs)
+    {
+        for (std::size_t i = 0; i < N; ++i) {
+            m_data[i] -= rhs.m_data[i];
+        }
+        return *this;
+    }
+    Vec &operator*=(const T &rhs)
+    {
+        for (std::size_t i = 0; i < N; ++i) {
+            m_data[i] *= rhs;
+        }
+        return *this;
+    }
+};
+
+template <typename T, std::size_t N> inline Vec<T, N> operator+(Vec<T, N> a, const Vec<T, N> &b)
+{
+    return a += b;
+}
+template <typename T, std::size_t N> inline Vec<T, N> operator-(Vec<T, N> a, const Vec<T, N> &b)
+{
+    return a -= b;
+}
+template <typename T, std::size_t N> inline Vec<T, N> operator*(Vec<T, N> a, const T &b)
+{
+    return a *= b;
+}
+template <typename T, std::size_t N> inline Vec<T, N> operator*(const T &a, Vec<T, N> b)
+{
+    return b *= a;
+}
+
+/// Returns the scalar product of \p a and \p b.
+template <typename T, std::size_t N> inline T dot(const Vec<T, N> &a, const Vec<T, N> &b)
+{
+    T r = a[0] * b[0];
+    for (std::size_t i = 1; i < N; ++i) {
+        r += a[i] * b[i];
+    }
+    return r;
+}
+
+/// Returns the product of the matrix \p a and the column vector \p x.
+template <typename T, std::size_t M, std::size_t N>
+inline Vec<T, M> operator*(const SmallMatrix<T, M, N> &a, const Vec<T, N> &x)
+{
+    Vec<T, M> r;
+    for (std::size_t i = 0; i < M; ++i) {
+        T s = a(i, 0) * x[0];
+        for (std::size_t k = 1; k < N; ++k) {
+            s += a(i, k) * x[k];
+        }
+        r[i] = s;
+    }
+    return r;
+}
+
+// SymMatrix {{{1
+/**
+ * \ingroup Utilities
+ * \headerfile symmatrix.h <Vc/Matrix>
+ *
+ * A symmetric \p N × \p N matrix that stores only the lower triangle, i.e. N(N+1)/2
+ * entries in row-major order: (0,0), (1,0), (1,1), (2,0), ...
+ *
+ * The intended use is covariance matrices in batched fits (e.g. Kalman filters), where \p
+ * T is a Vc vector type and every SIMD lane processes an independent fit:
+ * \code
+ * using Cov = Vc::SymMatrix<Vc::float_v, 5>;
+ * Cov c = Cov::identity() * Vc::float_v(100.f);
+ * Vc::similarityTransform(c, jacobian);  // C = F C Fᵀ for float_v::Size tracks at once
+ * \endcode
+ * \c simdize<SymMatrix<float, N>> yields the SoA type for SymMatrix<float, N>.
+ */
+template <typename T, std::size_t N> class SymMatrix
+{
+public:
+    /// The number of stored entries.
+    static constexpr std::size_t PackedSize = N * (N + 1) / 2;
+
+private:
+    T m_data[PackedSize];
+
+    static constexpr std::size_t index(std::size_t i, std::size_t j)
+    {
+        return i >= j ? i * (i + 1) / 2 + j : j * (j + 1) / 2 + i;
+    }
+
+public:
+    typedef T value_type;
+
+    /// The number of rows and columns.
+    static constexpr std::size_t rows() { return N; }
+    /// The number of rows and columns.
+    static constexpr std::size_t cols() { return N; }
+
+    /**
+     * Default initialization. Entries of fundamental type are left uninitialized, Vc
+     * vector entries are zero.
+     */
+    SymMatrix() = default;
+
+    /// Initializes the lower triangle from N(N+1)/2 values in packed order.
+    template <typename... Ts,
+              typename = enable_if<(PackedSize > 1 && sizeof...(Ts) == PackedSize)>>
+    SymMatrix(const Ts &... values)
+        : m_data{static_cast<T>(values)...}
+    {
+    }
+
+    /// Initializes from the lower triangle of \p a.
+    explicit SymMatrix(const SmallMatrix<T, N, N> &a)
+    {
+        for (std::size_t i = 0; i < N; ++i) {
+            for (std::size_t j = 0; j <= i; ++j) {
+                m_data[index(i, j)] = a(i, j);
+            }
+        }
+    }
+
+    /// Returns a matrix with all entries set to zero.
+    static SymMatrix zero()
+    {
+        SymMatrix r;
+        for (std::size_t i = 0; i < PackedSize; ++i) {
+            r.m_data[i] = T(0);
+        }
+        return r;
+    }
+
+    /// Returns the identity matrix.
+    static SymMatrix identity()
+    {
+        SymMatrix r = zero();
+        for (std::size_t i = 0; i < N; ++i) {
+            r(i, i) = T(1);
+        }
+        return r;
+    }
+
+    /// Returns a reference to the entry at (\p i, \p j), which is the same as (\p j, \p i).
+    Vc_ALWAYS_INLINE T &operator()(std::size_t i, std::size_t j) { return m_data[index(i, j)]; }
+    /// Const overload of the above function.
+    Vc_ALWAYS_INLINE const T &operator()(std::size_t i, std::size_t j) const
+    {
+        return m_data[index(i, j)];
+    }
+
+    /// Returns the full (unpacked) matrix.
+    SmallMatrix<T, N, N> unpacked() const
+    {
+        SmallMatrix<T, N, N> r;
+        for (std::size_t i = 0; i < N; ++i) {
+            for (std::size_t j = 0; j <= i; ++j) {
+                r(i, j) = r(j, i) = m_data[index(i, j)];
+            }
+        }
+        return r;
+    }
+
+    ///\internal simdize interface
+    template <std::size_t N_> Vc_ALWAYS_INLINE T &vc_get_() { return m_data[N_]; }
+    ///\internal simdize interface
+    template <std::size_t N_> Vc_ALWAYS_INLINE const T &vc_get_() const
+    {
+        return m_data[N_];
+    }
+    enum : std::size_t { tuple_size = PackedSize };
+
+    SymMatrix &operator+=(const SymMatrix &rhs)
+    {
+        for (std::size_t i = 0; i < PackedSize; ++i) {
+            m_data[i] += rhs.m_data[i];
+        }
+        return *this;
+    }
+    SymMatrix &operator-=(const SymMatrix &rhs)
+    {
+        for (std::size_t i = 0; i < PackedSize; ++i) {
+            m_data[i] -= rhs.m_data[i];
+        }
+        return *this;
+    }
+    SymMatrix &operator*=(const T &rhs)
+    {
+        for (std::size_t i = 0; i < PackedSize; ++i) {
+            m_data[i] *= rhs;
+        }
+        return *this;
+    }
+};
+
+template <typename T, std::size_t N>
+inline SymMatrix<T, N> operator+(SymMatrix<T, N> a, const SymMatrix<T, N> &b)
+{
+    return a += b;
+}
+template <typename T, std::size_t N>
+inline SymMatrix<T, N> operator-(SymMatrix<T, N> a, const SymMatrix<T, N> &b)
+{
+    return a -= b;
+}
+template <typename T, std::size_t N>
+inline SymMatrix<T, N> operator*(SymMatrix<T, N> a, const T &b)
+{
+    return a *= b;
+}
+template <typename T, std::size_t N>
+inline SymMatrix<T, N> operator*(const T &a, SymMatrix<T, N> b)
+{
+    return b *= a;
+}
+
+/// Returns the product of the symmetric matrix \p c and the column vector \p x.
+template <typename T, std::size_t N>
+inline Vec<T, N> operator*(const SymMatrix<T, N> &c, const Vec<T, N> &x)
+{
+    Vec<T, N> r;
+    for (std::size_t i = 0; i < N; ++i) {
+        T s = c(i, 0) * x[0];
+        for (std::size_t k = 1; k < N; ++k) {
+            s += c(i, k) * x[k];
+        }
+        r[i] = s;
+    }
+    return r;
+}
+
+// similarity {{{1
+/**
+ * Returns \p a · \p c · transpose(\p a).
+ *
+ * The product \p a · \p c is computed in full (M·N·N multiplications). Of the second
+ * product only the lower triangle is computed, with M·(M+1)/2·N instead of M·M·N
+ * multiplications.
+ */
+template <typename T, std::size_t M, std::size_t N>
+inline SymMatrix<T, M> similarity(const SmallMatrix<T, M, N> &a, const SymMatrix<T, N> &c)
+{
+    // tmp = a · c
+    SmallMatrix<T, M, N> tmp;
+    for (std::size_t i = 0; i < M; ++i) {
+        for (std::size_t j = 0; j < N; ++j) {
+            T s = a(i, 0) * c(0, j);
+            for (std::size_t k = 1; k < N; ++k) {
+                s += a(i, k) * c(k, j);
+            }
+            tmp(i, j) = s;
+        }
+    }
+    SymMatrix<T, M> r;
+    for (std::size_t i = 0; i < M; ++i) {
+        for (std::size_t j = 0; j <= i; ++j) {
+            T s = tmp(i, 0) * a(j, 0);
+            for (std::size_t k = 1; k < N; ++k) {
+                s += tmp(i, k) * a(j, k);
+            }
+            r(i, j) = s;
+        }
+    }
+    return r;
+}
+
+/**
+ * Replaces \p c with \p a · \p c · transpose(\p a).
+ *
+ * This is the covariance propagation step of a Kalman filter with the Jacobian \p a.
+ */
+template <typename T, std::size_t N>
+inline void similarityTransform(SymMatrix<T, N> &c, const SmallMatrix<T, N, N> &a)
+{
+    c = similarity(a, c);
+}
+
+/**
+ * Returns transpose(\p v) · \p c · \p v.
+ */
+template <typename T, std::size_t N>
+inline T similarity(const Vec<T, N> &v, const SymMatrix<T, N> &c)
+{
+    return dot(v, c * v);
+}
+
+// rank1Update {{{1
+/**
+ * Adds \p alpha · \p v · transpose(\p v) to \p c.
+ */
+template <typename T, std::size_t N>
+inline void rank1Update(SymMatrix<T, N> &c, const Vec<T, N> &v, const T &alpha)
+{
+    for (std::size_t i = 0; i < N; ++i) {
+        const T av = alpha * v[i];
+        for (std::size_t j = 0; j <= i; ++j) {
+            c(i, j) += av * v[j];
+        }
+    }
+}
+
+// kalmanUpdate {{{1
+/**
+ * Performs the update step of a Kalman filter for a one-dimensional measurement.
+ *
+ * \param x The state vector. It is updated in place.
+ * \param c The covariance matrix of \p x. It is updated in place.
+ * \param h The measurement projection, i.e. the predicted measurement is dot(h, x).
+ * \param m The measured value.
+ * \param variance The variance of the measurement.
+ *
+ * \return The χ² contribution of the measurement.
+ */
+template <typename T, std::size_t N>
+inline T kalmanUpdate(Vec<T, N> &x, SymMatrix<T, N> &c, const Vec<T, N> &h, const T &m,
+                      const T &variance)
+{
+    const Vec<T, N> ch = c * h;
+    const T residual = m - dot(h, x);
+    const T s = dot(h, ch) + variance;
+    const T sInv = T(1) / s;
+    x += ch * (residual * sInv);
+    rank1Update(c, ch, -sInv);
+    return residual * residual * sInv;
+}
+//}}}1
+}  // namespace Common
+
+using Common::Vec;
+using Common::SymMatrix;
+using Common::dot;
+using Common::similarity;
+using Common::similarityTransform;
+using Common::rank1Update;
+using Common::kalmanUpdate;
+}  // namespace Vc
+
+#endif  // VC_COMMON_SYMMATRIX_H_
+
+// vim: foldmethod=marker
@@ -0,0 +1,172 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include <Vc/ByteScan>
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+#include "../tsc.h"
+
+// Prints the number of cycles per byte of the Vc byte scanning functions and of their
+// libc/STL counterparts, on a CSV-like text buffer with a given average field length.
+
+static std::vector<char> makeText(std::size_t size, int fieldLength)
+{
+    std::default_random_engine engine(1);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::uniform_int_distribution<int> field(1, 2 * fieldLength - 1);
+    std::vector<char> text(size + 1);
+    for (std::size_t i = 0; i < size;) {
+        for (int n = field(engine); n > 0 && i < size; --n) {
+            text[i++] = static_cast<char>(letter(engine));
+        }
+        if (i < size) {
+            text[i++] = i % 401 < fieldLength ? '\n' : ',';
+        }
+    }
+    text[size] = '\0';  // for strpbrk
+    return text;
+}
+
+template <typename F> double cyclesPerByte(std::size_t size, F &&scan)
+{
+    unsigned long long best = ~0ull;
+    TimeStampCounter tsc;
+    for (int rep = 0; rep < 20; ++rep) {
+        tsc.start();
+        scan();
+        tsc.stop();
+        best = std::min(best, tsc.cycles());
+    }
+    return double(best) / size;
+}
+
+static void check(bool ok, const char *what)
+{
+    if (!ok) {
+        std::cerr << what << " returned a wrong result\n";
+    }
+}
+
+static void printRow(int fieldLength)
+{
+    constexpr std::size_t Size = 1 << 20;
+    const std::vector<char> text = makeText(Size, fieldLength);
+    const char *const first = text.data();
+    const char *const last = first + Size;
+    const Vc::byte_set delimiters(",\n");
+    std::vector<std::size_t> offsets, offsetsRef;
+    offsets.reserve(Size);
+    offsetsRef.reserve(Size);
+    std::size_t n = 0, nRef = 0;
+
+    // all occurrences of ',' with memchr / find_byte
+    const double memchrCycles = cyclesPerByte(Size, [&] {
+        nRef = 0;
+        for (const char *p = first;
+             (p = static_cast<const char *>(std::memchr(p, ',', last - p))); ++p) {
+            ++nRef;
+        }
+    });
+    const double findCycles = cyclesPerByte(Size, [&] {
+        n = 0;
+        for (const char *p = first; (p = Vc::find_byte(p, last, ',')) != last; ++p) {
+            ++n;
+        }
+    });
+    check(n == nRef, "find_byte");
+
+    // all fields with strpbrk / find_first_of
+    const double strpbrkCycles = cyclesPerByte(Size, [&] {
+        nRef = 0;
+        for (const char *p = first; (p = std::strpbrk(p, ",\n")); ++p) {
+            ++nRef;
+        }
+    });
+    const double findFirstOfCycles = cyclesPerByte(Size, [&] {
+        n = 0;
+        for (const char *p = first; (p = Vc::find_first_of(p, last, delimiters)) != last;
+             ++p) {
+            ++n;
+        }
+    });
+    check(n == nRef, "find_first_of");
+
+    // line count with std::count / count_bytes
+    const double countRefCycles =
+        cyclesPerByte(Size, [&] { nRef = std::count(first, last, '\n'); });
+    const double countCycles =
+        cyclesPerByte(Size, [&] { n = Vc::count_bytes(first, last, '\n'); });
+    check(n == nRef, "count_bytes");
+
+    // field offsets with a byte loop / split_offsets
+    const double splitRefCycles = cyclesPerByte(Size, [&] {
+        offsetsRef.clear();
+        for (const char *p = first; p != last; ++p) {
+            if (*p == ',' || *p == '\n') {
+                offsetsRef.push_back(p - first);
+            }
+        }
+    });
+    const double splitCycles = cyclesPerByte(Size, [&] {
+        offsets.clear();
+        Vc::split_offsets(first, last, delimiters, std::back_inserter(offsets));
+    });
+    check(offsets == offsetsRef, "split_offsets");
+
+    bool valid = false;
+    const double utf8Cycles =
+        cyclesPerByte(Size, [&] { valid = Vc::is_valid_utf8(first, last); });
+    check(valid, "is_valid_utf8");
+
+    std::cout << std::setw(6) << fieldLength << std::setprecision(3) << std::setw(9)
+              << memchrCycles << std::setw(9) << findCycles << std::setw(9)
+              << strpbrkCycles << std::setw(9) << findFirstOfCycles << std::setw(9)
+              << countRefCycles << std::setw(9) << countCycles << std::setw(9)
+              << splitRefCycles << std::setw(9) << splitCycles << std::setw(9)
+              << utf8Cycles << '\n';
+}
+
+int main()
+{
+    std::cout << "[cycles per byte]\n"
+              << "find:  memchr vs. Vc::find_byte\n"
+              << "any:   strpbrk vs. Vc::find_first_of\n"
+              << "count: std::count vs. Vc::count_bytes\n"
+              << "split: byte loop vs. Vc::split_offsets\n"
+              << " field     find       Vc      any       Vc    count       Vc    split"
+                 "       Vc    utf-8\n";
+    for (int fieldLength : {4, 16, 64, 256}) {
+        printRow(fieldLength);
+    }
+    return 0;
+}
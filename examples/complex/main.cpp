@@ -0,0 +1,214 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include <Vc/Complex>
+#include <algorithm>
+#include <complex>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "../tsc.h"
+
+// Compares std::complex<float_v> with Vc::complex<float_v> on
+// - a complex multiply-accumulate over std::complex<float> arrays (a dot product), also
+//   with Vc::complex_interleaved,
+// - the rotation of an array of phasors by a constant angle step,
+// - the Mandelbrot iteration z = z * z + c with the norm(z) < 4 bailout test.
+
+using Vc::float_v;
+using Vc::float_m;
+typedef std::complex<float> Cf;
+
+template <typename F> double cyclesPer(std::size_t n, F &&f)
+{
+    unsigned long long best = ~0ull;
+    TimeStampCounter tsc;
+    for (int rep = 0; rep < 10; ++rep) {
+        tsc.start();
+        f();
+        tsc.stop();
+        best = std::min(best, tsc.cycles());
+    }
+    return double(best) / n;
+}
+
+static void print(const char *name, double stdCycles, double vcCycles)
+{
+    std::cout << std::setw(12) << name << std::setw(14) << stdCycles << std::setw(14)
+              << vcCycles << std::setw(10) << stdCycles / vcCycles << '\n';
+}
+
+// dot product {{{1
+static std::complex<float_v> load(const Cf *mem)
+{
+    float_v re, im;
+    Vc::deinterleave(&re, &im, reinterpret_cast<const float *>(mem), Vc::Unaligned);
+    return {re, im};
+}
+
+static Cf dotStd(const std::vector<Cf> &a, const std::vector<Cf> &b)
+{
+    std::complex<float_v> sum(float_v::Zero(), float_v::Zero());
+    for (std::size_t i = 0; i < a.size(); i += float_v::Size) {
+        sum += load(&a[i]) * load(&b[i]);
+    }
+    return {sum.real().sum(), sum.imag().sum()};
+}
+
+static Cf dotVc(const std::vector<Cf> &a, const std::vector<Cf> &b)
+{
+    Vc::complex<float_v> sum;
+    for (std::size_t i = 0; i < a.size(); i += float_v::Size) {
+        sum = fma(Vc::complex<float_v>(&a[i]), Vc::complex<float_v>(&b[i]), sum);
+    }
+    return {sum.real().sum(), sum.imag().sum()};
+}
+
+// the same with interleaved storage: no deinterleave, but shuffles in the multiplication
+typedef Vc::complex_interleaved<std::conditional<
+    float_v::Size % 2 == 0, float_v, Vc::SimdArray<float, 2>>::type> InterleavedCf;
+
+static Cf dotInterleaved(const std::vector<Cf> &a, const std::vector<Cf> &b)
+{
+    InterleavedCf sum;
+    for (std::size_t i = 0; i < a.size(); i += InterleavedCf::Size) {
+        sum = fma(InterleavedCf(&a[i]), InterleavedCf(&b[i]), sum);
+    }
+    const InterleavedCf::split_type split = sum.split();
+    return {split.real().sum(), split.imag().sum()};
+}
+
+// rotation {{{1
+static void rotateStd(std::vector<Cf> &z, float_v theta)
+{
+    const std::complex<float_v> step(Vc::cos(theta), Vc::sin(theta));
+    for (std::size_t i = 0; i < z.size(); i += float_v::Size) {
+        const std::complex<float_v> r = load(&z[i]) * step;
+        const std::pair<float_v, float_v> tmp = Vc::interleave(r.real(), r.imag());
+        tmp.first.store(reinterpret_cast<float *>(&z[i]), Vc::Unaligned);
+        tmp.second.store(reinterpret_cast<float *>(&z[i]) + float_v::Size, Vc::Unaligned);
+    }
+}
+
+static void rotateVc(std::vector<Cf> &z, float_v theta)
+{
+    const Vc::complex<float_v> step = Vc::polar(float_v::One(), theta);
+    for (std::size_t i = 0; i < z.size(); i += float_v::Size) {
+        (Vc::complex<float_v>(&z[i]) * step).store(&z[i]);
+    }
+}
+
+// Mandelbrot {{{1
+static const int MaxIt = 255;
+
+static float_v mandelStd(std::complex<float_v> c)
+{
+    std::complex<float_v> z = c;
+    float_v n = float_v::Zero();
+    float_m running = std::norm(z) < 4.f;
+    for (int i = 0; i < MaxIt && any_of(running); ++i) {
+        const std::complex<float_v> next = z * z + c;
+        z = std::complex<float_v>(iif(running, next.real(), z.real()),
+                                  iif(running, next.imag(), z.imag()));
+        ++n(running);
+        running = std::norm(z) < 4.f;
+    }
+    return n;
+}
+
+static float_v mandelVc(Vc::complex<float_v> c)
+{
+    Vc::complex_squares<float_v> z = c;
+    float_v n = float_v::Zero();
+    float_m running = z.norm() < 4.f;
+    for (int i = 0; i < MaxIt && any_of(running); ++i) {
+        z.assign(running, z.squared_plus(c));
+        ++n(running);
+        running = z.norm() < 4.f;
+    }
+    return n;
+}
+
+template <typename Z, typename F> static float mandelImage(F &&f)
+{
+    float sum = 0;
+    for (int y = 0; y < 200; ++y) {
+        for (int x = 0; x < 300; x += float_v::Size) {
+            const float_v re = (float_v::IndexesFromZero() + float(x)) * 0.01f - 2.2f;
+            sum += f(Z(re, float_v(y * 0.012f - 1.2f))).sum();
+        }
+    }
+    return sum;
+}
+
+// main {{{1
+int main()
+{
+    const std::size_t N = 4096;
+    std::vector<Cf> a(N), b(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        a[i] = std::polar(1.f + i % 7, 0.1f * i);
+        b[i] = std::polar(1.f + i % 5, -0.3f * i);
+    }
+
+    std::cout << std::setprecision(3) << std::setw(12) << "kernel" << std::setw(14)
+              << "std::complex" << std::setw(14) << "Vc::complex" << std::setw(10) << "speedup"
+              << "\n" << std::setw(12) << "" << std::setw(28) << "cycles/element\n";
+
+    Cf dot1, dot2;
+    const double dStd = cyclesPer(N, [&] { dot1 = dotStd(a, b); });
+    const double dVc = cyclesPer(N, [&] { dot2 = dotVc(a, b); });
+    print("dot", dStd, dVc);
+    Cf dot3;
+    const double dInterleaved = cyclesPer(N, [&] { dot3 = dotInterleaved(a, b); });
+    print("dot (il)", dStd, dInterleaved);
+
+    std::vector<Cf> z1 = a, z2 = a;
+    const double rStd = cyclesPer(N, [&] { rotateStd(z1, 0.01f); });
+    const double rVc = cyclesPer(N, [&] { rotateVc(z2, 0.01f); });
+    print("rotate", rStd, rVc);
+
+    float it1 = 0, it2 = 0;
+    const double mStd = cyclesPer(
+        300 * 200, [&] { it1 = mandelImage<std::complex<float_v>>(mandelStd); });
+    const double mVc =
+        cyclesPer(300 * 200, [&] { it2 = mandelImage<Vc::complex<float_v>>(mandelVc); });
+    print("mandelbrot", mStd, mVc);
+
+    // the results differ by rounding only
+    if (std::abs(dot1 - dot2) > 1e-3f * std::abs(dot1) ||
+        std::abs(dot1 - dot3) > 1e-3f * std::abs(dot1) ||
+        std::abs(z1[N - 1] - z2[N - 1]) > 1e-3f || std::abs(it1 - it2) > 1e-3f * it1) {
+        std::cerr << "results differ: " << dot1 << ' ' << dot2 << ' ' << dot3 << ' '
+                  << z1[N - 1] << ' ' << z2[N - 1] << ' ' << it1 << ' ' << it2 << '\n';
+        return 1;
+    }
+    return 0;
+}
+
+// vim: foldmethod=marker
@@ -0,0 +1,125 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include <Vc/Divider>
+#include <Vc/Allocator>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../tsc.h"
+
+// Divides 4096 integers by a runtime divisor: with a scalar loop, with operator/ of the
+// vector type, and with Vc::divider. Prints cycles per integer, for division and modulo.
+
+template <typename F> double cyclesPer(std::size_t n, F &&f)
+{
+    unsigned long long best = ~0ull;
+    TimeStampCounter tsc;
+    for (int rep = 0; rep < 10; ++rep) {
+        tsc.start();
+        f();
+        tsc.stop();
+        best = std::min(best, tsc.cycles());
+    }
+    return double(best) / n;
+}
+
+// keeps the divisor unknown to the compiler
+static volatile int runtimeDivisor = 7;
+
+template <typename V> static void row(const char *name)
+{
+    typedef typename V::value_type T;
+    constexpr std::size_t N = 4096;
+    std::default_random_engine engine;
+    std::uniform_int_distribution<T> dist(std::numeric_limits<T>::min(),
+                                          std::numeric_limits<T>::max());
+    std::vector<T, Vc::Allocator<T>> in(N), out(N);
+    for (auto &x : in) {
+        x = dist(engine);
+    }
+    const T d = T(runtimeDivisor);
+    const Vc::divider<T> div(d);
+
+    const double scalarDiv = cyclesPer(N, [&] {
+        for (std::size_t i = 0; i < N; ++i) {
+            out[i] = in[i] / d;
+        }
+        asm volatile("" ::"r"(out.data()) : "memory");
+    });
+    const double vectorDiv = cyclesPer(N, [&] {
+        for (std::size_t i = 0; i < N; i += V::Size) {
+            (V(&in[i], Vc::Aligned) / V(d)).store(&out[i], Vc::Aligned);
+        }
+        asm volatile("" ::"r"(out.data()) : "memory");
+    });
+    const double dividerDiv = cyclesPer(N, [&] {
+        for (std::size_t i = 0; i < N; i += V::Size) {
+            (V(&in[i], Vc::Aligned) / div).store(&out[i], Vc::Aligned);
+        }
+        asm volatile("" ::"r"(out.data()) : "memory");
+    });
+    const double scalarMod = cyclesPer(N, [&] {
+        for (std::size_t i = 0; i < N; ++i) {
+            out[i] = in[i] % d;
+        }
+        asm volatile("" ::"r"(out.data()) : "memory");
+    });
+    const double vectorMod = cyclesPer(N, [&] {
+        for (std::size_t i = 0; i < N; i += V::Size) {
+            (V(&in[i], Vc::Aligned) % V(d)).store(&out[i], Vc::Aligned);
+        }
+        asm volatile("" ::"r"(out.data()) : "memory");
+    });
+    const double dividerMod = cyclesPer(N, [&] {
+        for (std::size_t i = 0; i < N; i += V::Size) {
+            (V(&in[i], Vc::Aligned) % div).store(&out[i], Vc::Aligned);
+        }
+        asm volatile("" ::"r"(out.data()) : "memory");
+    });
+    std::cout << std::setw(12) << name << std::setw(4) << V::Size << std::setw(10)
+              << scalarDiv << std::setw(10) << vectorDiv << std::setw(10) << dividerDiv
+              << std::setw(12) << scalarMod << std::setw(10) << vectorMod << std::setw(10)
+              << dividerMod << '\n';
+}
+
+int main()
+{
+    std::cout << std::setprecision(3) << "cycles per integer, divisor " << runtimeDivisor
+              << "\n" << std::setw(16) << "" << std::setw(30) << "division          "
+              << std::setw(32) << "modulo          \n"
+              << std::setw(16) << "" << std::setw(10) << "scalar" << std::setw(10)
+              << "operator/" << std::setw(10) << "divider" << std::setw(12) << "scalar"
+              << std::setw(10) << "operator%" << std::setw(10) << "divider\n";
+    row<Vc::int_v>("int_v");
+    row<Vc::uint_v>("uint_v");
+    row<Vc::short_v>("short_v");
+    row<Vc::ushort_v>("ushort_v");
+    return 0;
+}
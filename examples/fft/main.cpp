@@ -0,0 +1,169 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include <Vc/FFT>
+#include <Vc/Allocator>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "../tsc.h"
+
+// Compares the cycles per complex transform of n points (float) for
+// - a textbook radix-2 FFT on std::complex<float> with a precomputed twiddle table,
+// - Vc::fft_plan on a single transform (vectorized over the butterflies),
+// - Vc::fft_plan on float_v::Size transforms at once (one transform per lane).
+
+using Vc::float_v;
+typedef std::complex<float> Cf;
+
+template <typename F> double cyclesPer(std::size_t n, F &&f)
+{
+    unsigned long long best = ~0ull;
+    TimeStampCounter tsc;
+    for (int rep = 0; rep < 10; ++rep) {
+        tsc.start();
+        f();
+        tsc.stop();
+        best = std::min(best, tsc.cycles());
+    }
+    return double(best) / n;
+}
+
+// radix-2 reference {{{1
+class Radix2
+{
+    std::size_t n;
+    std::vector<Cf> twiddles;
+
+public:
+    explicit Radix2(std::size_t size) : n(size), twiddles(size / 2)
+    {
+        for (std::size_t k = 0; k < n / 2; ++k) {
+            twiddles[k] = std::polar(1.f, float(-2 * M_PI * k / n));
+        }
+    }
+
+    void operator()(Cf *x) const
+    {
+        for (std::size_t i = 1, j = 0; i < n; ++i) {
+            std::size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1) {
+                j ^= bit;
+            }
+            j ^= bit;
+            if (i < j) {
+                std::swap(x[i], x[j]);
+            }
+        }
+        for (std::size_t len = 2; len <= n; len *= 2) {
+            const std::size_t stride = n / len;
+            for (std::size_t b = 0; b < n; b += len) {
+                for (std::size_t k = 0; k < len / 2; ++k) {
+                    const Cf u = x[b + k];
+                    const Cf v = x[b + k + len / 2] * twiddles[k * stride];
+                    x[b + k] = u + v;
+                    x[b + k + len / 2] = u - v;
+                }
+            }
+        }
+    }
+};
+
+// main {{{1
+int main()
+{
+    const std::size_t Batch = 64;  // transforms per measurement
+    std::cout << std::setprecision(4) << std::setw(6) << "n" << std::setw(12) << "radix-2"
+              << std::setw(12) << "single" << std::setw(12) << "batched" << std::setw(10)
+              << "speedup" << std::setw(10) << "speedup" << "\n" << std::setw(30)
+              << "cycles/transform" << std::setw(30) << "(single)  (batched)\n";
+
+    for (std::size_t n = 64; n <= 4096; n *= 4) {
+        const Radix2 radix2(n);
+        const Vc::fft_plan<float> plan(n);
+
+        std::vector<Cf> x(n * Batch);
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            x[i] = Cf(std::sin(0.1f * i), std::cos(0.37f * i));
+        }
+        std::vector<Cf> ref = x;
+        const double tRef = cyclesPer(Batch, [&] {
+            for (std::size_t t = 0; t < Batch; ++t) {
+                radix2(&ref[t * n]);
+            }
+        });
+
+        std::vector<float> re(n * Batch), im(n * Batch);
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            re[i] = x[i].real();
+            im[i] = x[i].imag();
+        }
+        const double tSingle = cyclesPer(Batch, [&] {
+            for (std::size_t t = 0; t < Batch; ++t) {
+                plan.forward(&re[t * n], &im[t * n]);
+            }
+        });
+
+        // the same transforms in SoA layout: transform t in lane t % Size of group t / Size
+        std::vector<float_v, Vc::Allocator<float_v>> vre(n * Batch / float_v::Size),
+            vim(n * Batch / float_v::Size);
+        for (std::size_t t = 0; t < Batch; ++t) {
+            for (std::size_t j = 0; j < n; ++j) {
+                vre[t / float_v::Size * n + j][t % float_v::Size] = x[t * n + j].real();
+                vim[t / float_v::Size * n + j][t % float_v::Size] = x[t * n + j].imag();
+            }
+        }
+        const double tBatched = cyclesPer(Batch, [&] {
+            for (std::size_t g = 0; g < Batch / float_v::Size; ++g) {
+                plan.forward(&vre[g * n], &vim[g * n]);
+            }
+        });
+
+        // every variant ran the forward transform 10 times (rounding aside, the results
+        // agree)
+        float err = 0;
+        for (std::size_t j = 0; j < n; ++j) {
+            err = std::max(err, std::abs(ref[j] - Cf(re[j], im[j])));
+            err = std::max(err, std::abs(Cf(re[j], im[j]) - Cf(vre[j][0], vim[j][0])));
+        }
+        if (!(err <= 1e-3f * std::abs(ref[0]))) {
+            std::cerr << "results differ for n = " << n << ": " << err << '\n';
+            return 1;
+        }
+
+        std::cout << std::setw(6) << n << std::setw(12) << tRef << std::setw(12) << tSingle
+                  << std::setw(12) << tBatched << std::setw(10) << tRef / tSingle
+                  << std::setw(10) << tRef / tBatched << '\n';
+    }
+    return 0;
+}
+
+// vim: foldmethod=marker
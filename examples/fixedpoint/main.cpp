@@ -0,0 +1,168 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include <Vc/FixedPoint>
+#include <Vc/Allocator>
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../tsc.h"
+
+// A Q15 FIR filter with 32 taps over 4096 samples: y[n] = sum_k h[k] * x[n + k], rounded
+// and saturated to Q15. Compares a scalar loop, a 32-bit accumulator with int_v, the
+// per-tap Q15 multiply Vc::mulhrs + Vc::adds (rounds every product), and Vc::madd on
+// interleaved samples with pairs of taps (exact). Prints cycles per output sample and the largest
+// deviation from the exact result.
+
+template <typename F> double cyclesPer(std::size_t n, F &&f)
+{
+    unsigned long long best = ~0ull;
+    TimeStampCounter tsc;
+    for (int rep = 0; rep < 10; ++rep) {
+        tsc.start();
+        f();
+        tsc.stop();
+        best = std::min(best, tsc.cycles());
+    }
+    return double(best) / n;
+}
+
+constexpr std::size_t N = 4096;
+constexpr std::size_t Taps = 32;
+
+typedef std::vector<short, Vc::Allocator<short>> Samples;
+
+static short roundQ15(int acc)
+{
+    return short(std::max(-0x8000, std::min(0x7fff, (acc + 0x4000) >> 15)));
+}
+
+static int maxError(const Samples &a, const Samples &b)
+{
+    int r = 0;
+    for (std::size_t i = 0; i < N; ++i) {
+        r = std::max(r, std::abs(a[i] - b[i]));
+    }
+    return r;
+}
+
+int main()
+{
+    typedef Vc::short_v S;
+    typedef Vc::int_v I;
+    // madd pairs adjacent entries, which needs an even vector size (even for Scalar)
+    typedef Vc::SimdArray<short, S::Size == 1 ? 2 : S::Size> M;
+    static_assert(Taps % 2 == 0 && N % M::Size == 0 && N % I::Size == 0, "");
+
+    std::default_random_engine engine;
+    std::uniform_int_distribution<short> dist(-0x4000, 0x4000);
+    Samples x(N + Taps), h(Taps), reference(N), y(N);
+    for (auto &v : x) {
+        v = dist(engine);
+    }
+    for (std::size_t k = 0; k < Taps; ++k) {  // a low-pass window summing to about 1
+        h[k] = short(0x7fff / Taps * (1 + (k < Taps / 2 ? k : Taps - 1 - k)) * 2 / (Taps / 2 + 1));
+    }
+
+    const double scalar = cyclesPer(N, [&] {
+        for (std::size_t n = 0; n < N; ++n) {
+            int acc = 0;
+            for (std::size_t k = 0; k < Taps; ++k) {
+                acc += h[k] * x[n + k];
+            }
+            reference[n] = roundQ15(acc);
+        }
+        asm volatile("" ::"r"(reference.data()) : "memory");
+    });
+
+    const double widened = cyclesPer(N, [&] {
+        for (std::size_t n = 0; n < N; n += I::Size) {
+            I acc = I::Zero();
+            for (std::size_t k = 0; k < Taps; ++k) {
+                acc += I(&x[n + k], Vc::Unaligned) * int(h[k]);
+            }
+            acc = Vc::min(Vc::max((acc + 0x4000) >> 15, I(-0x8000)), I(0x7fff));
+            Vc::simd_cast<Vc::SimdArray<short, I::Size>>(acc).store(&y[n], Vc::Unaligned);
+        }
+        asm volatile("" ::"r"(y.data()) : "memory");
+    });
+    const int widenedError = maxError(reference, y);
+
+    const double mulhrs = cyclesPer(N, [&] {
+        for (std::size_t n = 0; n < N; n += S::Size) {
+            S acc = S::Zero();
+            for (std::size_t k = 0; k < Taps; ++k) {
+                acc = Vc::adds(acc, Vc::mulhrs(S(&x[n + k], Vc::Unaligned), S(h[k])));
+            }
+            acc.store(&y[n], Vc::Aligned);
+        }
+        asm volatile("" ::"r"(y.data()) : "memory");
+    });
+    const int mulhrsError = maxError(reference, y);
+
+    // coefficient pairs h[k], h[k + 1] repeated over the vector
+    std::vector<M, Vc::Allocator<M>> pairs(Taps / 2);
+    for (std::size_t k = 0; k < Taps; k += 2) {
+        pairs[k / 2] = M::generate([&](std::size_t i) { return h[k + i % 2]; });
+    }
+    const double madd = cyclesPer(N, [&] {
+        typedef Vc::SimdArray<int, M::Size / 2> Acc;
+        for (std::size_t n = 0; n < N; n += M::Size) {
+            Acc acc0(0), acc1(0);
+            for (std::size_t k = 0; k < Taps; k += 2) {
+                // x[n + k + i] and x[n + k + i + 1] side by side, for madd with the pair
+                const M x0(&x[n + k], Vc::Unaligned), x1(&x[n + k + 1], Vc::Unaligned);
+                acc0 += Vc::madd(x0.interleaveLow(x1), pairs[k / 2]);
+                acc1 += Vc::madd(x0.interleaveHigh(x1), pairs[k / 2]);
+            }
+            const auto round = [](const Acc &acc) {
+                return Vc::min(Vc::max((acc + 0x4000) >> 15, Acc(-0x8000)), Acc(0x7fff));
+            };
+            Vc::simd_cast<M>(round(acc0), round(acc1)).store(&y[n], Vc::Aligned);
+        }
+        asm volatile("" ::"r"(y.data()) : "memory");
+    });
+    const int maddError = maxError(reference, y);
+
+    std::cout << std::setprecision(3) << "Q15 FIR filter, " << Taps << " taps, " << N
+              << " samples\n"
+              << std::setw(22) << "" << std::setw(14) << "cycles/sample" << std::setw(12)
+              << "max error\n"
+              << std::setw(22) << "scalar" << std::setw(14) << scalar << std::setw(11) << 0
+              << '\n'
+              << std::setw(22) << "int_v multiply-add" << std::setw(14) << widened
+              << std::setw(11) << widenedError << '\n'
+              << std::setw(22) << "mulhrs + adds" << std::setw(14) << mulhrs << std::setw(11)
+              << mulhrsError << '\n'
+              << std::setw(22) << "madd" << std::setw(14) << madd << std::setw(11)
+              << maddError << '\n';
+    return 0;
+}
@@ -0,0 +1,169 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include <Vc/Vc>
+#include <Vc/Matrix>
+#include <Vc/simdize>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using Vc::float_v;
+using Vc::SmallMatrix;
+
+template <typename T> void unused(T &&x) { asm("" ::"m"(x)); }
+
+// Runs f repeatedly and returns the best time for one call in seconds.
+template <typename F> double bestTime(F &&f, int repetitions)
+{
+    double best = 1e99;
+    for (int rep = 0; rep < repetitions; ++rep) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        const auto stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(stop - start).count());
+    }
+    return best;
+}
+
+// The algorithm of examples/matrix (broadcast of A times row vectors of B, 4 rows unrolled)
+// for runtime sizes.
+void exampleMatrixMul(const Vc::PitchedMemory<float_v, 2> &a,
+                      const Vc::PitchedMemory<float_v, 2> &b, Vc::PitchedMemory<float_v, 2> &c)
+{
+    const std::size_t N = a.size(0);
+    const std::size_t N0 = N / 4 * 4;
+    for (std::size_t i = 0; i < N0; i += 4) {
+        for (std::size_t j = 0; j < b.vectorsPerRow(); ++j) {
+            float_v c_ij[4];
+            for (int n = 0; n < 4; ++n) {
+                c_ij[n] = a(i + n, 0) * float_v(b.row(0) + j * float_v::Size, Vc::Aligned);
+            }
+            for (std::size_t k = 1; k < N; ++k) {
+                for (int n = 0; n < 4; ++n) {
+                    c_ij[n] += a(i + n, k) * float_v(b.row(k) + j * float_v::Size, Vc::Aligned);
+                }
+            }
+            for (int n = 0; n < 4; ++n) {
+                c.vector(i + n, j) = c_ij[n];
+            }
+        }
+    }
+    for (std::size_t i = N0; i < N; ++i) {
+        for (std::size_t j = 0; j < b.vectorsPerRow(); ++j) {
+            float_v c_ij = a(i, 0) * float_v(b.row(0) + j * float_v::Size, Vc::Aligned);
+            for (std::size_t k = 1; k < N; ++k) {
+                c_ij += a(i, k) * float_v(b.row(k) + j * float_v::Size, Vc::Aligned);
+            }
+            c.vector(i, j) = c_ij;
+        }
+    }
+}
+
+void benchmarkGemm()
+{
+    std::cout << "   N   examples/matrix [GFLOP/s]   Vc::gemm [GFLOP/s]\n";
+    for (std::size_t N : {32, 64, 128, 256, 512, 1024}) {
+        Vc::PitchedMemory<float_v, 2> a(N, N), b(N, N), c(N, N);
+        for (std::size_t i = 0; i < N; ++i) {
+            for (std::size_t j = 0; j < N; ++j) {
+                a(i, j) = 0.01f * (i + j);
+                b(i, j) = 0.01f * (N + i - j);
+            }
+        }
+        const double flop = 2. * N * N * N;
+        const int reps = N >= 512 ? 3 : 20;
+        const double t0 = bestTime([&] {
+            exampleMatrixMul(a, b, c);
+            unused(c.entries()[0]);
+        }, reps);
+        const double t1 = bestTime([&] {
+            Vc::gemm(a, b, c);
+            unused(c.entries()[0]);
+        }, reps);
+        std::cout << std::setw(4) << N << std::setw(22) << std::setprecision(3)
+                  << flop / t0 * 1e-9 << std::setw(21) << flop / t1 * 1e-9 << '\n';
+    }
+}
+
+template <std::size_t N> void benchmarkBatched()
+{
+    using M = SmallMatrix<float, N>;
+    using MV = Vc::simdize<M>;
+    constexpr std::size_t Count = 4096;
+    std::vector<M> aos(Count);
+    std::vector<MV, Vc::Allocator<MV>> soa(Count / MV::size());
+    for (std::size_t n = 0; n < Count; ++n) {
+        for (std::size_t i = 0; i < N; ++i) {
+            for (std::size_t j = 0; j < N; ++j) {
+                aos[n](i, j) = 0.01f * (n % 7 + i + j) + (i == j ? N : 0);
+            }
+        }
+        assign(soa[n / MV::size()], n % MV::size(), aos[n]);
+    }
+    const double flop = Count * N * N * (2. * N - 1);
+    const double t0 = bestTime([&] {
+        for (auto &m : aos) {
+            m = m * m;
+            m *= 1.f / N;
+        }
+    }, 20);
+    const double t1 = bestTime([&] {
+        for (auto &m : soa) {
+            static_cast<SmallMatrix<float_v, N> &>(m) = m * m;
+            m *= float_v(1.f / N);
+        }
+    }, 20);
+    const double t2 = bestTime([&] {
+        for (auto &m : aos) {
+            unused(Vc::choleskyInverse(m));
+        }
+    }, 20);
+    const double t3 = bestTime([&] {
+        for (auto &m : soa) {
+            unused(Vc::choleskyInverse(m));
+        }
+    }, 20);
+    std::cout << std::setw(4) << N << std::setw(16) << std::setprecision(3)
+              << flop / t0 * 1e-9 << std::setw(16) << flop / t1 * 1e-9 << std::setw(19)
+              << Count / t2 * 1e-6 << std::setw(16) << Count / t3 * 1e-6 << '\n';
+}
+
+int main()
+{
+    benchmarkGemm();
+    std::cout << "\n       multiply [GFLOP/s]      choleskyInverse [10⁶ matrices/s]\n"
+                 "   N   scalar (AoS)   simdize (SoA)   scalar (AoS)   simdize (SoA)\n";
+    benchmarkBatched<3>();
+    benchmarkBatched<4>();
+    benchmarkBatched<5>();
+    benchmarkBatched<6>();
+    benchmarkBatched<8>();
+    return 0;
+}
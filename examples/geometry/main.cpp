@@ -0,0 +1,201 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include <Vc/Geometry>
+#include <Vc/Allocator>
+#include <array>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../tsc.h"
+
+// Runs the Vc::Geometry kernels over 10240 points (or rays) of double precision, as in
+// examples/test_inside, for Scalar, SSE and the default ABI. Prints cycles per point.
+// The first row is the containment test of examples/test_inside (std::array points).
+
+using namespace Vc::Geometry;
+
+constexpr std::size_t ArraySize = 10240;
+
+template <typename F> double cyclesPer(std::size_t n, F &&f)
+{
+    unsigned long long best = ~0ull;
+    TimeStampCounter tsc;
+    for (int rep = 0; rep < 10; ++rep) {
+        tsc.start();
+        f();
+        tsc.stop();
+        best = std::min(best, tsc.cycles());
+    }
+    return double(best) / n;
+}
+
+static volatile double sink;
+
+template <typename V> struct Kernels
+{
+    typedef typename V::mask_type M;
+    typedef std::vector<point3<V>, Vc::Allocator<point3<V>>> Points;
+    static constexpr std::size_t Count = ArraySize / V::Size;
+
+    Points points, directions;
+    std::vector<M, Vc::Allocator<M>> inside;
+    std::vector<V, Vc::Allocator<V>> distance;
+
+    const aabb<double> box = {{0.2, 0.3, 0.4}, {0.5, 0.3, 0.1}};
+    obb<double> rotated;
+    const triangle<double> tri = {{-1, -1, 0.5}, {1, -1, 0.5}, {0, 1, 0.5}};
+    std::vector<point2<double>> corners;
+
+    Kernels() : points(Count), directions(Count), inside(Count), distance(Count)
+    {
+        std::default_random_engine engine;
+        std::uniform_real_distribution<double> uniform(-1, 1);
+        for (std::size_t i = 0; i < Count; ++i) {
+            for (std::size_t l = 0; l < V::Size; ++l) {
+                points[i].x[l] = uniform(engine);
+                points[i].y[l] = uniform(engine);
+                points[i].z[l] = uniform(engine);
+                // rays from z = -1 towards +z, stored as inverse directions for ray-box
+                directions[i].x[l] = 0.3 * uniform(engine);
+                directions[i].y[l] = 0.3 * uniform(engine);
+                directions[i].z[l] = 1;
+            }
+        }
+        const double c = std::cos(0.5), s = std::sin(0.5);
+        rotated = {box.center, box.half, {{c, s, 0}, {-s, c, 0}, {0, 0, 1}}};
+        // a star with 8 points
+        for (int i = 0; i < 16; ++i) {
+            const double r = i % 2 ? 0.4 : 0.9, phi = i * 3.14159265358979 / 8;
+            corners.push_back({r * std::cos(phi), r * std::sin(phi)});
+        }
+    }
+
+    double testInside()
+    {
+        typedef std::array<V, 3> Point;
+        const Point origin = {{V(0.2), V(0.3), V(0.4)}};
+        const Point boxsize = {{V(0.5), V(0.3), V(0.1)}};
+        std::vector<Point, Vc::Allocator<Point>> arrays(Count);
+        for (std::size_t i = 0; i < Count; ++i) {
+            arrays[i] = {{points[i].x, points[i].y, points[i].z}};
+        }
+        return cyclesPer(ArraySize, [&] {
+            for (std::size_t i = 0; i < Count; ++i) {
+                M in[3];
+                for (int dir = 0; dir < 3; ++dir) {
+                    in[dir] = Vc::abs(arrays[i][dir] - origin[dir]) < boxsize[dir];
+                }
+                inside[i] = in[0] && in[1] && in[2];
+            }
+            sink = inside[0].count();
+        });
+    }
+
+    template <typename F> double masks(F &&f)
+    {
+        return cyclesPer(ArraySize, [&] {
+            for (std::size_t i = 0; i < Count; ++i) {
+                inside[i] = f(i);
+            }
+            sink = inside[0].count();
+        });
+    }
+
+    template <typename F> double values(F &&f)
+    {
+        return cyclesPer(ArraySize, [&] {
+            for (std::size_t i = 0; i < Count; ++i) {
+                distance[i] = f(i);
+            }
+            sink = distance[0][0];
+        });
+    }
+
+    std::vector<double> run()
+    {
+        const polygon<double> star(corners.data(), corners.size());
+        const point3<V> origin(V(0.1), V(-0.1), V(-1));
+        return {
+            testInside(),
+            masks([&](std::size_t i) { return contains(box, points[i]); }),
+            masks([&](std::size_t i) { return contains(rotated, points[i]); }),
+            masks([&](std::size_t i) {
+                return contains(star, point2<V>(points[i].x, points[i].y));
+            }),
+            values([&](std::size_t i) { return safety_to_in(box, points[i]); }),
+            values([&](std::size_t i) { return safety_to_out(box, points[i]); }),
+            values([&](std::size_t i) {
+                V tNear, tFar;
+                const auto &d = directions[i];
+                const M hit = intersect(box, points[i],
+                                        point3<V>(V::One() / d.x, V::One() / d.y, V::One()),
+                                        tNear, tFar);
+                return iif(hit, tNear, V::Zero());
+            }),
+            values([&](std::size_t i) {
+                V t;
+                intersect(tri, origin, directions[i], t);
+                return t;
+            }),
+            values([&](std::size_t i) {
+                V r, phi;
+                to_polar(point2<V>(points[i].x, points[i].y), r, phi);
+                return r + phi;
+            }),
+        };
+    }
+};
+
+int main()
+{
+    const char *names[] = {"test_inside",   "aabb contains", "obb contains",
+                           "polygon (16)",  "safety_to_in",  "safety_to_out",
+                           "ray-box",       "ray-triangle",  "to_polar"};
+    const auto scalar = Kernels<Vc::Scalar::double_v>().run();
+#ifdef Vc_IMPL_SSE
+    const auto sse = Kernels<Vc::SSE::double_v>().run();
+#endif
+    const auto simd = Kernels<Vc::double_v>().run();
+    std::cout << std::setprecision(3) << "cycles per point, " << ArraySize
+              << " points (double)\n"
+              << std::setw(15) << "" << std::setw(9) << "Scalar" << std::setw(9) << "SSE"
+              << std::setw(9) << Vc::double_v::Size << " x double\n";
+    for (std::size_t k = 0; k < scalar.size(); ++k) {
+        std::cout << std::setw(15) << names[k] << std::setw(9) << scalar[k];
+#ifdef Vc_IMPL_SSE
+        std::cout << std::setw(9) << sse[k];
+#else
+        std::cout << std::setw(9) << "-";
+#endif
+        std::cout << std::setw(9) << simd[k] << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,138 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include <Vc/NumericIO>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../tsc.h"
+
+// Prints the number of cycles per value of parse_floats, parse_ints, and format_floats,
+// compared to a loop over strtof, strtol, and snprintf, for columns of random values.
+
+template <typename F> double cyclesPerValue(std::size_t count, F &&f)
+{
+    unsigned long long best = ~0ull;
+    TimeStampCounter tsc;
+    for (int rep = 0; rep < 10; ++rep) {
+        tsc.start();
+        f();
+        tsc.stop();
+        best = std::min(best, tsc.cycles());
+    }
+    return double(best) / count;
+}
+
+static void check(bool ok, const char *what)
+{
+    if (!ok) {
+        std::cerr << what << " returned a wrong result\n";
+    }
+}
+
+int main()
+{
+    constexpr std::size_t Count = 100000;
+    std::default_random_engine engine(1);
+    std::vector<float> floats(Count);
+    std::vector<int> ints(Count);
+    std::string floatText, intText;
+    char buffer[32];
+    for (std::size_t i = 0; i < Count; ++i) {
+        // a mix of measurement-like values with few digits and arbitrary floats
+        floats[i] = i % 2 ? std::round(std::uniform_real_distribution<float>(-1e4f, 1e4f)(
+                                engine)) / 100
+                          : std::uniform_real_distribution<float>(-1e6f, 1e6f)(engine);
+        ints[i] = std::uniform_int_distribution<int>(-1000000, 1000000)(engine);
+        std::snprintf(buffer, sizeof(buffer), "%.9g\n", floats[i]);
+        floatText += buffer;
+        std::snprintf(buffer, sizeof(buffer), "%d,", ints[i]);
+        intText += buffer;
+    }
+    std::vector<float> parsedFloats(Count);
+    std::vector<int> parsedInts(Count);
+    std::vector<char> text(Count * 16);
+
+    std::cout << "[cycles per value]\n";
+    const double strtofCycles = cyclesPerValue(Count, [&] {
+        const char *p = floatText.c_str();
+        for (std::size_t i = 0; i < Count; ++i) {
+            char *end;
+            parsedFloats[i] = std::strtof(p, &end);
+            p = end + 1;
+        }
+    });
+    const double parseFloatsCycles = cyclesPerValue(Count, [&] {
+        check(Vc::parse_floats(floatText.data(), floatText.size(), parsedFloats.data()) ==
+                  Count,
+              "parse_floats");
+    });
+    check(parsedFloats == floats, "parse_floats");
+    std::cout << "strtof        " << std::setw(8) << std::setprecision(3) << strtofCycles
+              << "\nparse_floats  " << std::setw(8) << parseFloatsCycles << '\n';
+
+    const double strtolCycles = cyclesPerValue(Count, [&] {
+        const char *p = intText.c_str();
+        for (std::size_t i = 0; i < Count; ++i) {
+            char *end;
+            parsedInts[i] = int(std::strtol(p, &end, 10));
+            p = end + 1;
+        }
+    });
+    const double parseIntsCycles = cyclesPerValue(Count, [&] {
+        check(Vc::parse_ints(intText.data(), intText.size(), parsedInts.data()) == Count,
+              "parse_ints");
+    });
+    check(parsedInts == ints, "parse_ints");
+    std::cout << "strtol        " << std::setw(8) << strtolCycles << "\nparse_ints    "
+              << std::setw(8) << parseIntsCycles << '\n';
+
+    std::size_t length = 0;
+    const double snprintfCycles = cyclesPerValue(Count, [&] {
+        char *p = text.data();
+        for (std::size_t i = 0; i < Count; ++i) {
+            p += std::snprintf(p, 16, "%.9g\n", floats[i]);
+        }
+    });
+    const double formatCycles = cyclesPerValue(Count, [&] {
+        length = Vc::format_floats(floats.data(), Count, text.data());
+    });
+    check(Vc::parse_floats(text.data(), length, parsedFloats.data()) == Count &&
+              parsedFloats == floats,
+          "format_floats");
+    std::cout << "snprintf %.9g " << std::setw(8) << snprintfCycles << "\nformat_floats "
+              << std::setw(8) << formatCycles << '\n';
+    return 0;
+}
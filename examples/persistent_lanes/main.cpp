@@ -0,0 +1,232 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include <Vc/Vc>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "../tsc.h"
+
+// Compares a vector loop that iterates until all lanes of the vector are done with
+// Vc::persistent_lanes, which refills every lane that is done with the next work item.
+// Two kernels with different spread in the number of iterations per work item are used:
+// - the Mandelbrot set of the mandelbrot example, where neighboring pixels mostly need
+//   similar numbers of iterations,
+// - the length of Collatz sequences, which varies a lot between neighboring start values.
+
+using Vc::float_v;
+using Vc::float_m;
+using Vc::uint_v;
+using Vc::uint_m;
+
+template <typename F> unsigned long long bestOf(F &&f)
+{
+    unsigned long long best = ~0ull;
+    TimeStampCounter tsc;
+    for (int rep = 0; rep < 5; ++rep) {
+        tsc.start();
+        f();
+        tsc.stop();
+        best = std::min(best, tsc.cycles());
+    }
+    return best;
+}
+
+// Mandelbrot {{{1
+template <typename T> struct Complex
+{
+    T re, im, re2, im2;
+    Complex(T r, T i) : re(r), im(i), re2(r * r), im2(i * i) {}
+    Complex next(T cr, T ci) const { return Complex(re2 + cr - im2, (re + re) * im + ci); }
+    T norm() const { return re2 + im2; }
+};
+
+struct Mandelbrot
+{
+    typedef Vc::SimdArray<int, float_v::Size> Items;
+    static constexpr int Width = 600;
+    static constexpr int Height = 400;
+    static constexpr int MaxIt = 255;
+    const float x0 = -2.2f, y0 = -1.2f, scale = 2.4f / Height;
+    std::vector<int> result = std::vector<int>(Width * Height);
+
+    static constexpr std::size_t count() { return Width * Height; }
+
+    // returns the number of lane iterations, including the idle lanes
+    unsigned long long vectorLoop()
+    {
+        unsigned long long laneSteps = 0;
+        for (int y = 0; y < Height; ++y) {
+            const float_v ci = y0 + y * scale;
+            for (int x = 0; x < Width; x += float_v::Size) {
+                const float_v cr = x0 + (float_v::IndexesFromZero() + float(x)) * scale;
+                Complex<float_v> z(cr, ci);
+                float_v n = float_v::Zero();
+                float_m running = z.norm() < 4.f;
+                while (!running.isEmpty()) {
+                    z = z.next(cr, ci);
+                    ++n(running);
+                    running = z.norm() < 4.f && n < MaxIt;
+                    laneSteps += float_v::Size;
+                }
+                Vc::simd_cast<Items>(n).store(&result[y * Width + x], Vc::Unaligned);
+            }
+        }
+        return laneSteps;
+    }
+
+    void persistentLanes()
+    {
+        for (int y = 0; y < Height; ++y) {
+            int *line = &result[y * Width];
+            const float_v ci = y0 + y * scale;
+            float_v cr = float_v::Zero();
+            float_v n = float_v::Zero();
+            Complex<float_v> z(cr, ci);
+            Vc::persistent_lanes<float_v>(
+                Width,
+                [&](const Items &x, const float_m &fresh) {
+                    Vc::where(fresh) | cr = x0 + Vc::simd_cast<float_v>(x) * scale;
+                    Vc::where(fresh) | n = float_v::Zero();
+                    Vc::where(fresh) | z.re = cr;
+                    Vc::where(fresh) | z.im = ci;
+                    Vc::where(fresh) | z.re2 = cr * cr;
+                    Vc::where(fresh) | z.im2 = ci * ci;
+                },
+                [&](const float_m &) {
+                    const float_m running = z.norm() < 4.f && n < MaxIt;
+                    z = z.next(cr, ci);
+                    ++n(running);
+                    return !running;
+                },
+                [&](const Items &x, const float_m &done) {
+                    const Items iterations = Vc::simd_cast<Items>(n);
+                    for (std::size_t i : Vc::where(done)) {
+                        line[x[i]] = iterations[i];
+                    }
+                });
+        }
+    }
+};
+
+// Collatz {{{1
+struct Collatz
+{
+    typedef Vc::SimdArray<int, uint_v::Size> Items;
+    // below 100000 all values of the sequences fit into 32 bits
+    static constexpr int Count = 100000;
+    std::vector<int> result = std::vector<int>(Count);
+
+    static constexpr std::size_t count() { return Count; }
+
+    unsigned long long vectorLoop()
+    {
+        unsigned long long laneSteps = 0;
+        for (int i = 0; i < Count; i += uint_v::Size) {
+            uint_v x = uint_v::IndexesFromZero() + unsigned(i + 1);
+            // lanes past the end start at 1 and therefore are done immediately
+            x.setZero(x > unsigned(Count));
+            x(x == 0) = 1u;
+            uint_v n = uint_v::Zero();
+            uint_m running = x != 1;
+            while (!running.isEmpty()) {
+                x = iif((x & 1) == 0, x >> 1, x * 3 + 1);
+                x(!running) = 1u;
+                ++n(running);
+                running = x != 1;
+                laneSteps += uint_v::Size;
+            }
+            Vc::simd_cast<Items>(n).store(&result[i], Items::IndexesFromZero() < Count - i,
+                                          Vc::Unaligned);
+        }
+        return laneSteps;
+    }
+
+    void persistentLanes()
+    {
+        uint_v x = uint_v::Zero();
+        uint_v n = uint_v::Zero();
+        Vc::persistent_lanes<uint_v>(
+            Count,
+            [&](const Items &items, const uint_m &fresh) {
+                Vc::where(fresh) | x = Vc::simd_cast<uint_v>(items) + 1u;
+                Vc::where(fresh) | n = uint_v::Zero();
+            },
+            [&](const uint_m &) {
+                const uint_m running = x != 1;
+                x = iif((x & 1) == 0, x >> 1, x * 3 + 1);
+                ++n(running);
+                return !running;
+            },
+            [&](const Items &items, const uint_m &done) {
+                const Items steps = Vc::simd_cast<Items>(n);
+                for (std::size_t i : Vc::where(done)) {
+                    result[items[i]] = steps[i];
+                }
+            });
+    }
+};
+
+// main {{{1
+template <typename Kernel> bool compare(const char *name)
+{
+    Kernel kernel;
+    unsigned long long laneSteps = 0;
+    const double vectorCycles = bestOf([&] { laneSteps = kernel.vectorLoop(); });
+    const std::vector<int> reference = kernel.result;
+    std::fill(kernel.result.begin(), kernel.result.end(), -1);
+    const double lanesCycles = bestOf([&] { kernel.persistentLanes(); });
+    if (kernel.result != reference) {
+        std::cerr << name << ": persistent_lanes computed a different result\n";
+        return false;
+    }
+
+    unsigned long long usefulSteps = 0;
+    for (int n : reference) {
+        usefulSteps += n;
+    }
+    const double n = Kernel::count();
+    std::cout << std::setw(12) << name << std::setw(12) << vectorCycles / n
+              << std::setw(12) << 100. * usefulSteps / laneSteps << '%' << std::setw(12)
+              << lanesCycles / n << std::setw(12) << vectorCycles / lanesCycles << '\n';
+    return true;
+}
+
+int main()
+{
+    std::cout << std::setprecision(3) << std::setw(12) << "kernel" << std::setw(12)
+              << "vector loop" << std::setw(13) << "lanes busy" << std::setw(12) << "persistent"
+              << std::setw(12) << "speedup" << '\n';
+    std::cout << std::setw(12) << "" << std::setw(12) << "cycles/item" << std::setw(13) << ""
+              << std::setw(12) << "cycles/item" << '\n';
+    const bool ok = compare<Mandelbrot>("mandelbrot") && compare<Collatz>("collatz");
+    return ok ? 0 : 1;
+}
+
+// vim: foldmethod=marker
@@ -0,0 +1,128 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include <Vc/Polynomial>
+#include <Vc/Allocator>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "../tsc.h"
+
+// Compares Horner's and Estrin's scheme for polynomials of 5 to 21 coefficients, with
+// coefficients known at compile time (array size) and at runtime, in two settings:
+// - latency: every evaluation depends on the previous result,
+// - throughput: independent evaluations over an array.
+// Prints cycles per evaluation (of one vector) for Scalar, SSE and the default ABI.
+
+template <typename F> double cyclesPer(std::size_t n, F &&f)
+{
+    unsigned long long best = ~0ull;
+    TimeStampCounter tsc;
+    for (int rep = 0; rep < 10; ++rep) {
+        tsc.start();
+        f();
+        tsc.stop();
+        best = std::min(best, tsc.cycles());
+    }
+    return double(best) / n;
+}
+
+static volatile float start = 0.5f, sink;
+
+template <typename V, typename F> static double latency(F &&p)
+{
+    const std::size_t Iterations = 1000;
+    return cyclesPer(Iterations, [&] {
+        V x = start;
+        for (std::size_t i = 0; i < Iterations; ++i) {
+            // the coefficients decay, so that x stays in [0.5, 0.6]
+            x = p(x) * 0.01f + 0.5f;
+        }
+        sink = x.sum();
+    });
+}
+
+template <typename V, typename F> static double throughput(F &&p)
+{
+    static std::vector<V, Vc::Allocator<V>> x(1024, V(0.5f)), y(1024);
+    return cyclesPer(x.size(), [&] {
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            y[i] = p(x[i]);
+        }
+        sink = y[0].sum();
+    });
+}
+
+template <typename V, std::size_t N> static void row()
+{
+    static float c[N];
+    for (std::size_t i = 0; i < N; ++i) {
+        c[i] = 1.f / (i + 1);
+    }
+    const float *dynamic = c;
+
+    const auto hornerC = [&](V x) { return Vc::horner(x, c); };
+    const auto estrinC = [&](V x) { return Vc::estrin(x, c); };
+    const auto hornerR = [&](V x) { return Vc::horner(x, dynamic, N); };
+    const auto estrinR = [&](V x) { return Vc::estrin(x, dynamic, N); };
+
+    std::cout << std::setw(7) << N - 1 << std::setw(9) << latency<V>(hornerC) << std::setw(9)
+              << latency<V>(estrinC) << std::setw(9) << latency<V>(hornerR) << std::setw(9)
+              << latency<V>(estrinR) << std::setw(11) << throughput<V>(hornerC)
+              << std::setw(9) << throughput<V>(estrinC) << std::setw(9)
+              << throughput<V>(hornerR) << std::setw(9) << throughput<V>(estrinR) << '\n';
+}
+
+template <typename V> static void table(const char *abi)
+{
+    std::cout << abi << " (" << V::Size << " x float)\n"
+              << std::setw(7) << "degree" << std::setw(36) << "latency            "
+              << std::setw(38) << "throughput          \n"
+              << std::setw(7) << "" << std::setw(18) << "horner estrin" << std::setw(18)
+              << "(runtime)      " << std::setw(20) << "horner estrin" << std::setw(18)
+              << "(runtime)      \n";
+    row<V, 5>();
+    row<V, 9>();
+    row<V, 13>();
+    row<V, 17>();
+    row<V, 21>();
+}
+
+int main()
+{
+    std::cout << std::setprecision(3);
+    table<Vc::Scalar::float_v>("Scalar");
+#ifdef Vc_IMPL_SSE
+    table<Vc::SSE::float_v>("SSE");
+#endif
+#ifdef Vc_IMPL_AVX
+    table<Vc::float_v>("AVX");
+#endif
+    return 0;
+}
@@ -0,0 +1,91 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+// Measures the roofs of the roofline model for the vector ABIs this binary was compiled
+// for and writes them as JSON:
+//
+//     vc_roofline [max-MiB] [output.json]
+//
+// max-MiB limits the working set of the memory probes (default: 1024).
+
+#include <Vc/Roofline>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+using namespace Vc::Roofline;
+
+template <typename V> void probeAll(Report &report, std::size_t maxBytes)
+{
+    report.add(probe_fma<V>());
+    for (std::size_t bytes : probe_sizes(maxBytes)) {
+        report.add(probe_load<V>(bytes, Vc::Aligned));
+        report.add(probe_load<V>(bytes, Vc::Unaligned));
+        report.add(probe_load<V>(bytes, Vc::Streaming));
+        report.add(probe_store<V>(bytes, Vc::Aligned));
+        report.add(probe_store<V>(bytes, Vc::Unaligned));
+        report.add(probe_store<V>(bytes, Vc::Streaming));
+        report.add(probe_gather<V>(bytes));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const std::size_t maxBytes = (argc > 1 ? std::atoi(argv[1]) : 1024) * std::size_t(1 << 20);
+
+    Report report;
+    probeAll<Vc::Scalar::float_v>(report, maxBytes);
+    probeAll<Vc::Scalar::double_v>(report, maxBytes);
+#ifdef Vc_IMPL_SSE
+    probeAll<Vc::SSE::float_v>(report, maxBytes);
+    probeAll<Vc::SSE::double_v>(report, maxBytes);
+#endif
+#if defined Vc_IMPL_AVX || defined Vc_IMPL_MIC
+    probeAll<Vc::float_v>(report, maxBytes);
+    probeAll<Vc::double_v>(report, maxBytes);
+#endif
+
+    if (argc > 2) {
+        std::ofstream file(argv[2]);
+        report.write_json(file);
+    } else {
+        report.write_json(std::cout);
+    }
+
+    std::cerr << "peak float FLOP/cycle: " << report.best("fma", "float")
+              << "\npeak double FLOP/cycle: " << report.best("fma", "double") << '\n';
+    for (const char *level : {"L1", "L2", "L3", "DRAM"}) {
+        const double bandwidth = report.best("load", "", level);
+        if (bandwidth > 0) {
+            std::cerr << "ridge point (" << level
+                      << ", float): " << report.best("fma", "float") / bandwidth
+                      << " FLOP/Byte\n";
+        }
+    }
+    return 0;
+}
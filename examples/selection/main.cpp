@@ -0,0 +1,128 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include <Vc/Selection>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "../tsc.h"
+
+// Compares simd_argmin/simd_argmax and simd_top_k with the standard algorithms over float
+// arrays that fit into L1, L2 and only into memory. Prints cycles per value. The threaded
+// variants use four threads.
+
+template <typename F> double cyclesPer(std::size_t n, F &&f)
+{
+    unsigned long long best = ~0ull;
+    TimeStampCounter tsc;
+    for (int rep = 0; rep < 10; ++rep) {
+        tsc.start();
+        f();
+        tsc.stop();
+        best = std::min(best, tsc.cycles());
+    }
+    return double(best) / n;
+}
+
+static volatile std::size_t sink;
+
+static void row(std::size_t n)
+{
+    std::default_random_engine engine;
+    std::normal_distribution<float> dist;
+    std::vector<float> data(n);
+    for (auto &x : data) {
+        x = dist(engine);
+    }
+    std::vector<std::size_t> indexes(n), top(100);
+
+    const double stdMin = cyclesPer(n, [&] {
+        sink = std::min_element(data.begin(), data.end()) - data.begin();
+    });
+    const double stdMax = cyclesPer(n, [&] {
+        sink = std::max_element(data.begin(), data.end()) - data.begin();
+    });
+    const double vcMin = cyclesPer(n, [&] {
+        sink = Vc::simd_argmin(data.begin(), data.end()) - data.begin();
+    });
+    const double vcMax = cyclesPer(n, [&] {
+        sink = Vc::simd_argmax(data.begin(), data.end()) - data.begin();
+    });
+    const double vcMax4 = cyclesPer(n, [&] {
+        sink = Vc::simd_argmax(data.begin(), data.end(), 4) - data.begin();
+    });
+    std::cout << std::setw(10) << n << std::setw(9) << stdMin << std::setw(9) << vcMin
+              << std::setw(9) << stdMax << std::setw(9) << vcMax << std::setw(9) << vcMax4;
+
+    for (std::size_t k : {8, 100}) {
+        // the standard way to select the indexes of the k largest values
+        const auto greater = [&](std::size_t a, std::size_t b) { return data[a] > data[b]; };
+        const double stdTop = cyclesPer(n, [&] {
+            std::iota(indexes.begin(), indexes.end(), 0);
+            std::partial_sort(indexes.begin(), indexes.begin() + k, indexes.end(), greater);
+            sink = indexes[0];
+        });
+        const double stdNth = cyclesPer(n, [&] {
+            std::iota(indexes.begin(), indexes.end(), 0);
+            std::nth_element(indexes.begin(), indexes.begin() + (k - 1), indexes.end(),
+                             greater);
+            std::sort(indexes.begin(), indexes.begin() + k, greater);
+            sink = indexes[0];
+        });
+        const double vcTop = cyclesPer(n, [&] {
+            Vc::simd_top_k(data.begin(), data.end(), k, top.begin());
+            sink = top[0];
+        });
+        const double vcTop4 = cyclesPer(n, [&] {
+            Vc::simd_top_k(data.begin(), data.end(), k, top.begin(), 4);
+            sink = top[0];
+        });
+        std::cout << std::setw(11) << stdTop << std::setw(9) << stdNth << std::setw(9) << vcTop
+                  << std::setw(9) << vcTop4;
+    }
+    std::cout << '\n';
+}
+
+int main()
+{
+    std::cout << std::setprecision(3) << Vc::float_v::Size << " x float, cycles per value\n"
+              << std::setw(10) << "values" << std::setw(18) << "argmin      "
+              << std::setw(27) << "argmax               " << std::setw(38)
+              << "top-8                       " << std::setw(38)
+              << "top-100                     \n"
+              << std::setw(10) << "" << std::setw(18) << "std    simd" << std::setw(27)
+              << "std    simd simd/4t" << std::setw(38) << "partial nth_elem   simd simd/4t"
+              << std::setw(38) << "partial nth_elem   simd simd/4t\n";
+    for (std::size_t n : {std::size_t(4096), std::size_t(65536), std::size_t(1) << 24}) {
+        row(n);
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include <Vc/Serialization>
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "../tsc.h"
+
+// Prints the throughput of writing and reading a large Vc::Memory object in the binary
+// serialization format, with and without checksum and streaming stores, compared to
+// memcpy of the same number of bytes.
+
+template <typename F> double bytesPerCycle(std::size_t bytes, F &&f)
+{
+    unsigned long long best = ~0ull;
+    TimeStampCounter tsc;
+    for (int rep = 0; rep < 5; ++rep) {
+        tsc.start();
+        f();
+        tsc.stop();
+        best = std::min(best, tsc.cycles());
+    }
+    return double(bytes) / best;
+}
+
+static void check(bool ok, const char *what)
+{
+    if (!ok) {
+        std::cerr << what << " returned a wrong result\n";
+    }
+}
+
+int main()
+{
+    constexpr std::size_t Count = 16 * 1024 * 1024;
+    Vc::Memory<Vc::float_v> data(Count);
+    for (std::size_t i = 0; i < Count; ++i) {
+        data[i] = float(i) * 0.5f;
+    }
+    const std::size_t size = Vc::serialized_size(data);
+    std::vector<char, Vc::Allocator<char>> buffer(size);
+    std::vector<char, Vc::Allocator<char>> copy(size);
+    Vc::Memory<Vc::float_v> result(Count);
+    const std::size_t bytes = Count * sizeof(float);
+
+    std::cout << "[bytes per cycle]\n" << std::setprecision(3);
+    std::cout << "memcpy                   " << std::setw(8) << bytesPerCycle(bytes, [&] {
+        std::memcpy(copy.data(), data.entries(), bytes);
+    }) << '\n';
+    std::cout << "serialize                " << std::setw(8) << bytesPerCycle(bytes, [&] {
+        Vc::serialize(data, buffer.data(), Vc::Aligned, false);
+    }) << '\n';
+    std::cout << "serialize + crc32c       " << std::setw(8) << bytesPerCycle(bytes, [&] {
+        Vc::serialize(data, buffer.data());
+    }) << '\n';
+    std::cout << "serialize streaming+crc  " << std::setw(8) << bytesPerCycle(bytes, [&] {
+        Vc::serialize(data, buffer.data(), Vc::Streaming);
+    }) << '\n';
+    std::cout << "deserialize              " << std::setw(8) << bytesPerCycle(bytes, [&] {
+        check(Vc::deserialize(buffer.data(), size, result, false) ==
+                  Vc::SerializationResult::Success,
+              "deserialize");
+    }) << '\n';
+    std::cout << "deserialize + crc32c     " << std::setw(8) << bytesPerCycle(bytes, [&] {
+        check(Vc::deserialize(buffer.data(), size, result) == Vc::SerializationResult::Success,
+              "deserialize");
+    }) << '\n';
+    check(std::memcmp(result.entries(), data.entries(), bytes) == 0, "deserialize");
+
+    // the zero-copy view only validates the header (and optionally the checksum)
+    Vc::MemoryView<Vc::float_v> view;
+    std::cout << "view_serialized + crc32c " << std::setw(8) << bytesPerCycle(bytes, [&] {
+        check(Vc::view_serialized(buffer.data(), size, view, true) ==
+                  Vc::SerializationResult::Success,
+              "view_serialized");
+    }) << '\n';
+    check(view.entriesCount() == Count && view[Count - 1] == data[Count - 1],
+          "view_serialized");
+    return 0;
+}
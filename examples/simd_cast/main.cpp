@@ -0,0 +1,113 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include <Vc/Vc>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "../tsc.h"
+
+// Prints the number of cycles per simd_cast<SimdArray<To, N>>(SimdArray<From, N>) for all
+// combinations of the SimdArray entry types. The number of entries is chosen such that
+// the SimdArrays are implemented with one, two, and four native vectors of float_v.
+
+template <typename T> const char *typeName();
+template <> const char *typeName<double>() { return "double"; }
+template <> const char *typeName<float>() { return "float"; }
+template <> const char *typeName<int>() { return "int"; }
+template <> const char *typeName<unsigned int>() { return "uint"; }
+template <> const char *typeName<short>() { return "short"; }
+template <> const char *typeName<unsigned short>() { return "ushort"; }
+
+template <typename To, typename From, std::size_t N> double cyclesPerCast()
+{
+    using A = Vc::SimdArray<From, N>;
+    using R = Vc::SimdArray<To, N>;
+    constexpr std::size_t Count = 1024;
+    std::vector<A, Vc::Allocator<A>> input(Count);
+    std::vector<R, Vc::Allocator<R>> output(Count);
+    for (std::size_t i = 0; i < Count; ++i) {
+        input[i] = A(Vc::IndexesFromZero) + From(i % 64);
+    }
+
+    unsigned long long best = ~0ull;
+    TimeStampCounter tsc;
+    for (int rep = 0; rep < 20; ++rep) {
+        tsc.start();
+        for (std::size_t i = 0; i < Count; ++i) {
+            output[i] = Vc::simd_cast<R>(input[i]);
+        }
+        tsc.stop();
+        best = std::min(best, tsc.cycles());
+    }
+
+    for (std::size_t i = 0; i < Count; i += 97) {
+        for (std::size_t j = 0; j < N; ++j) {
+            if (output[i][j] != static_cast<To>(input[i][j])) {
+                std::cerr << "simd_cast<SimdArray<" << typeName<To>() << ", " << N
+                          << ">> returned a wrong result\n";
+            }
+        }
+    }
+    return double(best) / Count;
+}
+
+template <typename From, std::size_t N> void printRow()
+{
+    std::cout << std::setw(8) << typeName<From>() << std::setprecision(3)
+              << std::setw(8) << cyclesPerCast<double, From, N>()
+              << std::setw(8) << cyclesPerCast<float, From, N>()
+              << std::setw(8) << cyclesPerCast<int, From, N>()
+              << std::setw(8) << cyclesPerCast<unsigned int, From, N>()
+              << std::setw(8) << cyclesPerCast<short, From, N>()
+              << std::setw(8) << cyclesPerCast<unsigned short, From, N>() << '\n';
+}
+
+template <std::size_t N> void printTable()
+{
+    std::cout << "\nSimdArray<From, " << N << "> -> SimdArray<To, " << N
+              << "> [cycles per simd_cast]\n"
+              << "From\\To   double   float     int    uint   short  ushort\n";
+    printRow<double, N>();
+    printRow<float, N>();
+    printRow<int, N>();
+    printRow<unsigned int, N>();
+    printRow<short, N>();
+    printRow<unsigned short, N>();
+}
+
+int main()
+{
+    std::cout << "native vector sizes: double_v " << Vc::double_v::Size << ", float_v "
+              << Vc::float_v::Size << ", int_v " << Vc::int_v::Size << ", short_v "
+              << Vc::short_v::Size << '\n';
+    printTable<Vc::float_v::Size>();
+    printTable<2 * Vc::float_v::Size>();
+    printTable<4 * Vc::float_v::Size>();
+    return 0;
+}
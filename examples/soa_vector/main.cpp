@@ -0,0 +1,119 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include <Vc/Vc>
+#include <Vc/simdize>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <tuple>
+#include <vector>
+
+// x, y, z, vx, vy, vz
+using Particle = std::tuple<float, float, float, float, float, float>;
+using ParticleV = Vc::simdize<Particle>;
+
+// moves the particle and returns its kinetic energy
+template <typename P, typename T> T step(P &p, T dt)
+{
+    using std::get;
+    get<0>(p) += get<3>(p) * dt;
+    get<1>(p) += get<4>(p) * dt;
+    get<2>(p) += get<5>(p) * dt;
+    return T(0.5f) * (get<3>(p) * get<3>(p) + get<4>(p) * get<4>(p) + get<5>(p) * get<5>(p));
+}
+
+template <typename F> double bestTime(F &&f)
+{
+    double best = 1e99;
+    for (int rep = 0; rep < 20; ++rep) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        const auto stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(stop - start).count());
+    }
+    return best;
+}
+
+int main()
+{
+    constexpr float dt = 0.01f;
+    std::cout << "      N   std::vector   simdize<iterator>   soa_vector   [10⁶ particles/s]\n";
+    for (std::size_t n : {1024, 16 * 1024, 256 * 1024, 4 * 1024 * 1024}) {
+        n = n / ParticleV::size() * ParticleV::size();  // simdize<iterator> needs full chunks
+        std::vector<Particle> aos;
+        Vc::soa_vector<Particle> soa;
+        for (std::size_t i = 0; i < n; ++i) {
+            const Particle p(i, 0.5f * i, 1.f, 0.001f * (i % 7), 1.f, -0.002f * (i % 11));
+            aos.push_back(p);
+            soa.push_back(p);
+        }
+
+        float energy0 = 0.f;
+        const double t0 = bestTime([&] {
+            energy0 = 0.f;
+            for (auto &p : aos) {
+                energy0 += step(p, dt);
+            }
+        });
+
+        float energy1 = 0.f;
+        const double t1 = bestTime([&] {
+            using It = Vc::simdize<std::vector<Particle>::iterator>;
+            Vc::float_v e = 0.f;
+            for (It it = aos.begin(); it != It(aos.end()); ++it) {
+                ParticleV p = *it;
+                e += step(p, Vc::float_v(dt));
+                *it = p;
+            }
+            energy1 = e.sum();
+        });
+
+        float energy2 = 0.f;
+        const double t2 = bestTime([&] {
+            Vc::float_v e = 0.f;
+            for (auto &&chunk : soa.vectors()) {
+                ParticleV p = chunk;
+                e += step(p, Vc::float_v(dt));
+                chunk = p;
+            }
+            energy2 = e.sum();
+        });
+
+        if (std::abs(energy0 - energy1) > 1e-3f * energy0 ||
+            std::abs(energy0 - energy2) > 1e-3f * energy0) {
+            std::cerr << "results differ: " << energy0 << ' ' << energy1 << ' ' << energy2
+                      << '\n';
+            return 1;
+        }
+        std::cout << std::setw(7) << n << std::setprecision(4) << std::setw(14)
+                  << n / t0 * 1e-6 << std::setw(20) << n / t1 * 1e-6 << std::setw(13)
+                  << n / t2 * 1e-6 << '\n';
+    }
+    return 0;
+}
@@ -25,6 +25,7 @@
 #include <iostream>
 #include <iomanip>
 #include <random>
+#include <Vc/Interpolation>
 #include "../tsc.h"
 #include "spline.h"
 #include "spline2.h"
@@ -52,6 +53,8 @@ enum EnabledTests {
     Horizontal1,
     Horizontal2,
     Autovectorized,
+    Grid,
+    GridHorizontal,
     NBenchmarks
 };
 
@@ -68,6 +71,8 @@ std::string testName(int i)
     case Horizontal2:        return "Horiz.2";
     case Horizontal3:        return "Horiz.3";
     case Autovectorized:     return "Autovec";
+    case Grid:               return "Grid";
+    case GridHorizontal:     return "GridHoriz.";
     default:                 return "<unknown>";
     }
 }
@@ -239,12 +244,16 @@ int main()  // {{{1
         Spline spline(-1.f, 1.f, MapSize, -1.f, 1.f, MapSize);
         Spline2 spline2(-1.f, 1.f, MapSize, -1.f, 1.f, MapSize);
         Spline3 spline3(-1.f, 1.f, MapSize, -1.f, 1.f, MapSize);
+        Vc::GridInterpolator<2, 3, Point3> grid({{-1.f, -1.f}}, {{1.f, 1.f}},
+                                                {{std::size_t(MapSize), std::size_t(MapSize)}});
         for (int i = 0; i < spline.GetNPoints(); ++i) {
             const float xyz[3] = {uniform(randomEngine), uniform(randomEngine),
                                   uniform(randomEngine)};
             spline.Fill(i, xyz);
             spline2.Fill(i, xyz);
             spline3.Fill(i, xyz);
+            grid.node({{std::size_t(i / MapSize), std::size_t(i % MapSize)}}) =
+                Point3{{xyz[0], xyz[1], xyz[2]}};
         }
 
         // run Benchmarks {{{2
@@ -317,6 +326,20 @@ int main()  // {{{1
                     }
                 });
                 break;
+            case Grid:  // {{{3
+                runner.benchmark(i, [&](const Point2 &p) {
+                    const auto &p2 = grid(p);
+                    asm("" ::"m"(p2));
+                });
+                break;
+            case GridHorizontal:  // {{{3
+                runner.benchmark(i, [&](const Point2 &p) {
+                    if (0 == vectorizer(p)) {
+                        const auto &p2 = grid(vectorizer.input);
+                        asm("" ::"m"(p2));
+                    }
+                });
+                break;
             default:  // {{{3
                 break;
             }
@@ -404,6 +427,18 @@ int main()  // {{{1
                         }
                     }
                 }
+                if (TestInfo(Grid)) {  //{{{3
+                    const auto &pv = grid(p);
+                    for (int i = 0; i < 3; ++i) {
+                        // the weights are summed in a different order than in GetSpline3
+                        if (std::abs(ps[i] - pv[i]) > 0.00001f * (1.f + std::abs(ps[i]))) {
+                            std::cout << "\nGrid not equal at " << p << ": " << ps
+                                      << " vs. " << pv;
+                            failed = true;
+                            break;
+                        }
+                    }
+                }
                 vectorizer3(ps);
                 if (0 == vectorizer2(p)) {
                     if (TestInfo(Horizontal1)) {  //{{{3
@@ -428,6 +463,18 @@ int main()  // {{{1
                             }
                         }
                     }
+                    if (TestInfo(GridHorizontal)) {  //{{{3
+                        const auto &pv = grid(vectorizer2.input);
+                        for (int i = 0; i < 3; ++i) {
+                            if (any_of(abs(vectorizer3.input[i] - pv[i]) >
+                                       0.00001f * (1.f + abs(vectorizer3.input[i])))) {
+                                cout << "\nGridHorizontal not equal at \n" << vectorizer2.input
+                                     << ":\n" << vectorizer3.input << " vs.\n" << pv;
+                                failed = true;
+                                break;
+                            }
+                        }
+                    }
                     if (TestInfo(Horizontal3)) {  //{{{3
                         const auto &pv = spline3.GetValue(vectorizer2.input);
                         for (int i = 0; i < 3; ++i) {
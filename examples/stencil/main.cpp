@@ -0,0 +1,203 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include <Vc/Stencil>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include "../tsc.h"
+
+// Benchmarks Vc::stencil
+// 1. against the central differences of the finitediff example (1-D, one step),
+// 2. for a 3-D 7-point diffusion stencil over several time steps: one Vc::stencil::apply
+//    per step, and Vc::stencil::sweep with temporal tiling and with several threads.
+
+using Vc::float_v;
+using Vc::stencil_point;
+
+template <typename F> unsigned long long bestOf(int reps, F &&f)
+{
+    unsigned long long best = ~0ull;
+    TimeStampCounter tsc;
+    for (int rep = 0; rep < reps; ++rep) {
+        tsc.start();
+        f();
+        tsc.stop();
+        best = std::min(best, tsc.cycles());
+    }
+    return best;
+}
+
+// 1-D central differences {{{1
+static void centralDifferences()
+{
+    const std::size_t N = 10240000;
+    const float h = 40000.f / N;
+    const float oneOver2h = 0.5f / h;
+    Vc::Memory<float_v> y(N), dy(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        y[i] = std::sin(i * h);
+    }
+
+    // the scalar loop of the finitediff example
+    const unsigned long long scalar = bestOf(5, [&] {
+        for (std::size_t i = 1; i < N - 1; ++i) {
+            dy[i] = (y[i + 1] - y[i - 1]) * oneOver2h;
+        }
+    });
+
+    // the hand-unrolled vector loop of the finitediff example. dy is shifted by one entry
+    // (as dy_points there), such that the stores are aligned.
+    Vc::Memory<float_v> dy1(N + float_v::Size);
+    const unsigned long long unrolled = bestOf(5, [&] {
+        const float_v c = oneOver2h;
+        float_v y0 = y.vector(0);
+        std::size_t i = 1;
+        for (; i + 4 <= y.vectorsCount(); i += 4) {
+            const float_v y1 = y.vector(i);
+            const float_v y2 = y.vector(i + 1);
+            const float_v y3 = y.vector(i + 2);
+            dy1.vector(i - 1) = (y0.shifted(2, y1) - y0) * c;
+            y0 = y.vector(i + 3);
+            dy1.vector(i) = (y1.shifted(2, y2) - y1) * c;
+            dy1.vector(i + 1) = (y2.shifted(2, y3) - y2) * c;
+            dy1.vector(i + 2) = (y3.shifted(2, y0) - y3) * c;
+        }
+        for (; i < y.vectorsCount(); ++i) {
+            const float_v y1 = y.vector(i);
+            dy1.vector(i - 1) = (y0.shifted(2, y1) - y0) * c;
+            y0 = y1;
+        }
+    });
+
+    typedef Vc::stencil<float_v, stencil_point<-1>, stencil_point<1>> Difference;
+    const Difference difference(-oneOver2h, oneOver2h);
+    const unsigned long long st = bestOf(5, [&] { difference.apply(y, dy); });
+
+    for (std::size_t i = 1; i + 2 < N; i += N / 7) {
+        if (std::abs(dy[i] - dy1[i - 1]) > 1e-3f * std::max(1.f, std::abs(dy[i]))) {
+            std::cerr << "results differ at " << i << ": " << dy[i] << " vs. " << dy1[i - 1]
+                      << '\n';
+        }
+    }
+
+    std::cout << "1-D central differences, " << N << " entries (cycles/entry)\n"
+              << std::setw(30) << "scalar loop" << std::setw(10) << double(scalar) / N << '\n'
+              << std::setw(30) << "finitediff vector loop" << std::setw(10)
+              << double(unrolled) / N << '\n'
+              << std::setw(30) << "Vc::stencil::apply" << std::setw(10) << double(st) / N
+              << '\n';
+}
+
+// 3-D diffusion {{{1
+typedef Vc::stencil<float_v, stencil_point<0, 0, 0>, stencil_point<-1, 0, 0>,
+                    stencil_point<1, 0, 0>, stencil_point<0, -1, 0>, stencil_point<0, 1, 0>,
+                    stencil_point<0, 0, -1>, stencil_point<0, 0, 1>> Diffusion;
+
+static void diffusion()
+{
+    const std::size_t n = 160;
+    const std::size_t steps = 8;
+    const float k = 0.1f;
+    const Diffusion diffusion(1 - 6 * k, k, k, k, k, k, k);
+    Vc::PitchedMemory<float_v, 3> init(n, n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            for (std::size_t l = 0; l < n; ++l) {
+                init(i, j, l) = (i * 7 + j * 3 + l) % 17 * 0.1f;
+            }
+        }
+    }
+
+    Vc::PitchedMemory<float_v, 3> a(init), b(init);
+    const unsigned long long scalar = bestOf(2, [&] {
+        for (std::size_t s = 0; s < steps; ++s) {
+            for (std::size_t i = 1; i + 1 < n; ++i) {
+                for (std::size_t j = 1; j + 1 < n; ++j) {
+                    for (std::size_t l = 1; l + 1 < n; ++l) {
+                        b(i, j, l) = (1 - 6 * k) * a(i, j, l) + k * a(i - 1, j, l) +
+                                     k * a(i + 1, j, l) + k * a(i, j - 1, l) +
+                                     k * a(i, j + 1, l) + k * a(i, j, l - 1) +
+                                     k * a(i, j, l + 1);
+                    }
+                }
+            }
+            a.swap(b);
+        }
+    });
+    const float reference = a(n / 2, n / 3, n / 4);
+
+    a = init;
+    b = init;
+    const unsigned long long perStep = bestOf(2, [&] {
+        for (std::size_t s = 0; s < steps; ++s) {
+            diffusion.apply(a, b);
+            a.swap(b);
+        }
+    });
+
+    a = init;
+    b = init;
+    const unsigned long long tiled = bestOf(2, [&] { diffusion.sweep(a, b, steps); });
+    const float result = a(n / 2, n / 3, n / 4);
+
+    const std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    a = init;
+    b = init;
+    const unsigned long long parallel =
+        bestOf(2, [&] { diffusion.sweep(a, b, steps, threads); });
+
+    if (std::abs(result - reference) > 1e-4f || std::abs(a(n / 2, n / 3, n / 4) - reference) > 1e-4f) {
+        std::cerr << "results differ: " << reference << ' ' << result << ' '
+                  << a(n / 2, n / 3, n / 4) << '\n';
+    }
+
+    const double points = double(n * n * n) * steps;
+    std::cout << "\n3-D 7-point diffusion, " << n << "^3 entries, " << steps
+              << " steps (cycles/entry/step)\n"
+              << std::setw(30) << "scalar loop" << std::setw(10) << scalar / points << '\n'
+              << std::setw(30) << "Vc::stencil::apply per step" << std::setw(10)
+              << perStep / points << '\n'
+              << std::setw(30) << "Vc::stencil::sweep" << std::setw(10) << tiled / points
+              << '\n'
+              << std::setw(24) << "sweep, " << std::setw(2) << threads << " threads"
+              << std::setw(10) << parallel / points << '\n';
+}
+
+// main {{{1
+int main()
+{
+    std::cout << std::setprecision(3);
+    centralDifferences();
+    diffusion();
+    return 0;
+}
+
+// vim: foldmethod=marker
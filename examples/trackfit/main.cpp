@@ -0,0 +1,136 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include <Vc/Vc>
+#include <Vc/Matrix>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using Vc::float_v;
+
+// A straight line track in a weak magnetic field, measured by planes at equidistant z that
+// alternately measure x and y. The track parameters are (x, y, tx, ty, q/p).
+constexpr std::size_t NPlanes = 12;
+constexpr float Dz = 10.f;
+constexpr float Sigma = 0.01f;
+constexpr float Bend = 0.001f;
+
+// The propagation Jacobian from one plane to the next.
+template <typename T> Vc::SmallMatrix<T, 5> jacobian()
+{
+    auto f = Vc::SmallMatrix<T, 5>::identity();
+    f(0, 2) = T(Dz);
+    f(0, 4) = T(0.5f * Bend * Dz * Dz);
+    f(1, 3) = T(Dz);
+    f(2, 4) = T(Bend * Dz);
+    return f;
+}
+
+// Fits one track per entry of T and returns the χ² of the fit.
+template <typename T> T fit(const T *measurements, std::size_t stride)
+{
+    const auto f = jacobian<T>();
+    Vc::Vec<T, 5> x = Vc::Vec<T, 5>::zero();
+    auto c = Vc::SymMatrix<T, 5>::identity() * T(100.f);
+    Vc::Vec<T, 5> hx = Vc::Vec<T, 5>::zero();
+    Vc::Vec<T, 5> hy = Vc::Vec<T, 5>::zero();
+    hx[0] = T(1);
+    hy[1] = T(1);
+    T chi2 = T(0);
+    for (std::size_t plane = 0; plane < NPlanes; ++plane) {
+        if (plane > 0) {
+            x = f * x;
+            Vc::similarityTransform(c, f);
+            c(2, 2) += T(1e-8f);  // multiple scattering
+            c(3, 3) += T(1e-8f);
+        }
+        chi2 += Vc::kalmanUpdate(x, c, plane % 2 ? hy : hx, measurements[plane * stride],
+                                 T(Sigma * Sigma));
+    }
+    return chi2;
+}
+
+template <typename F> double bestTime(F &&f)
+{
+    double best = 1e99;
+    for (int rep = 0; rep < 10; ++rep) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        const auto stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(stop - start).count());
+    }
+    return best;
+}
+
+int main()
+{
+    constexpr std::size_t NTracks = 100 * 1024;
+    static_assert(NTracks % float_v::Size == 0, "");
+
+    // simulate the tracks; the measurements of plane k are stored at [k * NTracks + track]
+    std::mt19937 rng;
+    std::normal_distribution<float> noise(0.f, Sigma);
+    std::uniform_real_distribution<float> uniform(-0.1f, 0.1f);
+    Vc::Memory<float_v> measurements(NPlanes * NTracks);
+    for (std::size_t t = 0; t < NTracks; ++t) {
+        Vc::Vec<float, 5> x(uniform(rng), uniform(rng), uniform(rng), uniform(rng),
+                            10 * uniform(rng));
+        const auto f = jacobian<float>();
+        for (std::size_t plane = 0; plane < NPlanes; ++plane) {
+            measurements[plane * NTracks + t] = x[plane % 2] + noise(rng);
+            x = f * x;
+        }
+    }
+
+    float chi2Scalar = 0.f;
+    const double t0 = bestTime([&] {
+        chi2Scalar = 0.f;
+        for (std::size_t t = 0; t < NTracks; ++t) {
+            chi2Scalar += fit(&measurements[t], NTracks);
+        }
+    });
+    float chi2Vector = 0.f;
+    const double t1 = bestTime([&] {
+        float_v sum = float_v::Zero();
+        for (std::size_t t = 0; t < NTracks; t += float_v::Size) {
+            sum += fit(reinterpret_cast<const float_v *>(&measurements[t]),
+                       NTracks / float_v::Size);
+        }
+        chi2Vector = sum.sum();
+    });
+
+    std::cout << "χ²/ndf: " << chi2Scalar / (NTracks * (NPlanes - 5)) << " (scalar), "
+              << chi2Vector / (NTracks * (NPlanes - 5)) << " (float_v)\n";
+    std::cout << std::setprecision(3) << "scalar:  " << NTracks / t0 * 1e-6
+              << " 10⁶ tracks/s\nfloat_v: " << NTracks / t1 * 1e-6 << " 10⁶ tracks/s ("
+              << t0 / t1 << "× speedup)\n";
+    return 0;
+}
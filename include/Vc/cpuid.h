@@ -67,6 +67,10 @@ class CpuId
          *
          * Will be executed automatically before main, but not necessarily before other functions
          * executing before main.
+         *
+         * The function may be called concurrently from several threads. Only the first call reads
+         * the CPU information; concurrent callers wait until it is complete. After that, a call
+         * only costs a single atomic load.
          */
         static void init();
 
@@ -80,6 +84,16 @@ class CpuId
         static inline uint processorModel() { return s_processorModel; }
         //! Return the number of logical processors.
         static inline uint logicalProcessors() { return s_logicalProcessors; }
+        //! Return the number of logical processors per physical core (i.e. the SMT siblings).
+        static inline uint threadsPerCore() { return s_threadsPerCore; }
+        //! Return the number of physical cores per processor package.
+        static inline uint coresPerPackage() { return s_coresPerPackage; }
+        //! Return the number of physical cores in the system.
+        static inline uint physicalCores() { return s_physicalCores; }
+        //! Return the number of processor packages (sockets) in the system.
+        static inline uint packages() { return s_packages; }
+        //! Return the number of NUMA nodes in the system.
+        static inline uint numaNodes() { return s_numaNodes; }
         //! Return whether the CPU vendor is AMD.
         static inline bool isAmd   () { return s_ecx0 == 0x444D4163; }
         //! Return whether the CPU vendor is Intel.
@@ -218,12 +232,26 @@ class CpuId
         static inline uint   L2Associativity() { return s_L2Associativity; }
         static inline uint   L3Associativity() { return s_L3Associativity; }
         static inline ushort prefetch() { return s_prefetch; }
+        //! Return the number of logical processors sharing the L1 data cache (0 if unknown).
+        static inline uint   L1DataSharedBy() { return s_L1DataSharedBy; }
+        //! Return the number of logical processors sharing the L2 cache (0 if unknown).
+        static inline uint   L2SharedBy() { return s_L2SharedBy; }
+        //! Return the number of logical processors sharing the L3 cache (0 if unknown).
+        static inline uint   L3SharedBy() { return s_L3SharedBy; }
 
     private:
+        static void initImpl();
+        static void initTopology();
+        static void setSharedBy(uint cacheType, uint cacheLevel, uint sharedBy);
         static void interpret(uchar byte, bool *checkLeaf4);
 
         static uint   s_ecx0;
         static uint   s_logicalProcessors;
+        static uint   s_threadsPerCore;
+        static uint   s_coresPerPackage;
+        static uint   s_physicalCores;
+        static uint   s_packages;
+        static uint   s_numaNodes;
         static uint   s_processorFeaturesC;
         static uint   s_processorFeaturesD;
         static uint   s_processorFeatures7B;
@@ -241,6 +269,9 @@ class CpuId
         static uint   s_L1Associativity;
         static uint   s_L2Associativity;
         static uint   s_L3Associativity;
+        static uint   s_L1DataSharedBy;
+        static uint   s_L2SharedBy;
+        static uint   s_L3SharedBy;
         static ushort s_prefetch;
         static uchar  s_brandIndex;
         static uchar  s_cacheLineSize;
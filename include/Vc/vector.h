@@ -253,6 +253,8 @@ constexpr std::size_t MemoryAlignment = alignof(MemoryAlignedBase);
 #include "common/algorithms.h"
 #include "common/where.h"
 #include "common/iif.h"
+#include "common/maskbits.h"
+#include "common/persistentlanes.h"
 
 #ifndef Vc_NO_STD_FUNCTIONS
 namespace std
@@ -33,4 +33,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "deinterleave.tcc"
 #include "prefetches.tcc"
 
+namespace Vc_VERSIONED_NAMESPACE
+{
+namespace Detail
+{
+// Streaming stores on MIC only pass a cache hint and stay strongly ordered. Thus no fence
+// is required.
+Vc_ALWAYS_INLINE void storeFence(VectorAbi::Mic) {}
+}  // namespace Detail
+}  // namespace Vc
+
 #endif // VC_MIC_HELPERIMPL_H_
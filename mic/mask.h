@@ -209,6 +209,13 @@ public:
      */
     int firstOne() const { return _mm_tzcnt_32(k); }
 
+    /**
+     * Returns the index of the last one in the mask.
+     *
+     * The return value is undefined if the mask is empty.
+     */
+    int lastOne() const { return _bit_scan_reverse(k); }
+
     int toInt() const { return k; }
 
     template <typename G> static Vc_INTRINSIC Mask generate(G &&gen)
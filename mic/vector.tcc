@@ -144,6 +144,59 @@ Vc_INTRINSIC void Vector<T, VectorAbi::Mic>::load(const U *x, Flags flags)
     d.v() = LoadHelper<Vector<T, VectorAbi::Mic>>::load(x, flags);
 }
 
+// masked load {{{1
+namespace MIC
+{
+// the masked (unaligned) loads do not access the memory of inactive entries
+template <typename Flags>
+Vc_INTRINSIC __m512 maskedLoad(__m512 v, __mmask16 k, const void *m,
+                               _MM_UPCONV_PS_ENUM upconv, std::size_t bytes, Flags)
+{
+    const int hint = Flags::IsStreaming ? _MM_HINT_NT : _MM_HINT_NONE;
+    if (Flags::IsAligned) {
+        return _mm512_mask_extload_ps(v, k, m, upconv, _MM_BROADCAST32_NONE, hint);
+    }
+    v = _mm512_mask_extloadunpacklo_ps(v, k, m, upconv, hint);
+    return _mm512_mask_extloadunpackhi_ps(v, k, static_cast<const char *>(m) + bytes,
+                                          upconv, hint);
+}
+template <typename Flags>
+Vc_INTRINSIC __m512d maskedLoad(__m512d v, __mmask8 k, const void *m,
+                                _MM_UPCONV_PD_ENUM upconv, std::size_t bytes, Flags)
+{
+    const int hint = Flags::IsStreaming ? _MM_HINT_NT : _MM_HINT_NONE;
+    if (Flags::IsAligned) {
+        return _mm512_mask_extload_pd(v, k, m, upconv, _MM_BROADCAST64_NONE, hint);
+    }
+    v = _mm512_mask_extloadunpacklo_pd(v, k, m, upconv, hint);
+    return _mm512_mask_extloadunpackhi_pd(v, k, static_cast<const char *>(m) + bytes,
+                                          upconv, hint);
+}
+template <typename Flags>
+Vc_INTRINSIC __m512i maskedLoad(__m512i v, __mmask16 k, const void *m,
+                                _MM_UPCONV_EPI32_ENUM upconv, std::size_t bytes, Flags)
+{
+    const int hint = Flags::IsStreaming ? _MM_HINT_NT : _MM_HINT_NONE;
+    if (Flags::IsAligned) {
+        return _mm512_mask_extload_epi32(v, k, m, upconv, _MM_BROADCAST32_NONE, hint);
+    }
+    v = _mm512_mask_extloadunpacklo_epi32(v, k, m, upconv, hint);
+    return _mm512_mask_extloadunpackhi_epi32(v, k, static_cast<const char *>(m) + bytes,
+                                             upconv, hint);
+}
+}  // namespace MIC
+
+template <typename T>
+template <typename Flags, typename>
+Vc_INTRINSIC void Vector<T, VectorAbi::Mic>::load(const EntryType *mem, MaskArgument mask,
+                                                  Flags flags)
+{
+    Common::handleLoadPrefetches(mem, flags);
+    d.v() = MIC::maskedLoad(d.v(), mask.data(), mem,
+                            MIC::UpDownConversion<VectorEntryType, EntryType>(),
+                            Size * sizeof(EntryType), flags);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 // zeroing {{{1
 template<typename T> Vc_INTRINSIC void Vector<T, VectorAbi::Mic>::setZero()
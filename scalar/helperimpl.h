@@ -48,6 +48,9 @@ Vc_ALWAYS_INLINE void prefetchForModify(const void *, VectorAbi::Scalar) {}
 Vc_ALWAYS_INLINE void prefetchClose(const void *, VectorAbi::Scalar) {}
 Vc_ALWAYS_INLINE void prefetchMid(const void *, VectorAbi::Scalar) {}
 Vc_ALWAYS_INLINE void prefetchFar(const void *, VectorAbi::Scalar) {}
+
+// Scalar stores are never weakly ordered, thus no fence is required
+Vc_ALWAYS_INLINE void storeFence(VectorAbi::Scalar) {}
 }  // namespace Detail
 }  // namespace Vc
 
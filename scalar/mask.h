@@ -134,6 +134,12 @@ public:
          * The return value is undefined if the mask is empty.
          */
         Vc_ALWAYS_INLINE int firstOne() const { return 0; }
+        /**
+         * Returns the index of the last one in the mask.
+         *
+         * The return value is undefined if the mask is empty.
+         */
+        Vc_ALWAYS_INLINE int lastOne() const { return 0; }
         Vc_ALWAYS_INLINE int toInt() const { return m ? 1 : 0; }
 
         template <typename G> static Vc_INTRINSIC Mask generate(G &&gen)
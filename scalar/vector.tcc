@@ -59,6 +59,16 @@ Vc_INTRINSIC void Vector<T, VectorAbi::Scalar>::load(const U *mem, Flags)
     m_data = mem[0];
 }
 
+template <typename T>
+template <typename Flags, typename>
+Vc_INTRINSIC void Vector<T, VectorAbi::Scalar>::load(const EntryType *mem, MaskArgument mask,
+                                                     Flags)
+{
+    if (mask.data()) {
+        m_data = mem[0];
+    }
+}
+
 // store member functions{{{1
 template <typename T>
 template <typename U, typename Flags, typename>
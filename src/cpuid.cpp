@@ -28,12 +28,29 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <Vc/cpuid.h>
 #include <Vc/global.h>
+#include <atomic>
+#include <thread>
+#ifdef __linux__
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#endif
 
 namespace Vc_VERSIONED_NAMESPACE
 {
 
 CpuId::uint   CpuId::s_ecx0 = 0;
 CpuId::uint   CpuId::s_logicalProcessors = 0;
+CpuId::uint   CpuId::s_threadsPerCore = 0;
+CpuId::uint   CpuId::s_coresPerPackage = 0;
+CpuId::uint   CpuId::s_physicalCores = 0;
+CpuId::uint   CpuId::s_packages = 0;
+CpuId::uint   CpuId::s_numaNodes = 0;
 CpuId::uint   CpuId::s_processorFeaturesC = 0;
 CpuId::uint   CpuId::s_processorFeaturesD = 0;
 CpuId::uint   CpuId::s_processorFeatures7B = 0;
@@ -51,6 +68,9 @@ CpuId::ushort CpuId::s_L3DataLineSize = 0;
 CpuId::uint   CpuId::s_L1Associativity = 0;
 CpuId::uint   CpuId::s_L2Associativity = 0;
 CpuId::uint   CpuId::s_L3Associativity = 0;
+CpuId::uint   CpuId::s_L1DataSharedBy = 0;
+CpuId::uint   CpuId::s_L2SharedBy = 0;
+CpuId::uint   CpuId::s_L3SharedBy = 0;
 CpuId::ushort CpuId::s_prefetch = 32; // The Intel ORM says that if Vc_CPUID(2) doesn't set the prefetch size it is 32
 CpuId::uchar  CpuId::s_brandIndex = 0;
 CpuId::uchar  CpuId::s_cacheLineSize = 0;
@@ -131,11 +151,26 @@ static unsigned int CpuIdAmdAssociativityTable(int bits)
 
 void CpuId::init()
 {
-    {
-        static bool done = false;
-        if (done) return;
-        done = true;
+    // 0: not initialized, 1: initialization in progress, 2: done
+    // The atomic is constant-initialized, thus it is usable before main.
+    static std::atomic<int> state{0};
+    if (Vc_IS_LIKELY(state.load(std::memory_order_acquire) == 2)) {
+        return;
+    }
+    int expected = 0;
+    if (state.compare_exchange_strong(expected, 1, std::memory_order_acq_rel)) {
+        initImpl();
+        initTopology();
+        state.store(2, std::memory_order_release);
+    } else {
+        while (state.load(std::memory_order_acquire) != 2) {
+            std::this_thread::yield();
+        }
     }
+}
+
+void CpuId::initImpl()
+{
     uint eax, ebx, ecx, edx;
 
     Vc_CPUID(0);
@@ -312,6 +347,191 @@ void CpuId::init()
     }
 }
 
+#ifdef __linux__
+// /sys/devices/system/cpu fallback {{{
+static bool readSysFile(const std::string &path, std::string &content)
+{
+    std::ifstream file(path);
+    return static_cast<bool>(std::getline(file, content));
+}
+
+// parses the cpulist format of sysfs, e.g. "0-3,8-11"
+static std::vector<unsigned int> parseCpuList(const std::string &list)
+{
+    std::vector<unsigned int> r;
+    std::istringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        unsigned int first = 0, last = 0;
+        const int n = std::sscanf(range.c_str(), "%u-%u", &first, &last);
+        if (n == 1) {
+            last = first;
+        } else if (n != 2) {
+            continue;
+        }
+        for (; first <= last; ++first) {
+            r.push_back(first);
+        }
+    }
+    return r;
+}
+
+static unsigned int readSysCpuListSize(const std::string &path)
+{
+    std::string content;
+    return readSysFile(path, content) ? parseCpuList(content).size() : 0;
+}
+
+static int readSysInt(const std::string &path)
+{
+    std::string content;
+    return readSysFile(path, content) ? std::atoi(content.c_str()) : -1;
+}
+// }}}
+#endif
+
+void CpuId::setSharedBy(uint cacheType, uint cacheLevel, uint sharedBy)
+{
+    if (cacheType != 1 && cacheType != 3) {  // only data and unified caches
+        return;
+    }
+    switch (cacheLevel) {
+    case 1: s_L1DataSharedBy = sharedBy; break;
+    case 2: s_L2SharedBy = sharedBy; break;
+    case 3: s_L3SharedBy = sharedBy; break;
+    }
+}
+
+/* Determines the topology of one package from
+ * - leaf 0xB (Intel x2APIC topology: SMT and core level),
+ * - leaf 4 (Intel deterministic cache parameters: cores per package and sharing of caches),
+ * - leaves 0x80000008, 0x8000001D, and 0x8000001E (AMD: threads per package, sharing of caches,
+ *   threads per core).
+ * Everything CPUID cannot tell (notably the number of packages and NUMA nodes) and everything
+ * the CPU does not report is read from /sys/devices/system on Linux. The remaining unknowns
+ * assume a single package and NUMA node.
+ */
+void CpuId::initTopology()
+{
+    uint eax, ebx, ecx, edx;
+    Vc_CPUID(0);
+    const uint maxLeaf = eax;
+    Vc_CPUID(0x80000000);
+    const uint maxExtLeaf = eax;
+
+    uint threadsPerPackage = hasHtt() && s_logicalProcessors > 0 ? s_logicalProcessors : 1;
+    uint coresPerPackage = 0;
+    uint threadsPerCore = 0;
+    const auto readCacheLeaf = [&](uint leaf) {
+        for (uint i = 0; i < 16; ++i) {
+            Vc_CPUID_C(leaf, i);
+            const uint cacheType = eax & 0x1f;
+            if (cacheType == 0) {
+                break;
+            }
+            setSharedBy(cacheType, (eax >> 5) & 7, 1 + ((eax >> 14) & 0xfff));
+            if (i == 0 && leaf == 4) {
+                coresPerPackage = 1 + ((eax >> 26) & 0x3f);
+            }
+        }
+    };
+
+    if (isAmd()) {
+        if (maxExtLeaf >= 0x80000008) {
+            Vc_CPUID(0x80000008);
+            threadsPerPackage = 1 + (ecx & 0xff);
+        }
+        const bool hasTopologyExtensions = (s_processorFeatures8C & (1 << 22)) != 0;
+        if (hasTopologyExtensions && maxExtLeaf >= 0x8000001D) {
+            readCacheLeaf(0x8000001D);
+        }
+        // before family 17h this leaf reports the cores per compute unit, not SMT siblings
+        if (hasTopologyExtensions && maxExtLeaf >= 0x8000001E && s_processorFamily >= 0x17) {
+            Vc_CPUID(0x8000001E);
+            threadsPerCore = 1 + ((ebx >> 8) & 0xff);
+        }
+    } else {
+        if (maxLeaf >= 4) {
+            readCacheLeaf(4);
+        }
+        if (maxLeaf >= 0xb) {
+            for (uint level = 0; level < 8; ++level) {
+                Vc_CPUID_C(0xb, level);
+                const uint levelType = (ecx >> 8) & 0xff;
+                const uint count = ebx & 0xffff;
+                if (levelType == 0 || count == 0) {
+                    break;
+                } else if (levelType == 1) {  // SMT
+                    threadsPerCore = count;
+                } else if (levelType == 2) {  // Core
+                    threadsPerPackage = count;
+                }
+            }
+        }
+        if (threadsPerCore == 0 && coresPerPackage > 0 && threadsPerPackage >= coresPerPackage) {
+            threadsPerCore = threadsPerPackage / coresPerPackage;
+        }
+    }
+
+    uint packages = 0;
+    uint physicalCores = 0;
+    uint numaNodes = 0;
+#ifdef __linux__
+    {
+        const std::string cpuDir = "/sys/devices/system/cpu/";
+        std::string online;
+        if (readSysFile(cpuDir + "online", online)) {
+            std::set<int> packageIds;
+            std::set<std::pair<int, int>> coreIds;
+            for (unsigned int cpu : parseCpuList(online)) {
+                const std::string topology = cpuDir + "cpu" + std::to_string(cpu) + "/topology/";
+                const int package = readSysInt(topology + "physical_package_id");
+                const int core = readSysInt(topology + "core_id");
+                if (package >= 0 && core >= 0) {
+                    packageIds.insert(package);
+                    coreIds.insert({package, core});
+                }
+            }
+            packages = packageIds.size();
+            physicalCores = coreIds.size();
+        }
+        if (threadsPerCore == 0) {
+            threadsPerCore = readSysCpuListSize(cpuDir + "cpu0/topology/thread_siblings_list");
+        }
+        for (uint index = 0; index < 16; ++index) {
+            const std::string cache = cpuDir + "cpu0/cache/index" + std::to_string(index) + "/";
+            const int level = readSysInt(cache + "level");
+            std::string type;
+            if (level < 0 || !readSysFile(cache + "type", type)) {
+                break;
+            }
+            const uint cacheType = type == "Data" ? 1 : type == "Unified" ? 3 : 2;
+            if ((level == 1 && s_L1DataSharedBy == 0) || (level == 2 && s_L2SharedBy == 0) ||
+                (level == 3 && s_L3SharedBy == 0)) {
+                setSharedBy(cacheType, level, readSysCpuListSize(cache + "shared_cpu_list"));
+            }
+        }
+        numaNodes = readSysCpuListSize("/sys/devices/system/node/online");
+    }
+#endif
+
+    s_threadsPerCore = threadsPerCore > 0 ? threadsPerCore : 1;
+    s_coresPerPackage = threadsPerPackage > s_threadsPerCore ? threadsPerPackage / s_threadsPerCore : 1;
+    s_packages = packages > 0 ? packages : 1;
+    s_physicalCores = physicalCores > 0 ? physicalCores : s_coresPerPackage * s_packages;
+    s_numaNodes = numaNodes > 0 ? numaNodes : 1;
+
+    // leaf 4 reports the number of addressable IDs, which is rounded up to a power of two
+    const auto clamp = [threadsPerPackage](uint &sharedBy) {
+        if (sharedBy > threadsPerPackage) {
+            sharedBy = threadsPerPackage;
+        }
+    };
+    clamp(s_L1DataSharedBy);
+    clamp(s_L2SharedBy);
+    clamp(s_L3SharedBy);
+}
+
 void CpuId::interpret(uchar byte, bool *checkLeaf4)
 {
     switch (byte) {
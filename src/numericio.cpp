@@ -0,0 +1,330 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include <Vc/global.h>
+#include "common/macros.h"
+#include <cstdint>
+#include <cstring>
+
+namespace Vc_VERSIONED_NAMESPACE
+{
+namespace Detail
+{
+namespace
+{
+// The shortest decimal representation of a float is computed with the Ryū algorithm
+// (Ulf Adams, "Ryū: fast float-to-string conversion", PLDI 2018). The tables hold the
+// 61 most significant bits of 5^i and of 2^k / 5^q, rounded up.
+constexpr int FloatPow5InvBitCount = 59;
+constexpr int FloatPow5BitCount = 61;
+
+const std::uint64_t FloatPow5InvSplit[31] = {
+    576460752303423489ull, 461168601842738791ull, 368934881474191033ull,
+    295147905179352826ull, 472236648286964522ull, 377789318629571618ull,
+    302231454903657294ull, 483570327845851670ull, 386856262276681336ull,
+    309485009821345069ull, 495176015714152110ull, 396140812571321688ull,
+    316912650057057351ull, 507060240091291761ull, 405648192073033409ull,
+    324518553658426727ull, 519229685853482763ull, 415383748682786211ull,
+    332306998946228969ull, 531691198313966350ull, 425352958651173080ull,
+    340282366920938464ull, 544451787073501542ull, 435561429658801234ull,
+    348449143727040987ull, 557518629963265579ull, 446014903970612463ull,
+    356811923176489971ull, 570899077082383953ull, 456719261665907162ull,
+    365375409332725730ull,
+};
+
+const std::uint64_t FloatPow5Split[47] = {
+    1152921504606846976ull, 1441151880758558720ull, 1801439850948198400ull,
+    2251799813685248000ull, 1407374883553280000ull, 1759218604441600000ull,
+    2199023255552000000ull, 1374389534720000000ull, 1717986918400000000ull,
+    2147483648000000000ull, 1342177280000000000ull, 1677721600000000000ull,
+    2097152000000000000ull, 1310720000000000000ull, 1638400000000000000ull,
+    2048000000000000000ull, 1280000000000000000ull, 1600000000000000000ull,
+    2000000000000000000ull, 1250000000000000000ull, 1562500000000000000ull,
+    1953125000000000000ull, 1220703125000000000ull, 1525878906250000000ull,
+    1907348632812500000ull, 1192092895507812500ull, 1490116119384765625ull,
+    1862645149230957031ull, 1164153218269348144ull, 1455191522836685180ull,
+    1818989403545856475ull, 2273736754432320594ull, 1421085471520200371ull,
+    1776356839400250464ull, 2220446049250313080ull, 1387778780781445675ull,
+    1734723475976807094ull, 2168404344971008868ull, 1355252715606880542ull,
+    1694065894508600678ull, 2117582368135750847ull, 1323488980084844279ull,
+    1654361225106055349ull, 2067951531382569187ull, 1292469707114105741ull,
+    1615587133892632177ull, 2019483917365790221ull,
+};
+
+// ceil(log2(5^e)) for e > 0, and 1 for e = 0
+inline int pow5bits(int e) { return int((std::uint32_t(e) * 1217359u) >> 19) + 1; }
+// floor(log10(2^e))
+inline int log10Pow2(int e) { return int((std::uint32_t(e) * 78913u) >> 18); }
+// floor(log10(5^e))
+inline int log10Pow5(int e) { return int((std::uint32_t(e) * 732923u) >> 20); }
+
+inline bool multipleOfPowerOf5(std::uint32_t value, int p)
+{
+    int count = 0;
+    for (; value % 5 == 0; value /= 5) {
+        ++count;
+    }
+    return count >= p;
+}
+
+inline bool multipleOfPowerOf2(std::uint32_t value, int p)
+{
+    return (value & ((1u << p) - 1)) == 0;
+}
+
+inline std::uint32_t mulShift(std::uint32_t m, std::uint64_t factor, int shift)
+{
+    const std::uint64_t bits0 = std::uint64_t(m) * std::uint32_t(factor);
+    const std::uint64_t bits1 = std::uint64_t(m) * std::uint32_t(factor >> 32);
+    return std::uint32_t(((bits0 >> 32) + bits1) >> (shift - 32));
+}
+
+struct Decimal
+{
+    std::uint32_t digits;
+    int exponent;  // value = digits * 10^exponent
+};
+
+// Returns the shortest decimal that rounds to the positive finite float with the given
+// IEEE mantissa and exponent fields. Ties are resolved to the decimal closest to the
+// float, exactly like std::to_chars.
+Decimal shortestDecimal(std::uint32_t ieeeMantissa, std::uint32_t ieeeExponent)
+{
+    int e2;
+    std::uint32_t m2;
+    if (ieeeExponent == 0) {
+        e2 = 1 - 127 - 23 - 2;
+        m2 = ieeeMantissa;
+    } else {
+        e2 = int(ieeeExponent) - 127 - 23 - 2;
+        m2 = (1u << 23) | ieeeMantissa;
+    }
+    const bool acceptBounds = (m2 & 1) == 0;
+
+    // the interval of decimals that round to the float, scaled by 4
+    const std::uint32_t mv = 4 * m2;
+    const std::uint32_t mp = 4 * m2 + 2;
+    const std::uint32_t mmShift = ieeeMantissa != 0 || ieeeExponent <= 1;
+    const std::uint32_t mm = 4 * m2 - 1 - mmShift;
+
+    std::uint32_t vr, vp, vm;
+    int e10;
+    bool vmIsTrailingZeros = false;
+    bool vrIsTrailingZeros = false;
+    std::uint32_t lastRemovedDigit = 0;
+    if (e2 >= 0) {
+        const int q = log10Pow2(e2);
+        e10 = q;
+        const int k = FloatPow5InvBitCount + pow5bits(q) - 1;
+        const int i = -e2 + q + k;
+        vr = mulShift(mv, FloatPow5InvSplit[q], i);
+        vp = mulShift(mp, FloatPow5InvSplit[q], i);
+        vm = mulShift(mm, FloatPow5InvSplit[q], i);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            // the last removed digit is needed for rounding if the loop below removes
+            // less than q digits
+            const int l = FloatPow5InvBitCount + pow5bits(q - 1) - 1;
+            lastRemovedDigit = mulShift(mv, FloatPow5InvSplit[q - 1], -e2 + q - 1 + l) % 10;
+        }
+        if (q <= 9) {
+            // only one of mp, mv, and mm can be a multiple of 5, if any
+            if (mv % 5 == 0) {
+                vrIsTrailingZeros = multipleOfPowerOf5(mv, q);
+            } else if (acceptBounds) {
+                vmIsTrailingZeros = multipleOfPowerOf5(mm, q);
+            } else {
+                vp -= multipleOfPowerOf5(mp, q);
+            }
+        }
+    } else {
+        const int q = log10Pow5(-e2);
+        e10 = q + e2;
+        const int i = -e2 - q;
+        const int k = pow5bits(i) - FloatPow5BitCount;
+        int j = q - k;
+        vr = mulShift(mv, FloatPow5Split[i], j);
+        vp = mulShift(mp, FloatPow5Split[i], j);
+        vm = mulShift(mm, FloatPow5Split[i], j);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            j = q - 1 - (pow5bits(i + 1) - FloatPow5BitCount);
+            lastRemovedDigit = mulShift(mv, FloatPow5Split[i + 1], j) % 10;
+        }
+        if (q <= 1) {
+            // mv has at least q trailing zero bits; mp = mv + 2 has exactly one
+            vrIsTrailingZeros = true;
+            if (acceptBounds) {
+                vmIsTrailingZeros = mmShift == 1;
+            } else {
+                --vp;
+            }
+        } else if (q < 31) {
+            vrIsTrailingZeros = multipleOfPowerOf2(mv, q - 1);
+        }
+    }
+
+    // remove the digits that are not needed to identify the float
+    int removed = 0;
+    std::uint32_t output;
+    if (vmIsTrailingZeros || vrIsTrailingZeros) {
+        while (vp / 10 > vm / 10) {
+            vmIsTrailingZeros &= vm % 10 == 0;
+            vrIsTrailingZeros &= lastRemovedDigit == 0;
+            lastRemovedDigit = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        if (vmIsTrailingZeros) {
+            while (vm % 10 == 0) {
+                vrIsTrailingZeros &= lastRemovedDigit == 0;
+                lastRemovedDigit = vr % 10;
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                ++removed;
+            }
+        }
+        if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0) {
+            // round even if the exact value is .5
+            lastRemovedDigit = 4;
+        }
+        output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) ||
+                       lastRemovedDigit >= 5);
+    } else {
+        while (vp / 10 > vm / 10) {
+            lastRemovedDigit = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        output = vr + (vr == vm || lastRemovedDigit >= 5);
+    }
+    return {output, e10 + removed};
+}
+
+const char DigitPairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+inline int decimalLength(std::uint32_t v)
+{
+    int n = 1;
+    for (; v >= 10; v /= 10) {
+        ++n;
+    }
+    return n;
+}
+
+// writes the n digits of v to out
+inline void writeDigits(char *out, std::uint32_t v, int n)
+{
+    for (; n >= 2; n -= 2) {
+        std::memcpy(out + n - 2, &DigitPairs[2 * (v % 100)], 2);
+        v /= 100;
+    }
+    if (n == 1) {
+        out[0] = char('0' + v);
+    }
+}
+}  // unnamed namespace
+
+std::size_t format_float(float x, char *out)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &x, 4);
+    const std::uint32_t ieeeMantissa = bits & ((1u << 23) - 1);
+    const std::uint32_t ieeeExponent = (bits >> 23) & 0xff;
+    char *p = out;
+    if (bits >> 31) {
+        *p++ = '-';
+    }
+    if (ieeeExponent == 0xff) {
+        std::memcpy(p, ieeeMantissa ? "nan" : "inf", 3);
+        return p + 3 - out;
+    }
+    if (ieeeExponent == 0 && ieeeMantissa == 0) {
+        *p = '0';
+        return p + 1 - out;
+    }
+
+    const Decimal d = shortestDecimal(ieeeMantissa, ieeeExponent);
+    const int length = decimalLength(d.digits);
+    const int sciExponent = d.exponent + length - 1;
+    const int sciLength = length + (length > 1) + 4;  // |sciExponent| < 100 for float
+    const int fixedLength = d.exponent >= 0 ? length + d.exponent
+                            : -d.exponent < length ? length + 1
+                                                   : 2 - d.exponent;
+    if (fixedLength <= sciLength) {
+        if (d.exponent >= 0) {
+            // an integer: print the exact value instead of padding the digits with zeros
+            std::uint64_t v = static_cast<std::uint64_t>(x < 0 ? -x : x);
+            char tmp[20];
+            int n = 0;
+            for (; v != 0; v /= 10) {
+                tmp[n++] = char('0' + v % 10);
+            }
+            while (n > 0) {
+                *p++ = tmp[--n];
+            }
+        } else if (-d.exponent < length) {
+            const int integerDigits = length + d.exponent;
+            writeDigits(p + 1, d.digits, length);
+            std::memmove(p, p + 1, integerDigits);
+            p[integerDigits] = '.';
+            p += length + 1;
+        } else {
+            p[0] = '0';
+            p[1] = '.';
+            std::memset(p + 2, '0', -d.exponent - length);
+            p += 2 - d.exponent;
+            writeDigits(p - length, d.digits, length);
+        }
+    } else {
+        writeDigits(p + 1, d.digits, length);
+        p[0] = p[1];
+        if (length > 1) {
+            p[1] = '.';
+            p += length + 1;
+        } else {
+            p += 1;
+        }
+        *p++ = 'e';
+        *p++ = sciExponent < 0 ? '-' : '+';
+        const int absExponent = sciExponent < 0 ? -sciExponent : sciExponent;
+        std::memcpy(p, &DigitPairs[2 * absExponent], 2);
+        p += 2;
+    }
+    return p - out;
+}
+}  // namespace Detail
+}  // namespace Vc
+
+// vim: foldmethod=marker
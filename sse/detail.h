@@ -457,6 +457,71 @@ Vc_INTRINSIC __m128i mul(__m128i a, __m128i b,  uchar) {
 #endif
 }
 
+// mulhi{{{1
+// the high half of the full product
+Vc_INTRINSIC __m128i mulhi(__m128i a, __m128i b,  short) { return _mm_mulhi_epi16(a, b); }
+Vc_INTRINSIC __m128i mulhi(__m128i a, __m128i b, ushort) { return _mm_mulhi_epu16(a, b); }
+Vc_INTRINSIC __m128i mulhi(__m128i a, __m128i b,   uint) {
+    const __m128i ab02 = _mm_mul_epu32(a, b);  // [a0 * b0, a2 * b2]
+    const __m128i ab13 = _mm_mul_epu32(_mm_shuffle_epi32(a, 0xf5), _mm_shuffle_epi32(b, 0xf5));
+#ifdef Vc_IMPL_SSE4_1
+    return _mm_blend_epi16(_mm_shuffle_epi32(ab02, 0xf5), ab13, 0xcc);
+#else
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(ab02, 0x0d), _mm_shuffle_epi32(ab13, 0x0d));
+#endif
+}
+Vc_INTRINSIC __m128i mulhi(__m128i a, __m128i b,    int) {
+#ifdef Vc_IMPL_SSE4_1
+    const __m128i ab02 = _mm_mul_epi32(a, b);  // [a0 * b0, a2 * b2]
+    const __m128i ab13 = _mm_mul_epi32(_mm_shuffle_epi32(a, 0xf5), _mm_shuffle_epi32(b, 0xf5));
+    return _mm_blend_epi16(_mm_shuffle_epi32(ab02, 0xf5), ab13, 0xcc);
+#else
+    // the unsigned product overcounts by b for negative a and by a for negative b
+    const __m128i hi = mulhi(a, b, uint());
+    return _mm_sub_epi32(_mm_sub_epi32(hi, _mm_and_si128(_mm_srai_epi32(a, 31), b)),
+                         _mm_and_si128(_mm_srai_epi32(b, 31), a));
+#endif
+}
+
+// adds / subs / avg{{{1
+Vc_INTRINSIC __m128i adds(__m128i a, __m128i b,  short) { return _mm_adds_epi16(a, b); }
+Vc_INTRINSIC __m128i adds(__m128i a, __m128i b, ushort) { return _mm_adds_epu16(a, b); }
+Vc_INTRINSIC __m128i subs(__m128i a, __m128i b,  short) { return _mm_subs_epi16(a, b); }
+Vc_INTRINSIC __m128i subs(__m128i a, __m128i b, ushort) { return _mm_subs_epu16(a, b); }
+Vc_INTRINSIC __m128i avg(__m128i a, __m128i b, ushort) { return _mm_avg_epu16(a, b); }
+Vc_INTRINSIC __m128i avg(__m128i a, __m128i b,  short) {
+    // flipping the sign bits maps short to ushort preserving the order
+    const __m128i bias = _mm_set1_epi16(-0x8000);
+    return _mm_xor_si128(_mm_avg_epu16(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias)), bias);
+}
+
+// mulhrs{{{1
+// (a * b + 0x4000) >> 15, the rounded Q15 product
+Vc_INTRINSIC __m128i mulhrs(__m128i a, __m128i b, short) {
+#ifdef Vc_IMPL_SSSE3
+    return _mm_mulhrs_epi16(a, b);
+#else
+    // 2 * hi + ((lo >> 14) + 1) >> 1 (logical shift of lo)
+    const __m128i hi = _mm_mulhi_epi16(a, b);
+    const __m128i lo = _mm_mullo_epi16(a, b);
+    const __m128i round = _mm_srli_epi16(_mm_add_epi16(_mm_srli_epi16(lo, 14), _mm_set1_epi16(1)), 1);
+    return _mm_add_epi16(_mm_add_epi16(hi, hi), round);
+#endif
+}
+
+// madd / mul_widen{{{1
+// a0 * b0 + a1 * b1, a2 * b2 + a3 * b3, ... as 32-bit integers
+Vc_INTRINSIC __m128i madd(__m128i a, __m128i b, short) { return _mm_madd_epi16(a, b); }
+
+// the full products of the low and high four entries
+template <typename T> Vc_INTRINSIC void mul_widen(__m128i a, __m128i b, __m128i &r0, __m128i &r1, T)
+{
+    const __m128i lo = _mm_mullo_epi16(a, b);
+    const __m128i hi = mulhi(a, b, T());
+    r0 = _mm_unpacklo_epi16(lo, hi);
+    r1 = _mm_unpackhi_epi16(lo, hi);
+}
+
 // TODO: fma{{{1
 //Vc_INTRINSIC __m128  fma(__m128  a, __m128  b, __m128  c,  float) { return _mm_mul_ps(a, b); }
 //Vc_INTRINSIC __m128d fma(__m128d a, __m128d b, __m128d c, double) { return _mm_mul_pd(a, b); }
@@ -859,6 +924,37 @@ template<typename V> struct InterleaveImpl<V, 8, 16> {
         v1.data() = _mm_unpackhi_epi16(tmp0, tmp1);
         v2.data() = _mm_unpacklo_epi16(tmp6, tmp7);
     }/*}}}*/
+    static inline void deinterleave(typename V::EntryType const *const data,/*{{{*/
+            const Common::SuccessiveEntries<3> &i, V &v0, V &v1, V &v2)
+    {
+        const __m128i m0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&data[i[0]]));               // a0 b0 c0 a1 b1 c1 a2 b2
+        const __m128i m1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&data[i[0] + V::Size]));     // c2 a3 b3 c3 a4 b4 c4 a5
+        const __m128i m2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&data[i[0] + 2 * V::Size])); // b5 c5 a6 b6 c6 a7 b7 c7
+
+        // move every struct to the low 48 bits of its own register
+        const __m128i a = m0;
+        const __m128i b = _mm_srli_si128(m0, 6);
+        const __m128i c = _mm_or_si128(_mm_srli_si128(m0, 12), _mm_slli_si128(m1, 4));
+        const __m128i d = _mm_srli_si128(m1, 2);
+        const __m128i e = _mm_srli_si128(m1, 8);
+        const __m128i f = _mm_or_si128(_mm_srli_si128(m1, 14), _mm_slli_si128(m2, 2));
+        const __m128i g = _mm_srli_si128(m2, 4);
+        const __m128i h = _mm_srli_si128(m2, 10);
+
+        const __m128i tmp2  = _mm_unpacklo_epi16(a, e); // a0 a4 b0 b4 c0 c4 XX XX
+        const __m128i tmp4  = _mm_unpacklo_epi16(b, f); // a1 a5 b1 b5 c1 c5 XX XX
+        const __m128i tmp3  = _mm_unpacklo_epi16(c, g); // a2 a6 b2 b6 c2 c6 XX XX
+        const __m128i tmp5  = _mm_unpacklo_epi16(d, h); // a3 a7 b3 b7 c3 c7 XX XX
+
+        const __m128i tmp0  = _mm_unpacklo_epi16(tmp2, tmp3); // a0 a2 a4 a6 b0 b2 b4 b6
+        const __m128i tmp1  = _mm_unpacklo_epi16(tmp4, tmp5); // a1 a3 a5 a7 b1 b3 b5 b7
+        const __m128i tmp6  = _mm_unpackhi_epi16(tmp2, tmp3); // c0 c2 c4 c6 XX XX XX XX
+        const __m128i tmp7  = _mm_unpackhi_epi16(tmp4, tmp5); // c1 c3 c5 c7 XX XX XX XX
+
+        v0.data() = _mm_unpacklo_epi16(tmp0, tmp1);
+        v1.data() = _mm_unpackhi_epi16(tmp0, tmp1);
+        v2.data() = _mm_unpacklo_epi16(tmp6, tmp7);
+    }/*}}}*/
     template<typename I> static inline void deinterleave(typename V::EntryType const *const data,/*{{{*/
             const I &i, V &v0, V &v1, V &v2, V &v3)
     {
@@ -1119,6 +1215,20 @@ template<typename V> struct InterleaveImpl<V, 4, 16> {
         v1.data() = SSE::sse_cast<typename V::VectorType>(_mm_movehl_ps(tmp1, tmp0));
         v2.data() = SSE::sse_cast<typename V::VectorType>(_mm_movelh_ps(tmp2, tmp3));
     }/*}}}*/
+    static inline void deinterleave(typename V::EntryType const *const data,/*{{{*/
+            const Common::SuccessiveEntries<3> &i, V &v0, V &v1, V &v2)
+    {
+        const __m128 a = _mm_loadu_ps(reinterpret_cast<const MayAlias<float> *>(&data[i[0]]));               // a0 b0 c0 a1
+        const __m128 b = _mm_loadu_ps(reinterpret_cast<const MayAlias<float> *>(&data[i[0] + V::Size]));     // b1 c1 a2 b2
+        const __m128 c = _mm_loadu_ps(reinterpret_cast<const MayAlias<float> *>(&data[i[0] + 2 * V::Size])); // c2 a3 b3 c3
+
+        const __m128 tmp0 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2)); // [a2 b2 a3 b3]
+        const __m128 tmp1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1)); // [b0 c0 b1 c1]
+
+        v0.data() = SSE::sse_cast<typename V::VectorType>(_mm_shuffle_ps(a, tmp0, _MM_SHUFFLE(2, 0, 3, 0)));
+        v1.data() = SSE::sse_cast<typename V::VectorType>(_mm_shuffle_ps(tmp1, tmp0, _MM_SHUFFLE(3, 1, 2, 0)));
+        v2.data() = SSE::sse_cast<typename V::VectorType>(_mm_shuffle_ps(tmp1, c, _MM_SHUFFLE(3, 0, 3, 1)));
+    }/*}}}*/
     template<typename I> static inline void deinterleave(typename V::EntryType const *const data,/*{{{*/
             const I &i, V &v0, V &v1, V &v2, V &v3)
     {
@@ -1199,6 +1309,17 @@ template<typename V> struct InterleaveImpl<V, 2, 16> {
         v2.gather(data + 2, i);
         deinterleave(data, i, v0, v1);
     }/*}}}*/
+    static inline void deinterleave(typename V::EntryType const *const data,/*{{{*/
+            const Common::SuccessiveEntries<3> &i, V &v0, V &v1, V &v2)
+    {
+        const __m128d a = _mm_loadu_pd(&data[i[0]]);     // a0 b0
+        const __m128d b = _mm_loadu_pd(&data[i[0] + 2]); // c0 a1
+        const __m128d c = _mm_loadu_pd(&data[i[0] + 4]); // b1 c1
+
+        v0.data() = _mm_shuffle_pd(a, b, 2);
+        v1.data() = _mm_shuffle_pd(a, c, 1);
+        v2.data() = _mm_shuffle_pd(b, c, 2);
+    }/*}}}*/
     template<typename I> static inline void deinterleave(typename V::EntryType const *const data,/*{{{*/
             const I &i, V &v0, V &v1, V &v2, V &v3)
     {
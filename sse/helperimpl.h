@@ -61,6 +61,11 @@ Vc_ALWAYS_INLINE_L void prefetchForModify(const void *addr, VectorAbi::Sse) Vc_A
 Vc_ALWAYS_INLINE_L void prefetchClose(const void *addr, VectorAbi::Sse) Vc_ALWAYS_INLINE_R;
 Vc_ALWAYS_INLINE_L void prefetchMid(const void *addr, VectorAbi::Sse) Vc_ALWAYS_INLINE_R;
 Vc_ALWAYS_INLINE_L void prefetchFar(const void *addr, VectorAbi::Sse) Vc_ALWAYS_INLINE_R;
+
+/**\internal
+ * Orders all preceding (streaming) stores before any subsequent store.
+ */
+Vc_ALWAYS_INLINE void storeFence(VectorAbi::Sse) { _mm_sfence(); }
 }  // namespace Detail
 }  // namespace Vc
 
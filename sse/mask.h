@@ -225,6 +225,13 @@ public:
          */
         Vc_ALWAYS_INLINE_L Vc_PURE_L int firstOne() const Vc_ALWAYS_INLINE_R Vc_PURE_R;
 
+        /**
+         * Returns the index of the last one in the mask.
+         *
+         * The return value is undefined if the mask is empty.
+         */
+        Vc_ALWAYS_INLINE_L Vc_PURE_L int lastOne() const Vc_ALWAYS_INLINE_R Vc_PURE_R;
+
         template <typename G> static Vc_INTRINSIC_L Mask generate(G &&gen) Vc_INTRINSIC_R;
         Vc_INTRINSIC_L Vc_PURE_L Mask shifted(int amount) const Vc_INTRINSIC_R Vc_PURE_R;
 
@@ -202,6 +202,18 @@ template<typename T> Vc_ALWAYS_INLINE Vc_PURE int Mask<T, VectorAbi::Sse>::first
 #endif
     return bit;
 }
+template<typename T> Vc_ALWAYS_INLINE Vc_PURE int Mask<T, VectorAbi::Sse>::lastOne() const
+{
+    const int mask = toInt();
+#ifdef _MSC_VER
+    unsigned long bit;
+    _BitScanReverse(&bit, mask);
+#else
+    int bit;
+    __asm__("bsr %1,%0" : "=&r"(bit) : "r"(mask));
+#endif
+    return bit;
+}
 /*operators{{{*/
 /*}}}*/
 
@@ -881,6 +881,31 @@ Vc_INTRINSIC Vc_CONST Return
     return static_cast<typename Return::EntryType>(x[offset]);
 }
 
+// 1 SSE::Vector to 2 SSE::Vector (SimdArray halves) {{{1
+// These overload the generic simd_cast_halves in common/simdarray.h. The high half is
+// unpacked directly instead of shifting it down first.
+#define Vc_SIMD_CAST_HALVES_(from_, to_, shift_)                                         \
+    Vc_INTRINSIC void simd_cast_halves(SSE::from_ x, SSE::to_ &r0, SSE::to_ &r1)          \
+    {                                                                                    \
+        r0 = shift_(_mm_unpacklo_epi16(x.data(), x.data()), 16);                         \
+        r1 = shift_(_mm_unpackhi_epi16(x.data(), x.data()), 16);                         \
+    }
+Vc_SIMD_CAST_HALVES_( short_v,  int_v, _mm_srai_epi32)
+Vc_SIMD_CAST_HALVES_( short_v, uint_v, _mm_srai_epi32)
+Vc_SIMD_CAST_HALVES_(ushort_v,  int_v, _mm_srli_epi32)
+Vc_SIMD_CAST_HALVES_(ushort_v, uint_v, _mm_srli_epi32)
+#undef Vc_SIMD_CAST_HALVES_
+Vc_INTRINSIC void simd_cast_halves(SSE::short_v x, SSE::float_v &r0, SSE::float_v &r1)
+{
+    r0 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x.data(), x.data()), 16));
+    r1 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x.data(), x.data()), 16));
+}
+Vc_INTRINSIC void simd_cast_halves(SSE::ushort_v x, SSE::float_v &r0, SSE::float_v &r1)
+{
+    r0 = _mm_cvtepi32_ps(_mm_srli_epi32(_mm_unpacklo_epi16(x.data(), x.data()), 16));
+    r1 = _mm_cvtepi32_ps(_mm_srli_epi32(_mm_unpackhi_epi16(x.data(), x.data()), 16));
+}
+
 // Mask casts with offset {{{1
 // SSE to SSE (Mask)
 template <typename Return, int offset, typename V>
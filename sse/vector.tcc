@@ -27,6 +27,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 }}}*/
 
 #include "../common/x86_prefetches.h"
+#include "../common/maskedload.h"
 #include "limits.h"
 #include "../common/bitscanintrinsics.h"
 #include "../common/set.h"
@@ -74,6 +75,52 @@ Vc_INTRINSIC void Vector<DstT, VectorAbi::Sse>::load(const SrcT *mem, Flags flag
     d.v() = Detail::load<VectorType, DstT>(mem, flags);
 }
 
+// masked load {{{1
+namespace Detail
+{
+#ifdef Vc_IMPL_AVX
+// vmaskmov suppresses faults for inactive entries
+Vc_INTRINSIC __m128 maskload(const float *mem, __m128i k) { return _mm_maskload_ps(mem, k); }
+Vc_INTRINSIC __m128d maskload(const double *mem, __m128i k) { return _mm_maskload_pd(mem, k); }
+Vc_INTRINSIC __m128i maskload(const int *mem, __m128i k)
+{
+    return _mm_castps_si128(_mm_maskload_ps(reinterpret_cast<const float *>(mem), k));
+}
+Vc_INTRINSIC __m128i maskload(const uint *mem, __m128i k)
+{
+    return _mm_castps_si128(_mm_maskload_ps(reinterpret_cast<const float *>(mem), k));
+}
+
+template <typename T, typename Flags>
+Vc_INTRINSIC enable_if<(sizeof(T) >= 4), void> maskedLoad(SSE::Vector<T> &v, const T *mem,
+                                                         const SSE::Mask<T> &k, Flags)
+{
+    v.assign(SSE::Vector<T>(maskload(mem, SSE::sse_cast<__m128i>(k.data()))), k);
+}
+template <typename T, typename Flags>
+Vc_INTRINSIC enable_if<(sizeof(T) < 4), void> maskedLoad(SSE::Vector<T> &v, const T *mem,
+                                                        const SSE::Mask<T> &k, Flags f)
+{
+    Common::maskedLoad(v, mem, k, f);
+}
+#else
+template <typename T, typename Flags>
+Vc_INTRINSIC void maskedLoad(SSE::Vector<T> &v, const T *mem, const SSE::Mask<T> &k, Flags f)
+{
+    Common::maskedLoad(v, mem, k, f);
+}
+#endif
+}  // namespace Detail
+
+template <typename T>
+template <typename Flags, typename>
+Vc_INTRINSIC void Vector<T, VectorAbi::Sse>::load(const EntryType *mem, MaskArgument mask,
+                                                  Flags flags)
+{
+    Common::handleLoadPrefetches(mem, flags);
+    Detail::maskedLoad(*this, mem, mask, flags);
+}
+
 // zeroing {{{1
 template<typename T> Vc_INTRINSIC void Vector<T, VectorAbi::Sse>::setZero()
 {
@@ -0,0 +1,180 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include "unittest.h"
+#include <Vc/ByteScan>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#ifdef __unix__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Returns a buffer with padding on both sides, so that the tests can place the range at
+// every alignment.
+static std::vector<char> randomText(std::size_t n, unsigned seed)
+{
+    std::default_random_engine engine(seed);
+    std::uniform_int_distribution<int> dist('a', 'z' + 6);
+    std::vector<char> text(n);
+    for (auto &c : text) {
+        const int x = dist(engine);
+        c = x > 'z' ? " ,;\n\t\x80"[x - 'z' - 1] : char(x);
+    }
+    return text;
+}
+
+TEST(findByte)
+{
+    const auto text = randomText(300, 1);
+    for (std::size_t offset = 0; offset < 40; ++offset) {
+        for (std::size_t length = 0; length + offset < 200; length += 7) {
+            const char *first = text.data() + offset;
+            const char *last = first + length;
+            for (char c : {',', 'a', 'q', '\n', '#', '\x80'}) {
+                const void *ref = std::memchr(first, c, length);
+                COMPARE(Vc::find_byte(first, last, c), ref ? static_cast<const char *>(ref) : last)
+                    << "offset: " << offset << ", length: " << length << ", c: " << int(c);
+                COMPARE(Vc::count_bytes(first, last, c), std::size_t(std::count(first, last, c)));
+            }
+        }
+    }
+}
+
+TEST(findFirstOf)
+{
+    const auto text = randomText(300, 2);
+    const char *sets[] = {",", ";\n", "xyz\t", "#", "\x80\x81\xff", "abcdefghijklmnopq"};
+    for (const char *chars : sets) {
+        const Vc::byte_set set(chars);
+        COMPARE(set.size(), std::strlen(chars));
+        for (int b = 0; b < 256; ++b) {
+            COMPARE(set.contains(char(b)), b != 0 && std::strchr(chars, b) != nullptr) << b;
+        }
+        for (std::size_t offset = 0; offset < 40; ++offset) {
+            for (std::size_t length = 0; length + offset < 200; length += 5) {
+                const char *first = text.data() + offset;
+                const char *last = first + length;
+                const auto isElement = [&](char c) { return set.contains(c); };
+                COMPARE(Vc::find_first_of(first, last, set),
+                        std::find_if(first, last, isElement))
+                    << "offset: " << offset << ", length: " << length << ", set: " << chars;
+                COMPARE(Vc::count_bytes(first, last, set),
+                        std::size_t(std::count_if(first, last, isElement)));
+            }
+        }
+    }
+}
+
+TEST(splitOffsets)
+{
+    const auto text = randomText(1000, 3);
+    const Vc::byte_set delimiters(",;\n");
+    for (std::size_t offset = 0; offset < 33; ++offset) {
+        const char *first = text.data() + offset;
+        const char *last = first + 900;
+        std::vector<std::size_t> offsets;
+        Vc::split_offsets(first, last, delimiters, std::back_inserter(offsets));
+        std::vector<std::size_t> reference;
+        for (const char *it = first; it != last; ++it) {
+            if (*it == ',' || *it == ';' || *it == '\n') {
+                reference.push_back(it - first);
+            }
+        }
+        COMPARE(offsets.size(), reference.size());
+        VERIFY(offsets == reference);
+    }
+}
+
+TEST(ascii)
+{
+    std::string text(100, 'x');
+    for (std::size_t offset = 0; offset < 40; ++offset) {
+        VERIFY(Vc::is_ascii(&text[offset], &text[60]));
+    }
+    // non-ASCII bytes directly outside of the range must be ignored
+    text[9] = '\xe4';
+    text[50] = '\x80';
+    VERIFY(Vc::is_ascii(&text[10], &text[50]));
+    VERIFY(!Vc::is_ascii(&text[9], &text[50]));
+    VERIFY(!Vc::is_ascii(&text[10], &text[51]));
+}
+
+TEST(utf8)
+{
+    const std::string valid[] = {"plain ascii", "gr\xc3\xbc\xc3\x9f" "e",
+                                 "\xe2\x82\xac 100", "\xf0\x9f\x98\x80!",
+                                 "\xed\x9f\xbf\xee\x80\x80\xf4\x8f\xbf\xbf", ""};
+    for (const auto &s : valid) {
+        for (std::size_t pad = 0; pad < 40; ++pad) {
+            const std::string x = std::string(pad, 'a') + s + std::string(pad % 7, 'b');
+            VERIFY(Vc::is_valid_utf8(x.data(), x.data() + x.size())) << x;
+        }
+    }
+    // truncated, unexpected continuation, overlong, surrogate, above U+10FFFF, 0xff
+    const std::string invalid[] = {"\xc3", "\x80", "\xc0\xaf", "\xe0\x80\xaf",
+                                   "\xed\xa0\x80", "\xf4\x90\x80\x80", "\xe2\x82", "\xff",
+                                   "\xf0\x9f\x98"};
+    for (const auto &s : invalid) {
+        for (std::size_t pad = 0; pad < 40; ++pad) {
+            const std::string x = std::string(pad, 'a') + "\xc3\xa4" + s + "tail";
+            COMPARE(Vc::find_invalid_utf8(x.data(), x.data() + x.size()), x.data() + pad + 2)
+                << "pad: " << pad;
+        }
+    }
+}
+
+#ifdef __unix__
+TEST(pageBoundary)
+{
+    // the aligned block loads must not touch the protected pages before and after the range
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    char *pages = static_cast<char *>(mmap(nullptr, 3 * pageSize, PROT_READ | PROT_WRITE,
+                                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    VERIFY(pages != MAP_FAILED);
+    VERIFY(mprotect(pages, pageSize, PROT_NONE) == 0);
+    VERIFY(mprotect(pages + 2 * pageSize, pageSize, PROT_NONE) == 0);
+    char *const first = pages + pageSize;
+    char *const last = pages + 2 * pageSize;
+    std::memset(first, 'x', pageSize);
+    for (int n = 0; n <= 70; ++n) {
+        COMPARE(Vc::find_byte(last - n, last, ','), last);
+        COMPARE(Vc::find_byte(first, first + n, ','), first + n);
+        COMPARE(Vc::count_bytes(last - n, last, 'x'), std::size_t(n));
+        COMPARE(Vc::find_first_of(last - n, last, Vc::byte_set(",;")), last);
+        VERIFY(Vc::is_valid_utf8(last - n, last));
+    }
+    last[-1] = ',';
+    COMPARE(Vc::find_byte(last - 5, last, ','), last - 1);
+    munmap(pages, 3 * pageSize);
+}
+#endif
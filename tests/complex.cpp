@@ -0,0 +1,270 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include "unittest.h"
+#include <Vc/Complex>
+#include <random>
+#include <vector>
+
+#define ALL_TYPES (REAL_VECTORS, SIMD_REAL_ARRAYS(3), SIMD_REAL_ARRAYS(16))
+
+using Vc::complex;
+
+// values with magnitudes in [0.5, 2] and arbitrary phase, away from over- and underflow
+template <typename V> static complex<V> randomComplex(std::default_random_engine &engine)
+{
+    typedef typename V::EntryType T;
+    std::uniform_real_distribution<T> magnitude(T(0.5), T(2));
+    std::uniform_real_distribution<T> phase(T(-3.14159), T(3.14159));
+    complex<V> z;
+    for (std::size_t i = 0; i < V::Size; ++i) {
+        const std::complex<T> x = std::polar(magnitude(engine), phase(engine));
+        V re = z.real(), im = z.imag();
+        re[i] = x.real();
+        im[i] = x.imag();
+        z = complex<V>(re, im);
+    }
+    return z;
+}
+
+template <typename V, typename F>
+static void compareEntries(const complex<V> &z, typename V::EntryType tolerance, F &&reference)
+{
+    typedef typename V::EntryType T;
+    for (std::size_t i = 0; i < V::Size; ++i) {
+        const std::complex<T> ref = reference(i);
+        VERIFY(std::abs(z[i] - ref) <= tolerance * std::max(T(1), std::abs(ref)))
+            << "entry " << i << ": " << z[i] << " != " << ref;
+    }
+}
+
+TEST_TYPES(V, loadStore, ALL_TYPES) //{{{1
+{
+    typedef typename V::EntryType T;
+    std::vector<std::complex<T>> interleaved(V::Size + 1);
+    std::vector<T> re(V::Size + 1), im(V::Size + 1);
+    for (std::size_t i = 0; i < interleaved.size(); ++i) {
+        interleaved[i] = std::complex<T>(T(i), T(-2) * T(i));
+        re[i] = T(i);
+        im[i] = T(-2) * T(i);
+    }
+    for (std::size_t offset = 0; offset < 2; ++offset) {
+        const complex<V> a(&interleaved[offset], Vc::Unaligned);
+        const complex<V> b(&re[offset], &im[offset], Vc::Unaligned);
+        COMPARE(a.real(), V(&re[offset], Vc::Unaligned)) << "offset " << offset;
+        COMPARE(a.imag(), V(&im[offset], Vc::Unaligned)) << "offset " << offset;
+        VERIFY(all_of(a == b)) << "offset " << offset;
+        VERIFY(none_of(a != b)) << "offset " << offset;
+
+        std::vector<std::complex<T>> out(V::Size + 1, std::complex<T>(T(-1), T(-1)));
+        a.store(&out[offset], Vc::Unaligned);
+        for (std::size_t i = 0; i < V::Size; ++i) {
+            COMPARE(out[offset + i], interleaved[offset + i]);
+            COMPARE(a[i], interleaved[offset + i]);
+        }
+        COMPARE(out[offset == 0 ? V::Size : 0], std::complex<T>(T(-1), T(-1)));
+
+        std::vector<T> outRe(V::Size), outIm(V::Size);
+        b.store(&outRe[0], &outIm[0], Vc::Unaligned);
+        for (std::size_t i = 0; i < V::Size; ++i) {
+            COMPARE(outRe[i], re[offset + i]);
+            COMPARE(outIm[i], im[offset + i]);
+        }
+    }
+
+    const complex<V> c(std::complex<T>(T(1), T(2)));
+    COMPARE(c.real(), V::One());
+    COMPARE(c.imag(), V(T(2)));
+    COMPARE(complex<V>().real(), V::Zero());
+    COMPARE(complex<V>().imag(), V::Zero());
+}
+
+TEST_TYPES(V, arithmetics, ALL_TYPES) //{{{1
+{
+    typedef typename V::EntryType T;
+    const T eps = std::numeric_limits<T>::epsilon() * 8;
+    std::default_random_engine engine;
+    for (int rep = 0; rep < 100; ++rep) {
+        const complex<V> a = randomComplex<V>(engine);
+        const complex<V> b = randomComplex<V>(engine);
+        const complex<V> c = randomComplex<V>(engine);
+        const V x = b.real();
+        compareEntries(a + b, eps, [&](std::size_t i) { return a[i] + b[i]; });
+        compareEntries(a - b, eps, [&](std::size_t i) { return a[i] - b[i]; });
+        compareEntries(a * b, eps, [&](std::size_t i) { return a[i] * b[i]; });
+        compareEntries(a / b, eps, [&](std::size_t i) { return a[i] / b[i]; });
+        compareEntries(-a, eps, [&](std::size_t i) { return -a[i]; });
+        compareEntries(a + x, eps, [&](std::size_t i) { return a[i] + x[i]; });
+        compareEntries(x - a, eps, [&](std::size_t i) { return x[i] - a[i]; });
+        compareEntries(a * x, eps, [&](std::size_t i) { return a[i] * x[i]; });
+        compareEntries(x * a, eps, [&](std::size_t i) { return x[i] * a[i]; });
+        compareEntries(a / x, eps, [&](std::size_t i) { return a[i] / x[i]; });
+        compareEntries(x / a, eps, [&](std::size_t i) { return x[i] / a[i]; });
+        compareEntries(a.squared(), eps, [&](std::size_t i) { return a[i] * a[i]; });
+        compareEntries(fma(a, b, c), eps, [&](std::size_t i) { return a[i] * b[i] + c[i]; });
+
+        complex<V> d = a;
+        d *= b;
+        d += c;
+        d -= b;
+        d /= c;
+        compareEntries(d, eps * 4,
+                       [&](std::size_t i) { return (a[i] * b[i] + c[i] - b[i]) / c[i]; });
+    }
+}
+
+TEST_TYPES(V, functions, ALL_TYPES) //{{{1
+{
+    typedef typename V::EntryType T;
+    const T eps = std::numeric_limits<T>::epsilon() * 8;
+    std::default_random_engine engine;
+    for (int rep = 0; rep < 100; ++rep) {
+        const complex<V> z = randomComplex<V>(engine);
+        const V r = Vc::abs(z.real()) + T(0.5);
+        const V theta = z.imag();
+        for (std::size_t i = 0; i < V::Size; ++i) {
+            const std::complex<T> ref = z[i];
+            COMPARE_RELATIVE_ERROR(norm(z)[i], std::norm(ref), eps);
+            COMPARE_RELATIVE_ERROR(abs(z)[i], std::abs(ref), eps);
+            COMPARE_ABSOLUTE_ERROR(arg(z)[i], std::arg(ref), eps * 4);
+            COMPARE(conj(z)[i], std::conj(ref));
+        }
+        compareEntries(exp(z), eps * 4, [&](std::size_t i) { return std::exp(z[i]); });
+        compareEntries(Vc::polar(r, theta), eps * 4,
+                       [&](std::size_t i) { return std::polar(r[i], theta[i]); });
+    }
+}
+
+TEST_TYPES(V, blend, ALL_TYPES) //{{{1
+{
+    typedef typename V::EntryType T;
+    const complex<V> a(V::IndexesFromZero(), V::One());
+    const complex<V> b(V::Zero(), -V::IndexesFromZero());
+    const typename V::mask_type k = V::IndexesFromZero() > T(1);
+    const complex<V> r = iif(k, a, b);
+    for (std::size_t i = 0; i < V::Size; ++i) {
+        COMPARE(r[i], k[i] ? a[i] : b[i]) << "entry " << i;
+    }
+    COMPARE(b.blend(k, a)[0], b[0]);
+}
+
+TEST_TYPES(V, cachedSquares, ALL_TYPES) //{{{1
+{
+    typedef typename V::EntryType T;
+    // a few Mandelbrot iterations: c inside and outside of the set
+    const complex<V> c(V::IndexesFromZero() * T(0.25) - T(1.5), V(T(0.125)));
+    complex<V> z = c;
+    Vc::complex_squares<V> zz = c;
+    for (int it = 0; it < 10; ++it) {
+        const typename V::mask_type running = zz.norm() < T(4);
+        COMPARE(running, z.norm() < T(4)) << "iteration " << it;
+        compareEntries(zz.value(), T(1e-4), [&](std::size_t i) { return z[i]; });
+        z = z.blend(running, z.squared() + c);
+        zz.assign(running, zz.squared_plus(c));
+    }
+}
+
+// complex_interleaved needs an even number of entries, which the Scalar float_v lacks
+typedef std::conditional<Vc::float_v::Size % 2 == 0, Vc::float_v,
+                         Vc::SimdArray<float, 2>>::type EvenFloatV;
+typedef std::conditional<Vc::double_v::Size % 2 == 0, Vc::double_v,
+                         Vc::SimdArray<double, 2>>::type EvenDoubleV;
+
+TEST_TYPES(V, interleaved, (EvenFloatV, EvenDoubleV, SIMD_REAL_ARRAYS(6),
+                            SIMD_REAL_ARRAYS(16))) //{{{1
+{
+    typedef typename V::EntryType T;
+    typedef Vc::complex_interleaved<V> Z;
+    typedef typename Z::split_type Split;
+    // absolute tolerance: the products have magnitudes up to 8
+    const T eps = std::numeric_limits<T>::epsilon() * 64;
+    std::default_random_engine engine;
+    std::uniform_real_distribution<T> dist(T(-2), T(2));
+    std::vector<std::complex<T>> mem(3 * Z::Size + 1);
+    for (int rep = 0; rep < 100; ++rep) {
+        for (auto &x : mem) {
+            x = std::complex<T>(dist(engine), dist(engine));
+        }
+        const std::size_t offset = rep % 2;
+        const std::complex<T> *a = &mem[offset];
+        const std::complex<T> *b = a + Z::Size;
+        const std::complex<T> *c = b + Z::Size;
+        const Z za(a, Vc::Unaligned), zb(b, Vc::Unaligned), zc(c, Vc::Unaligned);
+        const T x = dist(engine);
+        const V n = za.norm();
+        for (std::size_t i = 0; i < Z::Size; ++i) {
+            COMPARE(za[i], a[i]);
+            VERIFY(std::abs((za + zb)[i] - (a[i] + b[i])) <= eps * 4);
+            VERIFY(std::abs((za - zb)[i] - (a[i] - b[i])) <= eps * 4);
+            VERIFY(std::abs((za * zb)[i] - a[i] * b[i]) <= eps * 8)
+                << (za * zb)[i] << " != " << a[i] * b[i];
+            VERIFY(std::abs(fma(za, zb, zc)[i] - (a[i] * b[i] + c[i])) <= eps * 16)
+                << fma(za, zb, zc)[i] << " != " << a[i] * b[i] + c[i];
+            VERIFY(std::abs((x * za)[i] - x * a[i]) <= eps * 4);
+            COMPARE((-za)[i], -a[i]);
+            COMPARE(conj(za)[i], std::conj(a[i]));
+            FUZZY_COMPARE(n[2 * i], std::norm(a[i]));
+            FUZZY_COMPARE(n[2 * i + 1], std::norm(a[i]));
+        }
+
+        const Split split = za.split();
+        for (std::size_t i = 0; i < Z::Size; ++i) {
+            COMPARE(split[i], a[i]);
+        }
+        COMPARE(Z(split).data(), za.data());
+
+        std::vector<std::complex<T>> out(Z::Size + 1, std::complex<T>(T(-1), T(-1)));
+        za.store(&out[offset], Vc::Unaligned);
+        for (std::size_t i = 0; i < Z::Size; ++i) {
+            COMPARE(out[offset + i], a[i]);
+        }
+        COMPARE(out[offset == 0 ? Z::Size : 0], std::complex<T>(T(-1), T(-1)));
+    }
+    COMPARE(Z(std::complex<T>(T(1), T(2)))[Z::Size - 1], std::complex<T>(T(1), T(2)));
+    COMPARE(Z().data(), V::Zero());
+}
+
+TEST(fastFma) //{{{1
+{
+    // Vc::fma is only used where it is a single instruction, not the emulation
+    using Vc::Detail::HasFastFma;
+    typedef Vc::Vector<float, Vc::VectorAbi::Sse> SseFloat;
+#if defined Vc_IMPL_FMA4
+    VERIFY(HasFastFma<Vc::float_v>::value);
+#elif defined Vc_IMPL_FMA
+    // the SSE implementation emulates fma even with FMA instructions
+    COMPARE(HasFastFma<Vc::float_v>::value,
+            (std::is_same<Vc::float_v::abi, Vc::VectorAbi::Avx>::value));
+    VERIFY(!HasFastFma<SseFloat>::value);
+    VERIFY(!(HasFastFma<Vc::SimdArray<float, SseFloat::Size>>::value));
+#else
+    VERIFY(!HasFastFma<Vc::float_v>::value);
+#endif
+}
+
+// vim: foldmethod=marker
@@ -0,0 +1,147 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include "unittest.h"
+#include <Vc/Divider>
+#include <limits>
+#include <random>
+#include <vector>
+
+template <typename T> static std::vector<T> interestingDivisors()
+{
+    std::vector<T> r;
+    for (int i = 1; i <= 300; ++i) {
+        r.push_back(T(i));
+        if (std::is_signed<T>::value) {
+            r.push_back(T(-i));
+        }
+    }
+    for (int k = 2; k < std::numeric_limits<T>::digits; ++k) {
+        for (T d : {T(T(1) << k), T((T(1) << k) - 1), T((T(1) << k) + 1)}) {
+            r.push_back(d);
+            if (std::is_signed<T>::value) {
+                r.push_back(T(0) - d);
+            }
+        }
+    }
+    r.push_back(std::numeric_limits<T>::max());
+    r.push_back(std::numeric_limits<T>::max() - 1);
+    if (std::is_signed<T>::value) {
+        r.push_back(std::numeric_limits<T>::min());
+        r.push_back(std::numeric_limits<T>::min() + 1);
+    }
+    std::default_random_engine engine;
+    std::uniform_int_distribution<T> dist(std::numeric_limits<T>::min(),
+                                          std::numeric_limits<T>::max());
+    while (r.size() < 2000) {
+        const T d = dist(engine);
+        if (d != 0) {
+            r.push_back(d);
+        }
+    }
+    return r;
+}
+
+// n / d with wrap-around for min / -1
+template <typename T> static T reference(T n, T d)
+{
+    if (std::is_signed<T>::value && d == T(-1)) {
+        return T(0) - n;
+    }
+    return n / d;
+}
+
+TEST_TYPES(V, divide, (INT_VECTORS, SIMD_INT_ARRAYS(7), SIMD_INT_ARRAYS(19)))
+{
+    typedef typename V::value_type T;
+    std::default_random_engine engine;
+    std::uniform_int_distribution<T> dist(std::numeric_limits<T>::min(),
+                                          std::numeric_limits<T>::max());
+    std::vector<T> numerators = {0, 1, 2, 3, 7, std::numeric_limits<T>::max(),
+                                 T(std::numeric_limits<T>::max() - 1),
+                                 std::numeric_limits<T>::min(),
+                                 T(std::numeric_limits<T>::min() + 1), T(-1), T(-2)};
+    while (numerators.size() % V::Size != 0 || numerators.size() < 20 * V::Size) {
+        numerators.push_back(dist(engine));
+    }
+    for (const T d : interestingDivisors<T>()) {
+        const Vc::divider<T> div(d);
+        COMPARE(div.divisor(), d);
+        for (std::size_t i = 0; i < numerators.size(); i += V::Size) {
+            const V n(&numerators[i]);
+            const V q = n / div;
+            const V r = n % div;
+            for (std::size_t l = 0; l < V::Size; ++l) {
+                COMPARE(q[l], reference(n[l], d)) << "n: " << n[l] << " d: " << d;
+                COMPARE(r[l], T(n[l] - reference(n[l], d) * d)) << "n: " << n[l] << " d: " << d;
+            }
+        }
+    }
+}
+
+// every numerator with every divisor, compared with operator/ (exact via float for 16 bits)
+TEST_TYPES(V, exhaustive16, (Vc::short_v, Vc::ushort_v))
+{
+    typedef typename V::value_type T;
+    typedef typename V::mask_type M;
+    const int nMin = std::numeric_limits<T>::min(), nMax = std::numeric_limits<T>::max();
+    static_assert((nMax - nMin + 1) % V::Size == 0, "");
+    const V step(T(V::Size));
+    for (int d = nMin; d <= nMax; ++d) {
+        // operator/ saturates min / -1, which is tested above
+        if (d == 0 || d == -1) {
+            continue;
+        }
+        const Vc::divider<T> div{T(d)};
+        const V vd = T(d);
+        V n = V::IndexesFromZero() + V(T(nMin));
+        M wrong(false);
+        for (int i = nMin; i <= nMax; i += int(V::Size)) {
+            wrong |= (n / div != n / vd);
+            n += step;
+        }
+        if (Vc_IS_UNLIKELY(any_of(wrong))) {
+            for (int i = nMin; i <= nMax; ++i) {
+                const V x = T(i);
+                COMPARE(x / div, x / vd) << "n: " << i << " d: " << d;
+            }
+        }
+    }
+}
+
+TEST(divisorOne)
+{
+    const Vc::divider<int> one(1);
+    const Vc::int_v x = Vc::int_v::IndexesFromZero() - 3;
+    COMPARE(x / one, x);
+    COMPARE(x % one, Vc::int_v::Zero());
+    const Vc::divider<unsigned int> big(0x80000001u);
+    const Vc::uint_v y(0xffffffffu);
+    COMPARE(y / big, Vc::uint_v::One());
+    COMPARE(y % big, Vc::uint_v(0x7ffffffeu));
+}
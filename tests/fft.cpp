@@ -0,0 +1,239 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include "unittest.h"
+#include <Vc/FFT>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#define ALL_TYPES (REAL_VECTORS, SIMD_REAL_ARRAYS(8))
+
+using Vc::fft_plan;
+
+// the naive DFT in double precision
+static void dft(const std::vector<double> &re, const std::vector<double> &im,
+                std::vector<double> &outRe, std::vector<double> &outIm)
+{
+    const std::size_t n = re.size();
+    outRe.assign(n, 0.);
+    outIm.assign(n, 0.);
+    for (std::size_t k = 0; k < n; ++k) {
+        for (std::size_t j = 0; j < n; ++j) {
+            const double a = -2 * M_PI * double((j * k) % n) / double(n);
+            outRe[k] += re[j] * std::cos(a) - im[j] * std::sin(a);
+            outIm[k] += re[j] * std::sin(a) + im[j] * std::cos(a);
+        }
+    }
+}
+
+static std::vector<double> randomValues(std::size_t n, std::default_random_engine &engine)
+{
+    std::uniform_real_distribution<double> dist(-1., 1.);
+    std::vector<double> r(n);
+    for (auto &x : r) {
+        x = dist(engine);
+    }
+    return r;
+}
+
+// the error bound of the transform of n values in [-1, 1]
+template <typename T> static double tolerance(std::size_t n)
+{
+    return 8 * std::numeric_limits<T>::epsilon() * std::log2(double(n) + 1) *
+           std::sqrt(double(n));
+}
+
+TEST_TYPES(V, singleForwardInverse, (REAL_VECTORS))
+{
+    typedef typename V::EntryType T;
+    std::default_random_engine engine;
+    for (std::size_t n = 1; n <= 1024; n *= 2) {
+        const fft_plan<T> plan(n);
+        COMPARE(plan.size(), n);
+        const auto xr = randomValues(n, engine), xi = randomValues(n, engine);
+        std::vector<double> refRe, refIm;
+        dft(xr, xi, refRe, refIm);
+
+        std::vector<T> re(xr.begin(), xr.end()), im(xi.begin(), xi.end());
+        plan.forward(re.data(), im.data());
+        for (std::size_t k = 0; k < n; ++k) {
+            VERIFY(std::abs(re[k] - refRe[k]) < tolerance<T>(n)) << "n: " << n << " k: " << k
+                                                                 << ' ' << re[k] << " vs. "
+                                                                 << refRe[k];
+            VERIFY(std::abs(im[k] - refIm[k]) < tolerance<T>(n)) << "n: " << n << " k: " << k
+                                                                 << ' ' << im[k] << " vs. "
+                                                                 << refIm[k];
+        }
+        plan.inverse(re.data(), im.data());
+        for (std::size_t k = 0; k < n; ++k) {
+            VERIFY(std::abs(re[k] - xr[k]) < tolerance<T>(n)) << "n: " << n << " k: " << k;
+            VERIFY(std::abs(im[k] - xi[k]) < tolerance<T>(n)) << "n: " << n << " k: " << k;
+        }
+    }
+}
+
+TEST_TYPES(V, subSize, (REAL_VECTORS))
+{
+    typedef typename V::EntryType T;
+    std::default_random_engine engine;
+    const fft_plan<T> plan(4096);
+    for (std::size_t n = 1; n <= 512; n *= 2) {
+        const auto xr = randomValues(n, engine), xi = randomValues(n, engine);
+        std::vector<double> refRe, refIm;
+        dft(xr, xi, refRe, refIm);
+        std::vector<T> re(xr.begin(), xr.end()), im(xi.begin(), xi.end());
+        plan.forward(re.data(), im.data(), n);
+        for (std::size_t k = 0; k < n; ++k) {
+            VERIFY(std::abs(re[k] - refRe[k]) < tolerance<T>(n)) << "n: " << n << " k: " << k;
+            VERIFY(std::abs(im[k] - refIm[k]) < tolerance<T>(n)) << "n: " << n << " k: " << k;
+        }
+    }
+}
+
+TEST_TYPES(V, largeRoundtrip, (REAL_VECTORS))
+{
+    typedef typename V::EntryType T;
+    std::default_random_engine engine;
+    const std::size_t n = 4096;
+    const fft_plan<T> plan(n);
+    const auto xr = randomValues(n, engine), xi = randomValues(n, engine);
+    std::vector<T> re(xr.begin(), xr.end()), im(xi.begin(), xi.end());
+    plan.forward(re.data(), im.data());
+    // Parseval
+    double energy = 0, reference = 0;
+    for (std::size_t k = 0; k < n; ++k) {
+        energy += double(re[k]) * re[k] + double(im[k]) * im[k];
+        reference += xr[k] * xr[k] + xi[k] * xi[k];
+    }
+    COMPARE_RELATIVE_ERROR(energy / n, reference, 1.e-5);
+    plan.inverse(re.data(), im.data());
+    for (std::size_t k = 0; k < n; ++k) {
+        VERIFY(std::abs(re[k] - xr[k]) < tolerance<T>(n)) << "k: " << k;
+        VERIFY(std::abs(im[k] - xi[k]) < tolerance<T>(n)) << "k: " << k;
+    }
+}
+
+TEST_TYPES(V, batched, ALL_TYPES)
+{
+    typedef typename V::EntryType T;
+    std::default_random_engine engine;
+    for (std::size_t n = 1; n <= 256; n *= 2) {
+        const fft_plan<T> plan(n);
+        std::vector<V, Vc::Allocator<V>> re(n), im(n);
+        std::vector<std::vector<double>> xr(V::Size), xi(V::Size);
+        for (std::size_t l = 0; l < V::Size; ++l) {
+            xr[l] = randomValues(n, engine);
+            xi[l] = randomValues(n, engine);
+            for (std::size_t j = 0; j < n; ++j) {
+                re[j][l] = T(xr[l][j]);
+                im[j][l] = T(xi[l][j]);
+            }
+        }
+        plan.forward(re.data(), im.data());
+        for (std::size_t l = 0; l < V::Size; ++l) {
+            std::vector<double> refRe, refIm;
+            dft(xr[l], xi[l], refRe, refIm);
+            for (std::size_t k = 0; k < n; ++k) {
+                VERIFY(std::abs(re[k][l] - refRe[k]) < tolerance<T>(n))
+                    << "n: " << n << " lane: " << l << " k: " << k;
+                VERIFY(std::abs(im[k][l] - refIm[k]) < tolerance<T>(n))
+                    << "n: " << n << " lane: " << l << " k: " << k;
+            }
+        }
+        plan.inverse(re.data(), im.data());
+        for (std::size_t l = 0; l < V::Size; ++l) {
+            for (std::size_t j = 0; j < n; ++j) {
+                VERIFY(std::abs(re[j][l] - xr[l][j]) < tolerance<T>(n));
+                VERIFY(std::abs(im[j][l] - xi[l][j]) < tolerance<T>(n));
+            }
+        }
+    }
+}
+
+TEST_TYPES(V, singleReal, (REAL_VECTORS))
+{
+    typedef typename V::EntryType T;
+    std::default_random_engine engine;
+    for (std::size_t n = 2; n <= 1024; n *= 2) {
+        const fft_plan<T> plan(n);
+        const auto x = randomValues(n, engine);
+        std::vector<double> refRe, refIm;
+        dft(x, std::vector<double>(n, 0.), refRe, refIm);
+
+        const std::vector<T> in(x.begin(), x.end());
+        std::vector<T> re(n / 2 + 1), im(n / 2 + 1), out(n);
+        plan.forward_real(in.data(), re.data(), im.data());
+        for (std::size_t k = 0; k <= n / 2; ++k) {
+            VERIFY(std::abs(re[k] - refRe[k]) < tolerance<T>(n)) << "n: " << n << " k: " << k
+                                                                 << ' ' << re[k] << " vs. "
+                                                                 << refRe[k];
+            VERIFY(std::abs(im[k] - refIm[k]) < tolerance<T>(n)) << "n: " << n << " k: " << k
+                                                                 << ' ' << im[k] << " vs. "
+                                                                 << refIm[k];
+        }
+        plan.inverse_real(re.data(), im.data(), out.data());
+        for (std::size_t j = 0; j < n; ++j) {
+            VERIFY(std::abs(out[j] - x[j]) < tolerance<T>(n)) << "n: " << n << " j: " << j;
+        }
+    }
+}
+
+TEST_TYPES(V, batchedReal, ALL_TYPES)
+{
+    typedef typename V::EntryType T;
+    std::default_random_engine engine;
+    for (std::size_t n = 2; n <= 256; n *= 2) {
+        const fft_plan<T> plan(n);
+        std::vector<V, Vc::Allocator<V>> in(n), re(n / 2 + 1), im(n / 2 + 1), out(n);
+        std::vector<std::vector<double>> x(V::Size);
+        for (std::size_t l = 0; l < V::Size; ++l) {
+            x[l] = randomValues(n, engine);
+            for (std::size_t j = 0; j < n; ++j) {
+                in[j][l] = T(x[l][j]);
+            }
+        }
+        plan.forward_real(in.data(), re.data(), im.data());
+        for (std::size_t l = 0; l < V::Size; ++l) {
+            std::vector<double> refRe, refIm;
+            dft(x[l], std::vector<double>(n, 0.), refRe, refIm);
+            for (std::size_t k = 0; k <= n / 2; ++k) {
+                VERIFY(std::abs(re[k][l] - refRe[k]) < tolerance<T>(n))
+                    << "n: " << n << " lane: " << l << " k: " << k;
+                VERIFY(std::abs(im[k][l] - refIm[k]) < tolerance<T>(n))
+                    << "n: " << n << " lane: " << l << " k: " << k;
+            }
+        }
+        plan.inverse_real(re.data(), im.data(), out.data());
+        for (std::size_t l = 0; l < V::Size; ++l) {
+            for (std::size_t j = 0; j < n; ++j) {
+                VERIFY(std::abs(out[j][l] - x[l][j]) < tolerance<T>(n));
+            }
+        }
+    }
+}
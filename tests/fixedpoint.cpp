@@ -0,0 +1,211 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include "unittest.h"
+#include <Vc/FixedPoint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#define INT16_TYPES                                                                      \
+    Vc::short_v, Vc::ushort_v, Vc::SimdArray<short, 7>,                                  \
+        Vc::SimdArray<unsigned short, 19>, Vc::SimdArray<short, 32>
+
+// madd needs an even number of entries, which short_v does not have with the Scalar ABI
+typedef std::conditional<Vc::short_v::Size % 2 == 0, Vc::short_v,
+                         Vc::SimdArray<short, 2>>::type EvenShortV;
+
+template <typename T> static std::vector<T> interestingValues()
+{
+    typedef std::numeric_limits<T> L;
+    std::vector<T> r = {T(0),          T(1),          T(2),           T(3),
+                        T(0x3fff),     T(0x4000),     T(0x4001),      T(0x7fff),
+                        L::max(),      T(L::max() - 1), L::min(),     T(L::min() + 1),
+                        T(L::max() / 2), T(L::max() / 2 + 1)};
+    if (std::is_signed<T>::value) {
+        for (T x : {T(-1), T(-2), T(-3), T(-0x4000), T(-0x4001), T(-0x3fff)}) {
+            r.push_back(x);
+        }
+    }
+    std::default_random_engine engine;
+    std::uniform_int_distribution<T> dist(L::min(), L::max());
+    while (r.size() < 300) {
+        r.push_back(dist(engine));
+    }
+    return r;
+}
+
+// applies Op to all pairs of interestingValues() and compares against the scalar reference
+template <typename V, typename Op> static void checkAllPairs()
+{
+    typedef typename V::value_type T;
+    const std::vector<T> values = interestingValues<T>();
+    const std::size_t n = values.size();
+    for (std::size_t k = 0; k < n * n; k += V::Size) {
+        V a, b;
+        for (std::size_t i = 0; i < V::Size; ++i) {
+            a[i] = values[((k + i) / n) % n];
+            b[i] = values[(k + i) % n];
+        }
+        const V r = Op::vector(a, b);
+        for (std::size_t i = 0; i < V::Size; ++i) {
+            COMPARE(T(r[i]), Op::reference(T(a[i]), T(b[i]))) << "a = " << a << ", b = " << b
+                                                              << ", r = " << r;
+        }
+    }
+}
+
+template <typename T> static T saturate(long long x)
+{
+    return T(std::max<long long>(std::numeric_limits<T>::min(),
+                                 std::min<long long>(std::numeric_limits<T>::max(), x)));
+}
+
+struct Adds
+{
+    template <typename V> static V vector(const V &a, const V &b) { return Vc::adds(a, b); }
+    template <typename T> static T reference(T a, T b) { return saturate<T>(a + b); }
+};
+struct Subs
+{
+    template <typename V> static V vector(const V &a, const V &b) { return Vc::subs(a, b); }
+    template <typename T> static T reference(T a, T b) { return saturate<T>(a - b); }
+};
+struct Avg
+{
+    template <typename V> static V vector(const V &a, const V &b) { return Vc::avg(a, b); }
+    template <typename T> static T reference(T a, T b)
+    {
+        return T((static_cast<long long>(a) + b + 1) >> 1);
+    }
+};
+struct Mulhi
+{
+    template <typename V> static V vector(const V &a, const V &b) { return Vc::mulhi(a, b); }
+    template <typename T> static T reference(T a, T b)
+    {
+        typedef typename std::conditional<std::is_signed<T>::value, long long,
+                                          unsigned long long>::type Wide;
+        return T((static_cast<Wide>(a) * static_cast<Wide>(b)) >> (8 * sizeof(T)));
+    }
+};
+struct Mulhrs
+{
+    template <typename V> static V vector(const V &a, const V &b) { return Vc::mulhrs(a, b); }
+    template <typename T> static T reference(T a, T b)
+    {
+        return T(static_cast<unsigned short>((static_cast<int>(a) * b + 0x4000) >> 15));
+    }
+};
+
+TEST_TYPES(V, adds, (INT16_TYPES)) { checkAllPairs<V, Adds>(); }
+TEST_TYPES(V, subs, (INT16_TYPES)) { checkAllPairs<V, Subs>(); }
+TEST_TYPES(V, avg, (INT16_TYPES)) { checkAllPairs<V, Avg>(); }
+TEST_TYPES(V, mulhi, (INT_VECTORS, SIMD_INT_ARRAYS(7), Vc::SimdArray<short, 32>))
+{
+    checkAllPairs<V, Mulhi>();
+}
+TEST_TYPES(V, mulhrs, (Vc::short_v, Vc::SimdArray<short, 7>, Vc::SimdArray<short, 32>))
+{
+    checkAllPairs<V, Mulhrs>();
+}
+
+TEST_TYPES(V, mulhrsEdgeCases, (Vc::short_v, Vc::SimdArray<short, 7>))
+{
+    COMPARE(Vc::mulhrs(V(0x4000), V(0x4000)), V(0x2000));
+    COMPARE(Vc::mulhrs(V(0x7fff), V(0x7fff)), V(0x7ffe));
+    COMPARE(Vc::mulhrs(V(-0x8000), V(0x7fff)), V(-0x7fff));
+    COMPARE(Vc::mulhrs(V(-1), V(0x4000)), V(0));       // -0.5 rounds up
+    COMPARE(Vc::mulhrs(V(-1), V(0x4001)), V(-1));
+    COMPARE(Vc::mulhrs(V(-0x8000), V(-0x8000)), V(-0x8000));  // wraps like pmulhrsw
+}
+
+TEST_TYPES(V, saturationEdgeCases, (Vc::short_v, Vc::ushort_v))
+{
+    typedef typename V::value_type T;
+    typedef std::numeric_limits<T> L;
+    COMPARE(Vc::adds(V(L::max()), V(1)), V(L::max()));
+    COMPARE(Vc::adds(V(L::max()), V(L::max())), V(L::max()));
+    COMPARE(Vc::subs(V(L::min()), V(1)), V(L::min()));
+    COMPARE(Vc::subs(V(0), V(L::max())), V(saturate<T>(-static_cast<int>(L::max()))));
+    COMPARE(Vc::avg(V(L::max()), V(L::max())), V(L::max()));
+    COMPARE(Vc::avg(V(L::min()), V(L::min())), V(L::min()));
+}
+
+TEST_TYPES(V, mul_widen, (INT16_TYPES))
+{
+    typedef typename V::value_type T;
+    typedef typename std::conditional<std::is_signed<T>::value, int, unsigned int>::type W;
+    const std::vector<T> values = interestingValues<T>();
+    const std::size_t n = values.size();
+    for (std::size_t k = 0; k < n * n; k += 7 * V::Size) {
+        V a, b;
+        for (std::size_t i = 0; i < V::Size; ++i) {
+            a[i] = values[((k + i) / n) % n];
+            b[i] = values[(k + 3 * i) % n];
+        }
+        const auto r = Vc::mul_widen(a, b);
+        static_assert(std::is_same<decltype(r), const Vc::SimdArray<W, V::Size>>::value,
+                      "unexpected return type of mul_widen");
+        for (std::size_t i = 0; i < V::Size; ++i) {
+            COMPARE(W(r[i]), W(W(a[i]) * W(b[i]))) << "a = " << a << ", b = " << b;
+        }
+    }
+}
+
+TEST_TYPES(V, madd, (EvenShortV, Vc::SimdArray<short, 8>, Vc::SimdArray<short, 18>,
+                     Vc::SimdArray<short, 32>))
+{
+    typedef Vc::SimdArray<int, V::Size / 2> R;
+    const std::vector<short> values = interestingValues<short>();
+    const std::size_t n = values.size();
+    for (std::size_t k = 0; k < n * n; k += 5 * V::Size) {
+        V a, b;
+        for (std::size_t i = 0; i < V::Size; ++i) {
+            a[i] = values[((k + i) / n) % n];
+            b[i] = values[(k + 5 * i) % n];
+        }
+        const R r = Vc::madd(a, b);
+        for (std::size_t i = 0; i < R::Size; ++i) {
+            // only -0x8000 * -0x8000 * 2 wraps, compute it unsigned
+            const unsigned sum = unsigned(int(a[2 * i]) * b[2 * i]) +
+                                 unsigned(int(a[2 * i + 1]) * b[2 * i + 1]);
+            COMPARE(int(r[i]), int(sum)) << "a = " << a << ", b = " << b;
+        }
+    }
+}
+
+TEST(maddDotProduct)
+{
+    Vc::SimdArray<short, 16> a = Vc::SimdArray<short, 16>::IndexesFromZero();
+    const Vc::SimdArray<short, 16> b(-0x8000);
+    // (0 + 1 + ... + 15) * -32768
+    COMPARE(Vc::madd(a, b).sum(), 120 * -0x8000);
+    a = 0x7fff;
+    COMPARE(Vc::madd(a, a), (Vc::SimdArray<int, 8>(2 * 0x7fff * 0x7fff)));
+}
@@ -28,6 +28,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
 #include "unittest.h"
+#include <chrono>
 
 using namespace Vc;
 
@@ -54,7 +55,28 @@ template<typename V, size_t StructSize> struct Types<V, StructSize, false>
     typedef SomeStruct<T, StructSize> S;
     typedef const Vc::InterleavedMemoryWrapper<S, V> &Wrapper;
 };
-template<typename V, size_t StructSize, bool Random, size_t N = StructSize> struct TestDeinterleaveGatherCompare;
+template <typename V, size_t StructSize, bool Random, size_t N = StructSize>
+struct TestDeinterleaveGatherCompare {
+    template <std::size_t... Indexes>
+    static void test(typename Types<V, StructSize, Random>::Wrapper data_v,
+                     typename Types<V, StructSize, Random>::IArg indexes,
+                     const typename V::AsArg reference, Vc::index_sequence<Indexes...>)
+    {
+        std::array<V, N> v;
+        tie(v[Indexes]...) = data_v[indexes];
+        for (std::size_t i = 0; i < N; ++i) {
+            COMPARE(v[i], reference + V(i)) << "N = " << N << ", i = " << i;
+        }
+        TestDeinterleaveGatherCompare<V, StructSize, Random, N - 1>::test(data_v, indexes,
+                                                                          reference);
+    }
+    static void test(typename Types<V, StructSize, Random>::Wrapper data_v,
+                     typename Types<V, StructSize, Random>::IArg indexes,
+                     const typename V::AsArg reference)
+    {
+        test(data_v, indexes, reference, Vc::make_index_sequence<N>());
+    }
+};
 template<typename V, size_t StructSize, bool Random> struct TestDeinterleaveGatherCompare<V, StructSize, Random, 8> {
     static void test(typename Types<V, StructSize, Random>::Wrapper data_v, typename Types<V, StructSize, Random>::IArg indexes, const typename V::AsArg reference)
     {
@@ -169,7 +191,11 @@ TEST_TYPES(Param, testDeinterleaveGather,
                                    std::integral_constant<std::size_t, 5>,
                                    std::integral_constant<std::size_t, 6>,
                                    std::integral_constant<std::size_t, 7>,
-                                   std::integral_constant<std::size_t, 8>>>))
+                                   std::integral_constant<std::size_t, 8>,
+                                   std::integral_constant<std::size_t, 9>,
+                                   std::integral_constant<std::size_t, 11>,
+                                   std::integral_constant<std::size_t, 13>,
+                                   std::integral_constant<std::size_t, 16>>>))
 {
     typedef typename Param::template at<0> V;
     constexpr auto StructSize = Param::template at<1>::value;
@@ -210,4 +236,160 @@ TEST_TYPES(Param, testDeinterleaveGather,
     }
 }
 
+template <typename T, typename U> struct MixedStruct
+{
+    T a[3];
+    U b;
+    T c[6];
+    U d[2];
+    T e[4];
+};
+
+template <typename V, typename W> void testMixedMembers(std::false_type) {}
+template <typename V, typename W> void testMixedMembers(std::true_type)
+{
+    typedef typename V::EntryType T;
+    typedef typename W::EntryType U;
+    typedef typename V::IndexType I;
+    typedef MixedStruct<T, U> S;
+    typedef std::tuple<V, V, V, W, V, V, V, V, V, V, W, W, V, V, V, V> Members;
+    static_assert(sizeof(S) == 16 * sizeof(T), "");
+    constexpr std::size_t N = 1024;
+
+    S *data = Vc::malloc<S, Vc::AlignOnVector>(N);
+    S *out = Vc::malloc<S, Vc::AlignOnVector>(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        for (int k = 0; k < 3; ++k) { data[i].a[k] = i * 16 + k; }
+        data[i].b = i * 16 + 3;
+        for (int k = 0; k < 6; ++k) { data[i].c[k] = i * 16 + 4 + k; }
+        for (int k = 0; k < 2; ++k) { data[i].d[k] = i * 16 + 10 + k; }
+        for (int k = 0; k < 4; ++k) { data[i].e[k] = i * 16 + 12 + k; }
+    }
+    std::memset(out, 0, N * sizeof(S));
+    const Vc::InterleavedMemoryWrapper<S, V> data_v(data);
+    Vc::InterleavedMemoryWrapper<S, V> out_v(out);
+
+    for (int retest = 0; retest < 1000; ++retest) {
+        const I indexes = (I::IndexesFromZero() * 7 + retest) & I(N - 1);
+        const I i16 = indexes * 16;
+        const Members m = data_v[indexes];
+        COMPARE(std::get< 0>(m), simd_cast<V>(i16 +  0));
+        COMPARE(std::get< 2>(m), simd_cast<V>(i16 +  2));
+        COMPARE(std::get< 3>(m), simd_cast<W>(i16 +  3));
+        COMPARE(std::get< 9>(m), simd_cast<V>(i16 +  9));
+        COMPARE(std::get<10>(m), simd_cast<W>(i16 + 10));
+        COMPARE(std::get<11>(m), simd_cast<W>(i16 + 11));
+        COMPARE(std::get<15>(m), simd_cast<V>(i16 + 15));
+
+        out_v[indexes] = m;
+        for (std::size_t k = 0; k < V::Size; ++k) {
+            VERIFY(std::memcmp(&out[indexes[k]], &data[indexes[k]], sizeof(S)) == 0);
+        }
+        out_v[indexes] = std::make_tuple(V::Zero(), V::Zero(), V::Zero(), simd_cast<W>(indexes));
+        for (std::size_t k = 0; k < V::Size; ++k) {
+            COMPARE(out[indexes[k]].a[2], T(0));
+            COMPARE(out[indexes[k]].b, U(indexes[k]));
+            COMPARE(out[indexes[k]].c[0], T(indexes[k] * 16 + 4));
+        }
+    }
+    Vc::free(data);
+    Vc::free(out);
+}
+
+TEST_TYPES(V, testDeinterleaveMixed, (float_v, int_v, uint_v))
+{
+    typedef typename std::conditional<std::is_same<V, float_v>::value, int_v, float_v>::type W;
+    testMixedMembers<V, W>(std::integral_constant<bool, V::Size == W::Size>());
+}
+
+// throughput of the deinterleaving gathers {{{1
+template <typename V, typename S, typename I, std::size_t... Indexes>
+V sumOfMembers(const Vc::InterleavedMemoryWrapper<S, V> &data_v, const I &indexes,
+               Vc::index_sequence<Indexes...>)
+{
+    std::array<V, sizeof...(Indexes)> v;
+    tie(v[Indexes]...) = data_v[indexes];
+    V sum = V::Zero();
+    for (const V &x : v) {
+        sum += x;
+    }
+    return sum;
+}
+
+template <typename F> double bestTime(F &&f)
+{
+    double best = 1e99;
+    for (int rep = 0; rep < 5; ++rep) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        const auto stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(stop - start).count());
+    }
+    return best;
+}
+
+TEST_TYPES(Param, benchmarkDeinterleave,
+           (outer_product<Typelist<float_v>,
+                          Typelist<std::integral_constant<std::size_t, 3>,
+                                   std::integral_constant<std::size_t, 4>,
+                                   std::integral_constant<std::size_t, 8>,
+                                   std::integral_constant<std::size_t, 10>,
+                                   std::integral_constant<std::size_t, 12>,
+                                   std::integral_constant<std::size_t, 16>>>))
+{
+    typedef typename Param::template at<0> V;
+    constexpr auto StructSize = Param::template at<1>::value;
+    typedef typename V::EntryType T;
+    typedef typename V::IndexType I;
+    typedef SomeStruct<T, StructSize> S;
+    constexpr std::size_t N = 4096;
+    constexpr int Repetitions = 100;
+
+    S *data = Vc::malloc<S, Vc::AlignOnVector>(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        for (std::size_t j = 0; j < StructSize; ++j) {
+            data[i].d[j] = 1;
+        }
+    }
+    const Vc::InterleavedMemoryWrapper<S, V> data_v(data);
+    std::vector<I> indexes(N / V::Size);
+    for (auto &i : indexes) {
+        i = (I::Random() >> 10) & I(N - 1);
+    }
+
+    V sum = V::Zero();
+    const double gather = bestTime([&] {
+        for (int rep = 0; rep < Repetitions; ++rep) {
+            for (const I &i : indexes) {
+                const I scaled = i * I(StructSize);
+                for (std::size_t j = 0; j < StructSize; ++j) {
+                    sum += V(&data[0].d[j], scaled);
+                }
+            }
+        }
+    });
+    const double random = bestTime([&] {
+        for (int rep = 0; rep < Repetitions; ++rep) {
+            for (const I &i : indexes) {
+                sum += sumOfMembers(data_v, i, Vc::make_index_sequence<StructSize>());
+            }
+        }
+    });
+    const double successive = bestTime([&] {
+        for (int rep = 0; rep < Repetitions; ++rep) {
+            for (std::size_t i = 0; i < N; i += V::Size) {
+                sum += sumOfMembers(data_v, i, Vc::make_index_sequence<StructSize>());
+            }
+        }
+    });
+    VERIFY(all_of(sum > 0));
+
+    const double vectors = 1e-6 * Repetitions * N / V::Size;
+    std::cout << std::setw(2) << StructSize << " members, 10^6 vectors/s: gather "
+              << std::setw(6) << std::setprecision(4) << vectors / gather
+              << ", deinterleave " << std::setw(6) << vectors / random << ", successive "
+              << std::setw(6) << vectors / successive << '\n';
+    Vc::free(data);
+}
+
 // vim: foldmethod=marker
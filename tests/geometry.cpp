@@ -0,0 +1,280 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include "unittest.h"
+#include <Vc/Geometry>
+#include <Vc/simdize>
+#include <cmath>
+#include <random>
+
+using namespace Vc::Geometry;
+
+#define GEOMETRY_TYPES (REAL_VECTORS, SIMD_REAL_ARRAYS(3), SIMD_REAL_ARRAYS(8))
+
+template <typename V> static V uniform(std::default_random_engine &engine, float lo, float hi)
+{
+    std::uniform_real_distribution<float> dist(lo, hi);
+    V r;
+    for (std::size_t i = 0; i < V::Size; ++i) {
+        r[i] = dist(engine);
+    }
+    return r;
+}
+
+template <typename V> static point3<V> randomPoint(std::default_random_engine &engine)
+{
+    return {uniform<V>(engine, -1, 1), uniform<V>(engine, -1, 1), uniform<V>(engine, -1, 1)};
+}
+
+template <typename T, typename V> static point3<T> lane(const point3<V> &p, std::size_t i)
+{
+    return {p.x[i], p.y[i], p.z[i]};
+}
+
+TEST_TYPES(V, aabbContains, GEOMETRY_TYPES)
+{
+    typedef typename V::value_type T;
+    std::default_random_engine engine;
+    const aabb<T> box = {{T(0.2), T(0.3), T(0.4)}, {T(0.5), T(0.3), T(0.1)}};
+    for (int repetition = 0; repetition < 1000; ++repetition) {
+        const point3<V> p = randomPoint<V>(engine);
+        const auto inside = contains(box, p);
+        const V in = safety_to_in(box, p);
+        const V out = safety_to_out(box, p);
+        for (std::size_t i = 0; i < V::Size; ++i) {
+            const point3<T> q = lane<T>(p, i);
+            const T dx = std::abs(q.x - box.center.x) - box.half.x;
+            const T dy = std::abs(q.y - box.center.y) - box.half.y;
+            const T dz = std::abs(q.z - box.center.z) - box.half.z;
+            COMPARE(bool(inside[i]), dx < 0 && dy < 0 && dz < 0);
+            COMPARE(out[i], -std::max(std::max(dx, dy), dz));
+            const T ex = std::max(dx, T()), ey = std::max(dy, T()), ez = std::max(dz, T());
+            COMPARE_RELATIVE_ERROR(in[i], std::sqrt(ex * ex + ey * ey + ez * ez), 1e-6);
+            COMPARE(in[i] > 0, !inside[i] && (dx > 0 || dy > 0 || dz > 0));
+        }
+    }
+}
+
+TEST_TYPES(V, obbContains, GEOMETRY_TYPES)
+{
+    typedef typename V::value_type T;
+    std::default_random_engine engine;
+    // rotated by 30° about z
+    const T c = std::sqrt(T(3)) / 2, s = T(0.5);
+    const obb<T> box = {{T(0.1), T(-0.2), T(0)},
+                        {T(0.6), T(0.2), T(0.3)},
+                        {{c, s, 0}, {-s, c, 0}, {0, 0, 1}}};
+    for (int repetition = 0; repetition < 1000; ++repetition) {
+        const point3<V> p = randomPoint<V>(engine);
+        const auto inside = contains(box, p);
+        for (std::size_t i = 0; i < V::Size; ++i) {
+            const point3<T> d = lane<T>(p, i) - box.center;
+            const T u = c * d.x + s * d.y, v = -s * d.x + c * d.y;
+            // skip points within rounding distance of the surface
+            if (std::abs(std::abs(u) - box.half.x) < 1e-5 ||
+                std::abs(std::abs(v) - box.half.y) < 1e-5) {
+                continue;
+            }
+            COMPARE(bool(inside[i]),
+                    std::abs(u) < box.half.x && std::abs(v) < box.half.y &&
+                        std::abs(d.z) < box.half.z)
+                << "u: " << u << " v: " << v;
+        }
+    }
+
+    // without rotation, an obb is an aabb
+    const obb<T> axisAligned = {{T(0.2), T(0.3), T(0.4)},
+                                {T(0.5), T(0.3), T(0.1)},
+                                {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}};
+    const aabb<T> reference = {axisAligned.center, axisAligned.half};
+    for (int repetition = 0; repetition < 100; ++repetition) {
+        const point3<V> p = randomPoint<V>(engine);
+        COMPARE(contains(axisAligned, p), contains(reference, p));
+    }
+}
+
+TEST_TYPES(V, polygonContains, GEOMETRY_TYPES)
+{
+    typedef typename V::value_type T;
+    typedef typename V::mask_type M;
+    // an L shape: the unit square without its upper right quarter
+    const point2<T> corners[] = {{0, 0}, {1, 0}, {1, T(0.5)}, {T(0.5), T(0.5)},
+                                 {T(0.5), 1}, {0, 1}};
+    const polygon<T> L(corners, 6);
+    COMPARE(L.edges().size(), 6u);
+    const auto referenceInside = [](T x, T y) {
+        return x > 0 && y > 0 && x < 1 && y < 1 && (x < T(0.5) || y < T(0.5));
+    };
+
+    std::default_random_engine engine;
+    for (int repetition = 0; repetition < 1000; ++repetition) {
+        const point2<V> p = {uniform<V>(engine, -0.2f, 1.2f), uniform<V>(engine, -0.2f, 1.2f)};
+        const M inside = contains(L, p);
+        for (std::size_t i = 0; i < V::Size; ++i) {
+            COMPARE(bool(inside[i]), referenceInside(p.x[i], p.y[i]))
+                << "x: " << p.x[i] << " y: " << p.y[i];
+        }
+    }
+
+    // a triangle given counterclockwise, from an initializer list
+    const polygon<T> tri = {{0, 0}, {2, 0}, {0, 2}};
+    COMPARE(contains(tri, point2<V>(V(T(0.5)), V(T(0.5)))), M(true));
+    COMPARE(contains(tri, point2<V>(V(T(1.5)), V(T(1.5)))), M(false));
+    COMPARE(contains(tri, point2<V>(V(T(-0.1)), V(T(1)))), M(false));
+    COMPARE(contains(polygon<T>(), point2<V>(V::Zero(), V::Zero())), M(false));
+}
+
+TEST_TYPES(V, rayBox, GEOMETRY_TYPES)
+{
+    typedef typename V::value_type T;
+    typedef typename V::mask_type M;
+    const aabb<T> box = {{0, 0, 0}, {1, 2, 3}};
+    const T inf = std::numeric_limits<T>::infinity();
+    V tNear, tFar;
+
+    // along +x from x = -5: enters at t = 4, leaves at t = 6
+    M hit = intersect(box, point3<V>(V(T(-5)), V::Zero(), V::Zero()),
+                      point3<V>(V::One(), V(inf), V(inf)), tNear, tFar);
+    COMPARE(hit, M(true));
+    COMPARE(tNear, V(T(4)));
+    COMPARE(tFar, V(T(6)));
+
+    // the same ray pointing away misses
+    hit = intersect(box, point3<V>(V(T(-5)), V::Zero(), V::Zero()),
+                    point3<V>(-V::One(), V(inf), V(inf)), tNear, tFar);
+    COMPARE(hit, M(false));
+
+    // from inside: t_near < 0 and t_far the exit distance
+    hit = intersect(box, point3<V>(V::Zero(), V::Zero(), V::Zero()),
+                    point3<V>(V(inf), V(inf), V(T(0.5))), tNear, tFar);
+    COMPARE(hit, M(true));
+    COMPARE(tFar, V(T(1.5)));
+    VERIFY(all_of(tNear < V::Zero()));
+
+    // diagonal rays past the box
+    std::default_random_engine engine;
+    for (int repetition = 0; repetition < 1000; ++repetition) {
+        const point3<V> o = {uniform<V>(engine, -10, 10), uniform<V>(engine, -10, 10),
+                             V(T(-10))};
+        const point3<V> d = {uniform<V>(engine, -1, 1), uniform<V>(engine, -1, 1), V::One()};
+        hit = intersect(box, o, point3<V>(V::One() / d.x, V::One() / d.y, V::One()), tNear,
+                        tFar);
+        for (std::size_t i = 0; i < V::Size; ++i) {
+            // the ray crosses z = -3 ... 3 in t = 7 ... 13; sample it
+            bool sampledHit = false;
+            for (int j = 0; j <= 1000; ++j) {
+                const T t = T(7) + T(6) * j / 1000;
+                sampledHit |= std::abs(o.x[i] + t * d.x[i]) < 1 &&
+                              std::abs(o.y[i] + t * d.y[i]) < 2;
+            }
+            if (sampledHit) {
+                VERIFY(hit[i]);
+            }
+            if (hit[i] && tFar[i] - tNear[i] > T(0.1)) {
+                VERIFY(sampledHit);
+            }
+        }
+    }
+}
+
+TEST_TYPES(V, rayTriangle, GEOMETRY_TYPES)
+{
+    typedef typename V::value_type T;
+    typedef typename V::mask_type M;
+    const triangle<T> tri = {{0, 0, 1}, {1, 0, 1}, {0, 1, 1}};
+    std::default_random_engine engine;
+    for (int repetition = 0; repetition < 1000; ++repetition) {
+        // rays parallel to z through random points of the plane z = 0
+        const point3<V> o = {uniform<V>(engine, -0.5f, 1.5f), uniform<V>(engine, -0.5f, 1.5f),
+                             V::Zero()};
+        V t;
+        const M hit = intersect(tri, o, point3<V>(V::Zero(), V::Zero(), V::One()), t);
+        for (std::size_t i = 0; i < V::Size; ++i) {
+            const T x = o.x[i], y = o.y[i];
+            if (std::abs(x) < 1e-5 || std::abs(y) < 1e-5 || std::abs(x + y - 1) < 1e-5) {
+                continue;
+            }
+            COMPARE(bool(hit[i]), x > 0 && y > 0 && x + y < 1);
+            if (hit[i]) {
+                COMPARE_ABSOLUTE_ERROR(t[i], T(1), T(1e-6));
+            } else {
+                COMPARE(t[i], std::numeric_limits<T>::infinity());
+            }
+        }
+    }
+    // the other direction and a parallel ray miss
+    V t;
+    const point3<V> o(V(T(0.2)), V(T(0.2)), V::Zero());
+    COMPARE(intersect(tri, o, point3<V>(V::Zero(), V::Zero(), -V::One()), t), M(false));
+    COMPARE(intersect(tri, o, point3<V>(V::One(), V::Zero(), V::Zero()), t), M(false));
+    // a slanted ray: o + t * (0.1, 0.1, 2) hits z = 1 at t = 0.5
+    COMPARE(intersect(tri, o, point3<V>(V(T(0.1)), V(T(0.1)), V(T(2))), t), M(true));
+    for (std::size_t i = 0; i < V::Size; ++i) {
+        COMPARE_ABSOLUTE_ERROR(t[i], T(0.5), T(1e-6));
+    }
+}
+
+TEST_TYPES(V, polar, GEOMETRY_TYPES)
+{
+    typedef typename V::value_type T;
+    std::default_random_engine engine;
+    for (int repetition = 0; repetition < 1000; ++repetition) {
+        const point2<V> p = {uniform<V>(engine, -10, 10), uniform<V>(engine, -10, 10)};
+        V r, phi;
+        to_polar(p, r, phi);
+        for (std::size_t i = 0; i < V::Size; ++i) {
+            COMPARE_RELATIVE_ERROR(r[i], std::hypot(p.x[i], p.y[i]), 1e-6);
+            COMPARE_ABSOLUTE_ERROR(phi[i], std::atan2(p.y[i], p.x[i]), T(1e-6));
+        }
+        const point2<V> q = from_polar(r, phi);
+        for (std::size_t i = 0; i < V::Size; ++i) {
+            COMPARE_ABSOLUTE_ERROR(q.x[i], p.x[i], T(1e-5));
+            COMPARE_ABSOLUTE_ERROR(q.y[i], p.y[i], T(1e-5));
+        }
+    }
+}
+
+TEST(soaPoints)
+{
+    // the usage from the documentation: simdize<point3<float>> is a point3<float_v>
+    typedef Vc::simdize<point3<float>> P;
+    static_assert(P::size() == Vc::float_v::Size, "");
+    const aabb<float> box = {{0, 0, 0}, {1, 1, 1}};
+    Vc::soa_vector<point3<float>> points;
+    for (int i = 0; i < 37; ++i) {
+        points.push_back(point3<float>(i * 0.1f - 1.85f, 0.5f, -0.5f));
+    }
+    std::size_t inside = 0;
+    for (auto &&chunk : points.vectors()) {
+        const P p = chunk;
+        inside += (contains(box, p) && chunk.mask()).count();
+    }
+    // x = -0.95 ... 0.95
+    COMPARE(inside, 20u);
+    COMPARE(distance(point3<float>(0, 0, 0), point3<float>(3, 4, 0)), 5.f);
+}
@@ -0,0 +1,192 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include "unittest.h"
+#include <Vc/Interpolation>
+#include <random>
+#include <vector>
+#ifdef __unix__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using Vc::GridInterpolator;
+using Vc::float_v;
+
+template <typename T> T tolerance() { return T(std::is_same<T, float>::value ? 1e-4 : 1e-10); }
+
+#define COMPARE_TOLERANCE(a_, b_, T_)                                                    \
+    VERIFY(std::abs((a_) - (b_)) <= tolerance<T_>() * (1 + std::abs(b_))) << (a_)      \
+                                                                            << " vs. " << (b_)
+
+// A polynomial that the interpolation of the given order reproduces exactly: multilinear
+// for Order 1, and quadratic in every coordinate otherwise.
+template <std::size_t Order, typename T, std::size_t Dim>
+T polynomial(const std::array<T, Dim> &x)
+{
+    T r = 1;
+    for (std::size_t d = 0; d < Dim; ++d) {
+        r += T(d + 1) * x[d];
+    }
+    r += Order == 1 ? x[0] * x[Dim - 1] : T(0.5) * x[0] * x[0];
+    return Dim > 1 || Order > 1 ? r : r - x[0] * x[0];
+}
+
+template <std::size_t Dim, std::size_t Order, typename T> void testReproduction()
+{
+    typedef GridInterpolator<Dim, Order, T> G;
+    typedef typename G::point_type P;
+    typedef typename G::vector_type V;
+    P min, max;
+    std::array<std::size_t, Dim> nodes;
+    for (std::size_t d = 0; d < Dim; ++d) {
+        min[d] = T(-1) - T(d);
+        max[d] = T(2) + T(d);
+        nodes[d] = 5 + 3 * d;
+    }
+    G grid(min, max, nodes);
+    grid.fill([](const P &x) { return polynomial<Order>(x); });
+    for (std::size_t d = 0; d < Dim; ++d) {
+        COMPARE(grid.nodeCount(d), nodes[d]);
+    }
+
+    std::default_random_engine engine(Dim * 10 + Order);
+    std::vector<P> points(5 * V::Size + 3);
+    for (auto &p : points) {
+        for (std::size_t d = 0; d < Dim; ++d) {
+            // include positions slightly outside of the grid (extrapolation)
+            p[d] = std::uniform_real_distribution<T>(min[d] - T(0.5), max[d] + T(0.5))(engine);
+        }
+    }
+    std::vector<T> results(points.size());
+    grid.evaluate(points.data(), results.data(), points.size());
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        const T reference = polynomial<Order>(points[i]);
+        COMPARE_TOLERANCE(grid(points[i]), reference, T);
+        COMPARE_TOLERANCE(results[i], reference, T);
+    }
+
+    typename G::point_vector pv;
+    for (std::size_t d = 0; d < Dim; ++d) {
+        pv[d] = V::generate([&](std::size_t lane) { return points[lane][d]; });
+    }
+    const V rv = grid(pv);
+    for (std::size_t lane = 0; lane < V::Size; ++lane) {
+        COMPARE_TOLERANCE(rv[lane], results[lane], T);
+    }
+}
+
+TEST_TYPES(T, reproduction, (float, double))
+{
+    testReproduction<1, 1, T>();
+    testReproduction<1, 2, T>();
+    testReproduction<1, 3, T>();
+    testReproduction<2, 1, T>();
+    testReproduction<2, 2, T>();
+    testReproduction<2, 3, T>();
+    testReproduction<3, 1, T>();
+    testReproduction<3, 2, T>();
+    testReproduction<3, 3, T>();
+}
+
+TEST(components)
+{
+    typedef std::array<float, 3> Vec3;
+    typedef GridInterpolator<3, 3, Vec3> G;
+    typedef GridInterpolator<3, 3, float> G1;
+    const Vec3 min = {{-1.f, -1.f, -2.f}};
+    const Vec3 max = {{1.f, 1.f, 2.f}};
+    const std::array<std::size_t, 3> nodes = {{9, 10, 17}};
+    G field(min, max, nodes);
+    std::array<G1, 3> components = {{G1(min, max, nodes), G1(min, max, nodes),
+                                     G1(min, max, nodes)}};
+    auto f = [](const Vec3 &x) {
+        return Vec3{{std::sin(x[0]) * x[1], x[2] * x[2] - x[0], std::cos(x[1] * x[2])}};
+    };
+    field.fill(f);
+    for (int c = 0; c < 3; ++c) {
+        components[c].fill([&](const Vec3 &x) { return f(x)[c]; });
+    }
+    COMPARE(field.node({{3, 4, 5}})[1], components[1].node({{3, 4, 5}}));
+    COMPARE(field.memorySize(), 12u * 12u * 20u * 4u * sizeof(float));
+
+    std::default_random_engine engine(1);
+    std::uniform_real_distribution<float> uniform(-1.f, 1.f);
+    std::vector<Vec3> points(3 * float_v::Size + 1);
+    for (auto &p : points) {
+        p = {{uniform(engine), uniform(engine), 2.f * uniform(engine)}};
+    }
+    std::vector<Vec3> results(points.size());
+    field.evaluate(points.data(), results.data(), points.size());
+
+    G::point_vector pv;
+    for (std::size_t d = 0; d < 3; ++d) {
+        pv[d] = float_v::generate([&](std::size_t lane) { return points[lane][d]; });
+    }
+    const G::value_vector rv = field(pv);
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        const Vec3 r = field(points[i]);
+        for (int c = 0; c < 3; ++c) {
+            COMPARE(r[c], components[c](points[i]));
+            COMPARE_TOLERANCE(results[i][c], r[c], float);
+            if (i < float_v::Size) {
+                COMPARE_TOLERANCE(rv[c][i], r[c], float);
+            }
+        }
+    }
+}
+
+#ifdef __unix__
+// positions that end right before an inaccessible page
+TEST_TYPES(T, evaluateBeforeGuardPage, (float, double))
+{
+    typedef GridInterpolator<3, 1, T> G;
+    typedef typename G::point_type P;
+    constexpr std::size_t N = 2 * G::vector_type::Size;
+    G grid({{T(-1), T(-1), T(-1)}}, {{T(1), T(1), T(1)}}, {{5, 5, 5}});
+    grid.fill([](const P &x) { return polynomial<1>(x); });
+
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    char *pages = static_cast<char *>(mmap(nullptr, 2 * pageSize, PROT_READ | PROT_WRITE,
+                                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    VERIFY(pages != MAP_FAILED);
+    VERIFY(mprotect(pages + pageSize, pageSize, PROT_NONE) == 0);
+    P *const points = reinterpret_cast<P *>(pages + pageSize) - N;
+    for (std::size_t i = 0; i < N; ++i) {
+        points[i] = {{T(i) / N, T(-0.5), T(1) - T(i) / N}};
+    }
+    std::vector<T> results(N);
+    grid.evaluate(points, results.data(), N);
+    for (std::size_t i = 0; i < N; ++i) {
+        COMPARE_TOLERANCE(results[i], polynomial<1>(points[i]), T);
+    }
+    munmap(pages, 2 * pageSize);
+}
+#endif
+
+// vim: foldmethod=marker
@@ -27,6 +27,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 }}}*/
 
 #include "unittest.h"
+#ifdef __unix__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 using namespace Vc;
 
@@ -134,6 +138,70 @@ TEST_TYPES(Vec, loadArray, ALL_TYPES)
     tmp0.load(array, Vc::Aligned);
 }
 
+TEST_TYPES(Vec, maskedLoad, (ALL_VECTORS, SIMD_ARRAYS(3), SIMD_ARRAYS(17)))
+{
+    typedef typename Vec::EntryType T;
+    typedef typename Vec::Mask M;
+    typedef typename Vec::IndexType I;
+
+    T *array = Vc::malloc<T, Vc::AlignOnCacheline>(128);
+    for (size_t i = 0; i < 128; ++i) {
+        array[i] = T(i + 1);
+    }
+    const Vec old(T(-1));
+    for (size_t offset = 0; offset + Vec::Size <= 128; ++offset) {
+        const T *const addr = &array[offset];
+        for (int n = 0; n <= int(Vec::Size); ++n) {
+            const M k = simd_cast<M>(I::IndexesFromZero() < n);
+            const M odd = simd_cast<M>((I::IndexesFromZero() & 1) == 1);
+            Vec a = old;
+            Vec b = old;
+            if (reinterpret_cast<std::uintptr_t>(addr) % Vec::MemoryAlignment == 0) {
+                a.load(addr, k, Vc::Aligned);
+                b.load(addr, odd, Vc::Aligned | Vc::Streaming);
+            } else {
+                a.load(addr, k);
+                b.load(addr, odd, Vc::Unaligned);
+            }
+            for (size_t j = 0; j < Vec::Size; ++j) {
+                COMPARE(a[j], k[j] ? T(offset + j + 1) : T(-1)) << "offset: " << offset
+                                                               << ", mask: " << k;
+                COMPARE(b[j], odd[j] ? T(offset + j + 1) : T(-1)) << "offset: " << offset;
+            }
+        }
+    }
+    Vc::free(array);
+}
+
+#ifdef __unix__
+// inactive entries in an inaccessible page must not fault
+TEST_TYPES(Vec, maskedLoadPageBoundary, (ALL_VECTORS))
+{
+    typedef typename Vec::EntryType T;
+    typedef typename Vec::Mask M;
+    typedef typename Vec::IndexType I;
+
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    char *pages = static_cast<char *>(mmap(nullptr, 2 * pageSize, PROT_READ | PROT_WRITE,
+                                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    VERIFY(pages != MAP_FAILED);
+    VERIFY(mprotect(pages + pageSize, pageSize, PROT_NONE) == 0);
+    T *const end = reinterpret_cast<T *>(pages + pageSize);
+    for (int n = 0; n <= int(Vec::Size); ++n) {
+        const T *const addr = end - n;
+        for (int i = 0; i < n; ++i) {
+            end[i - n] = T(i + 1);
+        }
+        Vec v = Vec::Zero();
+        v.load(addr, simd_cast<M>(I::IndexesFromZero() < n));
+        for (size_t j = 0; j < Vec::Size; ++j) {
+            COMPARE(v[j], int(j) < n ? T(j + 1) : T(0)) << "n: " << n;
+        }
+    }
+    munmap(pages, 2 * pageSize);
+}
+#endif
+
 TEST_TYPES(Vec, streamingLoad, ALL_TYPES)
 {
     typedef typename Vec::EntryType T;
@@ -295,6 +295,100 @@ TEST_TYPES(Vec, testFirstOne, ALL_TYPES) /*{{{*/
     }
 }
 /*}}}*/
+TEST_TYPES(Vec, testLastOne, (ALL_VECTORS, SIMD_ARRAYS(16), SIMD_ARRAYS(31))) /*{{{*/
+{
+    typedef typename Vec::Mask M;
+
+    UnitTest::withRandomMask<Vec>([](const M &k) {
+        if (k.isEmpty()) {
+            return;
+        }
+        int last = 0;
+        for (size_t i = 0; i < Vec::Size; ++i) {
+            if (k[i]) {
+                last = i;
+            }
+        }
+        COMPARE(k.lastOne(), last) << k;
+    });
+}
+/*}}}*/
+TEST_TYPES(Vec, maskPrefixCount, (ALL_VECTORS, SIMD_ARRAYS(16), SIMD_ARRAYS(31), SIMD_ARRAYS(3))) /*{{{*/
+{
+    typedef typename Vec::Mask M;
+
+    UnitTest::withRandomMask<Vec>([](const M &k) {
+        const auto prefix = Vc::mask_prefix_count(k);
+        const auto indexes = Vc::mask_to_indexes(k);
+        COMPARE(prefix.size(), Vec::Size);
+        int count = 0;
+        for (size_t i = 0; i < Vec::Size; ++i) {
+            COMPARE(prefix[i], count) << "i: " << i << ", k: " << k;
+            if (k[i]) {
+                COMPARE(indexes[count], int(i)) << "count: " << count << ", k: " << k;
+                ++count;
+            }
+        }
+        for (size_t i = count; i < Vec::Size; ++i) {
+            COMPARE(indexes[i], 0) << "i: " << i << ", k: " << k;
+        }
+    });
+}
+/*}}}*/
+TEST_TYPES(Vec, compressExpand, (ALL_VECTORS, SIMD_ARRAYS(16), SIMD_ARRAYS(31))) /*{{{*/
+{
+    typedef typename Vec::Mask M;
+    typedef typename Vec::EntryType T;
+
+    UnitTest::withRandomMask<Vec>([](const M &k) {
+        const Vec x = Vec::IndexesFromZero() + 1;
+        T mem[Vec::Size + 1];
+        std::fill_n(mem, Vec::Size + 1, T(-1));
+        const std::size_t n = Vc::compress_store(x, k, mem);
+        COMPARE(n, std::size_t(k.count())) << k;
+        std::size_t j = 0;
+        for (size_t i = 0; i < Vec::Size; ++i) {
+            if (k[i]) {
+                COMPARE(mem[j++], x[i]) << "i: " << i << ", k: " << k;
+            }
+        }
+        for (; j <= Vec::Size; ++j) {
+            COMPARE(mem[j], T(-1)) << "compress_store wrote past the end, k: " << k;
+        }
+
+        Vec y = Vec::Zero();
+        Vc::expand_load(y, mem, k);
+        COMPARE(y, iif(k, x, Vec::Zero())) << k;
+    });
+}
+/*}}}*/
+TEST_TYPES(Vec, packMasks, (ALL_VECTORS, SIMD_ARRAYS(16), SIMD_ARRAYS(31), SIMD_ARRAYS(3))) /*{{{*/
+{
+    typedef typename Vec::Mask M;
+
+    constexpr std::size_t Count = 67;
+    std::vector<M> masks(Count);
+    std::vector<M> unpacked(Count);
+    std::vector<std::uint64_t> bits((Count * Vec::Size + 63) / 64 + 1, ~0ull);
+    for (int repetition = 0; repetition < 100; ++repetition) {
+        for (auto &k : masks) {
+            k = Vec::Random() < Vec::Random();
+        }
+        const std::size_t words = Vc::pack_masks(masks.data(), masks.data() + Count, bits.data());
+        COMPARE(words, (Count * Vec::Size + 63) / 64);
+        COMPARE(bits[words], ~0ull) << "pack_masks wrote past the end";
+        for (std::size_t bit = 0; bit < words * 64; ++bit) {
+            const bool expected =
+                bit < Count * Vec::Size ? masks[bit / Vec::Size][bit % Vec::Size] : false;
+            COMPARE(((bits[bit / 64] >> (bit % 64)) & 1) != 0, expected) << "bit: " << bit;
+        }
+        Vc::unpack_masks(bits.data(), unpacked.data(), unpacked.data() + Count);
+        for (std::size_t i = 0; i < Count; ++i) {
+            COMPARE(unpacked[i], masks[i]) << "i: " << i;
+        }
+    }
+}
+/*}}}*/
 TEST_TYPES(V, shifted, (ALL_VECTORS, SIMD_ARRAYS(16), SIMD_ARRAYS(31)))/*{{{*/
 {
     using M = typename V::Mask;
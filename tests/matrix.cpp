@@ -0,0 +1,274 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include "unittest.h"
+#include <Vc/Matrix>
+#include <Vc/simdize>
+#include <vector>
+
+using Vc::SmallMatrix;
+
+template <typename T> T tolerance() { return T(std::is_same<T, float>::value ? 2e-3 : 1e-10); }
+
+// Returns a diagonally dominant matrix with different values in every lane. The first two
+// rows are swapped in every other lane, forcing inverse() to pivot.
+template <typename V, std::size_t N> SmallMatrix<V, N> makeInvertible(int seed)
+{
+    using T = typename V::EntryType;
+    SmallMatrix<V, N> a;
+    for (std::size_t i = 0; i < N; ++i) {
+        for (std::size_t j = 0; j < N; ++j) {
+            a(i, j) = V::generate([&](std::size_t lane) {
+                return T(int((i * 7 + j * 3 + lane * 5 + seed) % 11) - 5) * T(0.1);
+            });
+        }
+        a(i, i) += T(N);
+    }
+    for (std::size_t j = 0; j < N; ++j) {
+        const V r0 = a(0, j);
+        const V r1 = a(1, j);
+        a(0, j) = V::generate([&](std::size_t lane) { return lane % 2 ? r1[lane] : r0[lane]; });
+        a(1, j) = V::generate([&](std::size_t lane) { return lane % 2 ? r0[lane] : r1[lane]; });
+    }
+    return a;
+}
+
+template <typename V, std::size_t N> SmallMatrix<V, N> makeSpd(int seed)
+{
+    const auto b = makeInvertible<V, N>(seed);
+    return b * Vc::transpose(b);
+}
+
+template <typename V, std::size_t R, std::size_t C>
+void compareMatrices(const SmallMatrix<V, R, C> &a, const SmallMatrix<V, R, C> &b)
+{
+    using T = typename V::EntryType;
+    for (std::size_t i = 0; i < R; ++i) {
+        for (std::size_t j = 0; j < C; ++j) {
+            VERIFY(all_of(abs(a(i, j) - b(i, j)) < tolerance<T>()))
+                << "\n(" << i << ", " << j << "): " << a(i, j) << " vs. " << b(i, j);
+        }
+    }
+}
+
+TEST_TYPES(V, smallMatrixMultiply, (REAL_VECTORS, SIMD_REAL_ARRAYS(7))) //{{{1
+{
+    using T = typename V::EntryType;
+    SmallMatrix<V, 3, 5> a;
+    SmallMatrix<V, 5, 2> b;
+    for (std::size_t i = 0; i < 5; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+            a(j, i) = V::Random();
+        }
+        for (std::size_t j = 0; j < 2; ++j) {
+            b(i, j) = V::Random();
+        }
+    }
+    const SmallMatrix<V, 3, 2> c = a * b;
+    for (std::size_t lane = 0; lane < V::Size; ++lane) {
+        for (std::size_t i = 0; i < 3; ++i) {
+            for (std::size_t j = 0; j < 2; ++j) {
+                T ref = 0;
+                for (std::size_t k = 0; k < 5; ++k) {
+                    ref += a(i, k)[lane] * b(k, j)[lane];
+                }
+                FUZZY_COMPARE(T(c(i, j)[lane]), ref);
+            }
+        }
+    }
+}
+
+TEST_TYPES(V, smallMatrixInverse, (REAL_VECTORS, SIMD_REAL_ARRAYS(7))) //{{{1
+{
+    const auto a2 = makeInvertible<V, 2>(1);
+    compareMatrices(a2 * Vc::inverse(a2), SmallMatrix<V, 2>::identity());
+    const auto a5 = makeInvertible<V, 5>(2);
+    compareMatrices(a5 * Vc::inverse(a5), SmallMatrix<V, 5>::identity());
+    const auto a8 = makeInvertible<V, 8>(3);
+    compareMatrices(Vc::inverse(a8) * a8, SmallMatrix<V, 8>::identity());
+}
+
+TEST_TYPES(V, smallMatrixCholesky, (REAL_VECTORS, SIMD_REAL_ARRAYS(7))) //{{{1
+{
+    using T = typename V::EntryType;
+    const auto a = makeSpd<V, 6>(4);
+    const auto l = Vc::cholesky(a);
+    for (std::size_t i = 0; i < 6; ++i) {
+        for (std::size_t j = i + 1; j < 6; ++j) {
+            COMPARE(l(i, j), V::Zero());
+        }
+    }
+    // scale down to get an absolute tolerance
+    const V scale = T(1) / a(1, 1);
+    compareMatrices(l * Vc::transpose(l) * scale, a * scale);
+    compareMatrices(Vc::choleskyInverse(a) * a, SmallMatrix<V, 6>::identity());
+}
+
+TEST(smallMatrixScalar) //{{{1
+{
+    const SmallMatrix<double, 2> a(4., 2., 2., 3.);
+    const auto l = Vc::cholesky(a);
+    COMPARE(l(0, 0), 2.);
+    COMPARE(l(1, 0), 1.);
+    COMPARE(l(0, 1), 0.);
+    FUZZY_COMPARE(l(1, 1), std::sqrt(2.));
+    const auto ai = Vc::inverse(SmallMatrix<double, 2>(0., 1., 2., 0.));
+    COMPARE(ai(0, 0), 0.);
+    COMPARE(ai(0, 1), .5);
+    COMPARE(ai(1, 0), 1.);
+    COMPARE(ai(1, 1), 0.);
+}
+
+TEST(smallMatrixSimdize) //{{{1
+{
+    using M = SmallMatrix<float, 3>;
+    using MV = Vc::simdize<M>;
+    static_assert(std::is_base_of<SmallMatrix<Vc::float_v, 3>, MV>::value, "");
+    MV mv = M(1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f);
+    COMPARE(mv(2, 1), Vc::float_v(8.f));
+    for (std::size_t i = 0; i < MV::size(); ++i) {
+        assign(mv, i, M(i + 1, 0, 0, 0, i + 2, 0, 0, 0, i + 3));
+    }
+    const auto inv = Vc::inverse(mv);
+    for (std::size_t i = 0; i < MV::size(); ++i) {
+        const M m = extract(mv, i);
+        COMPARE(m(1, 1), float(i + 2));
+        COMPARE(inv(2, 2)[i], 1.f / (i + 3));
+    }
+}
+
+TEST_TYPES(V, symMatrix, (REAL_VECTORS, SIMD_REAL_ARRAYS(7))) //{{{1
+{
+    using T = typename V::EntryType;
+    using Vc::SymMatrix;
+    const SymMatrix<V, 5> c(makeSpd<V, 5>(5));
+    COMPARE((SymMatrix<V, 5>::PackedSize), 15u);
+    COMPARE(c(1, 3), c(3, 1));
+    const SmallMatrix<V, 5> full = c.unpacked();
+    const SmallMatrix<V, 5> a = makeInvertible<V, 5>(6);
+    SmallMatrix<V, 3, 5> a3;
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 5; ++j) {
+            a3(i, j) = a(i, j);
+        }
+    }
+    const SymMatrix<V, 3> r = Vc::similarity(a3, c);
+    const SmallMatrix<V, 3> ref = a3 * full * Vc::transpose(a3);
+    const V scale = T(1) / ref(0, 0);
+    compareMatrices(r.unpacked() * scale, ref * scale);
+
+    const SmallMatrix<V, 5> f = makeInvertible<V, 5>(7);
+    SymMatrix<V, 5> c2 = c;
+    Vc::similarityTransform(c2, f);
+    const SmallMatrix<V, 5> ref2 = f * full * Vc::transpose(f);
+    const V scale2 = T(1) / ref2(0, 0);
+    compareMatrices(c2.unpacked() * scale2, ref2 * scale2);
+
+    const Vc::Vec<V, 5> v(V(T(1)), V(T(-2)), V::IndexesFromZero(), V(T(0.5)), V(T(3)));
+    SymMatrix<V, 5> c3 = c;
+    Vc::rank1Update(c3, v, V(T(2)));
+    for (std::size_t i = 0; i < 5; ++i) {
+        for (std::size_t j = 0; j < 5; ++j) {
+            FUZZY_COMPARE(c3(i, j), c(i, j) + T(2) * v[i] * v[j]);
+        }
+    }
+    FUZZY_COMPARE(Vc::similarity(v, c), Vc::dot(v, full * v));
+}
+
+TEST_TYPES(V, kalmanUpdate, (REAL_VECTORS, SIMD_REAL_ARRAYS(7))) //{{{1
+{
+    using T = typename V::EntryType;
+    using Vc::SymMatrix;
+    using Vc::Vec;
+    Vec<V, 3> x(V(T(1)), V(T(2)), V(T(3)));
+    SymMatrix<V, 3> c(V(T(4)), V(T(1)), V(T(3)), V(T(0)), V(T(0.5)), V(T(2)));
+    const Vec<V, 3> h(V(T(1)), V(T(0)), V(T(0)));
+    const V m = V::IndexesFromZero();
+    const V variance = T(1);
+    const SmallMatrix<V, 3> c0 = c.unpacked();
+    const V chi2 = Vc::kalmanUpdate(x, c, h, m, variance);
+    // reference: gain k = C hᵀ / (h C hᵀ + σ²) = column 0 of C / 5
+    for (std::size_t i = 0; i < 3; ++i) {
+        const V k = c0(i, 0) / T(5);
+        FUZZY_COMPARE(x[i], V(T(i + 1)) + k * (m - T(1)));
+        for (std::size_t j = 0; j <= i; ++j) {
+            FUZZY_COMPARE(c(i, j), c0(i, j) - k * c0(0, j));
+        }
+    }
+    FUZZY_COMPARE(chi2, (m - T(1)) * (m - T(1)) / T(5));
+}
+
+TEST_TYPES(V, gemm, (REAL_VECTORS)) //{{{1
+{
+    using T = typename V::EntryType;
+    for (std::size_t m : {1, 5, 17}) {
+        for (std::size_t n : {std::size_t(1), 2 * V::Size, 2 * V::Size + 3, std::size_t(61)}) {
+            for (std::size_t k : {1, 9, 600}) {
+                std::vector<T> a(m * k), b(k * n), c(m * n), ref(m * n);
+                for (std::size_t i = 0; i < a.size(); ++i) {
+                    a[i] = T(int(i % 13) - 6) / 8;
+                }
+                for (std::size_t i = 0; i < b.size(); ++i) {
+                    b[i] = T(int(i % 7) - 3) / 4;
+                }
+                for (std::size_t i = 0; i < c.size(); ++i) {
+                    c[i] = ref[i] = T(i % 5);
+                }
+                for (std::size_t i = 0; i < m; ++i) {
+                    for (std::size_t j = 0; j < n; ++j) {
+                        for (std::size_t p = 0; p < k; ++p) {
+                            ref[i * n + j] += a[i * k + p] * b[p * n + j];
+                        }
+                    }
+                }
+                Vc::gemm(m, n, k, a.data(), k, b.data(), n, c.data(), n);
+                // all products and partial sums are exactly representable
+                for (std::size_t i = 0; i < c.size(); ++i) {
+                    COMPARE(c[i], ref[i]) << "m: " << m << ", n: " << n << ", k: " << k
+                                          << ", i: " << i;
+                }
+            }
+        }
+    }
+
+    Vc::PitchedMemory<V, 2> pa(3, 4), pb(4, 5), pc(3, 5);
+    for (std::size_t i = 0; i < 4; ++i) {
+        pa(i % 3, i) = 1;
+        for (std::size_t j = 0; j < 5; ++j) {
+            pb(i, j) = T(i * 5 + j);
+        }
+    }
+    Vc::gemm(pa, pb, pc);
+    for (std::size_t j = 0; j < 5; ++j) {
+        COMPARE(pc(0, j), T(j + 15 + j));
+        COMPARE(pc(1, j), T(j + 5));
+        COMPARE(pc(2, j), T(j + 10));
+    }
+}
+
+// vim: foldmethod=marker
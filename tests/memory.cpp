@@ -331,6 +331,107 @@ template<typename V> void testCopyAssignment()
     }
 }
 
+template<typename V> void pitchedMemory2D()
+{
+    typedef typename V::EntryType T;
+    for (size_t cols : {size_t(1), V::Size - 1, V::Size, size_t(37), size_t(1024)}) {
+        if (cols == 0) {
+            continue;
+        }
+        PitchedMemory<V, 2> m(5, cols);
+        COMPARE(m.size(0), 5u);
+        COMPARE(m.size(1), cols);
+        COMPARE(m.pitch() % V::Size, 0u);
+        VERIFY(m.pitch() >= cols);
+        VERIFY((m.pitch() * sizeof(T)) % 512 != 0) << "pitch: " << m.pitch();
+        for (size_t i = 0; i < m.size(0); ++i) {
+            COMPARE(reinterpret_cast<std::uintptr_t>(m.row(i)) % V::MemoryAlignment, 0u);
+            for (size_t j = 0; j < cols; ++j) {
+                m(i, j) = T((i + j) % 100);
+            }
+        }
+        for (size_t i = 0; i < m.size(0); ++i) {
+            for (size_t j = 0; j < m.vectorsPerRow(); ++j) {
+                const V reference = V::generate([&](size_t k) {
+                    return j * V::Size + k < cols ? T((i + j * V::Size + k) % 100) : T(0);
+                });
+                COMPARE(V(m.vector(i, j)), reference);
+                m.vector(i, j) += T(1);
+            }
+        }
+        for (size_t i = 0; i < m.size(0); ++i) {
+            for (size_t j = 0; j < cols; ++j) {
+                COMPARE(m(i, j), T((i + j) % 100 + 1));
+            }
+        }
+
+        PitchedMemory<V, 2> copy(m);
+        COMPARE(copy.pitch(), m.pitch());
+        for (size_t j = 0; j < cols; ++j) {
+            COMPARE(copy(4, j), m(4, j));
+        }
+    }
+}
+
+template<typename V> void pitchedMemory3D()
+{
+    typedef typename V::EntryType T;
+    PitchedMemory<V, 3> m(3, 4, 2 * V::Size + 1);
+    COMPARE(m.stride(2), 1u);
+    COMPARE(m.stride(1), m.pitch());
+    COMPARE(m.stride(0), m.pitch() * 4);
+    for (size_t i = 0; i < m.size(0); ++i) {
+        for (size_t j = 0; j < m.size(1); ++j) {
+            for (size_t k = 0; k < m.size(2); ++k) {
+                m(i, j, k) = T(i * 20 + j * 5 + k);
+            }
+        }
+    }
+    for (size_t i = 0; i < m.size(0); ++i) {
+        for (size_t j = 0; j < m.size(1); ++j) {
+            COMPARE(m.row(i, j)[1], T(i * 20 + j * 5 + 1));
+            COMPARE(V(m.vectorAt(i, j, 1)), V(m.row(i, j) + 1, Vc::Unaligned));
+        }
+    }
+
+    PitchedMemory<V, 3> explicitPitch({{2, 2, 3}}, 4 * V::Size);
+    COMPARE(explicitPitch.pitch(), 4 * V::Size);
+    COMPARE(explicitPitch(1, 1, 2), T(0));
+}
+
+template<typename V> void pitchedMemoryTiles()
+{
+    typedef typename V::EntryType T;
+    PitchedMemory<V, 2> m(23, 5 * V::Size + 3);
+    auto check = [&](const MemoryTileRange<2> &range) {
+        for (size_t i = 0; i < m.size(0); ++i) {
+            for (size_t j = 0; j < m.vectorsPerRow(); ++j) {
+                m.vector(i, j) = V::Zero();
+            }
+        }
+        for (const auto &tile : range) {
+            COMPARE(tile.begin(1) % V::Size, 0u);
+            COMPARE(tile.end(1) % V::Size, 0u);
+            for (size_t i = tile.begin(0); i < tile.end(0); ++i) {
+                for (size_t j = tile.begin(1); j < tile.end(1); j += V::Size) {
+                    m.vector(i, j / V::Size) += T(1);
+                }
+            }
+        }
+        for (size_t i = 0; i < m.size(0); ++i) {
+            for (size_t j = 0; j < m.vectorsPerRow(); ++j) {
+                COMPARE(V(m.vector(i, j)), V::One()) << "i: " << i << ", j: " << j;
+            }
+        }
+    };
+    check(m.tiles({{4, 2 * V::Size}}));
+    check(m.tiles({{5, 1}}));
+    check(m.tiles({{100, 100}}));
+    check(m.l1Tiles());
+    check(m.l2Tiles());
+    check(m.cacheTiles(64));
+}
+
 void testmain()
 {
     testAllTypes(testEntries);
@@ -345,4 +446,7 @@ void testmain()
     testAllTypes(memoryOperators);
     testAllTypes(testCCtor);
     testAllTypes(testCopyAssignment);
+    testAllTypes(pitchedMemory2D);
+    testAllTypes(pitchedMemory3D);
+    testAllTypes(pitchedMemoryTiles);
 }
@@ -0,0 +1,200 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include "unittest.h"
+#include <Vc/NumericIO>
+#include <cfloat>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+static std::uint32_t floatBits(float x)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &x, 4);
+    return bits;
+}
+
+// Returns number tokens with up to 21 digits, optional fraction, and exponents that cover
+// the normal, subnormal, and overflow range of float.
+static std::vector<std::string> randomTokens(std::size_t count, unsigned seed)
+{
+    std::default_random_engine engine(seed);
+    std::uniform_int_distribution<int> digit(0, 9);
+    std::uniform_int_distribution<int> length(1, 21);
+    std::uniform_int_distribution<int> exponent(-50, 42);
+    std::uniform_int_distribution<int> choice(0, 7);
+    std::vector<std::string> tokens;
+    for (std::size_t i = 0; i < count; ++i) {
+        std::string s;
+        if (choice(engine) == 0) {
+            s += '-';
+        }
+        const int n = length(engine);
+        const int dot =
+            choice(engine) < 4 ? std::uniform_int_distribution<int>(0, n)(engine) : -1;
+        for (int j = 0; j < n; ++j) {
+            if (j == dot) {
+                s += '.';
+            }
+            s += char('0' + digit(engine));
+        }
+        if (choice(engine) < 5) {
+            s += choice(engine) < 4 ? 'e' : 'E';
+            s += std::to_string(exponent(engine));
+        }
+        tokens.push_back(s);
+    }
+    return tokens;
+}
+
+TEST(parseFloats)
+{
+    std::vector<std::string> tokens = randomTokens(20000, 1);
+    // exactly halfway between two floats in double precision: 1 + 2^-24 and 2^-126 + 2^-150
+    tokens.push_back("1.000000059604644775390625");
+    tokens.push_back("16777217");
+    tokens.push_back("16777219");
+    tokens.push_back("3.4028235677973366e38");
+    tokens.push_back("3.4028236e38");
+    tokens.push_back("1.1754943508222875e-38");
+    tokens.push_back("1e-46");
+    tokens.push_back("7e-46");
+    tokens.push_back("-0");
+    tokens.push_back("+.5");
+    tokens.push_back("1.");
+    tokens.push_back("0x1.8p3");
+    tokens.push_back("inf");
+    tokens.push_back("-Infinity");
+    tokens.push_back("00000000000000000000000000000000000123.25");
+    tokens.push_back("0.000000000000000000000000000000000000000000000000000001e60");
+    tokens.push_back("1e99999999999");
+    std::string text;
+    const char *separators[] = {" ", ",", "\n", " , ", "\t", ";"};
+    for (std::size_t i = 0; i < tokens.size(); ++i) {
+        text += tokens[i];
+        text += separators[i % 6];
+    }
+    std::vector<float> values(text.size());
+    const char *stop = nullptr;
+    COMPARE(Vc::parse_floats(text.data(), text.size(), values.data(), &stop), tokens.size());
+    COMPARE(stop, text.data() + text.size());
+    for (std::size_t i = 0; i < tokens.size(); ++i) {
+        const float reference = std::strtof(tokens[i].c_str(), nullptr);
+        COMPARE(floatBits(values[i]), floatBits(reference)) << tokens[i];
+    }
+}
+
+TEST(parseFloatsStop)
+{
+    const std::string text = "1.5, 2e3 ,-7\n1e x 4";
+    float values[8];
+    const char *stop = nullptr;
+    COMPARE(Vc::parse_floats(text.data(), text.size(), values, &stop), 3u);
+    COMPARE(stop - text.data(), 13);
+    COMPARE(values[0], 1.5f);
+    COMPARE(values[1], 2000.f);
+    COMPARE(values[2], -7.f);
+    COMPARE(Vc::parse_floats(text.data(), 0, values, &stop), 0u);
+    COMPARE(stop, text.data());
+    COMPARE(Vc::parse_floats(text.data(), 2, values, &stop), 1u);
+    COMPARE(values[0], 1.f);
+}
+
+TEST(parseInts)
+{
+    std::default_random_engine engine(2);
+    std::vector<int> reference;
+    std::string text;
+    for (int i = 0; i < 10000; ++i) {
+        const int x = i % 3 == 0 ? std::uniform_int_distribution<int>(-1000, 1000)(engine)
+                                 : std::uniform_int_distribution<int>(INT_MIN, INT_MAX)(engine);
+        reference.push_back(x);
+        text += (i % 5 == 0 && x >= 0 ? "+" : "") + std::to_string(x) + (i % 2 ? "," : "\n");
+    }
+    reference.push_back(INT_MIN);
+    reference.push_back(INT_MAX);
+    reference.push_back(7);
+    text += "-2147483648 2147483647 00000000000000000000000000007";
+    std::vector<int> values(text.size());
+    const char *stop = nullptr;
+    COMPARE(Vc::parse_ints(text.data(), text.size(), values.data(), &stop),
+            reference.size());
+    COMPARE(stop, text.data() + text.size());
+    for (std::size_t i = 0; i < reference.size(); ++i) {
+        COMPARE(values[i], reference[i]);
+    }
+
+    for (const char *invalid :
+         {"2147483648", "-2147483649", "12a", "-", "1.5", "99999999999999999999"}) {
+        const std::string s = std::string("1 ") + invalid + " 3";
+        COMPARE(Vc::parse_ints(s.data(), s.size(), values.data(), &stop), 1u) << invalid;
+        COMPARE(stop, s.data() + 2) << invalid;
+    }
+}
+
+TEST(formatFloats)
+{
+    // the output of std::to_chars
+    const float values[] = {1.f, 0.1f, 1e10f, 1000.f, 10000.f, 100000.f, 1099511627776.f,
+                            FLT_MIN, 1e-45f, 0.001f, 1e-4f, -2.5f, 123456.79f, FLT_MAX,
+                            1.5e-7f, 16777216.f, 0.3f, 0.f, -0.f};
+    const char *reference = "1 0.1 1e+10 1000 10000 1e+05 1099511627776 1.1754944e-38 "
+                            "1e-45 0.001 1e-04 -2.5 123456.79 3.4028235e+38 1.5e-07 "
+                            "16777216 0.3 0 -0 ";
+    char text[sizeof(values) / sizeof(float) * 15];
+    const std::size_t length =
+        Vc::format_floats(values, sizeof(values) / sizeof(float), text, ' ');
+    COMPARE(std::string(text, length), std::string(reference));
+}
+
+TEST(formatRoundTrip)
+{
+    std::default_random_engine engine(3);
+    std::uniform_int_distribution<std::uint32_t> bits;
+    std::vector<float> values;
+    while (values.size() < 100000) {
+        const std::uint32_t b = bits(engine);
+        float x;
+        std::memcpy(&x, &b, 4);
+        if (x == x) {
+            values.push_back(x);
+        }
+    }
+    std::vector<char> text(values.size() * 15);
+    const std::size_t length = Vc::format_floats(values.data(), values.size(), text.data());
+    std::vector<float> parsed(values.size());
+    COMPARE(Vc::parse_floats(text.data(), length, parsed.data()), values.size());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        COMPARE(floatBits(parsed[i]), floatBits(values[i]));
+    }
+}
@@ -0,0 +1,164 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include "unittest.h"
+#include <Vc/Polynomial>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#define ALL_TYPES (REAL_VECTORS, SIMD_REAL_ARRAYS(8), SIMD_REAL_ARRAYS(3))
+
+// reference evaluation in long double
+static long double reference(long double x, const std::vector<long double> &c)
+{
+    long double r = 0;
+    for (std::size_t i = c.size(); i > 0; --i) {
+        r = r * x + c[i - 1];
+    }
+    return r;
+}
+
+template <typename V> static V randomX(std::default_random_engine &engine)
+{
+    typedef typename V::EntryType T;
+    std::uniform_real_distribution<T> dist(T(-1.1), T(1.1));
+    V x;
+    for (std::size_t i = 0; i < V::Size; ++i) {
+        x[i] = dist(engine);
+    }
+    return x;
+}
+
+// Compares f(x) to the reference for the coefficients c. The tolerance accounts for the
+// different rounding of the schemes: the condition of the sum over |c_i x^i|.
+template <typename V, typename F>
+static void check(F &&f, const std::vector<typename V::EntryType> &c, std::size_t rounds = 20)
+{
+    typedef typename V::EntryType T;
+    std::default_random_engine engine;
+    const std::vector<long double> cl(c.begin(), c.end());
+    std::vector<long double> absC(c.size());
+    for (std::size_t i = 0; i < c.size(); ++i) {
+        absC[i] = std::abs(cl[i]);
+    }
+    for (std::size_t round = 0; round < rounds; ++round) {
+        const V x = randomX<V>(engine);
+        const V y = f(x);
+        for (std::size_t i = 0; i < V::Size; ++i) {
+            const long double ref = reference(x[i], cl);
+            const long double bound = reference(std::abs(x[i]), absC) * 4 * c.size() *
+                                      std::numeric_limits<T>::epsilon();
+            VERIFY(std::abs(y[i] - ref) <= bound) << "degree " << c.size() - 1 << ", x = "
+                                                  << x[i] << ": " << y[i] << " vs. " << ref;
+        }
+    }
+}
+
+template <typename T> static std::vector<T> coefficients(std::size_t n)
+{
+    std::vector<T> c(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        c[i] = T((i % 3 == 1 ? -1 : 1)) / T(i + 1);
+    }
+    return c;
+}
+
+TEST_TYPES(V, compileTimeCoefficients, ALL_TYPES)
+{
+    typedef typename V::EntryType T;
+    const T c1[] = {T(0.5)};
+    check<V>([&](V x) { return Vc::horner(x, c1); }, {T(0.5)});
+    check<V>([&](V x) { return Vc::estrin(x, c1); }, {T(0.5)});
+
+    check<V>([](V x) { return Vc::horner(x, {T(1), T(-2)}); }, {T(1), T(-2)});
+    check<V>([](V x) { return Vc::estrin(x, {T(1), T(-2)}); }, {T(1), T(-2)});
+    check<V>([](V x) { return Vc::estrin(x, {T(1), T(-2), T(3)}); }, {T(1), T(-2), T(3)});
+
+    const T c9[] = {T(1), T(2), T(-3), T(4), T(0.5), T(-1), T(0.25), T(2), T(-0.125)};
+    const std::vector<T> v9(std::begin(c9), std::end(c9));
+    check<V>([&](V x) { return Vc::horner(x, c9); }, v9);
+    check<V>([&](V x) { return Vc::estrin(x, c9); }, v9);
+    check<V>([&](V x) { return Vc::polynomial(x, c9); }, v9);
+
+    T c21[21];
+    const auto v21 = coefficients<T>(21);
+    std::copy(v21.begin(), v21.end(), c21);
+    check<V>([&](V x) { return Vc::horner(x, c21); }, v21);
+    check<V>([&](V x) { return Vc::estrin(x, c21); }, v21);
+    check<V>([&](V x) { return Vc::polynomial(x, c21); }, v21);
+}
+
+TEST_TYPES(V, runtimeCoefficients, ALL_TYPES)
+{
+    typedef typename V::EntryType T;
+    COMPARE(Vc::horner(V::One(), static_cast<const T *>(nullptr), 0), V::Zero());
+    COMPARE(Vc::estrin(V::One(), static_cast<const T *>(nullptr), 0), V::Zero());
+    for (std::size_t n : {1, 2, 3, 4, 5, 7, 8, 9, 16, 17, 31, 32, 33, 40, 64, 65, 100}) {
+        const auto c = coefficients<T>(n);
+        check<V>([&](V x) { return Vc::horner(x, c.data(), n); }, c, 5);
+        check<V>([&](V x) { return Vc::estrin(x, c.data(), n); }, c, 5);
+    }
+}
+
+TEST_TYPES(V, estrinMatchesHorner, ALL_TYPES)
+{
+    typedef typename V::EntryType T;
+    // exact in floating point: small integers
+    const T c[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13};
+    V x;
+    for (std::size_t i = 0; i < V::Size; ++i) {
+        x[i] = T(int(i % 3) - 1);
+    }
+    COMPARE(Vc::estrin(x, c), Vc::horner(x, c));
+    COMPARE(Vc::estrin(x, c, 13), Vc::horner(x, c));
+    COMPARE(Vc::horner(x, c, 13), Vc::horner(x, c));
+    COMPARE(Vc::horner(V(2), c), V(T(98305)));
+}
+
+TEST_TYPES(V, rationalFunctions, ALL_TYPES)
+{
+    typedef typename V::EntryType T;
+    std::default_random_engine engine;
+    // Padé approximant of exp(x)
+    const T p[] = {T(1), T(0.5), T(1) / 12};
+    const T q[] = {T(1), T(-0.5), T(1) / 12};
+    for (int round = 0; round < 20; ++round) {
+        const V x = randomX<V>(engine);
+        const V y = Vc::rational(x, p, q);
+        const V yr = Vc::rational(x, p, 3, q, 3);
+        for (std::size_t i = 0; i < V::Size; ++i) {
+            const long double ref = reference(x[i], {1, 0.5L, 1.L / 12}) /
+                                    reference(x[i], {1, -0.5L, 1.L / 12});
+            COMPARE_RELATIVE_ERROR(y[i], T(ref), T(4 * std::numeric_limits<T>::epsilon()));
+            COMPARE_RELATIVE_ERROR(yr[i], T(ref), T(4 * std::numeric_limits<T>::epsilon()));
+            // and it is a good approximation of exp
+            COMPARE_ABSOLUTE_ERROR(y[i], std::exp(x[i]), T(0.01));
+        }
+    }
+}
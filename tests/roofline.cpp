@@ -0,0 +1,110 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include "unittest.h"
+#include <Vc/Roofline>
+#include <sstream>
+
+using namespace Vc::Roofline;
+
+TEST_TYPES(V, probesArePositive, (REAL_VECTORS))
+{
+    const Measurement fma = probe_fma<V>(1000);
+    COMPARE(fma.kernel, "fma");
+    COMPARE(fma.level, "register");
+    COMPARE(fma.unit, "FLOP");
+    VERIFY(fma.perCycle > 0);
+    VERIFY(fma.perSecond > 0);
+
+    const Measurement load = probe_load<V>(4096, Vc::Unaligned);
+    COMPARE(load.flags, "Unaligned");
+    COMPARE(load.bytes, 4096u);
+    COMPARE(load.level, "L1");
+    VERIFY(load.perCycle > 0);
+
+    const Measurement store = probe_store<V>(4096, Vc::Streaming);
+    COMPARE(store.kernel, "store");
+    COMPARE(store.flags, "Streaming");
+    VERIFY(store.perCycle > 0);
+
+    const Measurement gather = probe_gather<V>(4096);
+    COMPARE(gather.unit, "entry");
+    VERIFY(gather.perCycle > 0);
+}
+
+TEST(probeSizes)
+{
+    const auto sizes = probe_sizes(std::size_t(1) << 30);
+    VERIFY(sizes.size() >= 3u);
+    for (std::size_t i = 1; i < sizes.size(); ++i) {
+        VERIFY(sizes[i - 1] < sizes[i]);
+    }
+    COMPARE(probe_sizes(std::size_t(1) << 20).back(), std::size_t(1) << 20);
+}
+
+static Measurement make(const char *kernel, const char *type, const char *level,
+                        double perCycle)
+{
+    return {kernel, "AVX", type, "", level, 0, "", perCycle, perCycle};
+}
+
+TEST(attainable)
+{
+    Report report;
+    report.add(make("fma", "float", "register", 32));
+    report.add(make("fma", "double", "register", 16));
+    report.add(make("load", "float", "L1", 64));
+    report.add(make("load", "float", "DRAM", 4));
+    report.add(make("load", "double", "DRAM", 5));
+
+    COMPARE(report.best("fma"), 32.);
+    COMPARE(report.best("load", "", "DRAM"), 5.);
+    COMPARE(report.best("load", "float", "DRAM"), 4.);
+    COMPARE(report.best("gather"), 0.);
+
+    COMPARE(report.attainable(1., "float"), 5.);     // memory bound
+    COMPARE(report.attainable(100., "float"), 32.);  // compute bound
+    COMPARE(report.attainable(1., "double", "L1"), 16.);
+    COMPARE(report.efficiency(2.5, 1., "float"), 0.5);
+}
+
+TEST(json)
+{
+    Report report;
+    report.add(make("fma", "float", "register", 32));
+    report.add(make("load", "fl\"oat", "L1", 64));
+    std::ostringstream out;
+    report.write_json(out);
+    const std::string s = out.str();
+    VERIFY(s.find("\"cache\": {\"L1\": ") != std::string::npos) << s;
+    VERIFY(s.find("{\"kernel\": \"fma\", \"abi\": \"AVX\", \"type\": \"float\"") !=
+           std::string::npos) << s;
+    VERIFY(s.find("\"type\": \"fl\\\"oat\"") != std::string::npos) << s;
+    VERIFY(s.find("\"per_cycle\": 64, \"per_second\": 64}\n  ]\n}\n") != std::string::npos)
+        << s;
+}
@@ -119,7 +119,11 @@ TEST_TYPES(Param, testInterleavingScatter,
                                    std::integral_constant<std::size_t, 5>,
                                    std::integral_constant<std::size_t, 6>,
                                    std::integral_constant<std::size_t, 7>,
-                                   std::integral_constant<std::size_t, 8>>>))
+                                   std::integral_constant<std::size_t, 8>,
+                                   std::integral_constant<std::size_t, 9>,
+                                   std::integral_constant<std::size_t, 11>,
+                                   std::integral_constant<std::size_t, 13>,
+                                   std::integral_constant<std::size_t, 16>>>))
 {
     typedef typename Param::template at<0> V;
     constexpr auto StructSize = Param::template at<1>::value;
@@ -0,0 +1,221 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include "unittest.h"
+#include <Vc/Selection>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// values with many duplicates, so that the tie-breaking is tested
+template <typename T>
+static std::vector<T> randomValues(std::size_t n, std::default_random_engine &engine)
+{
+    std::uniform_int_distribution<int> dist(-50, 50);
+    std::vector<T> r(n);
+    for (auto &x : r) {
+        x = T(dist(engine));
+    }
+    return r;
+}
+
+template <typename T>
+static std::vector<std::size_t> referenceTopK(const std::vector<T> &data, std::size_t k,
+                                              bool largest)
+{
+    std::vector<std::size_t> indexes;
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        if (data[i] == data[i]) {
+            indexes.push_back(i);
+        }
+    }
+    std::stable_sort(indexes.begin(), indexes.end(), [&](std::size_t a, std::size_t b) {
+        return largest ? data[a] > data[b] : data[a] < data[b];
+    });
+    indexes.resize(std::min(k, indexes.size()));
+    return indexes;
+}
+
+TEST_TYPES(V, argminArgmax, (ALL_VECTORS))
+{
+    typedef typename V::EntryType T;
+    std::default_random_engine engine;
+    std::vector<T> empty;
+    COMPARE(Vc::simd_argmin(empty.begin(), empty.end()) == empty.end(), true);
+    COMPARE(Vc::simd_argmax(empty.begin(), empty.end()) == empty.end(), true);
+    for (std::size_t n : {1, 2, 3, 7, 16, 31, 64, 65, 100, 257, 1000, 4099}) {
+        for (int round = 0; round < 5; ++round) {
+            const auto data = randomValues<T>(n, engine);
+            COMPARE(Vc::simd_argmin(data.begin(), data.end()) - data.begin(),
+                    std::min_element(data.begin(), data.end()) - data.begin())
+                << "n: " << n;
+            COMPARE(Vc::simd_argmax(data.begin(), data.end()) - data.begin(),
+                    std::max_element(data.begin(), data.end()) - data.begin())
+                << "n: " << n;
+            // unaligned start
+            if (n > 1) {
+                COMPARE(Vc::simd_argmin(data.data() + 1, data.data() + n) - data.data(),
+                        std::min_element(data.begin() + 1, data.end()) - data.begin());
+            }
+        }
+    }
+}
+
+TEST_TYPES(V, extremeValues, (ALL_VECTORS))
+{
+    typedef typename V::EntryType T;
+    // the largest possible values must still be found (they equal the initial lane values)
+    std::vector<T> data(1000, std::numeric_limits<T>::max());
+    COMPARE(Vc::simd_argmin(data.begin(), data.end()) - data.begin(), 0);
+    COMPARE(Vc::simd_argmax(data.begin(), data.end()) - data.begin(), 0);
+    data[517] = std::numeric_limits<T>::lowest();
+    COMPARE(Vc::simd_argmin(data.begin(), data.end()) - data.begin(), 517);
+    data.assign(1000, std::numeric_limits<T>::lowest());
+    data[999] = std::numeric_limits<T>::max();
+    data[998] = std::numeric_limits<T>::max();
+    COMPARE(Vc::simd_argmax(data.begin(), data.end()) - data.begin(), 998);
+    COMPARE(Vc::simd_argmin(data.begin(), data.end()) - data.begin(), 0);
+}
+
+TEST_TYPES(V, nans, (Vc::float_v, Vc::double_v))
+{
+    typedef typename V::EntryType T;
+    std::default_random_engine engine;
+    auto data = randomValues<T>(1000, engine);
+    for (std::size_t i = 1; i < data.size(); i += 3) {
+        data[i] = std::numeric_limits<T>::quiet_NaN();
+    }
+    COMPARE(Vc::simd_argmin(data.begin(), data.end()) - data.begin(),
+            std::min_element(data.begin(), data.end()) - data.begin());
+    COMPARE(Vc::simd_argmax(data.begin(), data.end()) - data.begin(),
+            std::max_element(data.begin(), data.end()) - data.begin());
+
+    // k <= V::Size also merges the vectors into a register of the best values
+    for (std::size_t k : {std::size_t(3), std::size_t(10)}) {
+        std::vector<std::size_t> result(k);
+        result.resize(Vc::simd_top_k(data.begin(), data.end(), k, result.begin()) -
+                      result.begin());
+        COMPARE(result, referenceTopK(data, k, true)) << "k = " << k;
+    }
+}
+
+TEST_TYPES(V, nansAtChunkBoundaries, (Vc::float_v, Vc::double_v))
+{
+    typedef typename V::EntryType T;
+    const T nan = std::numeric_limits<T>::quiet_NaN();
+    // four threads split 16384 values into chunks of 4096
+    std::vector<T> data(16384, T(1));
+    data[4096] = nan;
+    data[5000] = T(100);
+    for (std::size_t threads : {1, 4}) {
+        COMPARE(Vc::simd_argmax(data.begin(), data.end(), threads) - data.begin(), 5000)
+            << "threads: " << threads;
+    }
+    data[5000] = T(-100);
+    for (std::size_t threads : {1, 4}) {
+        COMPARE(Vc::simd_argmin(data.begin(), data.end(), threads) - data.begin(), 5000)
+            << "threads: " << threads;
+    }
+
+    // a chunk of NaNs only, and a NaN at the first position
+    std::fill(data.begin() + 8192, data.begin() + 12288, nan);
+    data[13000] = T(-200);
+    for (std::size_t threads : {1, 4}) {
+        COMPARE(Vc::simd_argmin(data.begin(), data.end(), threads) - data.begin(),
+                std::min_element(data.begin(), data.end()) - data.begin())
+            << "threads: " << threads;
+        COMPARE(Vc::simd_argmax(data.begin(), data.end(), threads) - data.begin(),
+                std::max_element(data.begin(), data.end()) - data.begin())
+            << "threads: " << threads;
+    }
+    data[0] = nan;
+    for (std::size_t threads : {1, 4}) {
+        COMPARE(Vc::simd_argmin(data.begin(), data.end(), threads) - data.begin(), 0);
+        COMPARE(Vc::simd_argmax(data.begin(), data.end(), threads) - data.begin(), 0);
+    }
+}
+
+TEST_TYPES(V, largeRanges, (Vc::float_v, Vc::double_v, Vc::int_v, Vc::short_v))
+{
+    typedef typename V::EntryType T;
+    std::default_random_engine engine;
+    // more iterations than the lane counters can represent for short
+    const std::size_t n = 3000000;
+    auto data = randomValues<T>(n, engine);
+    for (std::size_t pos : {std::size_t(0), n / 3, n - 1}) {
+        data[pos] = T(100);
+        COMPARE(std::size_t(Vc::simd_argmax(data.begin(), data.end()) - data.begin()), pos);
+        COMPARE(std::size_t(Vc::simd_argmax(data.begin(), data.end(), 3) - data.begin()), pos);
+        data[pos] = T(-100);
+        COMPARE(std::size_t(Vc::simd_argmin(data.begin(), data.end()) - data.begin()), pos);
+        COMPARE(std::size_t(Vc::simd_argmin(data.begin(), data.end(), 4) - data.begin()), pos);
+        data[pos] = T(0);
+    }
+    COMPARE(Vc::simd_argmin(data.begin(), data.end(), 4) - data.begin(),
+            std::min_element(data.begin(), data.end()) - data.begin());
+}
+
+TEST_TYPES(V, topK, (ALL_VECTORS))
+{
+    typedef typename V::EntryType T;
+    std::default_random_engine engine;
+    for (std::size_t n : {1, 5, 16, 33, 100, 1000, 20000}) {
+        const auto data = randomValues<T>(n, engine);
+        for (std::size_t k : {1, 2, 3, 8, 17, 100, 2000}) {
+            for (std::size_t threads : {1, 3}) {
+                std::vector<std::size_t> result(k);
+                result.resize(
+                    Vc::simd_top_k(data.begin(), data.end(), k, result.begin(), threads) -
+                    result.begin());
+                COMPARE(result, referenceTopK(data, k, true)) << "n: " << n << " k: " << k;
+                result.resize(k);
+                result.resize(
+                    Vc::simd_bottom_k(data.begin(), data.end(), k, result.begin(), threads) -
+                    result.begin());
+                COMPARE(result, referenceTopK(data, k, false)) << "n: " << n << " k: " << k;
+            }
+        }
+    }
+}
+
+TEST(topKIncreasing)
+{
+    // every value is a candidate: the worst case for the threshold
+    std::vector<float> data(10000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = float(i);
+    }
+    std::vector<std::size_t> result(5);
+    Vc::simd_top_k(data.begin(), data.end(), 5, result.begin());
+    COMPARE(result, (std::vector<std::size_t>{9999, 9998, 9997, 9996, 9995}));
+    Vc::simd_bottom_k(data.begin(), data.end(), 5, result.begin());
+    COMPARE(result, (std::vector<std::size_t>{0, 1, 2, 3, 4}));
+    COMPARE(Vc::simd_top_k(data.begin(), data.end(), 0, result.begin()) == result.begin(),
+            true);
+}
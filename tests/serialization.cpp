@@ -0,0 +1,325 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include "unittest.h"
+#include <Vc/Serialization>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using Vc::SerializationResult;
+
+#define ALL_TYPES (ALL_VECTORS)
+
+// Returns an aligned buffer of at least n bytes.
+static std::vector<char, Vc::Allocator<char>> buffer(std::size_t n)
+{
+    return std::vector<char, Vc::Allocator<char>>(n + 64);
+}
+
+static char *alignedData(std::vector<char, Vc::Allocator<char>> &b)
+{
+    const std::uintptr_t p = reinterpret_cast<std::uintptr_t>(b.data());
+    return b.data() + ((64 - p % 64) % 64);
+}
+
+TEST(crc32c)
+{
+    COMPARE(Vc::crc32c("123456789", 9), 0xe3069283u);
+    COMPARE(Vc::crc32c("", 0), 0u);
+
+    // incremental and unaligned updates agree with the one-shot checksum
+    std::vector<unsigned char> data(1000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<unsigned char>(i * 7 + 3);
+    }
+    const std::uint32_t crc = Vc::crc32c(data.data(), data.size());
+    for (std::size_t split : {1, 3, 8, 13, 511, 999}) {
+        COMPARE(Vc::crc32c(data.data() + split, data.size() - split,
+                           Vc::crc32c(data.data(), split)),
+                crc) << "split: " << split;
+    }
+}
+
+TEST_TYPES(V, dynamicMemory, ALL_TYPES)
+{
+    typedef typename V::EntryType T;
+    for (std::size_t n : {std::size_t(1), V::Size - 1, V::Size + 1, 1000 * V::Size + 3}) {
+        if (n == 0) {
+            continue;
+        }
+        Vc::Memory<V> m(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            m[i] = T(i * 3);
+        }
+        const std::size_t size = Vc::serialized_size(m);
+        COMPARE(size % 64, 0u);
+        auto b = buffer(size);
+        char *data = alignedData(b);
+        COMPARE(Vc::serialize(m, data), size);
+
+        Vc::Memory<V> r(1);
+        COMPARE(Vc::deserialize(data, size, r), SerializationResult::Success);
+        COMPARE(r.entriesCount(), n);
+        for (std::size_t i = 0; i < n; ++i) {
+            COMPARE(r[i], T(i * 3)) << "i: " << i << ", n: " << n;
+        }
+
+        std::fill_n(data, size, 0);
+        COMPARE(Vc::serialize(m, data, Vc::Streaming), size);
+        Vc::MemoryView<V> view;
+        COMPARE(Vc::view_serialized(data, size, view, true), SerializationResult::Success);
+        COMPARE(view.entriesCount(), n);
+        COMPARE(view.vectorsCount(), m.vectorsCount());
+        COMPARE(reinterpret_cast<const char *>(view.entries()), data + 128);
+        for (std::size_t i = 0; i < m.vectorsCount(); ++i) {
+            COMPARE(V(view.vector(i)), V(m.vector(i)));
+        }
+
+        std::stringstream stream;
+        COMPARE(Vc::serialize(m, stream), SerializationResult::Success);
+        const std::string s = stream.str();
+        COMPARE(s.size(), size);
+        COMPARE(std::memcmp(s.data(), data, size), 0);
+        Vc::Memory<V> r2(1);
+        COMPARE(Vc::deserialize(stream, r2), SerializationResult::Success);
+        COMPARE(r2.entriesCount(), n);
+        for (std::size_t i = 0; i < n; ++i) {
+            COMPARE(r2[i], T(i * 3));
+        }
+    }
+}
+
+TEST_TYPES(V, fixedMemory, ALL_TYPES)
+{
+    typedef typename V::EntryType T;
+    Vc::Memory<V, 5, 13> m;
+    for (std::size_t i = 0; i < m.rowsCount(); ++i) {
+        for (std::size_t j = 0; j < 13; ++j) {
+            m[i][j] = T(i * 13 + j);
+        }
+    }
+    const std::size_t size = Vc::serialized_size(m);
+    auto b = buffer(size);
+    char *data = alignedData(b);
+    COMPARE(Vc::serialize(m, data), size);
+
+    Vc::Memory<V, 5, 13> r;
+    COMPARE(Vc::deserialize(data, size, r), SerializationResult::Success);
+    for (std::size_t i = 0; i < m.rowsCount(); ++i) {
+        for (std::size_t j = 0; j < 13; ++j) {
+            COMPARE(r[i][j], T(i * 13 + j));
+        }
+    }
+
+    Vc::Memory<V, 5, 12> wrongShape;
+    COMPARE(Vc::deserialize(data, size, wrongShape), SerializationResult::SizeMismatch);
+    Vc::MemoryView<V> view;
+    COMPARE(Vc::view_serialized(data, size, view), SerializationResult::SizeMismatch);
+}
+
+TEST_TYPES(V, differentPadding, ALL_TYPES)
+{
+    // data written with a wider vector is re-padded for V
+    typedef typename V::EntryType T;
+    typedef Vc::SimdArray<T, 2 * V::Size> W;
+    Vc::Memory<W, 3, 5> m;
+    std::memset(m.entries(), 0, m.vectorsCount() * W::Size * sizeof(T));
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 5; ++j) {
+            m[i][j] = T(i * 5 + j + 1);
+        }
+    }
+    const std::size_t size = Vc::serialized_size(m);
+    auto b = buffer(size);
+    char *data = alignedData(b);
+    Vc::serialize(m, data);
+
+    Vc::Memory<V, 3, 5> r;
+    COMPARE(Vc::deserialize(data, size, r), SerializationResult::Success);
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 5; ++j) {
+            COMPARE(r[i][j], T(i * 5 + j + 1));
+        }
+        for (std::size_t j = 5; j < r.vectorsCount() / 3 * V::Size; ++j) {
+            COMPARE(r[i].entries()[j], T(0));
+        }
+    }
+}
+
+TEST(errors)
+{
+    Vc::Memory<Vc::float_v> m(100);
+    for (std::size_t i = 0; i < m.entriesCount(); ++i) {
+        m[i] = float(i);
+    }
+    const std::size_t size = Vc::serialized_size(m);
+    auto b = buffer(size);
+    char *data = alignedData(b);
+    Vc::serialize(m, data);
+    Vc::Memory<Vc::float_v> r(1);
+
+    COMPARE(Vc::deserialize(data, size - 1, r), SerializationResult::IOError);
+    COMPARE(Vc::deserialize(data, 10, r), SerializationResult::IOError);
+
+    Vc::Memory<Vc::int_v> wrongType(100);
+    COMPARE(Vc::deserialize(data, size, wrongType), SerializationResult::TypeMismatch);
+    Vc::MemoryView<Vc::int_v> wrongView;
+    COMPARE(Vc::view_serialized(data, size, wrongView), SerializationResult::TypeMismatch);
+
+    data[200] ^= 1;
+    COMPARE(Vc::deserialize(data, size, r), SerializationResult::ChecksumMismatch);
+    COMPARE(Vc::deserialize(data, size, r, false), SerializationResult::Success);
+    Vc::MemoryView<Vc::float_v> view;
+    COMPARE(Vc::view_serialized(data, size, view), SerializationResult::Success);
+    COMPARE(Vc::view_serialized(data, size, view, true),
+            SerializationResult::ChecksumMismatch);
+    data[200] ^= 1;
+
+    // without checksum no verification happens
+    Vc::serialize(m, data, Vc::Aligned, false);
+    data[200] ^= 1;
+    COMPARE(Vc::deserialize(data, size, r), SerializationResult::Success);
+
+    data[8] = 2;
+    COMPARE(Vc::deserialize(data, size, r), SerializationResult::UnsupportedVersion);
+    data[0] = 'X';
+    COMPARE(Vc::deserialize(data, size, r), SerializationResult::InvalidHeader);
+
+    // the payload must be aligned for a zero-copy view
+    Vc::serialize(m, data + 2);
+    COMPARE(Vc::view_serialized(data + 2, size, view), SerializationResult::Misaligned);
+    COMPARE(Vc::deserialize(data + 2, size, r), SerializationResult::Success);
+}
+
+TEST(typeCodes)
+{
+    using Vc::SerializationImpl::typeCode;
+    const unsigned char codes[] = {typeCode<bool>(),
+                                   typeCode<char>(),
+                                   typeCode<signed char>(),
+                                   typeCode<unsigned char>(),
+                                   typeCode<short>(),
+                                   typeCode<unsigned short>(),
+                                   typeCode<int>(),
+                                   typeCode<unsigned int>(),
+                                   typeCode<long long>(),
+                                   typeCode<unsigned long long>(),
+                                   typeCode<float>(),
+                                   typeCode<double>()};
+    for (std::size_t i = 0; i < sizeof(codes); ++i) {
+        for (std::size_t j = 0; j < i; ++j) {
+            VERIFY(codes[i] != codes[j]) << "types " << i << " and " << j;
+        }
+    }
+}
+
+template <typename T, typename U> struct Particle
+{
+    T x, y;
+    U id;
+    Particle() = default;
+    Particle(T xx, T yy, U ii) : x(xx), y(yy), id(ii) {}
+    Vc_SIMDIZE_INTERFACE((x, y, id));
+};
+
+TEST(soa_vector)
+{
+    using P = Particle<float, short>;
+    using C = Vc::soa_vector<P>;
+    for (std::size_t n : {std::size_t(0), std::size_t(1), 3 * C::simd_width + 1}) {
+        C c;
+        for (std::size_t i = 0; i < n; ++i) {
+            c.push_back(P(i, 2 * i, short(i)));
+        }
+        const std::size_t size = Vc::serialized_size(c);
+        auto b = buffer(size);
+        char *data = alignedData(b);
+        COMPARE(Vc::serialize(c, data), size);
+
+        C r(5);
+        COMPARE(Vc::deserialize(data, size, r), SerializationResult::Success);
+        COMPARE(r.size(), n);
+        for (std::size_t i = 0; i < n; ++i) {
+            const P p = r[i];
+            COMPARE(p.x, float(i));
+            COMPARE(p.y, float(2 * i));
+            COMPARE(p.id, short(i));
+        }
+
+        std::stringstream stream;
+        COMPARE(Vc::serialize(c, stream, false), SerializationResult::Success);
+        C r2;
+        COMPARE(Vc::deserialize(stream, r2), SerializationResult::Success);
+        COMPARE(r2.size(), n);
+
+        Vc::soa_vector<Particle<float, int>> wrongType;
+        COMPARE(Vc::deserialize(data, size, wrongType), SerializationResult::TypeMismatch);
+    }
+}
+
+TEST(oversizedHeader)
+{
+    // a corrupted entry count must fail before the destination is reallocated
+    Vc::Memory<Vc::float_v> m(100);
+    const std::size_t size = Vc::serialized_size(m);
+    auto b = buffer(size);
+    char *data = alignedData(b);
+    Vc::serialize(m, data);
+    const std::uint64_t huge = std::uint64_t(1) << 60;
+    std::memcpy(data + 32, &huge, 8);  // entriesPerRow
+    std::memcpy(data + 40, &huge, 8);  // paddedEntriesPerRow
+
+    Vc::Memory<Vc::float_v> r(1);
+    COMPARE(Vc::deserialize(data, size, r), SerializationResult::IOError);
+    COMPARE(r.entriesCount(), 1u);
+    std::stringstream stream(std::string(data, size));
+    COMPARE(Vc::deserialize(stream, r), SerializationResult::IOError);
+    COMPARE(r.entriesCount(), 1u);
+
+    using C = Vc::soa_vector<Particle<float, short>>;
+    C c(3);
+    const std::size_t soaSize = Vc::serialized_size(c);
+    auto b2 = buffer(soaSize);
+    char *soaData = alignedData(b2);
+    Vc::serialize(c, soaData);
+    std::memcpy(soaData + 32, &huge, 8);
+    std::memcpy(soaData + 40, &huge, 8);
+    C r2;
+    COMPARE(Vc::deserialize(soaData, soaSize, r2), SerializationResult::IOError);
+    COMPARE(r2.size(), 0u);
+
+    // the number of columns is checked as well
+    const std::uint32_t columns = 0xffffffffu;
+    const std::uint64_t offset = 64 + ((std::uint64_t(columns) + 63) & ~std::uint64_t(63));
+    Vc::serialize(m, data);
+    std::memcpy(data + 12, &columns, 4);
+    std::memcpy(data + 16, &offset, 8);
+    COMPARE(Vc::deserialize(data, size, r), SerializationResult::IOError);
+}
@@ -243,3 +243,41 @@ TEST(load_from_int_array)
     }
 }
 
+
+template <typename A, typename V> void convertFromNative()
+{
+    using T = typename A::EntryType;
+    using U = typename V::EntryType;
+    const U offset =
+        std::is_unsigned<T>::value && std::is_floating_point<U>::value ? U(3.e9) : U(-3);
+    const V x = V(IndexesFromZero) * U(3) + offset;
+
+    // the converting constructor, simd_cast, and the conversion from an atomic SimdArray
+    // must all agree with the scalar conversion
+    const A a(x);
+    const A b = simd_cast<A>(x);
+    const A c = SimdArray<U, V::Size>(x);
+    for (size_t i = 0; i < A::Size; ++i) {
+        COMPARE(a[i], static_cast<T>(x[i])) << x;
+        COMPARE(b[i], static_cast<T>(x[i])) << x;
+        COMPARE(c[i], static_cast<T>(x[i])) << x;
+    }
+}
+
+TEST_TYPES(A,
+           convert_from_float_v,
+           (SimdArray<int, float_v::Size>,
+            SimdArray<uint, float_v::Size>,
+            SimdArray<double, float_v::Size>))
+{
+    convertFromNative<A, float_v>();
+}
+
+TEST_TYPES(A,
+           convert_from_short_v,
+           (SimdArray<int, short_v::Size>,
+            SimdArray<uint, short_v::Size>,
+            SimdArray<float, short_v::Size>))
+{
+    convertFromNative<A, short_v>();
+}
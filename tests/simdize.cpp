@@ -28,6 +28,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "unittest.h"
 #include <list>
+#ifdef __unix__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 using Vc::simdize;
 using Vc::float_v;
@@ -602,4 +606,311 @@ TEST(copy_simdized_objects)
     COMPARE(std::get<1>(v3), V1::Zero());
 }
 
+template <typename T, typename U> struct Particle
+{
+    T x, y;
+    U id;
+    Particle() = default;
+    Particle(T xx, T yy, U ii) : x(xx), y(yy), id(ii) {}
+    Vc_SIMDIZE_INTERFACE((x, y, id));
+};
+
+TEST(soa_vector)
+{
+    using P = Particle<float, int>;
+    using C = Vc::soa_vector<P>;
+    using PV = C::simd_type;
+    static_assert(std::is_same<PV, simdize<P>>::value, "");
+    static_assert(C::simd_width == float_v::size(), "");
+
+    for (std::size_t n : {std::size_t(0), std::size_t(1), C::simd_width, 3 * C::simd_width + 1}) {
+        C c;
+        for (std::size_t i = 0; i < n; ++i) {
+            c.push_back(P(i, 2 * i, int(i)));
+        }
+        COMPARE(c.size(), n);
+        COMPARE(c.vectorsCount(), (n + C::simd_width - 1) / C::simd_width);
+        VERIFY(c.capacity() >= n);
+        COMPARE(reinterpret_cast<std::uintptr_t>(c.data<0>()) % float_v::MemoryAlignment, 0u);
+        for (std::size_t i = 0; i < n; ++i) {
+            const P p = c[i];
+            COMPARE(p.x, float(i));
+            COMPARE(p.y, float(2 * i));
+            COMPARE(p.id, int(i));
+        }
+
+        std::size_t count = 0;
+        for (auto &&chunk : c.vectors()) {
+            PV p = chunk;
+            const auto m = chunk.mask();
+            for (std::size_t lane = 0; lane < C::simd_width; ++lane) {
+                COMPARE(m[lane], chunk.index() + lane < n);
+                if (m[lane]) {
+                    COMPARE(p.x[lane], float(chunk.index() + lane));
+                    COMPARE(p.id[lane], int(chunk.index() + lane));
+                }
+            }
+            count += m.count();
+            p.y += 1.f;
+            chunk = p;
+        }
+        COMPARE(count, n);
+        for (std::size_t i = 0; i < n; ++i) {
+            COMPARE(c[i].get<1>(), float(2 * i + 1));
+        }
+
+        const C &constC = c;
+        count = 0;
+        for (auto &&chunk : constC.vectors()) {
+            const PV p = chunk;
+            const auto m = chunk.mask();
+            for (std::size_t lane = 0; lane < C::simd_width; ++lane) {
+                if (m[lane]) {
+                    COMPARE(p.y[lane], float(2 * (chunk.index() + lane) + 1));
+                }
+            }
+            count += m.count();
+        }
+        COMPARE(count, n);
+
+        if (1 + C::simd_width <= c.vectorsCount() * C::simd_width) {
+            const PV p = c.load(1);
+            COMPARE(p.x[0], 1.f);
+            c[0] = c[1];
+            COMPARE(c.data<2>()[0], 1);
+        }
+        c.resize(n + 2, P(-1, -1, -1));
+        COMPARE(c.size(), n + 2);
+        COMPARE(P(c[n + 1]).id, -1);
+        c.clear();
+        VERIFY(c.empty());
+    }
+
+    C c(5);
+    for (auto &&p : c) {
+        COMPARE(P(p).x, 0.f);
+        p = P(1, 2, 3);
+    }
+    COMPARE(P(c[4]).y, 2.f);
+}
+
+template <typename T> struct AggregatePoint
+{
+    T x, y;
+    Vc_SIMDIZE_INTERFACE((x, y));
+};
+
+TEST(soa_vector_of_aggregates)
+{
+    using P = AggregatePoint<float>;
+    Vc::soa_vector<P> c;
+    c.push_back(P{1.f, 2.f});
+    c.push_back(P{3.f, 4.f});
+    const P p = c[1];
+    COMPARE(p.x, 3.f);
+    COMPARE(p.y, 4.f);
+}
+
+template <typename T, typename U> struct ReorderedParticle
+{
+    T x, y;
+    U id;
+    ReorderedParticle() = default;
+    ReorderedParticle(T xx, T yy, U ii) : x(xx), y(yy), id(ii) {}
+    Vc_SIMDIZE_INTERFACE((id, y, x));
+};
+
+template <typename T> struct FiveFloats
+{
+    T a, b, c, d, e;
+    FiveFloats() = default;
+    FiveFloats(T aa, T bb, T cc, T dd, T ee) : a(aa), b(bb), c(cc), d(dd), e(ee) {}
+    Vc_SIMDIZE_INTERFACE((a, b, c, d, e));
+};
+
+template <typename T> struct Point3
+{
+    T x, y, z;
+    Vc_SIMDIZE_INTERFACE((x, y, z));
+};
+
+template <typename P> void testContiguousStructIterator()
+{
+    using PV = simdize<P>;
+    using L = std::vector<P>;
+    using LIV = simdize<typename L::iterator>;
+    constexpr std::size_t N = PV::size();
+
+    L list;
+    for (std::size_t i = 0; i < 4 * N; ++i) {
+        list.push_back(P(i, 2 * i, int(3 * i)));
+    }
+    const L &clist = list;
+    std::size_t i = 0;
+    for (simdize<typename L::const_iterator> it = clist.begin(); it != clist.end(); ++it) {
+        const PV p = *it;
+        for (std::size_t lane = 0; lane < N; ++lane, ++i) {
+            COMPARE(p.x[lane], float(i));
+            COMPARE(p.y[lane], float(2 * i));
+            COMPARE(p.id[lane], int(3 * i));
+        }
+    }
+    COMPARE(i, list.size());
+
+    for (LIV it = list.begin(); it != list.end(); ++it) {
+        PV p = *it;
+        p.x += 1.f;
+        p.id = -p.id;
+        *it = p;
+        it->y += 2.f;
+    }
+    for (i = 0; i < list.size(); ++i) {
+        COMPARE(list[i].x, float(i + 1));
+        COMPARE(list[i].y, float(2 * i + 2));
+        COMPARE(list[i].id, -int(3 * i));
+    }
+}
+
+TEST(contiguous_struct_iterator)
+{
+    using Vc::SimdizeDetail::IteratorDetails::is_contiguous_struct_iterator;
+    using P = Particle<float, int>;
+    static_assert(is_contiguous_struct_iterator<P *, simdize<P>>::value ==
+                      (int_v::size() == float_v::size()),
+                  "");
+    static_assert(is_contiguous_struct_iterator<std::vector<P>::const_iterator,
+                                                simdize<P>>::value ==
+                      (int_v::size() == float_v::size()),
+                  "");
+    static_assert(!is_contiguous_struct_iterator<std::list<P>::iterator, simdize<P>>::value,
+                  "");
+    static_assert(!is_contiguous_struct_iterator<Particle<float, double> *,
+                                                 simdize<Particle<float, double>>>::value,
+                  "");
+    static_assert(is_contiguous_struct_iterator<std::array<float, 5> *,
+                                                simdize<std::array<float, 5>>>::value,
+                  "");
+
+    testContiguousStructIterator<P>();
+    testContiguousStructIterator<ReorderedParticle<float, int>>();
+
+    using F = FiveFloats<float>;
+    static_assert(is_contiguous_struct_iterator<std::vector<F, Vc::Allocator<F>>::iterator,
+                                                simdize<F>>::value,
+                  "");
+    std::vector<F, Vc::Allocator<F>> data(3 * float_v::size());
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = F(i * 5.f, i * 5.f + 1, i * 5.f + 2, i * 5.f + 3, i * 5.f + 4);
+    }
+    using FIV = simdize<std::vector<F, Vc::Allocator<F>>::iterator>;
+    std::size_t offset = 0;
+    for (FIV it = data.begin(); it != data.end(); ++it, offset += float_v::size()) {
+        const float_v reference = (float_v::IndexesFromZero() + float(offset)) * 5.f;
+        COMPARE(it->a, reference);
+        COMPARE(it->b, reference + 1.f);
+        COMPARE(it->c, reference + 2.f);
+        COMPARE(it->d, reference + 3.f);
+        COMPARE(it->e, reference + 4.f);
+        it->c *= -1.f;
+    }
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        COMPARE(data[i].b, float(i * 5 + 1));
+        COMPARE(data[i].c, -float(i * 5 + 2));
+    }
+}
+
+template <typename T> void testThreeMemberStructs()
+{
+    using Vc::SimdizeDetail::IteratorDetails::is_deinterleavable_struct_iterator;
+    using P = Point3<T>;
+    using PV = simdize<P>;
+    using L = std::vector<P, Vc::Allocator<P>>;
+    using LIV = simdize<typename L::iterator>;
+    static_assert(is_deinterleavable_struct_iterator<typename L::iterator, PV>::value,
+                  "three members must take the vector path");
+    static_assert(is_deinterleavable_struct_iterator<P *, PV>::value,
+                  "three members must take the vector path");
+    constexpr std::size_t N = PV::size();
+
+    L data(3 * N);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = {T(3 * i), T(3 * i + 1), T(3 * i + 2)};
+    }
+    std::size_t i = 0;
+    for (LIV it = data.begin(); it != data.end(); ++it) {
+        PV p = *it;
+        for (std::size_t lane = 0; lane < N; ++lane, ++i) {
+            COMPARE(p.x[lane], T(3 * i));
+            COMPARE(p.y[lane], T(3 * i + 1));
+            COMPARE(p.z[lane], T(3 * i + 2));
+        }
+        p.y = -p.y;
+        *it = p;
+    }
+    COMPARE(i, data.size());
+    for (i = 0; i < data.size(); ++i) {
+        COMPARE(data[i].x, T(3 * i));
+        COMPARE(data[i].y, T(-T(3 * i + 1)));
+        COMPARE(data[i].z, T(3 * i + 2));
+    }
+}
+
+TEST(three_member_structs)
+{
+    testThreeMemberStructs<float>();
+    testThreeMemberStructs<double>();
+    testThreeMemberStructs<int>();
+    testThreeMemberStructs<unsigned short>();
+    testThreeMemberStructs<short>();
+}
+
+#ifdef __unix__
+// the last chunk of an array that ends right before an inaccessible page
+template <typename S> void testStructsBeforeGuardPage()
+{
+    using T = typename S::value_type;
+    using SV = simdize<S>;
+    using It = simdize<S *>;
+    constexpr std::size_t N = SV::size();
+    constexpr std::size_t Members = std::tuple_size<S>::value;
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    char *pages = static_cast<char *>(mmap(nullptr, 2 * pageSize, PROT_READ | PROT_WRITE,
+                                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    VERIFY(pages != MAP_FAILED);
+    VERIFY(mprotect(pages + pageSize, pageSize, PROT_NONE) == 0);
+    S *const end = reinterpret_cast<S *>(pages + pageSize);
+    S *const begin = end - 2 * N;
+    for (std::size_t i = 0; i < 2 * N; ++i) {
+        for (std::size_t m = 0; m < Members; ++m) {
+            begin[i][m] = T(i * Members + m);
+        }
+    }
+    // copy through the simdized iterators, then compare the scalar structs
+    std::vector<S> copy(2 * N);
+    It out = copy.data();
+    for (It it = begin, last = end; it != last; ++it, ++out) {
+        const SV v = *it;
+        *out = v;
+    }
+    for (std::size_t i = 0; i < 2 * N; ++i) {
+        for (std::size_t m = 0; m < Members; ++m) {
+            COMPARE(copy[i][m], T(i * Members + m)) << "members: " << Members;
+        }
+    }
+    munmap(pages, 2 * pageSize);
+}
+
+TEST(contiguous_structs_before_guard_page)
+{
+    testStructsBeforeGuardPage<std::array<float, 2>>();
+    testStructsBeforeGuardPage<std::array<float, 3>>();
+    testStructsBeforeGuardPage<std::array<double, 3>>();
+    testStructsBeforeGuardPage<std::array<short, 3>>();
+    testStructsBeforeGuardPage<std::array<float, 4>>();
+    testStructsBeforeGuardPage<std::array<float, 5>>();
+    testStructsBeforeGuardPage<std::array<float, 7>>();
+    testStructsBeforeGuardPage<std::array<float, 11>>();
+}
+#endif
+
 // vim: foldmethod=marker
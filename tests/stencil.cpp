@@ -0,0 +1,223 @@
+/*  This file is part of the Vc library. {{{
+Copyright © 2015 Matthias Kretz <kretz@kde.org>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the names of contributing organizations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+}}}*/
+
+#include "unittest.h"
+#include <Vc/Stencil>
+#include <random>
+#include <vector>
+
+#define ALL_TYPES (REAL_VECTORS, SIMD_REAL_ARRAYS(16))
+
+using Vc::stencil_point;
+using Vc::PitchedMemory;
+
+template <typename T> static T randomValue(std::default_random_engine &engine)
+{
+    return std::uniform_real_distribution<T>(T(-1), T(1))(engine);
+}
+
+TEST_TYPES(V, oneDimensional, ALL_TYPES) //{{{1
+{
+    typedef typename V::EntryType T;
+    // asymmetric, with offsets beyond one vector
+    typedef Vc::stencil<V, stencil_point<-11>, stencil_point<-1>, stencil_point<0>,
+                        stencil_point<3>, stencil_point<9>> S;
+    static_assert(S::Dimension == 1, "");
+    COMPARE(S::lowerHalo(0), 11u);
+    COMPARE(S::upperHalo(0), 9u);
+    const S st(T(0.5), T(-2), T(1), T(0.25), T(3));
+
+    std::default_random_engine engine;
+    for (std::size_t n : {std::size_t(20), std::size_t(21), 5 * V::Size + 23,
+                          std::size_t(1000)}) {
+        Vc::Memory<V> in(n), out(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            in[i] = randomValue<T>(engine);
+            out[i] = T(-7);
+        }
+        for (std::size_t threads : {1, 3}) {
+            st.apply(in, out, threads);
+            for (std::size_t i = 0; i < n; ++i) {
+                if (i < 11 || i + 9 >= n) {
+                    COMPARE(out[i], T(-7)) << "n: " << n << ", i: " << i;
+                } else {
+                    const T ref = T(0.5) * in[i - 11] + T(-2) * in[i - 1] + T(1) * in[i] +
+                                  T(0.25) * in[i + 3] + T(3) * in[i + 9];
+                    COMPARE(out[i], ref) << "n: " << n << ", i: " << i;
+                }
+            }
+        }
+    }
+}
+
+// references {{{1
+template <typename V>
+static void reference(const PitchedMemory<V, 2> &in, PitchedMemory<V, 2> &out,
+                      typename V::EntryType c0, typename V::EntryType c1)
+{
+    // 5-point Laplacian with a diagonal term
+    for (std::size_t i = 1; i + 1 < in.size(0); ++i) {
+        for (std::size_t j = 1; j + 2 < in.size(1); ++j) {
+            out(i, j) = c0 * in(i, j) + c1 * in(i - 1, j) + c1 * in(i + 1, j) +
+                        c1 * in(i, j - 1) + c1 * in(i, j + 1) + c1 * in(i + 1, j + 2);
+        }
+    }
+}
+
+template <typename V>
+static void reference(const PitchedMemory<V, 3> &in, PitchedMemory<V, 3> &out,
+                      typename V::EntryType c0, typename V::EntryType c1)
+{
+    // 7-point diffusion
+    for (std::size_t i = 1; i + 1 < in.size(0); ++i) {
+        for (std::size_t j = 1; j + 1 < in.size(1); ++j) {
+            for (std::size_t k = 1; k + 1 < in.size(2); ++k) {
+                out(i, j, k) = c0 * in(i, j, k) + c1 * in(i - 1, j, k) +
+                               c1 * in(i + 1, j, k) + c1 * in(i, j - 1, k) +
+                               c1 * in(i, j + 1, k) + c1 * in(i, j, k - 1) +
+                               c1 * in(i, j, k + 1);
+            }
+        }
+    }
+}
+
+template <typename V>
+using Stencil2D = Vc::stencil<V, stencil_point<0, 0>, stencil_point<-1, 0>, stencil_point<1, 0>,
+                              stencil_point<0, -1>, stencil_point<0, 1>, stencil_point<1, 2>>;
+template <typename V>
+using Stencil3D = Vc::stencil<V, stencil_point<0, 0, 0>, stencil_point<-1, 0, 0>,
+                              stencil_point<1, 0, 0>, stencil_point<0, -1, 0>,
+                              stencil_point<0, 1, 0>, stencil_point<0, 0, -1>,
+                              stencil_point<0, 0, 1>>;
+
+template <typename V, std::size_t D>
+static void fill(PitchedMemory<V, D> &a, PitchedMemory<V, D> &b,
+                 std::default_random_engine &engine)
+{
+    typedef typename V::EntryType T;
+    // a and b share the halo values; the padding stays zero
+    std::size_t rows = 1;
+    for (std::size_t d = 0; d + 1 < D; ++d) {
+        rows *= a.size(d);
+    }
+    for (std::size_t r = 0; r < rows; ++r) {
+        for (std::size_t j = 0; j < a.size(D - 1); ++j) {
+            a.entries()[r * a.pitch() + j] = b.entries()[r * b.pitch() + j] =
+                randomValue<T>(engine);
+        }
+    }
+}
+
+template <typename V, std::size_t D>
+static void compareGrids(const PitchedMemory<V, D> &a, const PitchedMemory<V, D> &b)
+{
+    std::size_t rows = 1;
+    for (std::size_t d = 0; d + 1 < D; ++d) {
+        rows *= a.size(d);
+    }
+    for (std::size_t r = 0; r < rows; ++r) {
+        for (std::size_t j = 0; j < a.size(D - 1); ++j) {
+            COMPARE(a.entries()[r * a.pitch() + j], b.entries()[r * b.pitch() + j])
+                << "row: " << r << ", entry: " << j;
+        }
+    }
+}
+
+TEST_TYPES(V, twoDimensional, ALL_TYPES) //{{{1
+{
+    typedef typename V::EntryType T;
+    typedef Stencil2D<V> S;
+    COMPARE(S::lowerHalo(0), 1u);
+    COMPARE(S::upperHalo(0), 1u);
+    COMPARE(S::lowerHalo(1), 1u);
+    COMPARE(S::upperHalo(1), 2u);
+    const S st(T(-4), T(1), T(1), T(1), T(1), T(1));
+    std::default_random_engine engine;
+    for (std::size_t cols : {std::size_t(4), V::Size + 3, std::size_t(300)}) {
+        PitchedMemory<V, 2> in(13, cols), out(13, cols), ref(13, cols);
+        // in, and the halo shared by out and ref
+        fill(in, ref, engine);
+        fill(out, ref, engine);
+        reference(in, ref, T(-4), T(1));
+        for (std::size_t threads : {1, 2}) {
+            st.apply(in, out, threads);
+            compareGrids(out, ref);
+        }
+    }
+}
+
+TEST_TYPES(V, threeDimensional, ALL_TYPES) //{{{1
+{
+    typedef typename V::EntryType T;
+    const Stencil3D<V> st(T(0.4), T(0.1), T(0.1), T(0.1), T(0.1), T(0.1), T(0.1));
+    std::default_random_engine engine;
+    PitchedMemory<V, 3> in(7, 9, 2 * V::Size + 5), out(7, 9, 2 * V::Size + 5),
+        ref(7, 9, 2 * V::Size + 5);
+    fill(in, ref, engine);
+    fill(out, ref, engine);
+    reference(in, ref, T(0.4), T(0.1));
+    st.apply(in, out, 1);
+    compareGrids(out, ref);
+    st.apply(in, out, 3);
+    compareGrids(out, ref);
+}
+
+TEST_TYPES(V, sweep, ALL_TYPES) //{{{1
+{
+    typedef typename V::EntryType T;
+    const Stencil3D<V> st3(T(0.4), T(0.1), T(0.1), T(0.1), T(0.1), T(0.1), T(0.1));
+    const Stencil2D<V> st2(T(0.3), T(0.14), T(0.14), T(0.14), T(0.14), T(0.14));
+    std::default_random_engine engine;
+    for (std::size_t steps : {1, 2, 5}) {
+        for (std::size_t perPass : {0, 1, 2, 3}) {
+            for (std::size_t threads : {1, 3}) {
+                PitchedMemory<V, 3> a(11, 8, V::Size + 3), b(11, 8, V::Size + 3);
+                fill(a, b, engine);
+                PitchedMemory<V, 3> refA(a), refB(b);
+                for (std::size_t s = 0; s < steps; ++s) {
+                    reference(refA, refB, T(0.4), T(0.1));
+                    refA.swap(refB);
+                }
+                st3.sweep(a, b, steps, threads, perPass);
+                compareGrids(a, refA);
+
+                PitchedMemory<V, 2> c(17, 3 * V::Size + 4), d(17, 3 * V::Size + 4);
+                fill(c, d, engine);
+                PitchedMemory<V, 2> refC(c), refD(d);
+                for (std::size_t s = 0; s < steps; ++s) {
+                    reference(refC, refD, T(0.3), T(0.14));
+                    refC.swap(refD);
+                }
+                st2.sweep(c, d, steps, threads, perPass);
+                compareGrids(c, refC);
+            }
+        }
+    }
+}
+
+// vim: foldmethod=marker
@@ -28,6 +28,7 @@
 #include <forward_list>
 #include <list>
 #include <deque>
+#include <limits>
 
 #include "common/macros.h"
 
@@ -150,4 +151,57 @@ TEST_TYPES(V, simdForEach, (ALL_VECTORS))
         reference += x.Size;
     });
 }
+
+template <typename X> std::size_t entryCount() { return X::Size; }
+template <typename X> std::size_t entryCount(const typename X::Mask &k)
+{
+    VERIFY(k.count() < int(X::Size));
+    return k.count();
+}
+
+template <typename T> struct MinAndCount {
+    T min = std::numeric_limits<T>::max();
+    std::size_t count = 0;
+    std::size_t calls_with_mask = 0;
+
+    template <typename X, typename... Mask> void operator()(const X &x, const Mask &... k)
+    {
+        min = std::min(min, x.min(k...));
+        count += entryCount<X>(k...);
+        calls_with_mask += sizeof...(Mask);
+    }
+};
+
+TEST_TYPES(V, simdForEachMasked, (ALL_VECTORS))
+{
+    typedef typename V::EntryType T;
+    std::vector<T> data;
+    std::size_t calls_with_mask = 0;
+    for (int n = 1; n < 67; ++n) {
+        data.clear();
+        for (int i = 0; i < n; ++i) {
+            data.push_back(T(i + 1));
+        }
+        // the zeros past the end of the range must not make it into the minimum
+        const auto r = Vc::simd_for_each(std::next(data.begin()), data.end(),
+                                         MinAndCount<T>());
+        COMPARE(r.count, std::size_t(n - 1)) << "n: " << n;
+        if (n > 1) {
+            COMPARE(r.min, T(2)) << "n: " << n;
+        }
+        VERIFY(r.calls_with_mask <= 1u);
+        calls_with_mask += r.calls_with_mask;
+
+        // masked entries must not be stored back
+        Vc::simd_for_each(std::next(data.begin()), data.end(),
+                          [](auto &x, auto... k) { x = -x; });
+        COMPARE(data[0], T(1));
+        for (int i = 1; i < n; ++i) {
+            COMPARE(data[i], T(-(i + 1))) << "i: " << i << ", n: " << n;
+        }
+    }
+    if (V::Size > 1) {
+        VERIFY(calls_with_mask > 0u);
+    }
+}
 #endif
@@ -29,6 +29,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "unittest-old.h"
 #include <iostream>
 #include <cstring>
+#include <vector>
+#include <Vc/cpuid.h>
 
 using namespace Vc;
 
@@ -191,12 +193,105 @@ template<typename Vec> void maskedStore()
     }
 }
 
+template<typename Vec> void streamingCopy()
+{
+    typedef typename Vec::EntryType T;
+    // large enough to exceed the threshold for streaming stores
+    const size_t count = 2 * CpuId::L2Data() / sizeof(T) + 3 * Vec::Size + 1;
+    std::vector<T> src(count + Vec::Size);
+    std::vector<T> dst(count + Vec::Size);
+    for (size_t i = 0; i < src.size(); ++i) {
+        src[i] = T(i & 0x7f);
+    }
+    for (size_t n : {size_t(0), size_t(1), Vec::Size + 1, 5 * Vec::Size + 3, count}) {
+        for (size_t offset = 0; offset < Vec::Size; ++offset) {
+            std::fill(dst.begin(), dst.end(), T(0x7e));
+            streaming_copy(&dst[offset], &src[Vec::Size - offset], n);
+            for (size_t i = 0; i < dst.size(); ++i) {
+                const T reference =
+                    i >= offset && i < offset + n ? src[Vec::Size - offset + i - offset] : T(0x7e);
+                COMPARE(dst[i], reference) << "i: " << i << ", n: " << n << ", offset: " << offset;
+            }
+        }
+    }
+
+    Memory<Vec> a(count);
+    Memory<Vec> b(count);
+    for (size_t i = 0; i < count; ++i) {
+        a[i] = T(i & 0x7f);
+    }
+    streaming_copy(b, a);
+    for (size_t i = 0; i < count; ++i) {
+        COMPARE(b[i], a[i]);
+    }
+}
+
+template<typename Vec> void streamingFill()
+{
+    typedef typename Vec::EntryType T;
+    const size_t count = 2 * CpuId::L2Data() / sizeof(T) + 3 * Vec::Size + 1;
+    std::vector<T> dst(count + Vec::Size);
+    for (size_t n : {size_t(1), Vec::Size + 1, count}) {
+        for (size_t offset = 0; offset < Vec::Size; ++offset) {
+            std::fill(dst.begin(), dst.end(), T(0));
+            streaming_fill(&dst[offset], n, T(3));
+            for (size_t i = 0; i < dst.size(); ++i) {
+                COMPARE(dst[i], T(i >= offset && i < offset + n ? 3 : 0))
+                    << "i: " << i << ", n: " << n << ", offset: " << offset;
+            }
+        }
+    }
+
+    Memory<Vec> array(count);
+    streaming_fill(array, T(5));
+    for (size_t i = 0; i < array.entriesCount(); ++i) {
+        COMPARE(array[i], T(5));
+    }
+}
+
+struct IncrementFunctor
+{
+    template <typename V> V operator()(V x) const { return x + V::One(); }
+};
+
+template<typename Vec> void streamingTransform()
+{
+    typedef typename Vec::EntryType T;
+    const size_t count = 2 * CpuId::L2Data() / sizeof(T) + 3 * Vec::Size + 1;
+    std::vector<T> data(count + Vec::Size);
+    for (size_t n : {size_t(1), 5 * Vec::Size + 3, count}) {
+        for (size_t offset = 0; offset < Vec::Size; ++offset) {
+            for (size_t i = 0; i < data.size(); ++i) {
+                data[i] = T(i & 0x3f);
+            }
+            // in-place: every entry must be incremented exactly once
+            streaming_transform(&data[offset], &data[offset], n, IncrementFunctor());
+            for (size_t i = 0; i < data.size(); ++i) {
+                const T reference = T((i & 0x3f) + (i >= offset && i < offset + n ? 1 : 0));
+                COMPARE(data[i], reference) << "i: " << i << ", n: " << n << ", offset: " << offset;
+            }
+        }
+    }
+
+    Memory<Vec> a(count);
+    for (size_t i = 0; i < count; ++i) {
+        a[i] = T(i & 0x3f);
+    }
+    streaming_transform(a, a, IncrementFunctor());
+    for (size_t i = 0; i < count; ++i) {
+        COMPARE(a[i], T((i & 0x3f) + 1));
+    }
+}
+
 void testmain()
 {
     testAllTypes(alignedStore);
     testAllTypes(unalignedStore);
     testAllTypes(streamingAndAlignedStore);
     testAllTypes(streamingAndUnalignedStore);
+    testAllTypes(streamingCopy);
+    testAllTypes(streamingFill);
+    testAllTypes(streamingTransform);
 
     if (float_v::Size > 1) {
         // only works with an even number of vector entries
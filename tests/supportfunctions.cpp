@@ -67,12 +67,29 @@ void testExtraInstructions()
     COMPARE(!(extra & Vc::Bmi2Instructions), !CpuId::hasBmi2());
 }
 
+void testTopology()
+{
+    using Vc::CpuId;
+    CpuId::init();
+    VERIFY(CpuId::threadsPerCore() >= 1u);
+    VERIFY(CpuId::coresPerPackage() >= 1u);
+    VERIFY(CpuId::packages() >= 1u);
+    VERIFY(CpuId::numaNodes() >= 1u);
+    VERIFY(CpuId::physicalCores() >= CpuId::packages());
+    VERIFY(CpuId::L1DataSharedBy() <= CpuId::L2SharedBy() || CpuId::L2SharedBy() == 0);
+    VERIFY(CpuId::L2SharedBy() <= CpuId::L3SharedBy() || CpuId::L3SharedBy() == 0);
+    if (CpuId::L3Data() > 0) {
+        VERIFY(CpuId::L3SharedBy() >= 1u);
+    }
+}
+
 void testmain()
 {
     runTest(testCompiledImplementation);
     runTest(testIsSupported);
     runTest(testBestImplementation);
     runTest(testExtraInstructions);
+    runTest(testTopology);
 }
 
 // vim: foldmethod=marker
@@ -436,3 +436,44 @@ TEST_TYPES(V, testNonMemberInterleave, (ALL_VECTORS, SIMD_ARRAYS(1), SIMD_ARRAYS
         COMPARE(testValues[1], references[1]);
     }
 }
+
+TEST_TYPES(V, persistentLanes, (ALL_VECTORS, SIMD_ARRAYS(3), SIMD_ARRAYS(16)))
+{
+    typedef typename V::Mask M;
+    typedef Vc::SimdArray<int, V::Size> I;
+    for (std::size_t count : {std::size_t(0), std::size_t(1), V::Size - 1, V::Size + 1,
+                              std::size_t(1000)}) {
+        // work item i needs (i * 7) % 13 + 1 iterations
+        std::vector<int> iterations(count, -1);
+        I remaining, counter;
+        std::size_t steps = 0;
+        Vc::persistent_lanes<V>(
+            count,
+            [&](const I &items, const M &lanes) {
+                const auto k = simd_cast<typename I::mask_type>(lanes);
+                where(k) | remaining = (items * 7) % 13 + 1;
+                where(k) | counter = 0;
+            },
+            [&](const M &active) {
+                ++steps;
+                const auto k = simd_cast<typename I::mask_type>(active);
+                where(k) | remaining -= 1;
+                where(k) | counter += 1;
+                return simd_cast<M>(remaining == 0);
+            },
+            [&](const I &items, const M &done) {
+                for (std::size_t i : where(done)) {
+                    VERIFY(std::size_t(items[i]) < count);
+                    COMPARE(iterations[items[i]], -1) << "item finished twice: " << items[i];
+                    iterations[items[i]] = counter[i];
+                }
+            });
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            COMPARE(iterations[i], int((i * 7) % 13 + 1)) << "i: " << i;
+            total += iterations[i];
+        }
+        // all lanes are busy, except while draining the last items
+        VERIFY(steps <= (total + V::Size - 1) / V::Size + 13) << "steps: " << steps;
+    }
+}